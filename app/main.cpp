@@ -1,9 +1,18 @@
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include <unistd.h>
+
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
@@ -11,81 +20,36 @@
 #include "instr/functions.hpp"
 #include "instr/instruction_encoder.hpp"
 #include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
 #include "instr/opcodes.hpp"
 #include "memory/memory.hpp"
 #include "reader/file_reader.hpp"
+#include "reader/instruction_scheduler.hpp"
 #include "registers/register_bank.hpp"
+#include "utils/string_utils.hpp"
 
+#include "batch_runner.hpp"
+#include "decoupled_simulator.hpp"
+#include "multicore_system.hpp"
 #include "simulator.hpp"
+#include "time_travel_debugger.hpp"
 #include "types.hpp"
 
-#include "instr/handlers/add_handler.hpp"
-#include "instr/handlers/addi_handler.hpp"
-#include "instr/handlers/beq_handler.hpp"
-#include "instr/handlers/bne_handler.hpp"
-#include "instr/handlers/lb_handler.hpp"
-#include "instr/handlers/lui_handler.hpp"
-#include "instr/handlers/ori_handler.hpp"
-#include "instr/handlers/sll_handler.hpp"
-#include "instr/handlers/slt_handler.hpp"
 #include "instr/handlers/syscall_handler.hpp"
-
-#include "instr/parsers/add_parser.hpp"
-#include "instr/parsers/addi_parser.hpp"
-#include "instr/parsers/b_parser.hpp"
-#include "instr/parsers/beq_parser.hpp"
-#include "instr/parsers/beqz_parser.hpp"
-#include "instr/parsers/bge_parser.hpp"
-#include "instr/parsers/bne_parser.hpp"
-#include "instr/parsers/la_parser.hpp"
-#include "instr/parsers/lb_parser.hpp"
-#include "instr/parsers/li_parser.hpp"
-#include "instr/parsers/lui_parser.hpp"
-#include "instr/parsers/nop_parser.hpp"
-#include "instr/parsers/ori_parser.hpp"
-#include "instr/parsers/sll_parser.hpp"
-#include "instr/parsers/slt_parser.hpp"
-#include "instr/parsers/subi_parser.hpp"
-#include "instr/parsers/syscall_parser.hpp"
+#include "memory/console_device.hpp"
+#include "memory/dma_device.hpp"
+#include "memory/timer_device.hpp"
+#include "pipeline/chrome_tracer.hpp"
+#include "pipeline/konata_tracer.hpp"
+#include "pipeline/multiply_divide_unit.hpp"
+#include "pipeline/pipeline_profiler.hpp"
+#include "pipeline/static_analyzer.hpp"
+#include "pipeline/timing_model.hpp"
+#include "utils/work_stealing_pool.hpp"
 
 
 // MARK: -- Setup Methods
 
-/**
- * Sets up the instruction set.
- * @return The instruction set
- */
-std::unique_ptr<InstructionSet> setupInstructions() {
-
-    // Create our instruction set
-    std::unique_ptr<InstructionSet> instrSet(new InstructionSet());
-
-    // R-Type
-    instrSet->registerRType("add", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_ADD), std::unique_ptr<AddParser>(new AddParser()), std::unique_ptr<AddHandler>(new AddHandler()));
-    instrSet->registerRType("sll", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SLL), std::unique_ptr<SllParser>(new SllParser()), std::unique_ptr<SllHandler>(new SllHandler()));
-    instrSet->registerRType("slt", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SLT), std::unique_ptr<SltParser>(new SltParser()), std::unique_ptr<SltHandler>(new SltHandler()));
-    instrSet->registerRType("syscall", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SYSCALL), std::unique_ptr<SyscallParser>(new SyscallParser()), std::unique_ptr<SyscallHandler>(new SyscallHandler()));
-
-    // I-Type
-    instrSet->registerIType("addi", static_cast<word_t>(Opcodes::OPCODE_ADDI), std::unique_ptr<AddiParser>(new AddiParser()), std::unique_ptr<AddiHandler>(new AddiHandler()));
-    instrSet->registerIType("beq", static_cast<word_t>(Opcodes::OPCODE_BEQ), std::unique_ptr<BeqParser>(new BeqParser()), std::unique_ptr<BeqHandler>(new BeqHandler()));
-    instrSet->registerIType("bne", static_cast<word_t>(Opcodes::OPCODE_BNE), std::unique_ptr<BneParser>(new BneParser()), std::unique_ptr<BneHandler>(new BneHandler()));
-    instrSet->registerIType("lb", static_cast<word_t>(Opcodes::OPCODE_LB), std::unique_ptr<LbParser>(new LbParser()), std::unique_ptr<LbHandler>(new LbHandler()));
-    instrSet->registerIType("lui", static_cast<word_t>(Opcodes::OPCODE_LUI), std::unique_ptr<LuiParser>(new LuiParser()), std::unique_ptr<LuiHandler>(new LuiHandler()));
-    instrSet->registerIType("ori", static_cast<word_t>(Opcodes::OPCODE_ORI), std::unique_ptr<OriParser>(new OriParser()), std::unique_ptr<OriHandler>(new OriHandler()));
-
-    // Psuedo-Type
-    instrSet->registerPsuedoType("b", std::unique_ptr<BParser>(new BParser()));
-    instrSet->registerPsuedoType("beqz", std::unique_ptr<BeqzParser>(new BeqzParser()));
-    instrSet->registerPsuedoType("bge", std::unique_ptr<BgeParser>(new BgeParser()));
-    instrSet->registerPsuedoType("la", std::unique_ptr<LaParser>(new LaParser()));
-    instrSet->registerPsuedoType("li", std::unique_ptr<LiParser>(new LiParser()));
-    instrSet->registerPsuedoType("nop", std::unique_ptr<NopParser>(new NopParser()));
-    instrSet->registerPsuedoType("subi", std::unique_ptr<SubiParser>(new SubiParser()));
-
-    return std::move(instrSet);
-}
-
 /**
  * Sets up things such as the logger.
  */
@@ -117,6 +81,427 @@ void setupLogger() {
 }
 
 
+// MARK: -- Device Methods
+
+/**
+ * Maps the console, timer and DMA engine into the MMIO region, a page each.
+ * @param memory The memory
+ * @param input The console input
+ * @return The timer, whose clock is still to be set
+ */
+std::shared_ptr<TimerDevice> mapDevices(Memory& memory, InputFeed * input) {
+
+    std::shared_ptr<TimerDevice> timer(new TimerDevice());
+    memory.mapDevice(Memory::MMIO_START, ConsoleDevice::SIZE, std::shared_ptr<MemoryDevice>(new ConsoleDevice(std::cout, input)));
+    memory.mapDevice(Memory::MMIO_START + Memory::PAGE_SIZE, TimerDevice::SIZE, timer);
+    memory.mapDevice(Memory::MMIO_START + 2 * Memory::PAGE_SIZE, DmaDevice::SIZE, std::shared_ptr<MemoryDevice>(new DmaDevice(memory)));
+    return timer;
+}
+
+
+// MARK: -- Debugger Methods
+
+/**
+ * Finds an address from a label or a number.
+ * @param str The label or number
+ * @param reader The reader holding the labels
+ * @param addr A placeholder for the address
+ * @return Whether or not the address was found
+ */
+bool parseAddress(const std::string& str, const FileReader& reader, Memory::addr_t& addr) {
+
+    auto search = reader.getSymbols().find(StringUtils::toLowerCase(str));
+    if (search != reader.getSymbols().end()) {
+        addr = search->second;
+        return true;
+    }
+
+    try {
+        addr = static_cast<Memory::addr_t>(std::stoul(str, nullptr, 0));
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+/**
+ * Reads a count, made only of decimal digits.
+ * @param str The count
+ * @param count A placeholder for the count
+ * @return Whether or not the count is valid
+ */
+bool parseCount(const std::string& str, dword_t& count) {
+
+    if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+
+    try {
+        count = std::stoull(str);
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+/**
+ * Parses a pipeline for the timing model: 5 or 8 for a preset, or a comma-separated list of stages.
+ * @param str The pipeline
+ * @param config A placeholder for the configuration
+ * @return Whether or not the pipeline is valid
+ */
+bool parseStages(const std::string& str, TimingModel::Config& config) {
+
+    if (str == "5" || str == "8") {
+        config = (str == "5") ? TimingModel::Config::fiveStage() : TimingModel::Config::eightStage();
+        return true;
+    }
+
+    config.vecStages.clear();
+    for (const std::string& name : StringUtils::split(str, ',')) {
+
+        size_t stage = 0;
+        while (stage < NUM_PIPELINE_STAGES && StringUtils::toLowerCase(name) != StringUtils::toLowerCase(getPipelineStageName(static_cast<PipelineStage>(stage))))
+            stage++;
+        if (stage == NUM_PIPELINE_STAGES)
+            return false;
+        config.vecStages.push_back(static_cast<PipelineStage>(stage));
+    }
+
+    // The model checks the order itself
+    try {
+        TimingModel model(config);
+        return true;
+    }
+    catch (const std::invalid_argument& e) {
+        return false;
+    }
+}
+
+/**
+ * Parses the latencies of the multiply/divide unit: "<multiply>,<divide>", in cycles.
+ * @param str The latencies
+ * @param config A placeholder for the configuration
+ * @return Whether or not the latencies are valid
+ */
+bool parseLatencies(const std::string& str, MultiplyDivideUnit::Config& config) {
+
+    std::vector<std::string> parts = StringUtils::split(str, ',');
+    if (parts.size() != 2)
+        return false;
+
+    try {
+        config.dwMultiplyLatency = std::stoull(parts[0]);
+        config.dwDivideLatency = std::stoull(parts[1]);
+        MultiplyDivideUnit unit(config);
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+/**
+ * Prints every register, four to a line.
+ * @param registers The registers
+ */
+void printRegisters(const RegisterBank& registers) {
+
+    for (word_t reg = 0; reg < RegisterBank::NUM_REGISTERS; ++reg) {
+        word_t value = 0;
+        registers.readRegister(reg, value);
+        std::cout << "$" << std::left << std::setw(3) << reg << "0x" << std::right << std::hex << std::setw(8) << std::setfill('0') << value
+                  << std::dec << std::setfill(' ') << ((reg % 4 == 3) ? "\n" : "  ");
+    }
+
+    std::cout << "hi  " << "0x" << std::hex << std::setw(8) << std::setfill('0') << registers.readHi() << "  "
+              << "lo  " << "0x" << std::setw(8) << registers.readLo() << std::dec << std::setfill(' ') << "\n";
+}
+
+/**
+ * Prints the cycle and next instruction the debugger is at.
+ * @param debugger The debugger
+ */
+void printLocation(const TimeTravelDebugger& debugger) {
+
+    std::cout << "cycle " << debugger.getCycle() << ", pc 0x" << std::hex << debugger.getPC() << std::dec;
+    if (debugger.getStop().reason == StopReason::CYCLE_LIMIT)
+        std::cout << " (cycle limit reached)";
+    else if (debugger.getStop().reason == StopReason::LIVELOCK)
+        std::cout << " (livelock, repeating every " << debugger.getStop().dwPeriod << " cycles)";
+    else if (!debugger.isRunning())
+        std::cout << " (finished)";
+    std::cout << std::endl;
+}
+
+/**
+ * Runs the time travel debugger's commands from standard input until it ends or we quit.
+ * @param debugger The debugger
+ * @param reader The reader holding the labels
+ */
+void runTimeTravel(TimeTravelDebugger& debugger, const FileReader& reader) {
+
+    const std::string help = "commands: step|s [n], reverse-step|rs [n], continue|c [label|addr], reverse-continue|rc [label|addr],\n"
+                             "          seek <cycle>, regs|r, mem|x <label|addr> [bytes], quit|q";
+    std::cout << help << std::endl;
+    printLocation(debugger);
+
+    std::string line;
+    while (std::cout << "(pipesim) " << std::flush, std::getline(std::cin, line)) {
+
+        std::istringstream stream(line);
+        std::string command, argument;
+        stream >> command >> argument;
+        if (command.empty()) continue;
+
+        // Stepping takes a count, continuing takes where to stop (or runs to the end / start)
+        if (command == "step" || command == "s" || command == "reverse-step" || command == "rs") {
+
+            dword_t count = 1;
+            if (!argument.empty() && !parseCount(argument, count)) {
+                std::cout << "usage: " << command << " [n]" << std::endl;
+                continue;
+            }
+
+            bool reverse = (command == "reverse-step" || command == "rs");
+            for (dword_t i = 0; i < count; ++i) {
+                if (reverse ? !debugger.reverseStep() : !debugger.step()) break;
+            }
+        }
+        else if (command == "continue" || command == "c" || command == "reverse-continue" || command == "rc") {
+
+            Memory::addr_t target = 0;
+            if (!argument.empty() && !parseAddress(argument, reader, target)) {
+                std::cout << "unknown label or address " << argument << std::endl;
+                continue;
+            }
+
+            auto stop = [&argument, target](Memory::addr_t pc) { return !argument.empty() && pc == target; };
+            if (command == "continue" || command == "c")
+                debugger.forwardContinue(stop);
+            else
+                debugger.reverseContinue(stop);
+        }
+        else if (command == "seek" && !argument.empty()) {
+
+            dword_t cycle = 0;
+            if (!parseCount(argument, cycle)) {
+                std::cout << "usage: seek <cycle>" << std::endl;
+                continue;
+            }
+
+            if (!debugger.seek(cycle))
+                std::cout << "program finished before cycle " << argument << std::endl;
+        }
+        else if (command == "regs" || command == "r") {
+            printRegisters(debugger.getRegisters());
+            continue;
+        }
+        else if ((command == "mem" || command == "x") && !argument.empty()) {
+
+            Memory::addr_t addr = 0;
+            if (!parseAddress(argument, reader, addr)) {
+                std::cout << "unknown label or address " << argument << std::endl;
+                continue;
+            }
+
+            size_t size = 16;
+            stream >> size;
+            for (size_t i = 0; i < size; ++i) {
+                byte_t byte = 0;
+                if (!debugger.getMemory().readByte(addr + i, byte)) break;
+                if (i % 16 == 0) std::cout << (i ? "\n" : "") << "0x" << std::hex << addr + i << ":";
+                std::cout << " " << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << std::setfill(' ') << std::dec;
+            }
+            std::cout << std::dec << std::endl;
+            continue;
+        }
+        else if (command == "quit" || command == "q")
+            break;
+        else {
+            std::cout << help << std::endl;
+            continue;
+        }
+
+        printLocation(debugger);
+    }
+
+    const TimeTravelDebugger::Stats& stats = debugger.getStats();
+    spdlog::info("Checkpoints: {} ({} pages copied), {} cycles run again", stats.dwCheckpoints, stats.dwPagesCopied, stats.dwCyclesReplayed);
+}
+
+
+/**
+ * Reports a stop that ended a run early, at its cycle limit or on a livelock, as a fault.
+ * @param stop Where and why the run stopped
+ * @return The exit code (1 if the run ended early)
+ */
+int reportStop(const SimulatorStop& stop) {
+
+    switch (stop.reason) {
+        case StopReason::CYCLE_LIMIT:
+            spdlog::critical("SIGXCPU: Cycle limit of {} reached at 0x{:x}", stop.dwCycle, stop.wPC);
+            return 1;
+        case StopReason::LIVELOCK:
+            spdlog::critical("SIGLOOP: Livelock at 0x{:x}, repeating every {} cycles with no system call", stop.wPC, stop.dwPeriod);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Runs the simulator to the end, printing where each breakpoint and watchpoint stops it.
+ * @param simulator The simulator, with its breakpoints and watchpoints set
+ * @param registers The simulator's registers
+ * @param memory The simulator's memory
+ */
+void runToStops(Simulator& simulator, const RegisterBank& registers, const Memory& memory) {
+
+    spdlog::info("Running Simulator...");
+    spdlog::set_pattern("%v");
+
+    spdlog::info("");
+    spdlog::info("Output:");
+    spdlog::info("------------");
+
+    // Does the printing straight to the console, in line with the program's output
+    simulator.reset();
+    for (const Simulator::Stop * stop = &simulator.resume(); stop->reason == StopReason::BREAKPOINT || stop->reason == StopReason::WATCHPOINT;
+         stop = &simulator.resume()) {
+
+        if (stop->reason == StopReason::BREAKPOINT) {
+            std::cout << "[breakpoint] cycle " << stop->dwCycle << ", pc 0x" << std::hex << stop->wPC << std::dec << std::endl;
+            printRegisters(registers);
+        }
+        else {
+            const Memory::WatchHit& hit = stop->watch;
+            std::cout << "[watchpoint] cycle " << stop->dwCycle << ", pc 0x" << std::hex << stop->wPC << ": "
+                      << (hit.bWrite ? "write" : "read") << " of " << std::dec << hit.szSize << " byte(s) at 0x" << std::hex << hit.wAddress;
+            if (hit.bWrite) std::cout << ", 0x" << hit.wOldValue << " -> 0x" << hit.wNewValue;
+            else            std::cout << ", 0x" << hit.wNewValue;
+            std::cout << std::dec << std::endl;
+        }
+    }
+
+    spdlog::info("------------");
+    spdlog::info("");
+    spdlog::set_pattern("%+");
+
+    const SimulatorStats& stats = simulator.getStats();
+    spdlog::info("Total Clock Cycles: {}", stats.dwClockCycles);
+    spdlog::info("Total NOP Count: {}", stats.dwNops);
+    spdlog::info("Total Instruction Count: {}", stats.dwInstructions);
+    if (stats.dwDecodeForwards > 0)
+        spdlog::info("Total Branch Forwards (ID): {}, costing {} stall cycles", stats.dwDecodeForwards, stats.dwDecodeStalls);
+    if (simulator.getLoadStoreUnit().getStats().dwForwards > 0)
+        spdlog::info("Total Store Forwards: {} of {} loads", simulator.getLoadStoreUnit().getStats().dwForwards, simulator.getLoadStoreUnit().getStats().dwLoads);
+    const MultiplyDivideUnit::Stats& mdu = simulator.getMultiplyDivideUnit().getStats();
+    if (mdu.dwMultiplies + mdu.dwDivides > 0)
+        spdlog::info("Total Multiplies / Divides: {} / {}, costing {} stall cycles", mdu.dwMultiplies, mdu.dwDivides, mdu.dwStalls);
+    if (memory.getDeviceCycles() > 0)
+        spdlog::info("Total Device Cycles: {}", memory.getDeviceCycles());
+}
+
+
+// MARK: -- Batch Methods
+
+/**
+ * Runs a batch of jobs, each in its own simulator process, and writes their results.
+ * @param argc The arguments count
+ * @param argv The arguments list (argv[2] is the jobs file)
+ * @return The exit code (1 unless every job finished)
+ */
+int runBatch(int argc, char ** argv) {
+
+    const std::string usage = "usage: ./pipeSim batch <jobs.jsonl> [--output <results.jsonl>] [--threads <n>] [--window <n>] [--pin]\n"
+                              "                 [--max-cycles <n>] [--timeout <ms>] [--no-detect-livelock]";
+    if (argc < 3) {
+        std::cerr << usage << std::endl;
+        exit(1);
+    }
+
+    std::string jobsFile = argv[2];
+    std::string outputFile = "results.jsonl";
+    BatchRunner::Config config;
+    dword_t count = 0;
+    bool threads = false;
+
+    // A count that does not parse falls through to the usage
+    for (int i = 3; i < argc; ++i) {
+
+        std::string flag = argv[i];
+        if (flag == "--output" && i + 1 < argc)
+            outputFile = argv[++i];
+        else if (flag == "--threads" && i + 1 < argc && parseCount(argv[i + 1], count)) {
+            config.szThreads = static_cast<size_t>(count);
+            threads = true;
+            ++i;
+        }
+        else if (flag == "--window" && i + 1 < argc && parseCount(argv[i + 1], count)) {
+            config.szWindow = static_cast<size_t>(count);
+            ++i;
+        }
+        else if (flag == "--pin")
+            config.bPin = true;
+        else if (flag == "--max-cycles" && i + 1 < argc && parseCount(argv[i + 1], config.dwMaxCycles))
+            ++i;
+        else if (flag == "--timeout" && i + 1 < argc && parseCount(argv[i + 1], config.dwTimeoutMs))
+            ++i;
+        else if (flag == "--no-detect-livelock")
+            config.bDetectLivelock = false;
+        else {
+            std::cerr << usage << std::endl;
+            exit(1);
+        }
+    }
+
+    if (config.szWindow == 0) {
+        std::cerr << "error: --window must be at least 1" << std::endl;
+        exit(1);
+    }
+
+    // Leaving --threads out gives one per host thread, but none at all would run nothing
+    if (threads && config.szThreads == 0) {
+        std::cerr << "error: --threads must be at least 1" << std::endl;
+        exit(1);
+    }
+
+    // Every job runs this same executable
+    char path[4096];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    config.strExecutable = (length > 0) ? std::string(path, length) : std::string(argv[0]);
+
+    setupLogger();
+
+    std::vector<BatchRunner::Job> jobs;
+    if (!BatchRunner::readJobs(jobsFile, jobs))
+        exit(1);
+
+    std::ofstream results(outputFile);
+    if (!results.is_open()) {
+        spdlog::critical("Unable to write results to {}", outputFile);
+        exit(1);
+    }
+
+    BatchRunner runner(config);
+    spdlog::info("Running {} jobs from {} on {} threads...", jobs.size(), jobsFile,
+                 (config.szThreads > 0) ? config.szThreads : WorkStealingPool::getHostThreads());
+    BatchRunner::Stats stats = runner.run(jobs, results);
+
+    spdlog::info("Total Jobs: {}", stats.dwJobs);
+    spdlog::info("Total Finished: {}", stats.dwOk);
+    spdlog::info("Total Traps: {} ({} livelocks, {} cycle limits)", stats.dwTraps, stats.dwLivelocks, stats.dwCycleLimits);
+    spdlog::info("Total Timeouts: {}", stats.dwTimeouts);
+    spdlog::info("Total Errors: {}", stats.dwErrors);
+    spdlog::info("Total Steals: {}", stats.dwSteals);
+    spdlog::info("Results written to {}", outputFile);
+
+    return (stats.dwOk == stats.dwJobs) ? 0 : 1;
+}
+
+
 // MARK: -- Entry Methods
 
 /**
@@ -127,21 +512,239 @@ void setupLogger() {
 int main(int argc, char ** argv) {
 
     //
-    // Usage: ./pipeSim <filename> [--debug]
+    // Usage: ./pipeSim <filename> [--debug] [--stdin-file <file>] [--record <log> | --replay <log>]
+    //                  [--trace <file> [--trace-format chrome|konata] [--trace-start <cycle>] [--trace-cycles <n>]]
+    //                  [--profile <file> [--profile-stage if|id|ex|mem|wb] [--profile-top <n>]]
+    //                  [--cores <label>[,<label>...] [--quantum <cycles> | --cache [--cache-line <bytes>]]]
+    //                  [--decoupled [--sequential] [--stages 5|8|<stage>,...]] [--time-travel [--checkpoint-interval <cycles>]]
+    //                  [--break <label|addr>]... [--watch|--rwatch|--awatch <label|addr>[:<bytes>]]... [--devices]
+    //                  [--mdu-latency <multiply>,<divide>] [--peephole] [--schedule] [--max-cycles <n>] [--detect-livelock]
+    //        ./pipeSim batch <jobs.jsonl> [--output <results.jsonl>] [--threads <n>] [--window <n>] [--pin]
+    //                  [--max-cycles <n>] [--timeout <ms>] [--no-detect-livelock]
     //
+    const std::string usage = "usage: ./pipeSim <filename> [--debug] [--stdin-file <file>] [--record <log> | --replay <log>]\n"
+                              "                 [--trace <file> [--trace-format chrome|konata] [--trace-start <cycle>] [--trace-cycles <n>]]\n"
+                              "                 [--profile <file> [--profile-stage if|id|ex|mem|wb] [--profile-top <n>]]\n"
+                              "                 [--cores <label>[,<label>...] [--quantum <cycles> | --cache [--cache-line <bytes>]]]\n"
+                              "                 [--decoupled [--sequential] [--stages 5|8|<stage>,...]] [--time-travel [--checkpoint-interval <cycles>]]\n"
+                              "                 [--break <label|addr>]... [--watch|--rwatch|--awatch <label|addr>[:<bytes>]]... [--devices]\n"
+                              "                 [--mdu-latency <multiply>,<divide>] [--peephole] [--schedule] [--max-cycles <n>] [--detect-livelock]\n"
+                              "       ./pipeSim batch <jobs.jsonl> [--output <results.jsonl>] [--threads <n>] [--window <n>] [--pin]\n"
+                              "                 [--max-cycles <n>] [--timeout <ms>] [--no-detect-livelock]";
     if (argc < 2) {
-        std::cerr << "usage: ./pipeSim <filename> [--debug]" << std::endl;
+        std::cerr << usage << std::endl;
         exit(1);
     }
 
-    // Get the filename
+    // Get the filename, unless we are running a batch of them
     std::string filename = argv[1];
+    if (filename == "batch")
+        return runBatch(argc, argv);
+
     bool debug = false;
+    std::string stdinFile;
+    std::string recordFile;
+    std::string replayFile;
+    std::string traceFile;
+    std::string traceFormat = "chrome";
+    dword_t traceStart = 0;
+    dword_t traceCycles = 0;
+    std::string profileFile;
+    std::string profileStage = "ex";
+    size_t profileTop = 10;
+    std::vector<std::string> cores;
+    dword_t quantum = 0;
+    bool cache = false;
+    CoherenceBus::Config cacheConfig;
+    bool decoupled = false;
+    bool sequential = false;
+    std::string stages;
+    TimingModel::Config timingConfig;
+    bool timeTravel = false;
+    dword_t checkpointInterval = TimeTravelDebugger::DEFAULT_INTERVAL;
+    std::vector<std::string> breakpoints;
+    std::vector<std::pair<std::string, Memory::WatchKind>> watchpoints;
+    bool devices = false;
+    std::string mduLatency;
+    MultiplyDivideUnit::Config mduConfig;
+    bool peephole = false;
+    bool schedule = false;
+    dword_t maxCycles = 0;
+    bool detectLivelock = false;
+
+    // Check the remaining flags (a count that does not parse falls through to the usage)
+    dword_t count = 0;
+    for (int i = 2; i < argc; ++i) {
+
+        std::string flag = argv[i];
+        if (flag == "--debug" || flag == "-d")
+            debug = true;
+        else if (flag == "--stdin-file" && i + 1 < argc)
+            stdinFile = argv[++i];
+        else if (flag == "--record" && i + 1 < argc)
+            recordFile = argv[++i];
+        else if (flag == "--replay" && i + 1 < argc)
+            replayFile = argv[++i];
+        else if (flag == "--trace" && i + 1 < argc)
+            traceFile = argv[++i];
+        else if (flag == "--trace-format" && i + 1 < argc)
+            traceFormat = argv[++i];
+        else if (flag == "--trace-start" && i + 1 < argc && parseCount(argv[i + 1], traceStart))
+            ++i;
+        else if (flag == "--trace-cycles" && i + 1 < argc && parseCount(argv[i + 1], traceCycles))
+            ++i;
+        else if (flag == "--profile" && i + 1 < argc)
+            profileFile = argv[++i];
+        else if (flag == "--profile-stage" && i + 1 < argc)
+            profileStage = argv[++i];
+        else if (flag == "--profile-top" && i + 1 < argc && parseCount(argv[i + 1], count)) {
+            profileTop = static_cast<size_t>(count);
+            ++i;
+        }
+        else if (flag == "--cores" && i + 1 < argc)
+            cores = StringUtils::split(argv[++i], ',');
+        else if (flag == "--quantum" && i + 1 < argc && parseCount(argv[i + 1], quantum)) {
+
+            // A quantum of 0 would mean lockstep, which is what leaving the flag out gives
+            if (quantum == 0) {
+                std::cerr << "error: --quantum must be at least 1" << std::endl;
+                exit(1);
+            }
+            ++i;
+        }
+        else if (flag == "--cache")
+            cache = true;
+        else if (flag == "--cache-line" && i + 1 < argc && parseCount(argv[i + 1], count)) {
+            cacheConfig.szLineSize = static_cast<size_t>(count);
+            ++i;
+        }
+        else if (flag == "--decoupled")
+            decoupled = true;
+        else if (flag == "--sequential")
+            sequential = true;
+        else if (flag == "--stages" && i + 1 < argc)
+            stages = argv[++i];
+        else if (flag == "--time-travel")
+            timeTravel = true;
+        else if (flag == "--checkpoint-interval" && i + 1 < argc && parseCount(argv[i + 1], checkpointInterval))
+            ++i;
+        else if (flag == "--break" && i + 1 < argc)
+            breakpoints.push_back(argv[++i]);
+        else if (flag == "--watch" && i + 1 < argc)
+            watchpoints.emplace_back(argv[++i], Memory::WatchKind::WRITE);
+        else if (flag == "--rwatch" && i + 1 < argc)
+            watchpoints.emplace_back(argv[++i], Memory::WatchKind::READ);
+        else if (flag == "--awatch" && i + 1 < argc)
+            watchpoints.emplace_back(argv[++i], Memory::WatchKind::ACCESS);
+        else if (flag == "--devices")
+            devices = true;
+        else if (flag == "--mdu-latency" && i + 1 < argc)
+            mduLatency = argv[++i];
+        else if (flag == "--peephole")
+            peephole = true;
+        else if (flag == "--schedule")
+            schedule = true;
+        else if (flag == "--max-cycles" && i + 1 < argc && parseCount(argv[i + 1], maxCycles))
+            ++i;
+        else if (flag == "--detect-livelock")
+            detectLivelock = true;
+        else {
+            std::cerr << usage << std::endl;
+            exit(1);
+        }
+    }
+
+    if (traceFormat != "chrome" && traceFormat != "konata") {
+        std::cerr << "error: unknown trace format " << traceFormat << " (expected chrome or konata)" << std::endl;
+        exit(1);
+    }
+
+    // Find the stage to profile by its name
+    std::transform(profileStage.begin(), profileStage.end(), profileStage.begin(), ::toupper);
+    size_t stageIndex = 0;
+    while (stageIndex < NUM_PIPELINE_STAGES && profileStage != getPipelineStageName(static_cast<PipelineStage>(stageIndex)))
+        stageIndex++;
+
+    if (stageIndex == NUM_PIPELINE_STAGES) {
+        std::cerr << "error: unknown pipeline stage " << profileStage << " (expected if, id, ex, mem or wb)" << std::endl;
+        exit(1);
+    }
+
+    if (!cores.empty() && (!traceFile.empty() || !profileFile.empty())) {
+        std::cerr << "error: --trace and --profile only work on a single core" << std::endl;
+        exit(1);
+    }
+
+    if ((quantum > 0 || cache) && cores.empty()) {
+        std::cerr << "error: --quantum and --cache only work with --cores" << std::endl;
+        exit(1);
+    }
+
+    if (quantum > 0 && cache) {
+        std::cerr << "error: --cache only works on cores running in lockstep (without --quantum)" << std::endl;
+        exit(1);
+    }
+
+    if (decoupled && (!cores.empty() || !traceFile.empty() || !profileFile.empty())) {
+        std::cerr << "error: --decoupled only works on a single core, without --trace or --profile" << std::endl;
+        exit(1);
+    }
+
+    if (timeTravel && (decoupled || !cores.empty() || !traceFile.empty() || !profileFile.empty())) {
+        std::cerr << "error: --time-travel only works on a single core, without --decoupled, --trace or --profile" << std::endl;
+        exit(1);
+    }
+
+    if (timeTravel && checkpointInterval == 0) {
+        std::cerr << "error: --checkpoint-interval must be at least 1" << std::endl;
+        exit(1);
+    }
+
+    bool stops = !breakpoints.empty() || !watchpoints.empty();
+    if (stops && (timeTravel || decoupled || !cores.empty() || !traceFile.empty() || !profileFile.empty())) {
+        std::cerr << "error: --break and --watch only work on a single core, without --time-travel, --decoupled, --trace or --profile" << std::endl;
+        exit(1);
+    }
+
+    if (devices && (timeTravel || decoupled || !cores.empty())) {
+        std::cerr << "error: --devices only works on a single core, without --time-travel or --decoupled" << std::endl;
+        exit(1);
+    }
+
+    if (sequential && !decoupled) {
+        std::cerr << "error: --sequential only works with --decoupled" << std::endl;
+        exit(1);
+    }
+
+    if (!stages.empty() && !decoupled) {
+        std::cerr << "error: --stages only works with --decoupled" << std::endl;
+        exit(1);
+    }
 
-    // Check the debug flag if we have it
-    if (argc >= 3) {
-        std::string debugFlag = argv[2];
-        debug = (debugFlag == "--debug" || debugFlag == "-d");
+    if (!stages.empty() && !parseStages(stages, timingConfig)) {
+        std::cerr << "error: unknown pipeline " << stages << " (expected 5, 8 or stages from if, id, ex, mem and wb, in order, with one id)" << std::endl;
+        exit(1);
+    }
+
+    if (!mduLatency.empty() && (timeTravel || !cores.empty())) {
+        std::cerr << "error: --mdu-latency only works on a single core, without --time-travel" << std::endl;
+        exit(1);
+    }
+
+    if (!mduLatency.empty() && !parseLatencies(mduLatency, mduConfig)) {
+        std::cerr << "error: invalid multiply/divide latencies " << mduLatency << " (expected <multiply>,<divide>, each at least 1 cycle)" << std::endl;
+        exit(1);
+    }
+    timingConfig.mdu = mduConfig;
+
+    if ((maxCycles > 0 || detectLivelock) && decoupled) {
+        std::cerr << "error: --max-cycles and --detect-livelock do not work with --decoupled" << std::endl;
+        exit(1);
+    }
+
+    if (!recordFile.empty() && !replayFile.empty()) {
+        std::cerr << "error: --record and --replay cannot be used together" << std::endl;
+        exit(1);
     }
 
     // Set up our logging - for some reason this works some of the time, and not other times
@@ -154,10 +757,50 @@ int main(int argc, char ** argv) {
     spdlog::info("");
     spdlog::info("{:<5}{:<9}: {}", "", "Filename", filename);
     spdlog::info("{:<5}{:<9}: {}", "", "Debug", (debug) ? "yes" : "no");
+    if (!stdinFile.empty())     spdlog::info("{:<5}{:<9}: {}", "", "Input", stdinFile);
+    if (!recordFile.empty())    spdlog::info("{:<5}{:<9}: {}", "", "Record", recordFile);
+    if (!replayFile.empty())    spdlog::info("{:<5}{:<9}: {}", "", "Replay", replayFile);
+    if (!traceFile.empty())     spdlog::info("{:<5}{:<9}: {} ({})", "", "Trace", traceFile, traceFormat);
+    if (!profileFile.empty())   spdlog::info("{:<5}{:<9}: {} ({})", "", "Profile", profileFile, profileStage);
+    if (!cores.empty())         spdlog::info("{:<5}{:<9}: {}", "", "Cores", cores.size());
+    if (quantum > 0)            spdlog::info("{:<5}{:<9}: {} cycles", "", "Quantum", quantum);
+    if (cache)                  spdlog::info("{:<5}{:<9}: MESI, {} byte lines", "", "L1D", cacheConfig.szLineSize);
+    if (decoupled)              spdlog::info("{:<5}{:<9}: {}, {} stages", "", "Decoupled", (sequential) ? "sequential" : "parallel", timingConfig.vecStages.size());
+    if (timeTravel)             spdlog::info("{:<5}{:<9}: checkpoint every {} cycles", "", "Debugger", checkpointInterval);
+    if (devices)                spdlog::info("{:<5}{:<9}: console, timer, DMA at 0x{:x}", "", "MMIO", Memory::MMIO_START);
+    if (stops)                  spdlog::info("{:<5}{:<9}: {} breakpoint(s), {} watchpoint(s)", "", "Stops", breakpoints.size(), watchpoints.size());
+    if (!mduLatency.empty())    spdlog::info("{:<5}{:<9}: multiply {} cycles, divide {} cycles", "", "MDU", mduConfig.dwMultiplyLatency, mduConfig.dwDivideLatency);
+    if (peephole)               spdlog::info("{:<5}{:<9}: yes", "", "Peephole");
+    if (schedule)               spdlog::info("{:<5}{:<9}: {} stages", "", "Schedule", timingConfig.vecStages.size());
+    if (maxCycles > 0)          spdlog::info("{:<5}{:<9}: {} cycles", "", "Limit", maxCycles);
+    if (detectLivelock)         spdlog::info("{:<5}{:<9}: yes", "", "Livelock");
     spdlog::info("");
 
-    // Get our instruction set
-    std::unique_ptr<InstructionSet> instrSet = setupInstructions();
+    // Set up our system calls - input comes only from the file if one was given
+    std::unique_ptr<SyscallHandler> syscallHandler(new SyscallHandler());
+    InputFeed * input = &syscallHandler->getInputFeed();
+    if (!stdinFile.empty()) {
+        if (!syscallHandler->getInputFeed().queueFile(stdinFile)) {
+            spdlog::critical("Unable to open input file {}", stdinFile);
+            exit(1);
+        }
+        syscallHandler->getInputFeed().setFallback(nullptr);
+    }
+
+    if (!recordFile.empty()) {
+        std::shared_ptr<SyscallLog> log(new SyscallLog());
+        if (!log->openForRecording(recordFile)) exit(1);
+        syscallHandler->setRecordLog(log);
+    }
+
+    if (!replayFile.empty()) {
+        std::shared_ptr<SyscallLog> log(new SyscallLog());
+        if (!log->load(replayFile)) exit(1);
+        syscallHandler->setReplayLog(log);
+    }
+
+    // Get our instruction set (on multiple cores, the first core gets our system call handler instead)
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault(cores.empty() ? std::move(syscallHandler) : nullptr);
 
     // Create our memory
     std::unique_ptr<Memory> memory(new Memory(0x1000, 0x1000));
@@ -165,8 +808,12 @@ int main(int argc, char ** argv) {
     // Create our register bank
     std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
 
-    // Read our file
+    // Read our file, scheduling it for the pipeline we time it on
     FileReader reader;
+    reader.setPeephole(peephole);
+    if (schedule)
+        reader.setScheduler(std::unique_ptr<InstructionScheduler>(new InstructionScheduler(timingConfig.vecStages)));
+
     if (!reader.readFile(filename, *instrSet.get(), *memory.get())) {
         spdlog::critical("Unable to open file {}", filename);
         exit(1);
@@ -174,9 +821,177 @@ int main(int argc, char ** argv) {
 
     spdlog::info("Loaded file {} into memory", filename);
 
+    // Reject anything the instruction set cannot run now, rather than once a run reaches it
+    StaticAnalyzer::Report analysis;
+    std::vector<PredecodedInstruction> predecoded;
+    if (!StaticAnalyzer(*instrSet.get()).analyze(*memory.get(), predecoded, analysis)) {
+        for (Memory::addr_t addr : analysis.vecIllegal) {
+            word_t word = 0;
+            memory->readWord(addr, word);
+            spdlog::critical("SIGILL: Illegal instruction 0x{:08x} at 0x{:x}", word, addr);
+        }
+        exit(1);
+    }
+
+    spdlog::debug("Analysis: {} instructions, {} reading a register written just before, {} using a load straight away, {} branches forwarded into decode ({} stall cycles)",
+                  analysis.dwInstructions, analysis.dwRawHazards, analysis.dwLoadUses, analysis.dwDecodeHazards, analysis.dwDecodeStalls);
+    if (peephole) {
+        const PeepholeOptimizer::Stats& optimized = reader.getPeepholeStats();
+        dword_t removed = optimized.dwInstructionsBefore - optimized.dwInstructionsAfter;
+        spdlog::info("Peephole: {} instructions down to {} ({} bytes smaller, {} fewer cycles through every instruction once)",
+                     optimized.dwInstructionsBefore, optimized.dwInstructionsAfter, 4 * removed, removed);
+        spdlog::info("Peephole: folded {} li and {} la, removed {} subi of 0 and {} NOPs from runs",
+                     optimized.dwConstantsFolded, optimized.dwAddressesFolded, optimized.dwMovesRemoved, optimized.dwNopsRemoved);
+    }
+
+    if (schedule) {
+        const InstructionScheduler::Stats& scheduled = reader.getScheduleStats();
+        spdlog::info("Scheduled {} basic blocks ({} reordered): removed {} NOPs, {} cycles through every block once, down from {} ({} saved)",
+                     scheduled.dwBlocks, scheduled.dwBlocksReordered, scheduled.dwNopsRemoved, scheduled.dwCyclesAfter, scheduled.dwCyclesBefore,
+                     scheduled.dwCyclesBefore - scheduled.dwCyclesAfter);
+    }
+
+    // Map our devices, if asked; the timer counts the cycles of whichever simulator runs
+    std::shared_ptr<TimerDevice> timer = devices ? mapDevices(*memory.get(), input) : nullptr;
+
+    // Run on multiple cores if asked, each starting at its own label
+    if (!cores.empty()) {
+
+        MulticoreSystem system(std::move(memory), quantum);
+        for (size_t core = 0; core < cores.size(); ++core) {
+
+            auto search = reader.getSymbols().find(StringUtils::toLowerCase(cores[core]));
+            if (search == reader.getSymbols().end()) {
+                spdlog::critical("Unable to find entry label '{}' for core {}", cores[core], core);
+                exit(1);
+            }
+
+            system.addCore(search->second, (core == 0) ? std::move(syscallHandler) : nullptr);
+        }
+
+        if (cache && !system.enableCaches(cacheConfig)) exit(1);
+
+        system.setCycleLimit(maxCycles);
+        system.setLivelockDetection(detectLivelock);
+        system.run();
+        return reportStop(system.getStop());
+    }
+
+    // Run the functional front end and timing back end apart, if asked
+    if (decoupled) {
+        DecoupledSimulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank), timingConfig);
+        simulator.setParallel(!sequential);
+        simulator.run();
+        return 0;
+    }
+
+    // Debug the program interactively, forwards and backwards, if asked
+    if (timeTravel) {
+        TimeTravelDebugger debugger(std::move(instrSet), std::move(memory), std::move(registerBank), checkpointInterval);
+        debugger.setCycleLimit(maxCycles);
+        debugger.setLivelockDetection(detectLivelock);
+        runTimeTravel(debugger, reader);
+        return 0;
+    }
+
+    // Stop at breakpoints and watchpoints, if asked; the simulator itself pays nothing for them
+    if (stops) {
+
+        const RegisterBank * registers = registerBank.get();
+        const Memory * simulatorMemory = memory.get();
+        Simulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+        simulator.setMultiplyDivideConfig(mduConfig);
+        simulator.setCycleLimit(maxCycles);
+        simulator.setLivelockDetection(detectLivelock);
+        if (timer != nullptr) timer->setClock(&simulator.getStats().dwClockCycles);
+
+        for (const auto& breakpoint : breakpoints) {
+            Memory::addr_t addr = 0;
+            if (!parseAddress(breakpoint, reader, addr)) {
+                spdlog::critical("Unable to find breakpoint label or address '{}'", breakpoint);
+                exit(1);
+            }
+            if (!simulator.addBreakpoint(addr)) exit(1);
+        }
+
+        // Watches a word unless told how many bytes (e.g. buffer:1)
+        for (const auto& watchpoint : watchpoints) {
+            std::vector<std::string> parts = StringUtils::split(watchpoint.first, ':');
+            Memory::addr_t addr = 0;
+            if (parts.empty() || parts.size() > 2 || !parseAddress(parts[0], reader, addr)) {
+                spdlog::critical("Unable to find watchpoint label or address '{}'", watchpoint.first);
+                exit(1);
+            }
+            dword_t size = sizeof(word_t);
+            if (parts.size() == 2 && !parseCount(parts[1], size)) {
+                spdlog::critical("Invalid watchpoint size '{}'", parts[1]);
+                exit(1);
+            }
+            if (!simulator.addWatchpoint(addr, static_cast<size_t>(size), watchpoint.second)) exit(1);
+        }
+
+        runToStops(simulator, *registers, *simulatorMemory);
+        return reportStop(simulator.getStop());
+    }
+
     // Now create our simulator
-    Simulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+    // Production runs use the uninstrumented simulator; only debugging, tracing or
+    // profiling pays for instrumentation
+    if (!debug && traceFile.empty() && profileFile.empty()) {
+        Simulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+        simulator.setMultiplyDivideConfig(mduConfig);
+        simulator.setCycleLimit(maxCycles);
+        simulator.setLivelockDetection(detectLivelock);
+        if (timer != nullptr) timer->setClock(&simulator.getStats().dwClockCycles);
+        simulator.run();
+        return reportStop(simulator.getStop());
+    }
+
+    size_t textSize = memory->getTextSize();
+    InstrumentedSimulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+    simulator.setMultiplyDivideConfig(mduConfig);
+    simulator.setCycleLimit(maxCycles);
+    simulator.setLivelockDetection(detectLivelock);
+    if (timer != nullptr) timer->setClock(&simulator.getStats().dwClockCycles);
+
+    // Set up our pipeline trace, if we want one
+    if (!traceFile.empty()) {
+
+        std::unique_ptr<PipelineTracer> tracer;
+        if (traceFormat == "konata")
+            tracer.reset(new KonataTracer(traceStart, traceCycles));
+        else
+            tracer.reset(new ChromeTracer(traceStart, traceCycles));
+
+        if (!tracer->open(traceFile)) exit(1);
+        simulator.getInstrumentation().setTracer(std::move(tracer));
+    }
+
+    // Set up our profiler, if we want one
+    if (!profileFile.empty()) {
+
+        std::unique_ptr<PipelineProfiler> profiler(new PipelineProfiler(static_cast<PipelineStage>(stageIndex), textSize));
+        profiler->setSymbols(reader.getSymbols());
+        simulator.getInstrumentation().setProfiler(std::move(profiler));
+    }
+
     simulator.run();
 
-    return 0;
+    // Write out our profile
+    const PipelineProfiler * profiler = simulator.getInstrumentation().getProfiler();
+    if (profiler != nullptr) {
+
+        std::ofstream file(profileFile);
+        if (!file.is_open()) {
+            spdlog::error("Unable to write profile to {}", profileFile);
+            exit(1);
+        }
+
+        profiler->writeFolded(file);
+
+        std::cout << std::endl;
+        profiler->writeTable(std::cout, profileTop);
+    }
+
+    return reportStop(simulator.getStop());
 }
\ No newline at end of file
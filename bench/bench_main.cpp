@@ -0,0 +1,367 @@
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/functions.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_encoder.hpp"
+#include "instr/instruction_parser.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "instr/opcodes.hpp"
+#include "memory/memory.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/workload_generator.hpp"
+
+#include "decoupled_simulator.hpp"
+#include "simulator.hpp"
+#include "types.hpp"
+
+#include "benchmark.hpp"
+
+// MARK: -- Static Variables
+
+// A sample line for every parser we benchmark
+static const std::vector<std::pair<std::string, std::string>> sm_vecParserSamples = {
+    { "add", "add $t0, $t1, $t2" },
+    { "sll", "sll $t0, $t1, 4" },
+    { "slt", "slt $t0, $t1, $t2" },
+    { "syscall", "syscall" },
+    { "addi", "addi $t0, $t1, -42" },
+    { "beq", "beq $t0, $t1, label" },
+    { "bne", "bne $t0, $t1, label" },
+    { "lb", "lb $t0, 4($t1)" },
+    { "lw", "lw $t0, 4($t1)" },
+    { "sw", "sw $t0, -8($t1)" },
+    { "lui", "lui $t0, 0x1234" },
+    { "ori", "ori $t0, $t1, 0xFF" },
+    { "b", "b label" },
+    { "beqz", "beqz $t0, label" },
+    { "bge", "bge $t0, $t1, label" },
+    { "la", "la $t0, label" },
+    { "li", "li $t0, 1234" },
+    { "nop", "nop" },
+    { "subi", "subi $t0, $t1, 1" }
+};
+
+// The end-to-end programs and the console input they are fed
+static const std::vector<std::pair<std::string, std::string>> sm_vecPrograms = {
+    { "lab3a.s", "" },
+    { "lab3b.s", "racecar" },
+    { "lab3c.s", "" }
+};
+
+
+// MARK: -- Benchmark Methods
+
+/**
+ * Benchmarks encoding and decoding.
+ * @param bench The harness
+ */
+void benchEncoder(Benchmark& bench) {
+
+    Instruction instr;
+    instr.setType(InstructionType::R_FORMAT);
+    instr.setOpcode(static_cast<word_t>(Opcodes::OPCODE_R_TYPE));
+    instr.setFunct(static_cast<word_t>(Functions::FUNCT_ADD));
+    instr.setRd(8);
+    instr.setRs(9);
+    instr.setRt(10);
+
+    Instruction::instr_t encoded = InstructionEncoder::encode(instr);
+
+    bench.run("InstructionEncoder::encode", 100000, [&instr](size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            Benchmark::keep(InstructionEncoder::encode(instr));
+    });
+
+    bench.run("InstructionEncoder::decode", 100000, [encoded](size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            Benchmark::keep(InstructionEncoder::decode(encoded, InstructionType::R_FORMAT).getRd());
+    });
+}
+
+/**
+ * Benchmarks handler lookups.
+ * @param bench The harness
+ * @param instrSet The instruction set
+ */
+void benchInstructionSet(Benchmark& bench, const InstructionSet& instrSet) {
+
+    bench.run("InstructionSet::getInstructionHandler", 100000, [&instrSet](size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            Benchmark::keep(instrSet.getInstructionHandler(static_cast<word_t>(Opcodes::OPCODE_R_TYPE), (i & 1) ? 0 : 32) != nullptr);
+    });
+}
+
+/**
+ * Benchmarks memory and register access.
+ * @param bench The harness
+ */
+void benchStorage(Benchmark& bench) {
+
+    Memory memory(0x10000, 0x10000);
+    const word_t mask = 0xFFFC;
+
+    bench.run("Memory::readWord", 100000, [&memory, mask](size_t n) {
+        word_t word, sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            memory.readWord(Memory::MEM_USER_START + ((i * 4) & mask), word);
+            sum += word;
+        }
+        Benchmark::keep(sum);
+    });
+
+    bench.run("Memory::writeWord", 100000, [&memory, mask](size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            memory.writeWord(Memory::MEM_USER_START + ((i * 4) & mask), static_cast<word_t>(i));
+    });
+
+    RegisterBank registerBank;
+    bench.run("RegisterBank::readRegister", 100000, [&registerBank](size_t n) {
+        word_t value, sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            registerBank.readRegister(i & 31, value);
+            sum += value;
+        }
+        Benchmark::keep(sum);
+    });
+}
+
+/**
+ * Benchmarks every parser.
+ * @param bench The harness
+ * @param instrSet The instruction set
+ */
+void benchParsers(Benchmark& bench, const InstructionSet& instrSet) {
+
+    for (const auto& sample : sm_vecParserSamples) {
+
+        InstructionParser * parser = instrSet.getInstructionParser(sample.first);
+        if (parser == nullptr) {
+            std::cerr << "warning: no parser registered for '" << sample.first << "'" << std::endl;
+            continue;
+        }
+
+        // Skip (rather than abort on) samples the parser rejects
+        const std::string& line = sample.second;
+        try {
+            parser->parse(line);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "warning: parser for '" << sample.first << "' rejected its sample line" << std::endl;
+            continue;
+        }
+
+        bench.run("parse/" + sample.first, 10, [parser, &line](size_t n) {
+            for (size_t i = 0; i < n; ++i)
+                Benchmark::keep(static_cast<word_t>(parser->parse(line).size()));
+        });
+    }
+}
+
+/**
+ * Loads a program into memory, exiting if it cannot be loaded.
+ * @param filename The program
+ * @return The loaded memory image
+ */
+std::unique_ptr<Memory> loadProgram(const std::string& filename) {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    std::unique_ptr<Memory> memory(new Memory(0x1000, 0x1000));
+
+    FileReader reader;
+    if (!reader.readFile(filename, *instrSet.get(), *memory.get())) {
+        std::cerr << "error: unable to load " << filename << std::endl;
+        exit(1);
+    }
+
+    return memory;
+}
+
+/**
+ * Benchmarks whole simulator runs of a loaded program.
+ * @param bench The harness
+ * @param name The benchmark name
+ * @param image The loaded program
+ * @param input The console input to feed the program
+ */
+template <typename SimulatorType>
+void benchRun(Benchmark& bench, const std::string& name, const Memory& image, const std::string& input) {
+
+    // Setting up is untimed - only the run itself is measured
+    std::unique_ptr<SimulatorType> simulator;
+    auto setup = [&simulator, &image, &input]() {
+
+        std::unique_ptr<SyscallHandler> syscallHandler(new SyscallHandler());
+        syscallHandler->getInputFeed().setFallback(nullptr);
+        syscallHandler->getInputFeed().queueInput(input);
+
+        std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault(std::move(syscallHandler));
+        std::unique_ptr<Memory> memory(new Memory(image));
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+        simulator = std::unique_ptr<SimulatorType>(new SimulatorType(std::move(instrSet), std::move(memory), std::move(registerBank)));
+    };
+
+    bench.run(name, 1, [&simulator](size_t n) {
+        simulator->run();
+    }, setup);
+}
+
+/**
+ * Benchmarks the cycle loop of a program, timed per simulated cycle (so the cost
+ * of a single cycle can be compared across changes to the stages).
+ * @param bench The harness
+ * @param name The benchmark name
+ * @param image The loaded program
+ */
+void benchCycles(Benchmark& bench, const std::string& name, const Memory& image) {
+
+    std::unique_ptr<Simulator> simulator;
+    auto setup = [&simulator, &image]() {
+
+        std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+        std::unique_ptr<Memory> memory(new Memory(image));
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+        simulator = std::unique_ptr<Simulator>(new Simulator(std::move(instrSet), std::move(memory), std::move(registerBank)));
+    };
+
+    // Counts the cycles with an untimed run first
+    setup();
+    while (simulator->step()) { }
+    size_t cycles = simulator->getStats().dwClockCycles;
+
+    bench.run(name, cycles, [&simulator](size_t n) {
+        while (simulator->step()) { }
+    }, setup);
+}
+
+/**
+ * Benchmarks a decoupled run of a program.
+ * @param bench The harness
+ * @param name The benchmark name
+ * @param image The loaded program
+ * @param parallel Whether the front and back ends run on their own threads
+ */
+void benchDecoupled(Benchmark& bench, const std::string& name, const Memory& image, bool parallel) {
+
+    std::unique_ptr<DecoupledSimulator> simulator;
+    auto setup = [&simulator, &image, parallel]() {
+
+        std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+        std::shared_ptr<Memory> memory(new Memory(image));
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+        simulator = std::unique_ptr<DecoupledSimulator>(new DecoupledSimulator(std::move(instrSet), memory, std::move(registerBank)));
+        simulator->setParallel(parallel);
+    };
+
+    bench.run(name, 1, [&simulator](size_t n) {
+        simulator->run();
+    }, setup);
+}
+
+/**
+ * Benchmarks whole simulator runs, with and without instrumentation.
+ * @param bench The harness
+ * @param directory The directory containing the programs
+ */
+void benchPrograms(Benchmark& bench, const std::string& directory) {
+
+    for (const auto& program : sm_vecPrograms) {
+
+        std::unique_ptr<Memory> image = loadProgram(directory + "/" + program.first);
+        benchRun<Simulator>(bench, "Simulator::run/" + program.first, *image.get(), program.second);
+        benchRun<InstrumentedSimulator>(bench, "InstrumentedSimulator::run/" + program.first, *image.get(), program.second);
+    }
+
+    // The lab programs are short, so also run a generated one long enough for the
+    // loop itself to dominate
+    WorkloadGenerator::Options options;
+    options.szInstructions = 1000;
+    options.szNesting = 2;
+    options.szIterations = 16;
+
+    std::string filename = "pipesim_bench_workload.s";
+    {
+        std::ofstream file(filename);
+        WorkloadGenerator(options).generate(file);
+    }
+
+    std::unique_ptr<Memory> image = loadProgram(filename);
+    std::remove(filename.c_str());
+
+    benchRun<Simulator>(bench, "Simulator::run/workload", *image.get(), "");
+    benchRun<InstrumentedSimulator>(bench, "InstrumentedSimulator::run/workload", *image.get(), "");
+    benchCycles(bench, "Simulator::step/workload (per cycle)", *image.get());
+    benchDecoupled(bench, "DecoupledSimulator::run/workload (sequential)", *image.get(), false);
+    benchDecoupled(bench, "DecoupledSimulator::run/workload (parallel)", *image.get(), true);
+}
+
+
+// MARK: -- Entry Methods
+
+/**
+ * The entry point to the benchmarks.
+ * @param argc The arguments count
+ * @param argv The arguments list
+ */
+int main(int argc, char ** argv) {
+
+    //
+    // Usage: ./pipeSimBench [--warmup <n>] [--reps <n>] [--programs <dir>] [--output <file.json>]
+    //
+    size_t warmup = 5;
+    size_t reps = 50;
+    std::string programs = "app";
+    std::string output = "pipesim_bench.json";
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string flag = argv[i];
+        if (flag == "--warmup" && i + 1 < argc)
+            warmup = std::stoul(argv[++i]);
+        else if (flag == "--reps" && i + 1 < argc)
+            reps = std::stoul(argv[++i]);
+        else if (flag == "--programs" && i + 1 < argc)
+            programs = argv[++i];
+        else if (flag == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else {
+            std::cerr << "usage: ./pipeSimBench [--warmup <n>] [--reps <n>] [--programs <dir>] [--output <file.json>]" << std::endl;
+            exit(1);
+        }
+    }
+
+    // Keep the simulator quiet while we measure it
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+
+    Benchmark bench(warmup, reps);
+    benchEncoder(bench);
+    benchInstructionSet(bench, *instrSet.get());
+    benchStorage(bench);
+    benchParsers(bench, *instrSet.get());
+    benchPrograms(bench, programs);
+
+    bench.writeTable(std::cout);
+
+    std::ofstream file(output);
+    if (!file.is_open()) {
+        std::cerr << "error: unable to write results to " << output << std::endl;
+        exit(1);
+    }
+
+    bench.writeJson(file);
+    std::cout << "\nResults written to " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+// MARK: -- Static Variables
+
+// A sink for values we want to keep alive
+static volatile word_t sm_wSink = 0;
+
+
+// MARK: -- Construction
+
+// Constructor
+Benchmark::Benchmark(size_t warmup, size_t repetitions)
+: m_szWarmup(warmup)
+, m_szRepetitions(std::max<size_t>(repetitions, 1))
+{ }
+
+
+// MARK: -- Run Methods
+
+// Runs a benchmark
+const Benchmark::Result& Benchmark::run(const std::string& name, size_t batch, const body_fn_t& body, const setup_fn_t& setup) {
+
+    batch = std::max<size_t>(batch, 1);
+    std::cerr << "running " << name << "..." << std::endl;
+
+    // Warm up first
+    for (size_t i = 0; i < this->m_szWarmup; ++i) {
+        if (setup) setup();
+        body(batch);
+    }
+
+    // Now time each repetition
+    std::vector<double> samples;
+    samples.reserve(this->m_szRepetitions);
+    for (size_t i = 0; i < this->m_szRepetitions; ++i) {
+
+        if (setup) setup();
+
+        auto start = std::chrono::steady_clock::now();
+        body(batch);
+        auto end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        samples.push_back(ns / batch);
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    // Nearest-rank percentiles
+    auto percentile = [&samples](double p) {
+        size_t rank = static_cast<size_t>(p * samples.size() + 0.999999);
+        return samples[std::min(std::max<size_t>(rank, 1), samples.size()) - 1];
+    };
+
+    Result result;
+    result.strName = name;
+    result.szWarmup = this->m_szWarmup;
+    result.szRepetitions = this->m_szRepetitions;
+    result.szBatch = batch;
+    result.dMean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    result.dP50 = percentile(0.50);
+    result.dP99 = percentile(0.99);
+    result.dMin = samples.front();
+    result.dMax = samples.back();
+
+    this->m_vecResults.push_back(result);
+    return this->m_vecResults.back();
+}
+
+// Returns the results
+const std::vector<Benchmark::Result>& Benchmark::getResults() const {
+    return this->m_vecResults;
+}
+
+
+// MARK: -- Output Methods
+
+// Writes a table
+void Benchmark::writeTable(std::ostream& stream) const {
+
+    stream << std::left << std::setw(48) << "benchmark"
+           << std::right << std::setw(12) << "mean (ns)"
+           << std::setw(12) << "p50 (ns)"
+           << std::setw(12) << "p99 (ns)" << "\n";
+
+    stream << std::fixed << std::setprecision(2);
+    for (const Result& result : this->m_vecResults) {
+        stream << std::left << std::setw(48) << result.strName
+               << std::right << std::setw(12) << result.dMean
+               << std::setw(12) << result.dP50
+               << std::setw(12) << result.dP99 << "\n";
+    }
+}
+
+// Writes JSON
+void Benchmark::writeJson(std::ostream& stream) const {
+
+    stream << "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n";
+    stream << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < this->m_vecResults.size(); ++i) {
+
+        const Result& result = this->m_vecResults[i];
+        stream << "    { \"name\": \"" << result.strName << "\""
+               << ", \"warmup\": " << result.szWarmup
+               << ", \"repetitions\": " << result.szRepetitions
+               << ", \"batch\": " << result.szBatch
+               << ", \"mean\": " << result.dMean
+               << ", \"p50\": " << result.dP50
+               << ", \"p99\": " << result.dP99
+               << ", \"min\": " << result.dMin
+               << ", \"max\": " << result.dMax << " }"
+               << ((i + 1 < this->m_vecResults.size()) ? ",\n" : "\n");
+    }
+    stream << "  ]\n}\n";
+}
+
+
+// MARK: -- Static Helpers
+
+// Keeps a value alive
+void Benchmark::keep(word_t value) {
+    sm_wSink = value;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+/**
+ * A small benchmark harness.
+ * 
+ * Each benchmark body is run for a number of warm-up repetitions (discarded)
+ * followed by the measured repetitions. A repetition times a batch of
+ * operations and records the mean time per operation, and the statistics are
+ * taken over the repetitions.
+ */
+class Benchmark {
+public:
+
+    // MARK: -- Public Types
+
+    /** The body of a benchmark. Runs the given number of operations. */
+    using body_fn_t = std::function<void(size_t)>;
+
+    /** Untimed setup run before every repetition. */
+    using setup_fn_t = std::function<void()>;
+
+    /** The results of a single benchmark (times are nanoseconds per operation). */
+    struct Result {
+
+        /** The benchmark name. */
+        std::string strName;
+
+        /** The number of warm-up repetitions. */
+        size_t szWarmup;
+
+        /** The number of measured repetitions. */
+        size_t szRepetitions;
+
+        /** The number of operations per repetition. */
+        size_t szBatch;
+
+        /** The mean time per operation. */
+        double dMean;
+
+        /** The median time per operation. */
+        double dP50;
+
+        /** The 99th percentile time per operation. */
+        double dP99;
+
+        /** The fastest repetition. */
+        double dMin;
+
+        /** The slowest repetition. */
+        double dMax;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param warmup The number of warm-up repetitions
+     * @param repetitions The number of measured repetitions
+     */
+    Benchmark(size_t warmup, size_t repetitions);
+    ~Benchmark() = default;
+
+
+    // MARK: -- Run Methods
+
+    /**
+     * Runs a benchmark and keeps its result.
+     * @param name The benchmark name
+     * @param batch The number of operations per repetition
+     * @param body The body
+     * @param setup Setup to run (untimed) before every repetition
+     * @return The result
+     */
+    const Result& run(const std::string& name, size_t batch, const body_fn_t& body, const setup_fn_t& setup = nullptr);
+
+    /**
+     * Returns every result so far.
+     * @return The results
+     */
+    const std::vector<Result>& getResults() const;
+
+
+    // MARK: -- Output Methods
+
+    /**
+     * Writes the results as a human-readable table.
+     * @param stream The stream
+     */
+    void writeTable(std::ostream& stream) const;
+
+    /**
+     * Writes the results as JSON.
+     * @param stream The stream
+     */
+    void writeJson(std::ostream& stream) const;
+
+
+    // MARK: -- Static Helpers
+
+    /**
+     * Prevents the compiler from optimising away a value.
+     * @param value The value
+     */
+    static void keep(word_t value);
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The number of warm-up repetitions. */
+    size_t m_szWarmup;
+
+    /** The number of measured repetitions. */
+    size_t m_szRepetitions;
+
+    /** The results so far. */
+    std::vector<Result> m_vecResults;
+};
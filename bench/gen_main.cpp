@@ -0,0 +1,53 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "utils/workload_generator.hpp"
+
+#include "workload_flags.hpp"
+
+// MARK: -- Entry Methods
+
+/**
+ * The entry point to the workload generator.
+ * @param argc The arguments count
+ * @param argv The arguments list
+ */
+int main(int argc, char ** argv) {
+
+    //
+    // Usage: ./pipeSimGen [-o <file.s>] <workload flags>
+    //
+    const std::string usage = std::string("usage: ./pipeSimGen [-o <file.s>] ") + WorkloadFlags::USAGE;
+    WorkloadGenerator::Options options;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string flag = argv[i];
+        if ((flag == "-o" || flag == "--output") && i + 1 < argc)
+            output = argv[++i];
+        else if (i + 1 >= argc || !WorkloadFlags::apply(flag, argv[++i], options)) {
+            std::cerr << usage << std::endl;
+            exit(1);
+        }
+    }
+
+    // Write to the file if we have one, or to stdout otherwise
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output, std::ios_base::out | std::ios_base::trunc);
+        if (!file.is_open()) {
+            std::cerr << "error: unable to open " << output << " for writing" << std::endl;
+            exit(1);
+        }
+    }
+
+    WorkloadGenerator generator(options);
+    WorkloadGenerator::Summary summary = generator.generate(output.empty() ? std::cout : file);
+
+    std::cerr << "generated " << summary.szInstructions << " statements in " << summary.szBlocks << " blocks ("
+              << summary.szLines << " lines, " << summary.szBytes << " bytes)" << std::endl;
+    return 0;
+}
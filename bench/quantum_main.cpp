@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "reader/file_reader.hpp"
+#include "utils/string_utils.hpp"
+
+#include "multicore_system.hpp"
+#include "types.hpp"
+
+#include "workload_flags.hpp"
+
+// MARK: -- Types
+
+/** A single point of the quantum report (times are the best over all repetitions). */
+struct QuantumPoint {
+
+    /** The number of cycles between synchronisations (0 for lockstep). */
+    dword_t dwQuantum;
+
+    /** The number of global clock cycles the guest ran for. */
+    dword_t dwClockCycles;
+
+    /** The error in clock cycles against lockstep, as a percentage. */
+    double dError;
+
+    /** Whether or not every core finished every round. */
+    bool bCorrect;
+
+    /** The time to run with every core on one host thread, in seconds. */
+    double dSequentialTime;
+
+    /** The time to run with every core on its own host thread, in seconds. */
+    double dParallelTime;
+};
+
+
+// MARK: -- Helper Methods
+
+/**
+ * Returns the number of seconds since a point in time.
+ * @param start The point in time
+ * @return The number of seconds
+ */
+static double secondsSince(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Writes the kernel every core runs: a work loop, then a software barrier where each
+ * core publishes its round in its own flag and spins until every flag has caught up.
+ * @param stream The stream to write to
+ * @param cores The number of cores
+ * @param rounds The number of rounds (at most 255, as flags are bytes)
+ * @param work The number of work loop iterations per round
+ */
+static void writeKernel(std::ostream& stream, size_t cores, size_t rounds, size_t work) {
+
+    stream << ".text\n"
+           << "main:\n"
+           << "    li      $2, 60\n"
+           << "    syscall\n"
+           << "    la      $17, flags\n"
+           << "    add     $18, $17, $2\n"
+           << "    li      $19, 0\n"
+           << "    li      $20, " << cores << "\n"
+           << "    li      $21, " << rounds << "\n"
+           << "round:\n"
+           << "    li      $8, " << work << "\n"
+           << "work:\n"
+           << "    subi    $8, $8, 1\n"
+           << "    add     $9, $9, $8\n"
+           << "    bne     $8, $0, work\n"
+           << "    nop\n"
+           << "    addi    $19, $19, 1\n"
+           << "    sb      $19, 0($18)\n"
+           << "    li      $10, 0\n"
+           << "check:\n"
+           << "    add     $11, $17, $10\n"
+           << "spin:\n"
+           << "    lb      $12, 0($11)\n"
+           << "    slt     $13, $12, $19\n"
+           << "    bne     $13, $0, spin\n"
+           << "    nop\n"
+           << "    addi    $10, $10, 1\n"
+           << "    slt     $13, $10, $20\n"
+           << "    bne     $13, $0, check\n"
+           << "    nop\n"
+           << "    bne     $19, $21, round\n"
+           << "    nop\n"
+           << "    li      $2, 10\n"
+           << "    syscall\n"
+           << ".data\n"
+           << "flags: .space " << cores << "\n";
+}
+
+/**
+ * Runs the kernel once.
+ * @param filename The kernel
+ * @param cores The number of cores
+ * @param rounds The number of rounds
+ * @param quantum The quantum
+ * @param parallel Whether or not to use one host thread per core
+ * @param cycles A placeholder for the number of global cycles
+ * @param correct A placeholder for whether every core finished every round
+ * @return The time taken to run, in seconds (negative if the kernel could not be loaded)
+ */
+static double runOnce(const std::string& filename, size_t cores, size_t rounds, dword_t quantum, bool parallel,
+                      dword_t& cycles, bool& correct) {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    std::shared_ptr<Memory> memory(new Memory(0x1000, 0x1000));
+
+    FileReader reader;
+    if (!reader.readFile(filename, *instrSet.get(), *memory.get()))
+        return -1.0;
+
+    MulticoreSystem system(memory, quantum);
+    system.setParallel(parallel);
+    for (size_t core = 0; core < cores; ++core)
+        system.addCore(reader.getSymbols().at("main"));
+
+    auto start = std::chrono::steady_clock::now();
+    system.run();
+    double runTime = secondsSince(start);
+
+    cycles = system.getClockCycles();
+    correct = true;
+    for (size_t core = 0; core < cores; ++core) {
+        byte_t flag = 0;
+        memory->readByte(reader.getSymbols().at("flags") + core, flag);
+        correct &= (flag == rounds);
+    }
+
+    return runTime;
+}
+
+/**
+ * Writes the report as a table.
+ * @param stream The stream to write to
+ * @param points The points
+ */
+static void writeTable(std::ostream& stream, const std::vector<QuantumPoint>& points) {
+
+    stream << std::right << std::setw(10) << "quantum"
+           << std::setw(14) << "cycles"
+           << std::setw(10) << "error %"
+           << std::setw(10) << "correct"
+           << std::setw(12) << "seq (s)"
+           << std::setw(12) << "par (s)"
+           << std::setw(10) << "speedup" << "\n";
+
+    stream << std::fixed;
+    for (const QuantumPoint& point : points) {
+        stream << std::setw(10) << point.dwQuantum
+               << std::setw(14) << point.dwClockCycles
+               << std::setprecision(2) << std::setw(10) << point.dError
+               << std::setw(10) << (point.bCorrect ? "yes" : "no")
+               << std::setprecision(4) << std::setw(12) << point.dSequentialTime
+               << std::setw(12) << point.dParallelTime
+               << std::setprecision(2) << std::setw(10) << (point.dSequentialTime / point.dParallelTime) << "\n";
+    }
+}
+
+/**
+ * Writes the report as JSON.
+ * @param stream The stream to write to
+ * @param cores The number of cores
+ * @param rounds The number of rounds
+ * @param work The number of work loop iterations per round
+ * @param points The points
+ */
+static void writeJson(std::ostream& stream, size_t cores, size_t rounds, size_t work, const std::vector<QuantumPoint>& points) {
+
+    stream << "{\n  \"kernel\": { \"cores\": " << cores
+           << ", \"rounds\": " << rounds
+           << ", \"work\": " << work
+           << ", \"host_threads\": " << std::thread::hardware_concurrency() << " },\n  \"quanta\": [\n";
+
+    stream << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < points.size(); ++i) {
+
+        const QuantumPoint& point = points[i];
+        stream << "    { \"quantum\": " << point.dwQuantum
+               << ", \"cycles\": " << point.dwClockCycles
+               << ", \"error_percent\": " << point.dError
+               << ", \"correct\": " << (point.bCorrect ? "true" : "false")
+               << ", \"sequential_seconds\": " << point.dSequentialTime
+               << ", \"parallel_seconds\": " << point.dParallelTime
+               << ", \"speedup\": " << (point.dSequentialTime / point.dParallelTime) << " }"
+               << ((i + 1 < points.size()) ? ",\n" : "\n");
+    }
+    stream << "  ]\n}\n";
+}
+
+
+// MARK: -- Entry Methods
+
+/**
+ * The entry point to the quantum report.
+ * @param argc The arguments count
+ * @param argv The arguments list
+ */
+int main(int argc, char ** argv) {
+
+    //
+    // Usage: ./pipeSimQuantum [--cores <n>] [--rounds <n>] [--work <n>] [--quanta <n>[,<n>...]]
+    //                         [--reps <n>] [--workdir <dir>] [--output <file.json>]
+    //
+    const std::string usage = "usage: ./pipeSimQuantum [--cores <n>] [--rounds <n>] [--work <n>] [--quanta <n>[,<n>...]] "
+                              "[--reps <n>] [--workdir <dir>] [--output <file.json>]";
+
+    size_t cores = 4;
+    size_t rounds = 20;
+    size_t work = 2000;
+    std::vector<std::string> quanta = { "1", "10", "100", "1000", "10000" };
+    size_t reps = 3;
+    std::string workdir = ".";
+    std::string output = "pipesim_quantum.json";
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string flag = argv[i];
+        bool valid = true;
+        if (i + 1 >= argc)
+            valid = false;
+        else if (flag == "--cores")
+            valid = WorkloadFlags::parseSize(argv[++i], cores) && cores > 0 && cores <= 64;
+        else if (flag == "--rounds")
+            valid = WorkloadFlags::parseSize(argv[++i], rounds) && rounds > 0 && rounds <= 255;
+        else if (flag == "--work")
+            valid = WorkloadFlags::parseSize(argv[++i], work) && work > 0 && work <= 0x7FFF;
+        else if (flag == "--quanta")
+            quanta = StringUtils::split(argv[++i], ',');
+        else if (flag == "--reps")
+            valid = WorkloadFlags::parseSize(argv[++i], reps) && reps > 0;
+        else if (flag == "--workdir")
+            workdir = argv[++i];
+        else if (flag == "--output")
+            output = argv[++i];
+        else
+            valid = false;
+
+        if (!valid) {
+            std::cerr << usage << std::endl;
+            exit(1);
+        }
+    }
+
+    // Keep the simulator quiet while we measure it
+    spdlog::set_level(spdlog::level::off);
+
+    std::string filename = workdir + "/pipesim_quantum.s";
+    {
+        std::ofstream file(filename, std::ios_base::out | std::ios_base::trunc);
+        if (!file.is_open()) {
+            std::cerr << "error: unable to write kernel to " << filename << std::endl;
+            exit(1);
+        }
+        writeKernel(file, cores, rounds, work);
+    }
+
+    // Lockstep is the reference every quantum is measured against
+    std::vector<dword_t> sweep = { 0 };
+    for (const std::string& quantum : quanta) {
+        size_t value = 0;
+        if (!WorkloadFlags::parseSize(quantum, value) || value == 0) {
+            std::cerr << usage << std::endl;
+            exit(1);
+        }
+        sweep.push_back(value);
+    }
+
+    std::vector<QuantumPoint> points;
+    for (dword_t quantum : sweep) {
+
+        std::cerr << "measuring quantum " << quantum << "..." << std::endl;
+
+        QuantumPoint point;
+        point.dwQuantum = quantum;
+        point.bCorrect = true;
+        point.dSequentialTime = 0.0;
+        point.dParallelTime = 0.0;
+        for (size_t rep = 0; rep < reps; ++rep) {
+
+            bool correct = false;
+            dword_t parallelCycles = 0;
+            double sequentialTime = runOnce(filename, cores, rounds, quantum, false, point.dwClockCycles, point.bCorrect);
+            double parallelTime = runOnce(filename, cores, rounds, quantum, true, parallelCycles, correct);
+            if (sequentialTime < 0.0 || parallelTime < 0.0) {
+                std::cerr << "error: unable to load kernel " << filename << std::endl;
+                exit(1);
+            }
+
+            // A quantum gives the same run on threads as in order, so anything else is a bug
+            if (parallelCycles != point.dwClockCycles || correct != point.bCorrect) {
+                std::cerr << "error: parallel run of quantum " << quantum << " diverged from the sequential run" << std::endl;
+                exit(1);
+            }
+
+            point.dSequentialTime = (rep == 0) ? sequentialTime : std::min(point.dSequentialTime, sequentialTime);
+            point.dParallelTime = (rep == 0) ? parallelTime : std::min(point.dParallelTime, parallelTime);
+        }
+
+        dword_t reference = points.empty() ? point.dwClockCycles : points.front().dwClockCycles;
+        point.dError = 100.0 * std::fabs(static_cast<double>(point.dwClockCycles) - reference) / reference;
+        points.push_back(point);
+    }
+
+    std::remove(filename.c_str());
+
+    writeTable(std::cout, points);
+
+    std::ofstream file(output);
+    if (!file.is_open()) {
+        std::cerr << "error: unable to write results to " << output << std::endl;
+        exit(1);
+    }
+
+    writeJson(file, cores, rounds, work, points);
+    std::cout << "\nResults written to " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/workload_generator.hpp"
+
+#include "simulator.hpp"
+#include "types.hpp"
+
+#include "workload_flags.hpp"
+
+// MARK: -- Types
+
+/** A single point of the scaling report (times are the best over all repetitions). */
+struct ScalePoint {
+
+    /** The size of the program source in bytes. */
+    size_t szBytes;
+
+    /** The number of statements in the program. */
+    size_t szStatements;
+
+    /** The size of the loaded text segment in bytes. */
+    size_t szTextSize;
+
+    /** The size of the loaded data segment in bytes. */
+    size_t szDataSize;
+
+    /** The time to assemble and load the program, in seconds. */
+    double dLoadTime;
+
+    /** The number of guest instructions run. */
+    dword_t dwInstructions;
+
+    /** The number of clock cycles run. */
+    dword_t dwClockCycles;
+
+    /** The time to run the program, in seconds. */
+    double dRunTime;
+};
+
+
+// MARK: -- Helper Methods
+
+/**
+ * Returns the number of seconds since a point in time.
+ * @param start The point in time
+ * @return The number of seconds
+ */
+static double secondsSince(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Measures a single generated program.
+ * @param filename The program
+ * @param reps The number of repetitions
+ * @param point The point to fill in
+ * @return Whether or not the program could be loaded
+ */
+static bool measure(const std::string& filename, size_t reps, ScalePoint& point) {
+
+    point.dLoadTime = 0.0;
+    point.dRunTime = 0.0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+
+        // Everything is rebuilt each time, since the simulator takes ownership of it
+        std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+        std::unique_ptr<Memory> memory(new Memory(0x1000, 0x1000));
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+
+        auto start = std::chrono::steady_clock::now();
+        FileReader reader;
+        if (!reader.readFile(filename, *instrSet.get(), *memory.get()))
+            return false;
+
+        double loadTime = secondsSince(start);
+        point.szTextSize = memory->getTextSize();
+        point.szDataSize = memory->getDataSize();
+
+        Simulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+        start = std::chrono::steady_clock::now();
+        simulator.run();
+        double runTime = secondsSince(start);
+
+        point.dwInstructions = simulator.getStats().dwInstructions;
+        point.dwClockCycles = simulator.getStats().dwClockCycles;
+        point.dLoadTime = (rep == 0) ? loadTime : std::min(point.dLoadTime, loadTime);
+        point.dRunTime = (rep == 0) ? runTime : std::min(point.dRunTime, runTime);
+    }
+
+    return true;
+}
+
+/**
+ * Writes the report as a table.
+ * @param stream The stream to write to
+ * @param points The points
+ */
+static void writeTable(std::ostream& stream, const std::vector<ScalePoint>& points) {
+
+    stream << std::right << std::setw(12) << "bytes"
+           << std::setw(12) << "statements"
+           << std::setw(12) << "load (s)"
+           << std::setw(12) << "asm MB/s"
+           << std::setw(14) << "asm stmt/s"
+           << std::setw(14) << "instructions"
+           << std::setw(12) << "run (s)"
+           << std::setw(12) << "guest MIPS" << "\n";
+
+    stream << std::fixed;
+    for (const ScalePoint& point : points) {
+        stream << std::setw(12) << point.szBytes
+               << std::setw(12) << point.szStatements
+               << std::setprecision(4) << std::setw(12) << point.dLoadTime
+               << std::setprecision(2) << std::setw(12) << (point.szBytes / point.dLoadTime / 1e6)
+               << std::setprecision(0) << std::setw(14) << (point.szStatements / point.dLoadTime)
+               << std::setw(14) << point.dwInstructions
+               << std::setprecision(4) << std::setw(12) << point.dRunTime
+               << std::setprecision(3) << std::setw(12) << (point.dwInstructions / point.dRunTime / 1e6) << "\n";
+    }
+}
+
+/**
+ * Writes the report as JSON.
+ * @param stream The stream to write to
+ * @param options The workload options used
+ * @param points The points
+ */
+static void writeJson(std::ostream& stream, const WorkloadGenerator::Options& options, const std::vector<ScalePoint>& points) {
+
+    stream << "{\n  \"workload\": { \"nesting\": " << options.szNesting
+           << ", \"iterations\": " << options.szIterations
+           << ", \"block\": " << options.szBlockSize
+           << ", \"branch_density\": " << options.dBranchDensity
+           << ", \"load_density\": " << options.dLoadDensity
+           << ", \"dep_distance\": " << options.szDependencyDistance
+           << ", \"data_size\": " << options.szDataSize
+           << ", \"seed\": " << options.wSeed << " },\n  \"scaling\": [\n";
+
+    stream << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < points.size(); ++i) {
+
+        const ScalePoint& point = points[i];
+        stream << "    { \"bytes\": " << point.szBytes
+               << ", \"statements\": " << point.szStatements
+               << ", \"text_size\": " << point.szTextSize
+               << ", \"data_size\": " << point.szDataSize
+               << ", \"load_seconds\": " << point.dLoadTime
+               << ", \"asm_mb_per_s\": " << (point.szBytes / point.dLoadTime / 1e6)
+               << ", \"instructions\": " << point.dwInstructions
+               << ", \"cycles\": " << point.dwClockCycles
+               << ", \"run_seconds\": " << point.dRunTime
+               << ", \"guest_mips\": " << (point.dwInstructions / point.dRunTime / 1e6) << " }"
+               << ((i + 1 < points.size()) ? ",\n" : "\n");
+    }
+    stream << "  ]\n}\n";
+}
+
+
+// MARK: -- Entry Methods
+
+/**
+ * The entry point to the scaling report.
+ * @param argc The arguments count
+ * @param argv The arguments list
+ */
+int main(int argc, char ** argv) {
+
+    //
+    // Usage: ./pipeSimScale [--min <bytes>] [--max <bytes>] [--factor <n>] [--reps <n>] [--workdir <dir>]
+    //                       [--output <file.json>] [--keep] <workload flags>
+    //
+    const std::string usage = std::string("usage: ./pipeSimScale [--min <bytes>] [--max <bytes>] [--factor <n>] [--reps <n>] ")
+        + "[--workdir <dir>] [--output <file.json>] [--keep] " + WorkloadFlags::USAGE;
+
+    size_t minBytes = 4 << 10;
+    size_t maxBytes = 64 << 10;
+    size_t factor = 4;
+    size_t reps = 3;
+    std::string workdir = ".";
+    std::string output = "pipesim_scale.json";
+    bool keep = false;
+    WorkloadGenerator::Options options;
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string flag = argv[i];
+        bool valid = true;
+        if (flag == "--keep")
+            keep = true;
+        else if (i + 1 >= argc)
+            valid = false;
+        else if (flag == "--min")
+            valid = WorkloadFlags::parseSize(argv[++i], minBytes);
+        else if (flag == "--max")
+            valid = WorkloadFlags::parseSize(argv[++i], maxBytes);
+        else if (flag == "--factor")
+            valid = WorkloadFlags::parseSize(argv[++i], factor) && factor > 1;
+        else if (flag == "--reps")
+            valid = WorkloadFlags::parseSize(argv[++i], reps) && reps > 0;
+        else if (flag == "--workdir")
+            workdir = argv[++i];
+        else if (flag == "--output")
+            output = argv[++i];
+        else
+            valid = WorkloadFlags::apply(flag, argv[++i], options);
+
+        if (!valid) {
+            std::cerr << usage << std::endl;
+            exit(1);
+        }
+    }
+
+    // Keep the simulator quiet while we measure it
+    spdlog::set_level(spdlog::level::off);
+
+    // Sweep the source size, so the points line up no matter the workload shape
+    std::vector<ScalePoint> points;
+    for (size_t bytes = std::max<size_t>(minBytes, 1); bytes <= maxBytes; bytes *= factor) {
+
+        options.szTargetBytes = bytes;
+        std::string filename = workdir + "/pipesim_scale_" + std::to_string(bytes) + ".s";
+
+        std::ofstream file(filename, std::ios_base::out | std::ios_base::trunc);
+        if (!file.is_open()) {
+            std::cerr << "error: unable to write workload to " << filename << std::endl;
+            exit(1);
+        }
+
+        WorkloadGenerator generator(options);
+        WorkloadGenerator::Summary summary = generator.generate(file);
+        file.close();
+
+        std::cerr << "measuring " << summary.szBytes << " bytes (" << summary.szInstructions << " statements)..." << std::endl;
+
+        ScalePoint point;
+        point.szBytes = summary.szBytes;
+        point.szStatements = summary.szInstructions;
+        if (!measure(filename, reps, point)) {
+            std::cerr << "error: unable to load generated workload " << filename << std::endl;
+            exit(1);
+        }
+
+        points.push_back(point);
+        if (!keep) std::remove(filename.c_str());
+    }
+
+    writeTable(std::cout, points);
+
+    std::ofstream file(output);
+    if (!file.is_open()) {
+        std::cerr << "error: unable to write results to " << output << std::endl;
+        exit(1);
+    }
+
+    writeJson(file, options, points);
+    std::cout << "\nResults written to " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "workload_flags.hpp"
+
+#include <cctype>
+#include <exception>
+
+// MARK: -- Constants
+const char * WorkloadFlags::USAGE =
+    "[--instructions <n>] [--size <bytes>] [--nesting <n>] [--iterations <n>] [--block <n>] "
+    "[--branch-density <f>] [--load-density <f>] [--dep-distance <n>] [--data-size <bytes>] [--seed <n>]";
+
+
+// MARK: -- Parse Methods
+
+// Parses a size
+bool WorkloadFlags::parseSize(const std::string& str, size_t& size) {
+
+    if (str.empty()) return false;
+
+    // Get our multiplier
+    size_t multiplier = 1;
+    std::string number = str;
+    char suffix = std::toupper(str.back());
+    if (suffix == 'K' || suffix == 'M' || suffix == 'G') {
+        multiplier = (suffix == 'K') ? (1 << 10) : (suffix == 'M') ? (1 << 20) : (1 << 30);
+        number = str.substr(0, str.length() - 1);
+    }
+
+    try {
+        size_t pos = 0;
+        unsigned long long value = std::stoull(number, &pos);
+        if (pos != number.length()) return false;
+
+        size = static_cast<size_t>(value) * multiplier;
+        return true;
+    }
+    catch (std::exception& e) {
+        return false;
+    }
+}
+
+// Applies a workload flag
+bool WorkloadFlags::apply(const std::string& flag, const std::string& value, WorkloadGenerator::Options& options) {
+
+    try {
+        if (flag == "--instructions")           return parseSize(value, options.szInstructions);
+        else if (flag == "--size")              return parseSize(value, options.szTargetBytes);
+        else if (flag == "--nesting")           return parseSize(value, options.szNesting);
+        else if (flag == "--iterations")        return parseSize(value, options.szIterations);
+        else if (flag == "--block")             return parseSize(value, options.szBlockSize);
+        else if (flag == "--dep-distance")      return parseSize(value, options.szDependencyDistance);
+        else if (flag == "--data-size")         return parseSize(value, options.szDataSize);
+        else if (flag == "--branch-density")    options.dBranchDensity = std::stod(value);
+        else if (flag == "--load-density")      options.dLoadDensity = std::stod(value);
+        else if (flag == "--seed")              options.wSeed = static_cast<word_t>(std::stoul(value));
+        else                                    return false;
+    }
+    catch (std::exception& e) {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "utils/workload_generator.hpp"
+
+/**
+ * Command line flags shared by the tools that generate workloads.
+ */
+namespace WorkloadFlags {
+
+    /** The usage text for the shared flags. */
+    extern const char * USAGE;
+
+    /**
+     * Parses a size, with an optional K, M, or G suffix (powers of 1024).
+     * @param str The size string
+     * @param size A placeholder for the size
+     * @return Whether or not the size was valid
+     */
+    bool parseSize(const std::string& str, size_t& size);
+
+    /**
+     * Applies a workload flag to a set of options.
+     * @param flag The flag (e.g. "--nesting")
+     * @param value The flag's value
+     * @param options The options to update
+     * @return Whether or not the flag was a valid workload flag
+     */
+    bool apply(const std::string& flag, const std::string& value, WorkloadGenerator::Options& options);
+}
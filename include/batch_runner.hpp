@@ -0,0 +1,314 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+/**
+ * Runs a list of jobs, each a program with its own input and options, across
+ * a WorkStealingPool, and streams one result per job as a line of JSON.
+ *
+ * Each job runs in a child process of its own (the simulator executable, given
+ * the job's program and options), since a program that faults stops the whole
+ * process it runs in. The child's output is read back as it is written to find
+ * the program's own output (hashed), the run's statistics, and the fault that
+ * stopped it, if any, keeping no more than a bounded tail of it. A job that
+ * takes longer than its timeout is killed.
+ *
+ * Results are written in job order, whatever order the jobs finish in, and
+ * only hold what a run decides (no wall-clock times), so the results of a batch
+ * are the same on any number of threads - jobs that time out aside. The pool
+ * starts no job more than a window ahead of the oldest one unfinished, so no
+ * more than that many results are ever held back waiting for it.
+ */
+class BatchRunner {
+public:
+
+    // MARK: -- Public Types
+
+    /** How a batch is run. */
+    struct Config {
+
+        /** The simulator executable each job runs. */
+        std::string strExecutable;
+
+        /** The number of jobs run at once (0 for one per host thread). */
+        size_t szThreads = 0;
+
+        /** The most results held back waiting for an older job. */
+        size_t szWindow = 64;
+
+        /** Whether or not to pin each thread (and the jobs it runs) to its own host CPU. */
+        bool bPin = false;
+
+        /** The cycle limit of jobs that do not give their own (0 for none). */
+        dword_t dwMaxCycles = 0;
+
+        /** The timeout of jobs that do not give their own, in milliseconds (0 for none). */
+        dword_t dwTimeoutMs = 0;
+
+        /** Whether or not to stop jobs that livelock (see LivelockDetector). */
+        bool bDetectLivelock = true;
+    };
+
+    /** A job, as one line of JSON: {"id", "program", "input", "options", "max_cycles", "timeout_ms"}. */
+    struct Job {
+
+        /** The name of the job in its result (its line number by default). */
+        std::string strId;
+
+        /** The program to run. */
+        std::string strProgram;
+
+        /** The file the program reads its input from, if any. */
+        std::string strInput;
+
+        /** Any other flags to run the simulator with. */
+        std::vector<std::string> vecOptions;
+
+        /** The most cycles the program may run for (0 for the batch's limit). */
+        dword_t dwMaxCycles = 0;
+
+        /** How long the job may take, in milliseconds (0 for the batch's timeout). */
+        dword_t dwTimeoutMs = 0;
+    };
+
+    /** How a job ended. */
+    enum class Status {
+        OK,                     // The program finished
+        TRAP,                   // The program (or the simulator) stopped with a fault
+        TIMEOUT,                // The job took too long and was killed
+        ERROR                   // The job could not be started
+    };
+
+    /** The result of a job. */
+    struct Result {
+
+        /** The index of the job. */
+        size_t szJob = 0;
+
+        /** The name of the job. */
+        std::string strId;
+
+        /** How the job ended. */
+        Status status = Status::ERROR;
+
+        /** The exit code of the child (128 + the signal if it was killed by one). */
+        int iExitCode = 0;
+
+        /** Every "Total ..." statistic the run reported, by name (e.g. clock_cycles), in the order reported. */
+        std::vector<std::pair<std::string, dword_t>> vecCounters;
+
+        /** The FNV-1a hash of the program's own output. */
+        dword_t dwOutputHash = 0;
+
+        /** The number of bytes the program wrote. */
+        dword_t dwOutputBytes = 0;
+
+        /** The fault that stopped the run, if any. */
+        std::string strTrap;
+
+        /** The kind of fault (e.g. SIGLOOP for a livelock, SIGXCPU for the cycle limit), if it gave one. */
+        std::string strSignal;
+    };
+
+    /** The outcome of a batch. */
+    struct Stats {
+
+        /** The number of jobs run. */
+        dword_t dwJobs = 0;
+
+        /** The number that finished. */
+        dword_t dwOk = 0;
+
+        /** The number that stopped with a fault. */
+        dword_t dwTraps = 0;
+
+        /** The number of those stopped for livelocking. */
+        dword_t dwLivelocks = 0;
+
+        /** The number of those stopped at their cycle limit. */
+        dword_t dwCycleLimits = 0;
+
+        /** The number that timed out. */
+        dword_t dwTimeouts = 0;
+
+        /** The number that could not be started. */
+        dword_t dwErrors = 0;
+
+        /** The number the pool stole from one thread for another. */
+        dword_t dwSteals = 0;
+    };
+
+    /**
+     * Reads a job's output as it arrives, without keeping all of it. The
+     * program's own output (between the rules run() prints around it) is hashed
+     * as it goes, and only a bounded tail is kept, for the fault and the
+     * statistics a run prints last.
+     */
+    class OutputParser {
+    public:
+
+        // MARK: -- Public Constants
+
+        /** The most bytes kept from the end of the output (a fault or statistics past them are cut short). */
+        static constexpr size_t TAIL_BYTES = 64 * 1024;
+
+
+        // MARK: -- Construction
+
+        OutputParser();
+        ~OutputParser() = default;
+
+
+        // MARK: -- Parsing Methods
+
+        /**
+         * Reads the next part of the output.
+         * @param data The bytes
+         * @param length The number of bytes
+         */
+        void append(const char * data, size_t length);
+
+        /**
+         * Returns the number of bytes read so far.
+         * @return The number of bytes
+         */
+        dword_t getLength() const;
+
+        /**
+         * Fills in a result from everything read.
+         * @param result The result, with its exit code and status already set
+         */
+        void finish(Result& result) const;
+
+    private:
+
+        // MARK: -- Private Variables
+
+        /** The last few bytes before the program's output starts, to find its start with. */
+        std::string m_strWindow;
+
+        /** Whether or not the program's output has started. */
+        bool m_bInOutput;
+
+        /** The number of bytes read. */
+        dword_t m_dwLength;
+
+        /** The hash of everything read since the program's output started, and its length. */
+        dword_t m_dwHash;
+        dword_t m_dwBytes;
+
+        /** Whether or not the next byte starts a line. */
+        bool m_bLineStart;
+
+        /** The hash and length at the start of the current line. */
+        dword_t m_dwLineHash;
+        dword_t m_dwLineBytes;
+
+        /** Whether or not a line of the program's output has ended, and the hash and length at its start. */
+        bool m_bLastLine;
+        dword_t m_dwLastLineHash;
+        dword_t m_dwLastLineBytes;
+
+        /** The number of bytes of the current line matching a rule, or -1 if it cannot be one. */
+        sdword_t m_iRuleMatch;
+
+        /** Whether or not a rule ended the program's output, the hash and length before the last, and where it ends. */
+        bool m_bFinished;
+        dword_t m_dwRuleHash;
+        dword_t m_dwRuleBytes;
+        dword_t m_dwRuleEnd;
+
+        /** The last bytes read, and where they start. */
+        std::string m_strTail;
+        dword_t m_dwTailStart;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument if there is no executable to run.
+     * @param config How to run the batch
+     */
+    explicit BatchRunner(const Config& config);
+    ~BatchRunner() = default;
+
+
+    // MARK: -- Job Methods
+
+    /**
+     * Parses a job from a line of JSON.
+     * @param line The line
+     * @param number The line number, which names the job unless it has an id
+     * @param job A placeholder for the job
+     * @param error A placeholder for what was wrong with the line, if anything
+     * @return Whether or not the line is a job
+     */
+    static bool parseJob(const std::string& line, size_t number, Job& job, std::string& error);
+
+    /**
+     * Reads jobs, one per line (blank lines are skipped).
+     * @param path The file of jobs
+     * @param jobs A placeholder for the jobs
+     * @return Whether or not every line was a job
+     */
+    static bool readJobs(const std::string& path, std::vector<Job>& jobs);
+
+
+    // MARK: -- Execution Methods
+
+    /**
+     * Runs every job, writing each result as soon as every job before it has one.
+     * @param jobs The jobs
+     * @param results The stream to write the results to, one line each
+     * @return The outcome of the batch
+     */
+    Stats run(const std::vector<Job>& jobs, std::ostream& results) const;
+
+
+    // MARK: -- Result Methods
+
+    /**
+     * Fills in a result from everything a job's child process wrote.
+     * @param output The output of the child (stdout and stderr)
+     * @param result The result, with its exit code and status already set
+     */
+    static void parseOutput(const std::string& output, Result& result);
+
+    /**
+     * Writes a result as a line of JSON.
+     * @param stream The stream
+     * @param result The result
+     */
+    static void writeResult(std::ostream& stream, const Result& result);
+
+    /**
+     * Returns the name of a status, as results give it.
+     * @param status The status
+     * @return The name
+     */
+    static const char * getStatusName(Status status);
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** How the batch is run. */
+    Config m_config;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Runs a job in a child process.
+     * @param index The index of the job
+     * @param job The job
+     * @return The result
+     */
+    Result runJob(size_t index, const Job& job) const;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "instr/instruction_set.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/retire_record.hpp"
+#include "pipeline/timing_model.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/spsc_queue.hpp"
+
+#include "simulator.hpp"
+
+/**
+ * A functional-first simulator, split into a functional front end and a timing
+ * back end that can each run on their own host thread.
+ *
+ * The front end is a FunctionalSimulator: it runs the program exactly as
+ * Simulator does, and records each instruction it runs. The records go through
+ * a bounded lock-free queue to the back end, a TimingModel, which works out
+ * how long a pipelined machine would take. The front end can run ahead of the
+ * back end by as much as the queue holds.
+ *
+ * When the back end mispredicts a branch, it asks for the instructions down
+ * the wrong path. These are decoded from a copy of the text segment taken when
+ * the simulator is built, so the back end never touches memory the front end
+ * may be writing.
+ *
+ * Timing results are the same whether or not the two halves run in parallel.
+ */
+class DecoupledSimulator {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The number of records the queue holds by default. */
+    static constexpr size_t DEFAULT_QUEUE_SIZE = 4096;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param instrSet The instruction set
+     * @param memory The memory (already loaded)
+     * @param registerBank The register bank
+     * @param config The shape of the timed pipeline
+     * @param queueSize The number of records the queue holds (a power of two)
+     */
+    DecoupledSimulator(std::unique_ptr<InstructionSet> instrSet, std::shared_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank,
+                       const TimingModel::Config& config = TimingModel::Config(), size_t queueSize = DEFAULT_QUEUE_SIZE);
+    ~DecoupledSimulator() = default;
+
+
+    // MARK: -- Execution Methods
+
+    /**
+     * Runs the program from start to finish, then prints the functional and timing results.
+     */
+    void run();
+
+    /**
+     * Sets whether the front and back ends run on their own host threads.
+     * @param parallel Whether or not to run in parallel (the default)
+     */
+    void setParallel(bool parallel);
+
+    /**
+     * Returns whether the front and back ends run on their own host threads.
+     * @return Whether or not runs are parallel
+     */
+    bool isParallel() const;
+
+
+    // MARK: -- Stats Methods
+
+    /**
+     * Returns the results of the functional front end (one cycle per instruction).
+     * @return The results
+     */
+    const SimulatorStats& getFunctionalStats() const;
+
+    /**
+     * Returns the results of the timing back end.
+     * @return The results
+     */
+    const TimingModel::Stats& getTimingStats() const;
+
+
+    // MARK: -- Wrong Path Methods
+
+    /**
+     * Decodes the instructions down a path without running them.
+     * @param pc The address to start at
+     * @param count The number of instructions
+     * @param records A placeholder for the records (stops early at the end of the text segment)
+     */
+    void decodeWrongPath(Memory::addr_t pc, size_t count, std::vector<RetireRecord>& records) const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The instruction set (owned by the front end). */
+    const InstructionSet * m_ptrInstrSet;
+
+    /** A copy of the text segment, for decoding wrong paths. */
+    std::vector<byte_t> m_vecText;
+
+    /** The functional front end. */
+    std::unique_ptr<FunctionalSimulator> m_ptrFrontEnd;
+
+    /** The timing back end. */
+    TimingModel m_timing;
+
+    /** The records passed from the front end to the back end. */
+    SpscQueue<RetireRecord> m_queue;
+
+    /** Whether or not the two halves run on their own threads. */
+    bool m_bParallel;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Runs the front end until the program exits, pushing every record.
+     */
+    void runFrontEnd();
+
+    /**
+     * Runs the back end until it has timed the last record.
+     */
+    void runBackEnd();
+};
@@ -27,7 +27,7 @@ public:
      * @param registerBank The register bank
      * @param PC The program counter
      */
-    void onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
 
     /**
      * Handles any execution necessary.
@@ -42,5 +42,5 @@ public:
      * @param memory Our memory
      * @return Any read memory, or 0
      */
-    word_t onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) override;
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
 };
\ No newline at end of file
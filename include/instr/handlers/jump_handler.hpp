@@ -0,0 +1,63 @@
+#pragma once
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_handler.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_decode_buffer.hpp"
+#include "pipeline/memory_buffer.hpp"
+#include "types.hpp"
+
+/**
+ * A handler for the J-Type jumps (J and JAL).
+ *
+ * The target is the 26-bit word address in the instruction, within the 256 MB
+ * region of the instruction after the jump. Like branches, jumps are taken in
+ * decode. JAL links the address of the instruction after it into $ra, which
+ * is carried on to write back in the immediate.
+ */
+class JumpHandler: public InstructionHandler {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param bLink Whether or not the jump links into $ra (JAL)
+     */
+    explicit JumpHandler(bool bLink);
+    ~JumpHandler() = default;
+
+
+    // MARK: -- Handler Methods
+
+    /**
+     * Handles any post decoding of an instruction.
+     * @param decodeBuffer The decode buffer
+     * @param registerBank The register bank
+     * @param PC The program counter
+     */
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+
+    /**
+     * Handles any execution necessary.
+     * @param decodeBuffer The decoded information
+     * @return The return address for JAL, or 0
+     */
+    word_t onExecute(const InstructionDecodeBuffer& decodeBuffer) override;
+
+    /**
+     * Handles any reading / writing of memory.
+     * @param executionBuffer The execution buffer information
+     * @param memory Our memory
+     * @return The execution output
+     */
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** Whether or not the jump links into $ra. */
+    bool m_bLink;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_handler.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_decode_buffer.hpp"
+#include "pipeline/memory_buffer.hpp"
+#include "types.hpp"
+
+/**
+ * A handler for the jumps through a register (JR and JALR).
+ *
+ * Like branches, these read RS and jump in decode, so RS is forwarded into
+ * decode. JALR links the address of the instruction after it into RD, which
+ * is carried on to write back in the immediate.
+ */
+class JumpRegisterHandler: public InstructionHandler {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param bLink Whether or not the jump links into RD (JALR)
+     */
+    explicit JumpRegisterHandler(bool bLink);
+    ~JumpRegisterHandler() = default;
+
+
+    // MARK: -- Handler Methods
+
+    /**
+     * Handles any post decoding of an instruction.
+     * @param decodeBuffer The decode buffer
+     * @param registerBank The register bank
+     * @param PC The program counter
+     */
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+
+    /**
+     * Handles any execution necessary.
+     * @param decodeBuffer The decoded information
+     * @return The return address for JALR, or 0
+     */
+    word_t onExecute(const InstructionDecodeBuffer& decodeBuffer) override;
+
+    /**
+     * Handles any reading / writing of memory.
+     * @param executionBuffer The execution buffer information
+     * @param memory Our memory
+     * @return The execution output
+     */
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** Whether or not the jump links into RD. */
+    bool m_bLink;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_handler.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_decode_buffer.hpp"
+#include "pipeline/memory_buffer.hpp"
+#include "types.hpp"
+
+/**
+ * A handler for the load instructions (LB, LH, LW, LBU and LHU), which differ
+ * only in how many bytes they read and whether they sign extend them.
+ */
+class LoadHandler: public InstructionHandler {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument for a size other than 1, 2 or 4.
+     * @param size The number of bytes loaded
+     * @param bSigned Whether or not the bytes are sign extended
+     */
+    LoadHandler(size_t size, bool bSigned);
+    ~LoadHandler() = default;
+
+
+    // MARK: -- Handler Methods
+
+    /**
+     * Handles any post decoding of an instruction.
+     * @param decodeBuffer The decode buffer
+     * @param registerBank The register bank
+     * @param PC The program counter
+     */
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+
+    /**
+     * Handles any execution necessary.
+     * @param decodeBuffer The decoded information
+     * @return The address to load from
+     */
+    word_t onExecute(const InstructionDecodeBuffer& decodeBuffer) override;
+
+    /**
+     * Handles any reading / writing of memory.
+     * @param executionBuffer The execution buffer information
+     * @param memory Our memory
+     * @return The loaded value, extended to a word
+     */
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The number of bytes loaded. */
+    size_t m_szSize;
+
+    /** Whether or not the bytes are sign extended. */
+    bool m_bSigned;
+};
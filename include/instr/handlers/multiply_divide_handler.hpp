@@ -0,0 +1,67 @@
+#pragma once
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_handler.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_decode_buffer.hpp"
+#include "pipeline/memory_buffer.hpp"
+#include "types.hpp"
+
+/**
+ * A handler for the instructions of the multiply/divide unit (MULT, MULTU,
+ * DIV, DIVU, MFHI, MFLO, MTHI and MTLO), which all read or write HI and LO.
+ *
+ * Like system calls, these reach HI and LO while decoding, since only decode
+ * sees the register bank. A multiply or divide writes its result there at
+ * once (the multiply/divide unit accounts for how long it would really take),
+ * and a move from HI or LO carries the value on to write back in the
+ * immediate, where forwarding cannot overwrite it. Dividing by zero leaves HI
+ * and LO as they were, and the signed overflow of INT_MIN / -1 leaves INT_MIN
+ * in LO and 0 in HI.
+ */
+class MultiplyDivideHandler: public InstructionHandler {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument for a funct the unit does not run.
+     * @param funct The funct of the instruction
+     */
+    explicit MultiplyDivideHandler(word_t funct);
+    ~MultiplyDivideHandler() = default;
+
+
+    // MARK: -- Handler Methods
+
+    /**
+     * Handles any post decoding of an instruction.
+     * @param decodeBuffer The decode buffer
+     * @param registerBank The register bank
+     * @param PC The program counter
+     */
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+
+    /**
+     * Handles any execution necessary.
+     * @param decodeBuffer The decoded information
+     * @return The value moved from HI or LO, or 0
+     */
+    word_t onExecute(const InstructionDecodeBuffer& decodeBuffer) override;
+
+    /**
+     * Handles any reading / writing of memory.
+     * @param executionBuffer The execution buffer information
+     * @param memory Our memory
+     * @return The execution output
+     */
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The funct of the instruction. */
+    word_t m_wFunct;
+};
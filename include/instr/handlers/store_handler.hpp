@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 #include "instr/instruction.hpp"
 #include "instr/instruction_handler.hpp"
 #include "memory/memory.hpp"
@@ -9,14 +11,20 @@
 #include "types.hpp"
 
 /**
- * A handler for the ADD instruction
+ * A handler for the store instructions (SB, SH and SW), which differ only in
+ * how many of the low bytes of RT they write.
  */
-class LbHandler: public InstructionHandler {
+class StoreHandler: public InstructionHandler {
 public:
 
     // MARK: -- Construction
-    LbHandler() = default;
-    ~LbHandler() = default;
+
+    /**
+     * Constructor. Throws std::invalid_argument for a size other than 1, 2 or 4.
+     * @param size The number of bytes stored
+     */
+    explicit StoreHandler(size_t size);
+    ~StoreHandler() = default;
 
 
     // MARK: -- Handler Methods
@@ -27,12 +35,12 @@ public:
      * @param registerBank The register bank
      * @param PC The program counter
      */
-    void onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
 
     /**
      * Handles any execution necessary.
      * @param decodeBuffer The decoded information
-     * @return The output value (ALU output) from the execution stage, or 0
+     * @return The address to store to
      */
     word_t onExecute(const InstructionDecodeBuffer& decodeBuffer) override;
 
@@ -40,7 +48,14 @@ public:
      * Handles any reading / writing of memory.
      * @param executionBuffer The execution buffer information
      * @param memory Our memory
-     * @return Any read memory, or 0
+     * @return 0
      */
-    word_t onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) override;
-};
\ No newline at end of file
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The number of bytes stored. */
+    size_t m_szSize;
+};
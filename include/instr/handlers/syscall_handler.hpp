@@ -1,7 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "instr/instruction.hpp"
+#include "instr/input_feed.hpp"
 #include "instr/instruction_handler.hpp"
+#include "instr/syscall_context.hpp"
+#include "instr/syscall_log.hpp"
 #include "memory/memory.hpp"
 #include "pipeline/execution_buffer.hpp"
 #include "pipeline/instruction_decode_buffer.hpp"
@@ -9,14 +18,41 @@
 #include "types.hpp"
 
 /**
- * A handler for the ADD instruction
+ * A handler for the SYSCALL instruction.
+ * 
+ * System calls are dispatched through a flat table indexed by the code in $v0.
+ * The SPIM / MARS calls listed in Syscalls are registered on construction, and
+ * more can be added (or replaced) with registerSyscall().
+ * 
+ * Console input comes from an InputFeed, so runs can be fed from files or
+ * memory instead of the terminal. Every call can also be recorded to a
+ * SyscallLog, and a recorded log can be replayed: calls that depend on the host
+ * (input, files, time) then take their results from the log instead.
  */
 class SyscallHandler: public InstructionHandler {
 public:
 
+    // MARK: -- Public Types
+
+    /** A system call implementation. */
+    using syscall_fn_t = std::function<void(SyscallContext&)>;
+
+    /** A program break, which handlers over the same memory share (0 until first used). */
+    using heap_break_t = std::atomic<Memory::addr_t>;
+
+
+    // MARK: -- Public Constants
+
+    /** The largest system call code that can be registered. */
+    static constexpr word_t LIMIT_SYSCALL = 255;
+
+    /** The size of the chunks used to stream file data between the host and guest. */
+    static constexpr size_t IO_CHUNK_SIZE = 64 * 1024;
+
+
     // MARK: -- Construction
-    SyscallHandler() = default;
-    ~SyscallHandler() = default;
+    SyscallHandler();
+    ~SyscallHandler();
 
 
     // MARK: -- Handler Methods
@@ -27,7 +63,7 @@ public:
      * @param registerBank The register bank
      * @param PC The program counter
      */
-    void onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+    void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
 
     /**
      * Handles any execution necessary.
@@ -42,10 +78,155 @@ public:
      * @param memory Our memory
      * @return Any read memory, or 0
      */
-    word_t onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) override;
+    word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
+
+
+    // MARK: -- Registration Methods
+
+    /**
+     * Registers a system call. Registering over an existing code replaces it.
+     * @param code The system call code
+     * @param name The name (used for logging)
+     * @param syscall The implementation
+     * @param usesHost Whether the results depend on the host (replayed from the log instead of run)
+     * @return Whether or not the registration succeeded (fails for out of bounds codes or null implementations)
+     */
+    bool registerSyscall(word_t code, const std::string& name, syscall_fn_t syscall, bool usesHost = true);
+
+    /**
+     * Returns whether a system call code has been registered.
+     * @param code The system call code
+     * @return Whether or not the code is registered
+     */
+    bool hasSyscall(word_t code) const;
+
+
+    // MARK: -- Input Methods
+
+    /**
+     * Returns the feed console input is read from.
+     * @return The input feed
+     */
+    InputFeed& getInputFeed();
+
+
+    // MARK: -- Core Methods
+
+    /**
+     * Sets the id of the core this handler serves, as returned by the core id call.
+     * @param coreId The core id
+     */
+    void setCoreId(word_t coreId);
+
+    /**
+     * Returns the id of the core this handler serves.
+     * @return The core id (0 unless set)
+     */
+    word_t getCoreId() const;
+
+
+    // MARK: -- Heap Methods
+
+    /**
+     * Shares a program break with the other handlers over the same memory
+     * (e.g. the other cores'), so SBRK never hands out the same bytes twice.
+     * @param heapBreak The break (each handler has its own by default)
+     */
+    void setHeapBreak(std::shared_ptr<heap_break_t> heapBreak);
+
+
+    // MARK: -- Record / Replay Methods
+
+    /**
+     * Records the results of every system call into a log.
+     * @param log The log, or nullptr to stop recording
+     */
+    void setRecordLog(std::shared_ptr<SyscallLog> log);
+
+    /**
+     * Replays system call results from a recorded log. Calls that use the host
+     * are not run; their register and memory writes are applied from the log.
+     * @param log The log, or nullptr to stop replaying
+     */
+    void setReplayLog(std::shared_ptr<const SyscallLog> log);
+
+
+    // MARK: -- History Methods
+
+    /**
+     * Keeps every system call in a history, so a run that is rewound and run
+     * again takes the results from the history instead of running the calls
+     * twice. Calls past the end of the history run as normal and are added to it.
+     * @param history The history (kept in memory), or nullptr to stop
+     */
+    void setHistory(std::shared_ptr<SyscallLog> history);
+
+    /**
+     * Moves to a point in the history, e.g. after rewinding the run.
+     * @param position The number of calls made before that point
+     */
+    void setHistoryPosition(size_t position);
+
+    /**
+     * Returns the point we are at in the history.
+     * @return The number of calls made so far
+     */
+    size_t getHistoryPosition() const;
 
 private:
 
+    // MARK: -- Private Types
+
+    /** An entry in the system call table. */
+    struct SyscallEntry {
+
+        /** The name of the system call. */
+        std::string strName;
+
+        /** The implementation. */
+        syscall_fn_t fnSyscall;
+
+        /** Whether the results depend on the host. */
+        bool bUsesHost;
+    };
+
+
+    // MARK: -- Private Variables
+
+    /** The system call table, indexed by code. */
+    std::vector<SyscallEntry> m_vecSyscalls;
+
+    /** Guest file descriptors mapped to host file descriptors (-1 if closed). */
+    std::vector<int> m_vecFileDescriptors;
+
+    /** The id of the core we serve. */
+    word_t m_wCoreId;
+
+    /** The current program break for SBRK, which may be shared with other handlers. */
+    std::shared_ptr<heap_break_t> m_ptrHeapBreak;
+
+    /** A scratch buffer for moving file data between host and guest. */
+    std::vector<byte_t> m_vecScratch;
+
+    /** The console input. */
+    InputFeed m_inputFeed;
+
+    /** The log to record into (if any). */
+    std::shared_ptr<SyscallLog> m_ptrRecordLog;
+
+    /** The log to replay from (if any). */
+    std::shared_ptr<const SyscallLog> m_ptrReplayLog;
+
+    /** The next entry to replay. */
+    size_t m_szReplayIndex;
+
+    /** Every call made so far (if kept). */
+    std::shared_ptr<SyscallLog> m_ptrHistory;
+
+    /** The next entry of the history. */
+    size_t m_szHistoryIndex;
+
+
     // MARK: -- Private Methods
 
     /**
@@ -54,5 +235,59 @@ private:
      * @param registerBank The register bank
      * @param memory The memory
      */
-    void handleSystemCall(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory);
-};
\ No newline at end of file
+    void handleSystemCall(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory);
+
+    /**
+     * Registers the built-in SPIM / MARS system calls.
+     */
+    void registerDefaultSyscalls();
+
+    /**
+     * Applies the next replayed entry for a system call.
+     * @param context The system call context
+     * @param code The system call code
+     * @param apply Whether to apply the side effects (false for calls that are run live)
+     */
+    void replaySyscall(SyscallContext& context, word_t code, bool apply);
+
+    /**
+     * Applies the side effects of a logged system call.
+     * @param context The system call context
+     * @param entry The logged call
+     */
+    void applyEntry(SyscallContext& context, const SyscallLog::Entry& entry);
+
+    /**
+     * Reads a raw null-terminated string (no escape processing) from guest memory.
+     * @param context The system call context
+     * @param addr The address of the string
+     * @param str A placeholder to read the string into
+     * @return Whether or not the read was successful
+     */
+    bool readCString(const SyscallContext& context, Memory::addr_t addr, std::string& str) const;
+
+    /**
+     * Returns the host file descriptor for a guest file descriptor.
+     * @param guestFd The guest file descriptor
+     * @return The host file descriptor, or -1 if the guest descriptor is not open
+     */
+    int getHostDescriptor(word_t guestFd) const;
+
+
+    // MARK: -- Private System Call Methods
+
+    void syscallPrintInt(SyscallContext& context);
+    void syscallPrintString(SyscallContext& context);
+    void syscallReadInt(SyscallContext& context);
+    void syscallReadString(SyscallContext& context);
+    void syscallSbrk(SyscallContext& context);
+    void syscallExit(SyscallContext& context);
+    void syscallPrintChar(SyscallContext& context);
+    void syscallReadChar(SyscallContext& context);
+    void syscallOpen(SyscallContext& context);
+    void syscallRead(SyscallContext& context);
+    void syscallWrite(SyscallContext& context);
+    void syscallClose(SyscallContext& context);
+    void syscallTime(SyscallContext& context);
+    void syscallCoreId(SyscallContext& context);
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <deque>
+#include <istream>
+#include <memory>
+#include <string>
+
+#include "types.hpp"
+
+/**
+ * The source of all guest console input.
+ * 
+ * Input is read from a queue of in-memory strings and files, in the order they
+ * were queued. Once the queue runs dry, reads fall back to an interactive stream
+ * (std::cin by default), or report end of input if there is no fallback.
+ */
+class InputFeed {
+public:
+
+    // MARK: -- Construction
+    InputFeed();
+    ~InputFeed() = default;
+
+
+    // MARK: -- Queue Methods
+
+    /**
+     * Queues a string of input.
+     * @param data The input
+     */
+    void queueInput(const std::string& data);
+
+    /**
+     * Queues the contents of a file as input. The file is streamed, not loaded.
+     * @param filename The file
+     * @return Whether or not the file could be opened
+     */
+    bool queueFile(const std::string& filename);
+
+    /**
+     * Sets the stream to read from once the queue is empty.
+     * @param stream The stream, or nullptr to report end of input instead
+     */
+    void setFallback(std::istream * stream);
+
+
+    // MARK: -- Read Methods
+
+    /**
+     * Reads a single character.
+     * @return The character, or EOF at the end of input
+     */
+    int get();
+
+    /**
+     * Reads a whitespace-delimited token, skipping leading whitespace.
+     * @param token A placeholder for the token
+     * @return Whether or not a token was read
+     */
+    bool readToken(std::string& token);
+
+    /**
+     * Reads a signed decimal integer, skipping leading whitespace.
+     * @param value A placeholder for the value
+     * @return Whether or not an integer was read
+     */
+    bool readInt(sword_t& value);
+
+    /**
+     * Reads up to size bytes in bulk.
+     * @param data The buffer to read into
+     * @param size The maximum number of bytes
+     * @return The number of bytes read (0 at the end of input)
+     */
+    size_t read(byte_t * data, size_t size);
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** Queued input streams, front first. */
+    std::deque<std::unique_ptr<std::istream>> m_queStreams;
+
+    /** The stream to fall back to (not owned). */
+    std::istream * m_pFallback;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Returns the stream to read from next, dropping exhausted queued streams.
+     * @return The stream, or nullptr at the end of input
+     */
+    std::istream * currentStream();
+
+    /**
+     * Peeks at the next character without consuming it.
+     * @return The character, or EOF at the end of input
+     */
+    int peek();
+};
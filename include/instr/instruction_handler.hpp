@@ -32,7 +32,7 @@ public:
      * @param memory Memory for things like system calls
      * @param PC The program counter
      */
-    virtual void onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) = 0;
+    virtual void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) = 0;
 
     /**
      * Handles any execution necessary.
@@ -47,5 +47,5 @@ public:
      * @param memory Our memory
      * @return Any read memory, or 0
      */
-    virtual word_t onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) = 0;
+    virtual word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) = 0;
 };
\ No newline at end of file
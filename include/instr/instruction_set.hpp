@@ -59,6 +59,14 @@ public:
      */
     InstructionParser * getInstructionParser(const std::string& name) const;
 
+    /**
+     * Returns the name of an instruction given its opcode and funct.
+     * @param opcode The opcode
+     * @param funct The funct (0 if not an R-Type instruction)
+     * @return The name, or an empty string if not found
+     */
+    std::string getInstructionName(word_t opcode, word_t funct) const;
+
 
     // MARK: -- Registration Methods
 
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+
+#include "instr/handlers/syscall_handler.hpp"
+#include "instr/instruction_set.hpp"
+
+/**
+ * A class with a single static method that builds the instruction set
+ * supported by the simulator (every handler and parser registered).
+ */
+class InstructionSetFactory {
+public:
+
+    /**
+     * Creates the default instruction set.
+     * @param syscallHandler The (already configured) system call handler, or nullptr for a default one
+     * @return The instruction set
+     */
+    static std::unique_ptr<InstructionSet> createDefault(std::unique_ptr<SyscallHandler> syscallHandler = nullptr);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_parser.hpp"
+#include "types.hpp"
+
+/**
+ * A parser for the J-Type jumps (J and JAL), which share one format.
+ */
+class JumpParser: public InstructionParser {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param name The name of the instruction (e.g. "jal")
+     * @param opcode The opcode of the instruction
+     */
+    JumpParser(const std::string& name, word_t opcode);
+    ~JumpParser() = default;
+
+
+    // MARK: -- Parse Methods
+
+    /**
+     * Parses a line with a jump instruction
+     * 
+     * The format for these instructions is as follows:
+     * 
+     *      <NAME> <label>
+     * 
+     * The label is resolved to an address once the whole file is read.
+     * 
+     * @param line The line to parse
+     * @throw SyntaxError If there is a syntax error
+     * @return A vector with the instructions
+     */
+    std::vector<Instruction> parse(const std::string& line) const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The name of the instruction. */
+    std::string m_strName;
+
+    /** The name of the instruction, for error messages. */
+    std::string m_strMnemonic;
+
+    /** The opcode of the instruction. */
+    word_t m_wOpcode;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_parser.hpp"
+#include "types.hpp"
+
+/**
+ * A parser for the jumps through a register (JR and JALR), which are R-Type
+ * instructions.
+ */
+class JumpRegisterParser: public InstructionParser {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param name The name of the instruction (e.g. "jr")
+     * @param funct The funct of the instruction
+     */
+    JumpRegisterParser(const std::string& name, word_t funct);
+    ~JumpRegisterParser() = default;
+
+
+    // MARK: -- Parse Methods
+
+    /**
+     * Parses a line with a jump through a register
+     * 
+     * The format for these instructions is one of:
+     * 
+     *      JR <Rs>
+     *      JALR <Rs>
+     *      JALR <Rd> <Rs>
+     * 
+     * where Rs holds the address to jump to, and JALR links into Rd ($ra if
+     * not given). A syntax error will be thrown if any of the registers are
+     * invalid or out of bounds.
+     * 
+     * @param line The line to parse
+     * @throw SyntaxError If there is a syntax error
+     * @return A vector with the instructions
+     */
+    std::vector<Instruction> parse(const std::string& line) const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The name of the instruction. */
+    std::string m_strName;
+
+    /** The name of the instruction, for error messages. */
+    std::string m_strMnemonic;
+
+    /** The funct of the instruction. */
+    word_t m_wFunct;
+};
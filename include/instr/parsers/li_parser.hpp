@@ -27,6 +27,9 @@ public:
      * 
      *      LI <Rdest> <immediate>
      * 
+     * A value from 0 to 65535 loads with a single ORI, and any other value
+     * (negative ones included) with a LUI and an ORI.
+     * 
      * A syntax error will be thrown if any of the registers are invalid or
      * out of bounds.
      * 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_parser.hpp"
+#include "types.hpp"
+
+/**
+ * A parser for the load and store instructions (LB, LH, LW, LBU, LHU, SB, SH
+ * and SW), which all share one format.
+ */
+class LoadStoreParser: public InstructionParser {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param name The name of the instruction (e.g. "lw")
+     * @param opcode The opcode of the instruction
+     */
+    LoadStoreParser(const std::string& name, word_t opcode);
+    ~LoadStoreParser() = default;
+
+
+    // MARK: -- Parse Methods
+
+    /**
+     * Parses a line with a load or store instruction
+     * 
+     * The format for these instructions is as follows:
+     * 
+     *      <NAME> <Rt> <offset>(<Rbase>)
+     * 
+     * OR
+     * 
+     *      <NAME> <Rt>, <Rbase>
+     * 
+     * where Rt is loaded into or stored from. A syntax error will be thrown if
+     * any of the registers are invalid or out of bounds.
+     * 
+     * @param line The line to parse
+     * @throw SyntaxError If there is a syntax error
+     * @return A vector with the instructions
+     */
+    std::vector<Instruction> parse(const std::string& line) const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The name of the instruction. */
+    std::string m_strName;
+
+    /** The name of the instruction, for error messages. */
+    std::string m_strMnemonic;
+
+    /** The opcode of the instruction. */
+    word_t m_wOpcode;
+};
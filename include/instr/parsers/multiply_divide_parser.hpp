@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_parser.hpp"
+#include "types.hpp"
+
+/**
+ * A parser for the instructions of the multiply/divide unit (MULT, MULTU,
+ * DIV, DIVU, MFHI, MFLO, MTHI and MTLO), which are all R-Type instructions
+ * with one or two registers.
+ */
+class MultiplyDivideParser: public InstructionParser {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param name The name of the instruction (e.g. "mult")
+     * @param funct The funct of the instruction
+     */
+    MultiplyDivideParser(const std::string& name, word_t funct);
+    ~MultiplyDivideParser() = default;
+
+
+    // MARK: -- Parse Methods
+
+    /**
+     * Parses a line with a multiply/divide instruction
+     * 
+     * The format for these instructions is one of:
+     * 
+     *      <MULT|MULTU|DIV|DIVU> <Rs> <Rt>
+     *      <MFHI|MFLO> <Rd>
+     *      <MTHI|MTLO> <Rs>
+     * 
+     * A syntax error will be thrown if any of the registers are invalid or
+     * out of bounds.
+     * 
+     * @param line The line to parse
+     * @throw SyntaxError If there is a syntax error
+     * @return A vector with the instructions
+     */
+    std::vector<Instruction> parse(const std::string& line) const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The name of the instruction. */
+    std::string m_strName;
+
+    /** The name of the instruction, for error messages. */
+    std::string m_strMnemonic;
+
+    /** The funct of the instruction. */
+    word_t m_wFunct;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "instr/syscall_log.hpp"
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+// MARK: -- Forward Declarations
+class RegisterBank;
+
+/**
+ * The view of the machine given to a system call implementation.
+ * 
+ * System calls should read their arguments and write their results through
+ * this class rather than touching the register bank and memory directly, so
+ * that every side effect of a system call passes through one place (and can
+ * be recorded for replay).
+ */
+class SyscallContext {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The register holding the system call code and result ($v0). */
+    static constexpr word_t REG_RESULT = 2;
+
+    /** The first argument register ($a0). */
+    static constexpr word_t REG_ARG_START = 4;
+
+    /** The number of argument registers ($a0-$a3). */
+    static constexpr word_t NUM_ARGS = 4;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param registerBank The register bank of the calling program
+     * @param memory The memory of the calling program
+     */
+    SyscallContext(RegisterBank& registerBank, Memory& memory);
+    ~SyscallContext() = default;
+
+
+    // MARK: -- Argument Methods
+
+    /**
+     * Returns the value of an argument register.
+     * @param index The argument index (0 = $a0, 3 = $a3)
+     * @return The argument value, or 0 if the index is out of bounds
+     */
+    word_t getArgument(word_t index) const;
+
+
+    // MARK: -- Result Methods
+
+    /**
+     * Writes a value to a register.
+     * @param num The register number
+     * @param value The value
+     */
+    void setRegister(word_t num, word_t value);
+
+    /**
+     * Writes the result of the system call to $v0.
+     * @param value The value
+     */
+    void setResult(word_t value);
+
+    /**
+     * Returns whether a system call may write a register: its result to $v0,
+     * or a second word to $a0 and $a1 (as the system time does).
+     * @param num The register number
+     * @return Whether or not it may
+     */
+    static bool writesRegister(sword_t num);
+
+    /**
+     * Marks that the program should exit.
+     */
+    void requestExit();
+
+    /**
+     * Returns whether the program requested to exit.
+     * @return Whether or not to exit
+     */
+    bool shouldExit() const;
+
+
+    // MARK: -- Memory Methods
+
+    /**
+     * Reads a block of guest memory.
+     * @param addr The guest address
+     * @param data The buffer to read into
+     * @param size The number of bytes
+     * @return Whether or not the read was successful
+     */
+    bool readMemory(Memory::addr_t addr, byte_t * data, size_t size) const;
+
+    /**
+     * Writes a block of guest memory.
+     * @param addr The guest address
+     * @param data The bytes to write
+     * @param size The number of bytes
+     * @return Whether or not the write was successful
+     */
+    bool writeMemory(Memory::addr_t addr, const byte_t * data, size_t size);
+
+    /**
+     * Returns the memory of the calling program.
+     * @return The memory
+     */
+    Memory& getMemory();
+
+
+    // MARK: -- Recording Methods
+
+    /**
+     * Sets an entry to record every register and memory write into.
+     * @param entry The entry, or nullptr to stop recording
+     */
+    void setRecord(SyscallLog::Entry * entry);
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The register bank. */
+    RegisterBank& m_registerBank;
+
+    /** The memory. */
+    Memory& m_memory;
+
+    /** Whether or not the program requested to exit. */
+    bool m_bExit;
+
+    /** The entry to record side effects into (if any). */
+    SyscallLog::Entry * m_pRecord;
+};
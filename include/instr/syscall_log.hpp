@@ -0,0 +1,111 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * A log of system call results, used to record a run and replay it later
+ * without touching the host.
+ * 
+ * Each entry holds every side effect a system call had on the guest: the
+ * registers it wrote, the memory it wrote, and whether it exited. When recording
+ * to a file, entries are streamed out as they happen; otherwise they are kept in
+ * memory. A loaded log is read-only and can be shared between any number of
+ * replaying runs.
+ */
+class SyscallLog {
+public:
+
+    // MARK: -- Public Types
+
+    /** A block of guest memory written by a system call. */
+    struct MemoryWrite {
+
+        /** The guest address. */
+        Memory::addr_t wAddr;
+
+        /** The bytes written. */
+        std::vector<byte_t> vecData;
+    };
+
+    /** The side effects of a single system call. */
+    struct Entry {
+
+        /** The system call code. */
+        word_t wCode = 0;
+
+        /** Whether or not the call exited the program. */
+        bool bExit = false;
+
+        /** Registers written, as (register, value) pairs, in order. */
+        std::vector<std::pair<word_t, word_t>> vecRegisters;
+
+        /** Memory written, in order. */
+        std::vector<MemoryWrite> vecMemory;
+    };
+
+
+    // MARK: -- Construction
+    SyscallLog() = default;
+    ~SyscallLog() = default;
+
+
+    // MARK: -- File Methods
+
+    /**
+     * Starts streaming appended entries to a file (instead of keeping them in memory).
+     * @param filename The file
+     * @return Whether or not the file could be opened
+     */
+    bool openForRecording(const std::string& filename);
+
+    /**
+     * Loads all entries from a recorded file, replacing any entries in memory.
+     * @param filename The file
+     * @return Whether or not the file was read successfully
+     */
+    bool load(const std::string& filename);
+
+
+    // MARK: -- Entry Methods
+
+    /**
+     * Appends an entry.
+     * @param entry The entry
+     */
+    void append(const Entry& entry);
+
+    /**
+     * Returns the number of entries held in memory.
+     * @return The number of entries
+     */
+    size_t size() const;
+
+    /**
+     * Returns an entry held in memory.
+     * @param index The index
+     * @return The entry
+     */
+    const Entry& at(size_t index) const;
+
+private:
+
+    // MARK: -- Private Constants
+
+    /** The file header. */
+    static constexpr const char * LOG_MAGIC = "PSYSLOG1";
+
+
+    // MARK: -- Private Variables
+
+    /** Entries held in memory (loaded, or appended while not recording). */
+    std::vector<Entry> m_vecEntries;
+
+    /** The file entries are streamed to while recording. */
+    std::ofstream m_fileRecord;
+};
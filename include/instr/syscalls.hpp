@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * A collection of system call codes (passed in $v0). These follow the
+ * SPIM / MARS numbering, except for the simulator's own calls at 60 and up.
+ */
+enum class Syscalls {
+
+    // MARK: -- System Calls
+    SYSCALL_PRINT_INT       = 1,        // Print the integer in $a0
+    SYSCALL_PRINT_STRING    = 4,        // Print the null-terminated string at $a0
+    SYSCALL_READ_INT        = 5,        // Read an integer into $v0
+    SYSCALL_READ_STRING     = 8,        // Read a string into the buffer at $a0 (max $a1 bytes)
+    SYSCALL_SBRK            = 9,        // Grow the heap by $a0 bytes, $v0 = old break
+    SYSCALL_EXIT            = 10,       // Exit the program
+    SYSCALL_PRINT_CHAR      = 11,       // Print the character in $a0
+    SYSCALL_READ_CHAR       = 12,       // Read a character into $v0
+    SYSCALL_OPEN            = 13,       // Open the file named at $a0 with flags $a1, $v0 = fd
+    SYSCALL_READ            = 14,       // Read $a2 bytes from fd $a0 into $a1, $v0 = count
+    SYSCALL_WRITE           = 15,       // Write $a2 bytes from $a1 to fd $a0, $v0 = count
+    SYSCALL_CLOSE           = 16,       // Close fd $a0
+    SYSCALL_TIME            = 30,       // System time in ms, $a0 = low word, $a1 = high word
+    SYSCALL_CORE_ID         = 60        // The id of the calling core, $v0 = id
+};
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "memory/l1_cache.hpp"
+#include "memory/memory.hpp"
+#include "memory/memory_observer.hpp"
+#include "types.hpp"
+
+/**
+ * A snooping bus keeping a private L1 data cache per core coherent with MESI.
+ *
+ * The bus watches the shared Memory of a lockstep multicore run. Before each
+ * core runs its cycle, the system tells the bus which core is active, so every
+ * access made that cycle is charged to that core's cache. Accesses to the text
+ * segment are instruction fetches, which are left to the (unmodelled) L1
+ * instruction caches.
+ *
+ * A read miss puts a BusRd on the bus (any other holder drops to S, writing
+ * its line back if it was M, and supplies the data); a write miss puts a
+ * BusRdX, and a write to an S line a BusUpgr, which both invalidate every
+ * other copy. Only one transaction holds the bus at once: a core wins it
+ * after the arbitration latency once it is free, and holds it for as long as
+ * the transfer takes. The pipeline itself never stalls on the caches, so the
+ * latency beyond a hit is charged to each core as stall cycles instead, and
+ * each core's own clock runs that far ahead when it next uses the bus.
+ */
+class CoherenceBus: public MemoryObserver {
+public:
+
+    // MARK: -- Public Types
+
+    /** The geometry and latencies of the caches and bus. */
+    struct Config {
+
+        /** The line size in bytes (a power of two, at most 64). */
+        size_t szLineSize = 32;
+
+        /** The number of sets in each cache (a power of two). */
+        size_t szSets = 32;
+
+        /** The number of lines in each set. */
+        size_t szWays = 2;
+
+        /** The cycles to win the bus once it is free. */
+        dword_t dwArbitrationLatency = 2;
+
+        /** The cycles a line takes to come from another cache. */
+        dword_t dwCacheToCacheLatency = 10;
+
+        /** The cycles a line takes to come from (or go to) memory. */
+        dword_t dwMemoryLatency = 40;
+
+        /** The cycles an upgrade takes to invalidate the other copies. */
+        dword_t dwInvalidateLatency = 4;
+    };
+
+    /** The bus counters. */
+    struct Stats {
+
+        /** The number of BusRd transactions. */
+        dword_t dwReads = 0;
+
+        /** The number of BusRdX transactions. */
+        dword_t dwReadExclusives = 0;
+
+        /** The number of BusUpgr transactions. */
+        dword_t dwUpgrades = 0;
+
+        /** The number of write backs of modified lines. */
+        dword_t dwWriteBacks = 0;
+
+        /** The number of lines supplied by another cache instead of memory. */
+        dword_t dwCacheToCache = 0;
+
+        /** The cycles the bus was held. */
+        dword_t dwBusyCycles = 0;
+
+        /** The cycles cores waited for the bus to become free. */
+        dword_t dwWaitCycles = 0;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument if the cache geometry is not valid.
+     * @param config The geometry and latencies
+     */
+    explicit CoherenceBus(const Config& config);
+    ~CoherenceBus() = default;
+
+
+    // MARK: -- Cache Methods
+
+    /**
+     * Adds a cache for the next core.
+     * @return The id of the core the cache belongs to
+     */
+    size_t addCache();
+
+    /**
+     * Returns the number of caches.
+     * @return The number of caches
+     */
+    size_t getNumCaches() const;
+
+    /**
+     * Returns a core's cache.
+     * @param core The core id
+     * @return The cache
+     */
+    const L1Cache& getCache(size_t core) const;
+
+    /**
+     * Returns the configuration.
+     * @return The configuration
+     */
+    const Config& getConfig() const;
+
+
+    // MARK: -- Cycle Methods
+
+    /**
+     * Sets the start of the data segment; accesses below it are not cached.
+     * @param addr The first data address
+     */
+    void setDataStart(Memory::addr_t addr);
+
+    /**
+     * Starts a core's part of a global cycle. Accesses are charged to it until the next call.
+     * @param core The core id
+     * @param cycle The global cycle
+     */
+    void beginCycle(size_t core, dword_t cycle);
+
+    /**
+     * Returns the bus counters.
+     * @return The counters
+     */
+    const Stats& getStats() const;
+
+    /**
+     * Empties every cache and clears every counter.
+     */
+    void reset();
+
+
+    // MARK: -- Observer Methods
+
+    /**
+     * Runs a read by the active core through its cache.
+     * @param addr The first address read
+     * @param size The number of bytes read
+     */
+    void onRead(word_t addr, size_t size) override;
+
+    /**
+     * Runs a write by the active core through its cache.
+     * @param addr The first address written
+     * @param size The number of bytes written
+     */
+    void onWrite(word_t addr, size_t size) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The geometry and latencies. */
+    Config m_config;
+
+    /** The caches, indexed by core. */
+    std::vector<std::unique_ptr<L1Cache>> m_vecCaches;
+
+    /** The first address that is cached. */
+    Memory::addr_t m_wDataStart;
+
+    /** The core the current accesses are charged to. */
+    size_t m_szActiveCore;
+
+    /** The current global cycle. */
+    dword_t m_dwCycle;
+
+    /** The (global) cycle the bus is next free. */
+    dword_t m_dwBusyUntil;
+
+    /** The bus counters. */
+    Stats m_stats;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Runs an access by the active core, one line at a time.
+     * @param addr The first address
+     * @param size The number of bytes
+     * @param write Whether or not the access is a write
+     */
+    void access(Memory::addr_t addr, size_t size, bool write);
+
+    /**
+     * Runs the part of an access that falls in one line.
+     * @param lineAddr The line address
+     * @param mask The bytes of the line accessed
+     * @param write Whether or not the access is a write
+     */
+    void accessLine(Memory::addr_t lineAddr, uint64_t mask, bool write);
+
+    /**
+     * Holds the bus for a transaction of the active core, charging the time it
+     * takes (waiting included) to the core as stall cycles.
+     * @param occupancy The cycles the transaction holds the bus for
+     */
+    void transact(dword_t occupancy);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ostream>
+
+#include "instr/input_feed.hpp"
+#include "memory/memory_device.hpp"
+#include "types.hpp"
+
+/**
+ * A console a program can talk to through loads and stores, rather than
+ * through system calls.
+ *
+ * The device has a single data register. Each store to it prints the low byte
+ * stored, and each load from it takes a character of console input (0xFF at
+ * the end of input) into the low byte.
+ */
+class ConsoleDevice : public MemoryDevice {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The offset of the data register. */
+    static constexpr word_t REG_DATA = 0;
+
+    /** The number of bytes the device takes up. */
+    static constexpr size_t SIZE = 4;
+
+    /** The number of cycles an access takes by default. */
+    static constexpr dword_t DEFAULT_LATENCY = 1;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param output The stream characters are printed to
+     * @param input The console input (not owned), or nullptr for none
+     * @param latency The number of cycles an access takes
+     */
+    ConsoleDevice(std::ostream& output, InputFeed * input, dword_t latency = DEFAULT_LATENCY);
+    ~ConsoleDevice() = default;
+
+
+    // MARK: -- Device Methods
+    bool read(word_t offset, byte_t * data, size_t size, dword_t& cycles) override;
+    bool write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The stream characters are printed to. */
+    std::ostream& m_output;
+
+    /** The console input (if any). */
+    InputFeed * m_ptrInput;
+
+    /** The number of cycles an access takes. */
+    dword_t m_dwLatency;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "memory/memory_device.hpp"
+#include "types.hpp"
+
+/**
+ * A DMA engine that copies a block of memory on behalf of a program.
+ *
+ * A program stores the source, destination and length into their registers
+ * (a byte at a time, if need be), then stores a non-zero byte into the
+ * control register to start the copy. The copy is done by the time the store
+ * finishes, and the store takes as many cycles as the copy would: a fixed
+ * setup cost, then a number of bytes per cycle. Reading the control register
+ * gives 0 once a copy is done, or STATUS_ERROR if it could not be done.
+ */
+class DmaDevice : public MemoryDevice {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The offset of the source address register. */
+    static constexpr word_t REG_SOURCE = 0;
+
+    /** The offset of the destination address register. */
+    static constexpr word_t REG_DEST = 4;
+
+    /** The offset of the length register (in bytes). */
+    static constexpr word_t REG_LENGTH = 8;
+
+    /** The offset of the control register. */
+    static constexpr word_t REG_CONTROL = 12;
+
+    /** The number of bytes the device takes up. */
+    static constexpr size_t SIZE = 16;
+
+    /** The control register's value after a copy that could not be done. */
+    static constexpr byte_t STATUS_ERROR = 2;
+
+    /** The number of cycles to set up a copy by default. */
+    static constexpr dword_t DEFAULT_SETUP_CYCLES = 8;
+
+    /** The number of bytes copied per cycle by default. */
+    static constexpr dword_t DEFAULT_BYTES_PER_CYCLE = 4;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument for 0 bytes per cycle.
+     * @param memory The memory to copy within (which must outlive us)
+     * @param setupCycles The number of cycles to set up a copy
+     * @param bytesPerCycle The number of bytes copied per cycle
+     */
+    DmaDevice(Memory& memory, dword_t setupCycles = DEFAULT_SETUP_CYCLES, dword_t bytesPerCycle = DEFAULT_BYTES_PER_CYCLE);
+    ~DmaDevice() = default;
+
+
+    // MARK: -- Device Methods
+    bool read(word_t offset, byte_t * data, size_t size, dword_t& cycles) override;
+    bool write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The memory to copy within. */
+    Memory& m_memory;
+
+    /** The number of cycles to set up a copy. */
+    dword_t m_dwSetupCycles;
+
+    /** The number of bytes copied per cycle. */
+    dword_t m_dwBytesPerCycle;
+
+    /** The registers, little-endian. */
+    std::array<byte_t, SIZE> m_arrRegisters;
+
+    /** Whether a copy is running (so a copy onto our own registers cannot start another). */
+    bool m_bBusy;
+
+    /** A buffer for the bytes being copied. */
+    std::vector<byte_t> m_vecScratch;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Returns the word in a register.
+     * @param reg The offset of the register
+     * @return The value
+     */
+    word_t readRegister(word_t reg) const;
+
+    /**
+     * Does the copy the registers describe.
+     * @return The number of cycles the copy takes
+     */
+    dword_t runCopy();
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * The MESI state of a cache line.
+ */
+enum class MesiState: uint8_t {
+    INVALID = 0,
+    SHARED,
+    EXCLUSIVE,
+    MODIFIED
+};
+
+/**
+ * Returns the single letter name of a MESI state.
+ * @param state The state
+ * @return The name (I, S, E or M)
+ */
+const char * getMesiStateName(MesiState state);
+
+/**
+ * The tags and states of a private, set associative L1 data cache.
+ *
+ * Caches here only model timing and coherence: the data itself always lives
+ * in the shared Memory, which every access still goes through. A cache only
+ * remembers which lines it holds, in which MESI state, and which bytes of each
+ * line it has touched since filling it. It also remembers, for each line taken
+ * away from it by another core, which bytes other cores have written since, so
+ * the miss that brings the line back can be told apart as true or false
+ * sharing. The protocol itself is run by the CoherenceBus.
+ */
+class L1Cache {
+public:
+
+    // MARK: -- Public Types
+
+    /** A line of the cache. */
+    struct Line {
+
+        /** The address of the first byte of the line. */
+        Memory::addr_t wAddress = 0;
+
+        /** The MESI state. */
+        MesiState state = MesiState::INVALID;
+
+        /** The bytes touched since the line was filled, one bit per byte. */
+        uint64_t dwAccessed = 0;
+
+        /** When the line was last used, for LRU replacement. */
+        dword_t dwLastUsed = 0;
+    };
+
+    /** The per-core counters. */
+    struct Stats {
+
+        /** The number of reads. */
+        dword_t dwReads = 0;
+
+        /** The number of writes. */
+        dword_t dwWrites = 0;
+
+        /** The number of accesses that found their line valid. */
+        dword_t dwHits = 0;
+
+        /** The number of accesses that did not. */
+        dword_t dwMisses = 0;
+
+        /** The misses on lines another core had taken away from us. */
+        dword_t dwCoherenceMisses = 0;
+
+        /** The coherence misses that touch bytes another core wrote. */
+        dword_t dwTrueSharingMisses = 0;
+
+        /** The coherence misses that only touch bytes no other core wrote. */
+        dword_t dwFalseSharingMisses = 0;
+
+        /** The number of our lines invalidated by other cores. */
+        dword_t dwInvalidationsReceived = 0;
+
+        /** The number of lines in other caches our writes invalidated. */
+        dword_t dwInvalidationsSent = 0;
+
+        /** The number of modified lines written back to memory. */
+        dword_t dwWriteBacks = 0;
+
+        /** The number of bus transactions we started. */
+        dword_t dwBusTransactions = 0;
+
+        /** The cycles spent waiting on the cache and bus beyond a hit. */
+        dword_t dwStallCycles = 0;
+    };
+
+
+    // MARK: -- Public Constants
+
+    /** The largest line size, so a line's bytes fit in one mask. */
+    static constexpr size_t MAX_LINE_SIZE = 64;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument if the geometry is not valid.
+     * @param lineSize The line size in bytes (a power of two, at most MAX_LINE_SIZE)
+     * @param numSets The number of sets (a power of two)
+     * @param numWays The number of lines in each set
+     */
+    L1Cache(size_t lineSize, size_t numSets, size_t numWays);
+    ~L1Cache() = default;
+
+
+    // MARK: -- Line Methods
+
+    /**
+     * Returns the address of the line holding an address.
+     * @param addr The address
+     * @return The address of the first byte of its line
+     */
+    Memory::addr_t getLineAddress(Memory::addr_t addr) const;
+
+    /**
+     * Returns the line size.
+     * @return The line size in bytes
+     */
+    size_t getLineSize() const;
+
+    /**
+     * Finds a valid line.
+     * @param lineAddr The line address
+     * @return The line, or nullptr if we do not hold it
+     */
+    Line * find(Memory::addr_t lineAddr);
+
+    /**
+     * Finds a valid line for another core's request, without counting it as a use.
+     * @param lineAddr The line address
+     * @return The line, or nullptr if we do not hold it
+     */
+    Line * snoop(Memory::addr_t lineAddr);
+
+    /**
+     * Returns the state we hold a line in.
+     * @param addr Any address in the line
+     * @return The state (INVALID if we do not hold it)
+     */
+    MesiState getState(Memory::addr_t addr) const;
+
+    /**
+     * Makes room for a line, evicting the least recently used line of its set if needed.
+     * @param lineAddr The line address
+     * @param evicted A placeholder for the state of the evicted line (INVALID if none)
+     * @return The (now empty) line to fill
+     */
+    Line& allocate(Memory::addr_t lineAddr, MesiState& evicted);
+
+    /**
+     * Invalidates a line because another core is writing it.
+     * @param line The line
+     * @param written The bytes the other core is writing
+     */
+    void invalidate(Line& line, uint64_t written);
+
+
+    // MARK: -- Sharing Methods
+
+    /**
+     * Notes bytes another core wrote, if they are in a line taken away from us.
+     * @param lineAddr The line address
+     * @param written The bytes written
+     */
+    void noteRemoteWrite(Memory::addr_t lineAddr, uint64_t written);
+
+    /**
+     * Forgets a line taken away from us, returning which bytes other cores wrote since.
+     * @param lineAddr The line address
+     * @param written A placeholder for the bytes written
+     * @return Whether or not another core had taken the line away from us
+     */
+    bool takeInvalidation(Memory::addr_t lineAddr, uint64_t& written);
+
+
+    // MARK: -- Stats Methods
+
+    /**
+     * Returns the counters.
+     * @return The counters
+     */
+    Stats& getStats();
+    const Stats& getStats() const;
+
+    /**
+     * Empties the cache and clears the counters.
+     */
+    void reset();
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The line size in bytes. */
+    size_t m_szLineSize;
+
+    /** The number of sets. */
+    size_t m_szSets;
+
+    /** The number of lines in each set. */
+    size_t m_szWays;
+
+    /** The lines, set by set. */
+    std::vector<Line> m_vecLines;
+
+    /** The bytes written by other cores to each line they took away from us. */
+    std::unordered_map<Memory::addr_t, uint64_t> m_mapInvalidated;
+
+    /** A counter of accesses, for LRU replacement. */
+    dword_t m_dwTick;
+
+    /** The counters. */
+    Stats m_stats;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Returns the first line of the set holding a line address.
+     * @param lineAddr The line address
+     * @return The index of the first line of the set
+     */
+    size_t getSetIndex(Memory::addr_t lineAddr) const;
+};
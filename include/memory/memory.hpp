@@ -1,10 +1,16 @@
 #pragma once
 
 #include "types.hpp"
+#include "memory/memory_device.hpp"
+#include "memory/memory_observer.hpp"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -15,6 +21,56 @@ public:
 
     // MARK: -- Typedefs
     using addr_t = word_t;                  // An address reference    
+    using journal_t = std::vector<std::pair<addr_t, byte_t>>;  // Bytes written, in order
+    using page_t = std::shared_ptr<const std::vector<byte_t>>;  // A page of a snapshot (shared, never written)
+
+
+    // MARK: -- Public Types
+
+    /**
+     * A copy of memory at some point in a run. Pages no one wrote between two
+     * snapshots are shared between them instead of being copied again.
+     */
+    struct Snapshot {
+
+        /** The data segment size (in bytes). */
+        size_t szDataSegment = 0;
+
+        /** The text segment size (in bytes). */
+        size_t szTextSegment = 0;
+
+        /** The pages, each PAGE_SIZE bytes (the last padded with zeroes). */
+        std::vector<page_t> vecPages;
+    };
+
+    /** The accesses a watchpoint stops on. */
+    enum class WatchKind {
+        READ = 1,                           // Reads only
+        WRITE = 2,                          // Writes only
+        ACCESS = 3                          // Reads and writes
+    };
+
+    /** An access that touched a watchpoint. */
+    struct WatchHit {
+
+        /** The first address accessed. */
+        addr_t wAddress = 0;
+
+        /** The number of bytes accessed. */
+        size_t szSize = 0;
+
+        /** Whether the access was a write (rather than a read). */
+        bool bWrite = false;
+
+        /** The first (up to) 4 bytes accessed, before the access. */
+        word_t wOldValue = 0;
+
+        /** The first (up to) 4 bytes accessed, after the access. */
+        word_t wNewValue = 0;
+    };
+
+    /** Told about every access that touches a watchpoint. */
+    using watch_fn_t = std::function<void(const WatchHit&)>;
 
 
     // MARK: -- Public Constants
@@ -22,6 +78,15 @@ public:
     /** The start of the userland memory section. */
     static constexpr addr_t MEM_USER_START = 0x1000;
 
+    /** The size of a page, the granularity snapshots are copied at. */
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    /** The start of the MMIO region devices are mapped into (memory never grows into it). */
+    static constexpr addr_t MMIO_START = 0xFFFF0000;
+
+    /** The number of pages in the MMIO region. */
+    static constexpr size_t MMIO_PAGES = 16;
+
 
     // MARK: -- Initialisation
     Memory(size_t dataSize, size_t textSize);
@@ -38,6 +103,15 @@ public:
      */
     bool readByte(addr_t addr, byte_t& byte) const;
 
+    /**
+     * Reads a block of bytes starting at an address in a single copy.
+     * @param addr The address to read from
+     * @param data A buffer of at least size bytes to read into
+     * @param size The number of bytes to read
+     * @return Whether or not the read was successful (nothing is read on failure)
+     */
+    bool readBlock(addr_t addr, byte_t * data, size_t size) const;
+
     /**
      * Reads a string starting at an address until it reaches a null terminator,
      * byte boundary, or runs out of memory.
@@ -63,6 +137,15 @@ public:
      */
     bool writeByte(addr_t addr, byte_t byte);
 
+    /**
+     * Writes a block of bytes starting at an address in a single copy.
+     * @param addr The address to write to
+     * @param data The bytes to write
+     * @param size The number of bytes to write
+     * @return Whether or not the write was successful (nothing is written on failure)
+     */
+    bool writeBlock(addr_t addr, const byte_t * data, size_t size);
+
     /**
      * Writes a string to an address.
      * @param addr The address to write to
@@ -79,6 +162,16 @@ public:
      */
     bool writeWord(addr_t addr, word_t word);
 
+    /**
+     * Swaps the word at an address without telling the journal, undo log, observer
+     * or watchpoints, e.g. to plant a breakpoint in the text segment.
+     * @param addr The address to write to
+     * @param word The word to write
+     * @param old A placeholder for the word that was there
+     * @return Whether or not the write was successful
+     */
+    bool patchWord(addr_t addr, word_t word, word_t& old);
+
 
     // MARK: -- Size Methods
 
@@ -100,6 +193,140 @@ public:
      */
     size_t getTotalSize() const;
 
+    /**
+     * Returns the number of writes that have landed in the text segment, so
+     * anything decoded from it can tell when it has gone stale.
+     * @return The number of writes
+     */
+    dword_t getTextWrites() const;
+
+    /**
+     * Returns the number of writes memory has taken anywhere, so anything
+     * watching for progress can tell memory has changed without comparing it.
+     * @return The number of writes
+     */
+    dword_t getWriteGeneration() const;
+
+    /**
+     * Grows the data segment by a number of bytes. The new bytes are placed at
+     * the end of memory and are zeroed.
+     * @param bytes The number of bytes to grow by
+     * @return Whether or not the data segment could be grown
+     */
+    bool growData(size_t bytes);
+
+    /**
+     * Grows the text segment by a number of bytes. The new bytes are placed at
+     * the end of the text segment and are zeroed, which moves the data segment
+     * (and anything in it) up by the same amount.
+     * @param bytes The number of bytes to grow by
+     * @return Whether or not the text segment could be grown
+     */
+    bool growText(size_t bytes);
+
+
+    // MARK: -- Journal Methods
+
+    /**
+     * Starts (or stops) recording every byte written into a journal, so the
+     * writes can be replayed onto another copy of memory.
+     * @param journal The journal to append to, or nullptr to stop recording
+     */
+    void setJournal(journal_t * journal);
+
+    /**
+     * Replays a journal from another copy of memory, growing the data segment if
+     * the other copy had grown it. Nothing is recorded into our own journal.
+     * @param journal The journal
+     * @return Whether or not every write could be replayed
+     */
+    bool applyJournal(const journal_t& journal);
+
+    /**
+     * Starts (or stops) recording the old value of every byte before it is
+     * written, so the writes can be undone by applying the log in reverse.
+     * @param log The log to append to, or nullptr to stop recording
+     */
+    void setUndoLog(journal_t * log);
+
+
+    // MARK: -- Snapshot Methods
+
+    /**
+     * Takes a snapshot. Only pages written since the last snapshot was taken,
+     * restored or matched are copied; the rest are shared with that snapshot.
+     * @param snapshot A placeholder for the snapshot
+     */
+    void takeSnapshot(Snapshot& snapshot);
+
+    /**
+     * Restores a snapshot. Memory grown since is kept, but zeroed.
+     * @param snapshot The snapshot
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
+
+    /**
+     * Notes that memory matches a snapshot again (e.g. after re-running up to
+     * the point it was taken), so the next snapshot can share its pages.
+     * @param snapshot The snapshot
+     */
+    void matchSnapshot(const Snapshot& snapshot);
+
+
+    // MARK: -- Watchpoint Methods
+
+    /**
+     * Watches a range of addresses. Pages holding a watched address are marked,
+     * and accesses to other pages are never checked against the watchpoints.
+     * @param addr The first address to watch
+     * @param size The number of bytes to watch
+     * @param kind The accesses to report
+     * @return Whether or not the range could be watched (it must be in memory)
+     */
+    bool addWatchpoint(addr_t addr, size_t size, WatchKind kind);
+
+    /**
+     * Stops watching the range starting at an address.
+     * @param addr The first address of the range
+     * @return Whether or not a watchpoint started there
+     */
+    bool removeWatchpoint(addr_t addr);
+
+    /**
+     * Sets the function told about accesses that touch a watchpoint.
+     * @param handler The function, or nullptr for none
+     */
+    void setWatchHandler(watch_fn_t handler);
+
+
+    // MARK: -- Device Methods
+
+    /**
+     * Maps a device into the MMIO region. Accesses to it are dispatched through a
+     * table with an entry per MMIO page, and only once an address is found to lie
+     * outside memory, so ordinary accesses never look at it.
+     * @param addr The first address of the device (on a page boundary)
+     * @param size The number of bytes the device takes up
+     * @param device The device
+     * @return Whether or not the device could be mapped (its pages must be in the region, and free)
+     */
+    bool mapDevice(addr_t addr, size_t size, std::shared_ptr<MemoryDevice> device);
+
+    /**
+     * Returns the number of cycles device accesses have taken.
+     * @return The number of cycles
+     */
+    dword_t getDeviceCycles() const;
+
+
+    // MARK: -- Observer Methods
+
+    /**
+     * Sets the observer told about every successful read and write.
+     * @param observer The observer (not owned), or nullptr for none
+     */
+    void setObserver(MemoryObserver * observer);
+
 private:
 
     // MARK: -- Private Variables
@@ -110,6 +337,42 @@ private:
     // Segment Sizes
     size_t m_szDataSegment;                 // The data segment size (in bytes)
     size_t m_szTextSegment;                 // The text segment size (in bytes)
+    dword_t m_dwTextWrites;                 // The writes that have landed in the text segment
+    dword_t m_dwWriteGeneration;            // The writes that have landed anywhere
+
+    // Journal
+    journal_t * m_ptrJournal;               // The journal writes are recorded into (if any)
+
+    // Undo Log
+    journal_t * m_ptrUndoLog;               // The log old bytes are recorded into (if any)
+
+    // Observer
+    MemoryObserver * m_ptrObserver;         // The observer of every access (if any)
+
+    // Snapshots
+    bool m_bTrackPages;                     // Whether written pages are tracked (once a snapshot is taken)
+    std::vector<bool> m_vecDirtyPages;      // The pages written since the last snapshot
+    std::vector<page_t> m_vecSnapshotPages; // The pages of the last snapshot
+
+    // Watchpoints
+    struct Watchpoint {
+        addr_t wAddress;                    // The first address watched
+        size_t szSize;                      // The number of bytes watched
+        WatchKind kind;                     // The accesses reported
+    };
+    bool m_bWatching;                       // Whether any watchpoint is set
+    std::vector<Watchpoint> m_vecWatchpoints; // The watchpoints
+    std::vector<bool> m_vecWatchedPages;    // The pages holding a watched address
+    watch_fn_t m_fnWatchHandler;            // Told about accesses that touch a watchpoint
+
+    // Devices
+    struct DeviceMapping {
+        MemoryDevice * ptrDevice;           // The device (if any)
+        addr_t wBase;                       // The first address of the device
+    };
+    std::array<DeviceMapping, MMIO_PAGES> m_arrDevices;  // The device on each MMIO page
+    std::vector<std::shared_ptr<MemoryDevice>> m_vecDevices;  // The devices mapped (owned)
+    mutable dword_t m_dwDeviceCycles;       // The cycles device accesses have taken
 
     
     // MARK: -- Private Methods
@@ -123,4 +386,84 @@ private:
      *          address that exceeds expected size
      */
     std::vector<byte_t>::size_type addressToOffset(addr_t addr, size_t expSize = 1) const;
+
+    /**
+     * Tells the observer and journal (if any) about bytes that were just written.
+     * @param offset The offset of the first byte
+     * @param size The number of bytes
+     */
+    void recordWrite(std::vector<byte_t>::size_type offset, size_t size);
+
+    /**
+     * Records the old value of bytes that are about to be written into the undo log.
+     * @param offset The offset of the first byte
+     * @param size The number of bytes
+     */
+    void recordUndo(std::vector<byte_t>::size_type offset, size_t size);
+
+    /**
+     * Marks the pages holding a range of bytes as written.
+     * @param offset The offset of the first byte
+     * @param size The number of bytes
+     */
+    void markDirty(std::vector<byte_t>::size_type offset, size_t size);
+
+    /**
+     * Remembers a snapshot as the one memory last matched.
+     * @param snapshot The snapshot
+     */
+    void setSnapshotPages(const Snapshot& snapshot);
+
+    /**
+     * Returns whether an access touches a watchpoint of a kind.
+     * @param offset The offset of the first byte
+     * @param size The number of bytes
+     * @param kind The kind of access
+     * @return Whether or not a watchpoint was touched
+     */
+    bool checkWatch(std::vector<byte_t>::size_type offset, size_t size, WatchKind kind) const;
+
+    /**
+     * Tells the watch handler (if any) about an access that touched a watchpoint.
+     * @param offset The offset of the first byte
+     * @param size The number of bytes
+     * @param write Whether the access was a write
+     * @param old The first (up to) 4 bytes accessed, before the access
+     */
+    void reportWatch(std::vector<byte_t>::size_type offset, size_t size, bool write, word_t old) const;
+
+    /**
+     * Returns the first (up to) 4 bytes of a range as a little-endian word.
+     * @param offset The offset of the first byte
+     * @param size The number of bytes
+     * @return The value
+     */
+    word_t valueAt(std::vector<byte_t>::size_type offset, size_t size) const;
+
+    /**
+     * Finds the device mapped over a range of addresses.
+     * @param addr The first address
+     * @param size The number of bytes
+     * @param offset A placeholder for the offset of the first address into the device
+     * @return The device, or nullptr if no single device covers the range
+     */
+    MemoryDevice * findDevice(addr_t addr, size_t size, word_t& offset) const;
+
+    /**
+     * Reads bytes from the device mapped at an address.
+     * @param addr The first address
+     * @param data A buffer of at least size bytes to read into
+     * @param size The number of bytes
+     * @return Whether or not a device was read
+     */
+    bool readDevice(addr_t addr, byte_t * data, size_t size) const;
+
+    /**
+     * Writes bytes to the device mapped at an address.
+     * @param addr The first address
+     * @param data The bytes to write
+     * @param size The number of bytes
+     * @return Whether or not a device was written
+     */
+    bool writeDevice(addr_t addr, const byte_t * data, size_t size);
 };
\ No newline at end of file
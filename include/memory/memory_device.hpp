@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+#include "types.hpp"
+
+/**
+ * A device mapped into the MMIO region of a Memory.
+ *
+ * Guest loads and stores to the device's range are handed to it instead of
+ * memory, at offsets from the start of the range. Each access reports how many
+ * cycles it takes, so device latency can be modelled. Device accesses are not
+ * memory: they are never journalled, undone, snapshotted, watched or observed.
+ */
+class MemoryDevice {
+public:
+
+    // MARK: -- Construction
+    virtual ~MemoryDevice() = default;
+
+
+    // MARK: -- Device Methods
+
+    /**
+     * Reads bytes from the device.
+     * @param offset The offset of the first byte from the start of the device's range
+     * @param data A buffer of at least size bytes to read into
+     * @param size The number of bytes to read
+     * @param cycles A placeholder for the number of cycles the read takes
+     * @return Whether or not the device could be read there
+     */
+    virtual bool read(word_t offset, byte_t * data, size_t size, dword_t& cycles) = 0;
+
+    /**
+     * Writes bytes to the device.
+     * @param offset The offset of the first byte from the start of the device's range
+     * @param data The bytes to write
+     * @param size The number of bytes to write
+     * @param cycles A placeholder for the number of cycles the write takes
+     * @return Whether or not the device could be written there
+     */
+    virtual bool write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) = 0;
+};
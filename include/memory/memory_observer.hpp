@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+#include "types.hpp"
+
+/**
+ * Watches the accesses made to a Memory, e.g. to model caches in front of it.
+ *
+ * Observers are only told about accesses that succeeded, after the data has
+ * been read or written, and cannot change the outcome.
+ */
+class MemoryObserver {
+public:
+
+    // MARK: -- Construction
+    virtual ~MemoryObserver() = default;
+
+
+    // MARK: -- Observer Methods
+
+    /**
+     * Called after bytes have been read.
+     * @param addr The first address read
+     * @param size The number of bytes read
+     */
+    virtual void onRead(word_t addr, size_t size) = 0;
+
+    /**
+     * Called after bytes have been written.
+     * @param addr The first address written
+     * @param size The number of bytes written
+     */
+    virtual void onWrite(word_t addr, size_t size) = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "memory/memory_device.hpp"
+#include "types.hpp"
+
+/**
+ * A read-only timer counting the clock cycles of a run.
+ *
+ * The 64-bit count is read a word (or byte) at a time, low word first, from
+ * the simulator's own cycle counter, so reading it costs nothing per cycle.
+ */
+class TimerDevice : public MemoryDevice {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The offset of the low word of the cycle count. */
+    static constexpr word_t REG_CYCLES_LO = 0;
+
+    /** The offset of the high word of the cycle count. */
+    static constexpr word_t REG_CYCLES_HI = 4;
+
+    /** The number of bytes the device takes up. */
+    static constexpr size_t SIZE = 8;
+
+    /** The number of cycles an access takes by default. */
+    static constexpr dword_t DEFAULT_LATENCY = 1;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param latency The number of cycles an access takes
+     */
+    TimerDevice(dword_t latency = DEFAULT_LATENCY);
+    ~TimerDevice() = default;
+
+
+    // MARK: -- Clock Methods
+
+    /**
+     * Sets the cycle counter the timer reads, e.g. a simulator's statistics.
+     * @param clock The counter (not owned), or nullptr to always read 0
+     */
+    void setClock(const dword_t * clock);
+
+
+    // MARK: -- Device Methods
+    bool read(word_t offset, byte_t * data, size_t size, dword_t& cycles) override;
+    bool write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The cycle counter (if any). */
+    const dword_t * m_ptrClock;
+
+    /** The number of cycles an access takes. */
+    dword_t m_dwLatency;
+};
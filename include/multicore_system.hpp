@@ -0,0 +1,242 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "instr/handlers/syscall_handler.hpp"
+#include "memory/coherence_bus.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/livelock_detector.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+/**
+ * A guest system of several cores sharing one memory.
+ *
+ * Each core is a full Simulator with its own register bank, pipeline and
+ * instruction set (so its own system call handler, which tells the core its id
+ * through the core id call), and starts at its own entry point. A global clock
+ * steps every core that is still running once per cycle, in core order, so
+ * a run is always the same from one time to the next.
+ *
+ * With a quantum of 0, every core works directly on the shared memory, and a
+ * store is seen by higher cores in the same cycle. With a quantum of N, each
+ * core instead works on its own copy of memory for N cycles at a time, and the
+ * stores of every core are committed (in core order, so the last core wins any
+ * conflict) to the shared memory and to every other copy at each quantum
+ * boundary. Cores then only see each other's stores up to N cycles late, but
+ * they no longer share anything while they run, so each can run on its own
+ * host thread. A run with a given quantum gives the same result whether or not
+ * it is run in parallel.
+ *
+ * Lockstep runs can also model a private L1 data cache per core, kept coherent
+ * by a snooping MESI bus (see CoherenceBus), to count coherence traffic and
+ * false sharing and estimate what they cost.
+ *
+ * A cycle limit stops every core on the same global cycle. Livelocks are
+ * watched for across the whole system, whenever every core sees the same
+ * memory (each cycle in lockstep, or each quantum): a core spinning on a flag
+ * another core has yet to set is not stuck, so the system only stops once
+ * every running core has come back to a state it was in on the same cycle.
+ */
+class MulticoreSystem {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param memory The memory every core shares (already loaded)
+     * @param quantum The number of cycles between synchronisations (0 to run in lockstep)
+     */
+    MulticoreSystem(std::shared_ptr<Memory> memory, dword_t quantum = 0);
+
+    /**
+     * Destructor. Stops the shared memory reporting to our caches.
+     */
+    ~MulticoreSystem();
+
+
+    // MARK: -- Core Methods
+
+    /**
+     * Adds a core. Its id is the number of cores added before it.
+     * @param entry The address the core starts at
+     * @param syscallHandler The (already configured) system call handler, or nullptr for a default one
+     * @return The id of the new core
+     */
+    size_t addCore(Memory::addr_t entry, std::unique_ptr<SyscallHandler> syscallHandler = nullptr);
+
+    /**
+     * Returns the number of cores.
+     * @return The number of cores
+     */
+    size_t getNumCores() const;
+
+    /**
+     * Returns a core.
+     * @param core The core id
+     * @return The core
+     */
+    Simulator& getCore(size_t core);
+
+    /**
+     * Returns a core's register bank.
+     * @param core The core id
+     * @return The register bank
+     */
+    RegisterBank& getRegisterBank(size_t core);
+
+
+    // MARK: -- Execution Methods
+
+    /**
+     * Runs every core until they have all exited. With a quantum and parallel
+     * execution enabled, each core runs on its own host thread.
+     */
+    void run();
+
+    /**
+     * Resets every core, ready to step through a run.
+     */
+    void reset();
+
+    /**
+     * Runs a single global clock cycle, stepping every core that is still running.
+     * @return Whether or not any core is still running afterwards
+     */
+    bool step();
+
+    /**
+     * Returns the number of global clock cycles run (those of the longest running core).
+     * @return The number of cycles
+     */
+    dword_t getClockCycles() const;
+
+    /**
+     * Sets the most global cycles a run may take before every core stops for good.
+     * @param limit The cycle limit (0 for none)
+     */
+    void setCycleLimit(dword_t limit);
+
+    /**
+     * Sets whether or not a run where every core livelocks at once stops for good.
+     * @param detect Whether or not to watch for livelocks
+     */
+    void setLivelockDetection(bool detect);
+
+    /**
+     * Returns why the last run stopped early, if it did: a StopReason::CYCLE_LIMIT
+     * or StopReason::LIVELOCK stop, with the program counter of the first core still running.
+     * @return The stop (StopReason::NONE if every core exited)
+     */
+    const SimulatorStop& getStop() const;
+
+
+    // MARK: -- Quantum Methods
+
+    /**
+     * Returns the number of cycles between synchronisations.
+     * @return The quantum (0 when running in lockstep)
+     */
+    dword_t getQuantum() const;
+
+    /**
+     * Sets whether run() uses one host thread per core. Only used with a quantum.
+     * @param parallel Whether or not to run in parallel (the default)
+     */
+    void setParallel(bool parallel);
+
+    /**
+     * Returns whether run() uses one host thread per core.
+     * @return Whether or not runs are parallel
+     */
+    bool isParallel() const;
+
+    /**
+     * Commits the stores made by every core since the last synchronisation to
+     * the shared memory and every other core. Does nothing without a quantum.
+     */
+    void synchronise();
+
+
+    // MARK: -- Cache Methods
+
+    /**
+     * Gives every core (including those added later) a private L1 data cache,
+     * kept coherent over a snooping bus. Only works in lockstep (without a quantum).
+     * @param config The geometry and latencies of the caches and bus
+     * @return Whether or not the caches were enabled
+     */
+    bool enableCaches(const CoherenceBus::Config& config = CoherenceBus::Config());
+
+    /**
+     * Returns the coherence bus.
+     * @return The bus, or nullptr if caches are not enabled
+     */
+    const CoherenceBus * getBus() const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The memory every core shares. */
+    std::shared_ptr<Memory> m_memory;
+
+    /** The number of cycles between synchronisations (0 for lockstep). */
+    dword_t m_dwQuantum;
+
+    /** Whether or not run() uses one host thread per core. */
+    bool m_bParallel;
+
+    /** The private copies of memory of the cores, indexed by id (only with a quantum). */
+    std::vector<std::shared_ptr<Memory>> m_vecReplicas;
+
+    /** The stores made by each core since the last synchronisation (only with a quantum). */
+    std::vector<std::unique_ptr<Memory::journal_t>> m_vecJournals;
+
+    /** The number of cycles run since the last synchronisation. */
+    dword_t m_dwSinceSync;
+
+    /** The bus keeping the caches of the cores coherent (if enabled). */
+    std::unique_ptr<CoherenceBus> m_ptrBus;
+
+    /** The cores, indexed by id. */
+    std::vector<std::unique_ptr<Simulator>> m_vecCores;
+
+    /** The register banks of the cores (owned by the cores). */
+    std::vector<RegisterBank *> m_vecRegisterBanks;
+
+    /** The program break every core's system call handler shares. */
+    std::shared_ptr<SyscallHandler::heap_break_t> m_ptrHeapBreak;
+
+    /** The number of global clock cycles run. */
+    dword_t m_dwClockCycles;
+
+    /** The most global cycles a run may take (0 for no limit). */
+    dword_t m_dwCycleLimit;
+
+    /** Whether or not to watch for livelocks. */
+    bool m_bDetectLivelock;
+
+    /** Watches each core for a livelock, indexed by id. */
+    std::vector<LivelockDetector> m_vecLivelocks;
+
+    /** The livelock that stopped the last run, if any. */
+    SimulatorStop m_stop;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Runs every core on its own host thread, meeting at each quantum boundary.
+     */
+    void runParallel();
+
+    /**
+     * Checks every running core for a livelock, at a point where they all see the same memory.
+     * @return Whether or not every running core repeated a state on this cycle (stopping the run)
+     */
+    bool checkLivelock();
+};
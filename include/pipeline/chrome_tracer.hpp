@@ -0,0 +1,56 @@
+#pragma once
+
+#include "pipeline/pipeline_tracer.hpp"
+
+/**
+ * Writes the pipeline trace as Chrome trace events (chrome://tracing, Perfetto).
+ *
+ * Each stage is its own row, and each cycle an instruction spends in a stage is
+ * a one microsecond slice named after the instruction. Bubbles are named "nop"
+ * and forwarded operands show up as instant events on the EX row. The events are
+ * written as a bare JSON array, which the viewers accept even if the run is cut
+ * short before the closing bracket is written.
+ */
+class ChromeTracer : public PipelineTracer {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param startCycle The first cycle to record
+     * @param numCycles The number of cycles to record (0 to record until the end)
+     */
+    ChromeTracer(dword_t startCycle = 0, dword_t numCycles = 0);
+
+    /**
+     * Destructor. Finishes the trace.
+     */
+    ~ChromeTracer() override;
+
+protected:
+
+    // MARK: -- Protected Event Methods
+    void onOpen() override;
+    void onCycle(dword_t cycle) override;
+    void onIntroduce(dword_t cycle, const InFlight& instr) override;
+    void onStage(dword_t cycle, PipelineStage stage, const InFlight& instr) override;
+    void onForward(dword_t cycle, const InFlight& instr, sword_t reg, PipelineStage from, dword_t producer) override;
+    void onRetire(dword_t cycle, const InFlight& instr, bool flushed) override;
+    void onFinish() override;
+
+private:
+
+    // MARK: -- Private Methods
+
+    /**
+     * Starts a new event, separating it from the last one.
+     */
+    void beginEvent();
+
+
+    // MARK: -- Private Variables
+
+    /** Whether or not we have written an event yet. */
+    bool m_bFirstEvent;
+};
@@ -8,6 +8,9 @@
  */
 struct ExecutionBuffer {
 
+    /** The sequence number of the instruction in this buffer (in fetch order). */
+    dword_t dwSequence;
+
     /** The function. */
     word_t wFunct;
 
@@ -22,4 +25,7 @@ struct ExecutionBuffer {
 
     /** The value of the second register if applicable. */
     word_t wRegValue;
+
+    /** The address the instruction was fetched from. */
+    word_t wPC;
 };
\ No newline at end of file
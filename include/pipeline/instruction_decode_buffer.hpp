@@ -17,6 +17,9 @@
  */
 struct InstructionDecodeBuffer {
 
+    /** The sequence number of the instruction in this buffer (in fetch order). */
+    dword_t dwSequence;
+
     /** Whether or not to exit. */
     bool bExit;
 
@@ -43,4 +46,7 @@ struct InstructionDecodeBuffer {
 
     /** The value of the source RT register, if used (0 otherwise). */
     word_t wValSrc2;
+
+    /** The address the instruction was fetched from. */
+    word_t wPC;
 };
\ No newline at end of file
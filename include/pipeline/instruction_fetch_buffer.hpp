@@ -7,6 +7,12 @@
  */
 struct InstructionFetchBuffer { 
 
+    /** The sequence number of the instruction in this buffer (in fetch order). */
+    dword_t dwSequence;
+
     /** The read instruction. */
     word_t wInstruction;
+
+    /** The address the instruction was fetched from. */
+    word_t wPC;
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * The fetch stage's predictor for jumps through a register (JR and JALR),
+ * whose targets are not in the instruction.
+ *
+ * Calls (JAL and JALR) push their return address onto a return-address stack,
+ * and a return (JR $ra) pops it, so a return to the caller is predicted however
+ * many places call the function. The stack is a fixed ring: a call chain deeper
+ * than it loses its oldest return addresses, and a return with the stack empty
+ * falls back to the target table. Every other jump through a register is
+ * predicted to go where it last went, from a small table indexed by address.
+ */
+class JumpPredictor {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument for an empty stack, or a table
+     * size that is not a power of two.
+     * @param returnStackEntries The number of return addresses the stack holds
+     * @param indirectEntries The number of entries in the target table
+     */
+    JumpPredictor(size_t returnStackEntries, size_t indirectEntries);
+    ~JumpPredictor() = default;
+
+
+    // MARK: -- Prediction Methods
+
+    /**
+     * Pushes the return address of a call.
+     * @param addr The address after the call
+     */
+    void pushReturn(Memory::addr_t addr);
+
+    /**
+     * Predicts the target of a jump through a register.
+     * @param pc The address of the jump
+     * @param bReturn Whether or not the jump is a return (JR $ra), which pops the stack
+     * @return The predicted target (0 if nothing is known)
+     */
+    Memory::addr_t predict(Memory::addr_t pc, bool bReturn);
+
+    /**
+     * Records where a jump through a register went.
+     * @param pc The address of the jump
+     * @param target The address it went to
+     */
+    void update(Memory::addr_t pc, Memory::addr_t target);
+
+    /**
+     * Empties the stack and the target table.
+     */
+    void reset();
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The return-address stack, a ring whose newest entry is just below the top. */
+    std::vector<Memory::addr_t> m_vecReturnStack;
+
+    /** The index the next return address is pushed to. */
+    size_t m_szTop;
+
+    /** The number of return addresses on the stack. */
+    size_t m_szDepth;
+
+    /** The last target of each jump, indexed by address. */
+    std::vector<Memory::addr_t> m_vecTargets;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "pipeline/pipeline_tracer.hpp"
+
+/**
+ * Writes the pipeline trace as a Konata log (Kanata format, version 0004).
+ *
+ * Each instruction is its own row, labelled with its address and name, showing
+ * the stages it passed through over time. Forwarded operands are added to the
+ * instruction's hover text.
+ */
+class KonataTracer : public PipelineTracer {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param startCycle The first cycle to record
+     * @param numCycles The number of cycles to record (0 to record until the end)
+     */
+    KonataTracer(dword_t startCycle = 0, dword_t numCycles = 0);
+
+    /**
+     * Destructor. Finishes the trace.
+     */
+    ~KonataTracer() override;
+
+protected:
+
+    // MARK: -- Protected Event Methods
+    void onOpen() override;
+    void onCycle(dword_t cycle) override;
+    void onIntroduce(dword_t cycle, const InFlight& instr) override;
+    void onStage(dword_t cycle, PipelineStage stage, const InFlight& instr) override;
+    void onForward(dword_t cycle, const InFlight& instr, sword_t reg, PipelineStage from, dword_t producer) override;
+    void onRetire(dword_t cycle, const InFlight& instr, bool flushed) override;
+    void onFinish() override;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** Whether or not we have written a cycle yet. */
+    bool m_bStarted;
+
+    /** The last cycle we wrote. */
+    dword_t m_dwLastCycle;
+
+    /** The number of instructions retired so far (Konata numbers retirements). */
+    dword_t m_dwRetired;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "memory/memory.hpp"
+#include "registers/register_bank.hpp"
+#include "types.hpp"
+
+/**
+ * Watches a run for a livelock: the program coming back to exactly the same
+ * state (program counter, registers, and memory) with no system call in
+ * between. A run is deterministic between system calls, so from there it can
+ * only go around the same loop forever.
+ *
+ * Memory is not compared, only how many writes it has taken, so a loop that
+ * stores anything counts as making progress, even if it stores the same value.
+ *
+ * The state is saved on cycles 1, 2, 4, 8 and so on, and each cycle is checked
+ * against the last state saved. A loop of any length is caught within about
+ * twice its length (or twice the cycles before it starts, if that is longer).
+ * Most cycles cost a single comparison of the program counter; the registers
+ * are only compared when everything else already matches.
+ *
+ * Several cores sharing a memory use one detector each, checked on the same
+ * cycles: they save on the same cycles too, so when every core repeats on the
+ * same cycle, the whole system has come back to the state it was in.
+ */
+class LivelockDetector {
+public:
+
+    // MARK: -- Construction
+    LivelockDetector();
+    ~LivelockDetector() = default;
+
+
+    // MARK: -- Detection Methods
+
+    /**
+     * Checks the state at the end of a cycle against the last state saved,
+     * saving it instead on every power of two.
+     * @param cycle The number of cycles run so far
+     * @param pc The program counter
+     * @param registers The registers
+     * @param writes The number of writes memory has taken (including any still buffered)
+     * @param syscalls The number of system calls run so far
+     * @return Whether or not the state repeats the last one saved
+     */
+    bool check(dword_t cycle, Memory::addr_t pc, const RegisterBank& registers, dword_t writes, dword_t syscalls);
+
+    /**
+     * Returns the number of cycles between the repeated states, once check has found them.
+     * @return The length of the loop, in cycles
+     */
+    dword_t getPeriod() const;
+
+    /**
+     * Forgets the saved state, such as when the run goes back in time.
+     */
+    void reset();
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** Whether or not a state has been saved. */
+    bool m_bSaved;
+
+    /** The cycle the state was saved on. */
+    dword_t m_dwSavedCycle;
+
+    /** The cycle the state is next saved on. */
+    dword_t m_dwNextSave;
+
+    /** The saved program counter. */
+    Memory::addr_t m_wPC;
+
+    /** The saved registers. */
+    RegisterBank::registers_t m_arrRegisters;
+
+    /** The saved number of writes to memory. */
+    dword_t m_dwWrites;
+
+    /** The saved number of system calls. */
+    dword_t m_dwSyscalls;
+
+    /** The length of the loop found. */
+    dword_t m_dwPeriod;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "instr/instruction_handler.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "types.hpp"
+
+/**
+ * The load/store unit of the memory stage: every load and store (LB through
+ * SW) goes through it, rather than straight to its handler.
+ *
+ * The unit checks each access is aligned to its size, then keeps the last few
+ * stores in a small store buffer. A load whose bytes were all written by one
+ * buffered store counts as a forwarding hit. Stores are written through to
+ * memory as they happen, so memory, system calls and debuggers always see them
+ * in program order, and a forwarded load still reads the same bytes through
+ * memory, where watchpoints and observers see it; the buffer only decides
+ * which loads are forwarded. A store retires from the buffer on
+ * each cycle the memory stage has nothing else to do, and the whole buffer
+ * drains on a system call (which may write memory itself) or a store to a
+ * device (which may be a DMA engine writing memory).
+ *
+ * The buffer is a fixed array, so the unit copies cheaply with the rest of a
+ * simulator's state.
+ */
+class LoadStoreUnit {
+public:
+
+    // MARK: -- Public Types
+
+    /** The counts of accesses so far. */
+    struct Stats {
+
+        /** The number of loads. */
+        dword_t dwLoads = 0;
+
+        /** The number of stores. */
+        dword_t dwStores = 0;
+
+        /** The number of loads forwarded from the store buffer. */
+        dword_t dwForwards = 0;
+    };
+
+
+    // MARK: -- Public Constants
+
+    /** The number of stores the buffer holds. */
+    static constexpr size_t BUFFER_SIZE = 8;
+
+
+    // MARK: -- Construction
+    LoadStoreUnit();
+    ~LoadStoreUnit() = default;
+
+
+    // MARK: -- Access Methods
+
+    /**
+     * Returns whether an opcode is a load or a store.
+     * @param opcode The opcode
+     * @return Whether or not the unit handles it
+     */
+    static bool isLoadStore(word_t opcode);
+
+    /**
+     * Returns whether an opcode is a load.
+     * @param opcode The opcode
+     * @return Whether or not the opcode loads a register from memory
+     */
+    static bool isLoad(word_t opcode);
+
+    /**
+     * Does the memory stage of a load or store. A misaligned access is fatal.
+     * @param executionBuffer The execution buffer, with the address as its output
+     * @param handler The instruction's handler, which reads or writes memory for every access
+     * @param memory The memory
+     * @return The value loaded (extended to a word), or 0 for a store
+     */
+    word_t access(const ExecutionBuffer& executionBuffer, InstructionHandler& handler, Memory& memory);
+
+    /**
+     * Retires the oldest store in the buffer, if any.
+     */
+    void drain();
+
+    /**
+     * Retires every store in the buffer.
+     */
+    void flush();
+
+    /**
+     * Returns the number of stores in the buffer.
+     * @return The number of stores
+     */
+    size_t getBufferedStores() const;
+
+    /**
+     * Returns the counts of accesses so far.
+     * @return The statistics
+     */
+    const Stats& getStats() const;
+
+private:
+
+    // MARK: -- Private Types
+
+    /** A store in the buffer. */
+    struct Entry {
+
+        /** The first address written. */
+        Memory::addr_t wAddress;
+
+        /** The number of bytes written. */
+        size_t szSize;
+    };
+
+
+    // MARK: -- Private Variables
+
+    /** The buffered stores, a ring starting at the oldest. */
+    std::array<Entry, BUFFER_SIZE> m_arrEntries;
+
+    /** The index of the oldest store. */
+    size_t m_szHead;
+
+    /** The number of buffered stores. */
+    size_t m_szCount;
+
+    /** The counts of accesses so far. */
+    Stats m_stats;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Describes the access a load or store opcode makes.
+     * @param opcode The opcode
+     * @param size A placeholder for the number of bytes accessed
+     * @return Whether or not the opcode is a store
+     */
+    static bool describe(word_t opcode, size_t& size);
+
+    /**
+     * Returns whether a load would be forwarded: whether a buffered store holds every byte of it.
+     * @param addr The address of the load
+     * @param size The size of the load
+     * @return Whether or not the youngest store overlapping the load holds all of it
+     */
+    bool forward(Memory::addr_t addr, size_t size) const;
+};
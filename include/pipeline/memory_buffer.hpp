@@ -8,6 +8,9 @@
  */
 struct MemoryBuffer {
 
+    /** The sequence number of the instruction in this buffer (in fetch order). */
+    dword_t dwSequence;
+
     /** The function. */
     word_t wFunct;
 
@@ -19,4 +22,7 @@ struct MemoryBuffer {
 
     /** The destination register number. */
     word_t wRegDest;
+
+    /** The address the instruction was fetched from. */
+    word_t wPC;
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "types.hpp"
+
+/**
+ * The timing of the multiply/divide unit, which runs MULT, MULTU, DIV and DIVU
+ * beside the pipeline and leaves its result in HI and LO.
+ *
+ * The results themselves are computed by the instructions' handlers; the unit
+ * only keeps track of when they would be ready. A multiply or divide holds the
+ * unit for its latency (a pipelined multiplier takes a new multiply every
+ * cycle, but a divide never shares), and an MFHI, MFLO, MTHI or MTLO issued
+ * before the result is ready stalls until it is. Issuing returns the stall, so
+ * the caller decides what the stall costs.
+ *
+ * The unit holds no more than a few counters, so it copies cheaply with the
+ * rest of a simulator's state.
+ */
+class MultiplyDivideUnit {
+public:
+
+    // MARK: -- Public Types
+
+    /** The latencies of the unit. */
+    struct Config {
+
+        /** The cycles after a multiply issues until HI and LO hold its result. */
+        dword_t dwMultiplyLatency = 4;
+
+        /** The cycles after a divide issues until HI and LO hold its result. */
+        dword_t dwDivideLatency = 32;
+
+        /** Whether or not a multiply can issue on the cycle after another. */
+        bool bPipelinedMultiply = true;
+    };
+
+    /** The counts of operations so far. */
+    struct Stats {
+
+        /** The number of multiplies. */
+        dword_t dwMultiplies = 0;
+
+        /** The number of divides. */
+        dword_t dwDivides = 0;
+
+        /** The number of cycles instructions waited on the unit. */
+        dword_t dwStalls = 0;
+    };
+
+
+    // MARK: -- Construction
+    MultiplyDivideUnit();
+
+    /**
+     * Constructor. Throws std::invalid_argument for a latency of 0.
+     * @param config The latencies
+     */
+    explicit MultiplyDivideUnit(const Config& config);
+    ~MultiplyDivideUnit() = default;
+
+
+    // MARK: -- Issue Methods
+
+    /**
+     * Returns whether an R-Type funct uses the unit (MFHI through DIVU).
+     * @param funct The funct
+     * @return Whether or not the unit handles it
+     */
+    static bool isMultiplyDivide(word_t funct);
+
+    /**
+     * Issues an instruction to the unit.
+     * @param funct The instruction's funct
+     * @param cycle The cycle the instruction would issue, were there no stall
+     * @return The number of cycles the instruction stalls
+     */
+    dword_t issue(word_t funct, dword_t cycle);
+
+    /**
+     * Returns the latencies of the unit.
+     * @return The configuration
+     */
+    const Config& getConfig() const;
+
+    /**
+     * Returns the counts of operations so far.
+     * @return The statistics
+     */
+    const Stats& getStats() const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The latencies of the unit. */
+    Config m_config;
+
+    /** The cycle HI and LO hold the last result. */
+    dword_t m_dwReady;
+
+    /** The cycle the unit can take another multiply or divide. */
+    dword_t m_dwFree;
+
+    /** The counts of operations so far. */
+    Stats m_stats;
+};
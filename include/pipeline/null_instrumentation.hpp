@@ -0,0 +1,33 @@
+#pragma once
+
+#include "instr/instruction_set.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_fetch_buffer.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "types.hpp"
+
+/**
+ * The instrumentation policy for production runs: every hook is an empty
+ * inline function, so the simulator instantiated with it compiles the hooks
+ * (and anything only computed for them) away completely.
+ *
+ * Any other policy has to provide the same hooks, which the simulator calls in
+ * this order each cycle: beginCycle, onFetch, onStage for each stage (with
+ * onForward in between as operands are forwarded, and onExecute once the
+ * instruction has executed), and onRetire. onFinish is called once the run is
+ * over.
+ */
+struct NullInstrumentation {
+
+    /** Whether or not this policy records anything. */
+    static constexpr bool ENABLED = false;
+
+    void beginCycle(dword_t cycle) { }
+    void onFetch(const InstructionFetchBuffer& fetchBuffer, const InstructionSet& instrSet) { }
+    void onStage(PipelineStage stage, dword_t sequence, Memory::addr_t pc) { }
+    void onForward(dword_t sequence, sword_t reg, PipelineStage from, dword_t producer) { }
+    void onExecute(const ExecutionBuffer& executionBuffer) { }
+    void onRetire(dword_t sequence) { }
+    void onFinish() { }
+};
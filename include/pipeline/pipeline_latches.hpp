@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_decode_buffer.hpp"
+#include "pipeline/instruction_fetch_buffer.hpp"
+#include "pipeline/memory_buffer.hpp"
+
+/**
+ * The pipeline latches written on one cycle: the buffer each stage hands
+ * on to the next.
+ *
+ * A simulator keeps two sets, one for this cycle and one for the last, and
+ * swaps which is which by index at the start of every cycle. The stages then
+ * write their buffers in place, and forwarding reads the last cycle's set, so
+ * no buffer is ever copied.
+ */
+struct PipelineLatches {
+
+    /** The buffer between the fetch and decode stages. */
+    InstructionFetchBuffer bufferIF;
+
+    /** The buffer between the decode and execution stages. */
+    InstructionDecodeBuffer bufferID;
+
+    /** The buffer between the execution and memory stages. */
+    ExecutionBuffer bufferEX;
+
+    /** The buffer between the memory and write back stages. */
+    MemoryBuffer bufferMEM;
+};
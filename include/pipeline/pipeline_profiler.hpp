@@ -0,0 +1,174 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "types.hpp"
+
+/**
+ * Attributes every cycle to the address of whatever occupies one chosen stage
+ * of the pipeline that cycle - stalls and bubbles included, since a bubble
+ * still holds its slot - and then sums the addresses up by the nearest label
+ * before them.
+ *
+ * The counters are a flat array with one entry per word of the text segment,
+ * so recording a cycle is a subtraction, a shift and an increment. Anything
+ * outside the text segment (such as the NOPs used to drain the pipeline) is
+ * counted separately.
+ */
+class PipelineProfiler {
+public:
+
+    // MARK: -- Public Types
+
+    /** The cycles spent at an address or under a label. */
+    struct Entry {
+
+        /** The name of the entry (the label, or the address in hex). */
+        std::string strName;
+
+        /** The number of cycles. */
+        dword_t dwCycles = 0;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param stage The stage to attribute cycles to
+     * @param textSize The size of the text segment, in bytes
+     */
+    PipelineProfiler(PipelineStage stage, size_t textSize);
+    ~PipelineProfiler() = default;
+
+
+    // MARK: -- Setup Methods
+
+    /**
+     * Sets the symbols to group addresses by. Only those in the text segment are kept.
+     * @param symbols The symbols and their addresses (as kept by FileReader)
+     */
+    void setSymbols(const std::unordered_map<std::string, Memory::addr_t>& symbols);
+
+    /**
+     * Returns the stage cycles are attributed to.
+     * @return The stage
+     */
+    PipelineStage getStage() const;
+
+
+    // MARK: -- Record Methods
+
+    /**
+     * Records a cycle spent in our stage at an address.
+     * @param pc The address
+     */
+    void record(Memory::addr_t pc) {
+
+        // Addresses below the text segment wrap around, so one check covers both ends
+        size_t index = static_cast<size_t>(pc - Memory::MEM_USER_START) >> 2;
+        if (index < this->m_vecCycles.size())
+            this->m_vecCycles[index]++;
+        else
+            this->m_dwOutside++;
+    }
+
+
+    // MARK: -- Result Methods
+
+    /**
+     * Returns the number of cycles recorded at an address.
+     * @param pc The address
+     * @return The number of cycles
+     */
+    dword_t getCycles(Memory::addr_t pc) const;
+
+    /**
+     * Returns the number of cycles recorded outside the text segment.
+     * @return The number of cycles
+     */
+    dword_t getOutsideCycles() const;
+
+    /**
+     * Returns the total number of cycles recorded.
+     * @return The number of cycles
+     */
+    dword_t getTotalCycles() const;
+
+    /**
+     * Returns the label an address falls under (the nearest one at or before it).
+     * @param pc The address
+     * @return The label, or an empty string if there is none
+     */
+    std::string getLabel(Memory::addr_t pc) const;
+
+    /**
+     * Returns the hottest labels, hottest first.
+     * @param count The most to return (0 for all)
+     * @return The labels
+     */
+    std::vector<Entry> getHotLabels(size_t count = 0) const;
+
+    /**
+     * Returns the hottest addresses, hottest first.
+     * @param count The most to return (0 for all)
+     * @return The addresses
+     */
+    std::vector<Entry> getHotAddresses(size_t count = 0) const;
+
+
+    // MARK: -- Output Methods
+
+    /**
+     * Writes the profile as folded stacks ("label;address cycles" per line), the
+     * input format of flamegraph.pl, inferno and speedscope.
+     * @param out The stream to write to
+     */
+    void writeFolded(std::ostream& out) const;
+
+    /**
+     * Writes a table of the hottest labels and addresses.
+     * @param out The stream to write to
+     * @param count The number of rows in each table
+     */
+    void writeTable(std::ostream& out, size_t count) const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The stage we attribute cycles to. */
+    PipelineStage m_stage;
+
+    /** The cycles spent at each word of the text segment. */
+    std::vector<dword_t> m_vecCycles;
+
+    /** The cycles spent outside the text segment. */
+    dword_t m_dwOutside;
+
+    /** The text symbols, sorted by address. */
+    std::vector<std::pair<Memory::addr_t, std::string>> m_vecSymbols;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Returns the name of an address.
+     * @param pc The address
+     * @return The address in hex
+     */
+    static std::string formatAddress(Memory::addr_t pc);
+
+    /**
+     * Sorts entries hottest first, and trims them.
+     * @param entries The entries
+     * @param count The most to keep (0 for all)
+     */
+    static void sortEntries(std::vector<Entry>& entries, size_t count);
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "types.hpp"
+
+/**
+ * The stages of the pipeline, in order.
+ */
+enum class PipelineStage : byte_t {
+
+    IF = 0,         // Instruction fetch
+    ID,             // Instruction decode
+    EX,             // Execution
+    MEM,            // Memory
+    WB              // Write back
+};
+
+/** The number of pipeline stages. */
+constexpr size_t NUM_PIPELINE_STAGES = 5;
+
+/**
+ * Returns the short name of a pipeline stage.
+ * @param stage The stage
+ * @return The name (e.g. "IF")
+ */
+inline const char * getPipelineStageName(PipelineStage stage) {
+
+    static const char * names[NUM_PIPELINE_STAGES] = { "IF", "ID", "EX", "MEM", "WB" };
+    return names[static_cast<size_t>(stage)];
+}
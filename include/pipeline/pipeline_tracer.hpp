@@ -0,0 +1,231 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "types.hpp"
+
+/**
+ * Records which stage each dynamic instruction occupies on every cycle, and
+ * streams it out in some trace format.
+ *
+ * The simulator reports each cycle, each instruction entering each stage, each
+ * forwarded operand, and each retirement. Only the instructions currently in
+ * flight are remembered (and only a bounded number of them), and everything
+ * else is written out as soon as it happens, so memory use does not grow with
+ * the length of the run. Recording can also be limited to a window of cycles,
+ * since a full trace of a long run is very large.
+ *
+ * Subclasses only have to write out the events in their format.
+ */
+class PipelineTracer {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The most instructions that can be in flight at once. */
+    static constexpr size_t MAX_IN_FLIGHT = 16;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param startCycle The first cycle to record
+     * @param numCycles The number of cycles to record (0 to record until the end)
+     */
+    PipelineTracer(dword_t startCycle = 0, dword_t numCycles = 0);
+
+    /**
+     * Destructor. Subclasses should finish the trace in their destructor.
+     */
+    virtual ~PipelineTracer() = default;
+
+
+    // MARK: -- File Methods
+
+    /**
+     * Opens a file to stream the trace to.
+     * @param filename The file
+     * @return Whether or not the file could be opened
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Finishes the trace, closing off anything still in flight and the file.
+     */
+    void finish();
+
+
+    // MARK: -- Record Methods
+
+    /**
+     * Starts a new cycle.
+     * @param cycle The cycle number
+     */
+    void beginCycle(dword_t cycle);
+
+    /**
+     * Records a newly fetched instruction. It should also be recorded as being
+     * in the fetch stage with recordStage(..).
+     * @param sequence The sequence number of the instruction
+     * @param pc The address of the instruction
+     * @param name The instruction name
+     * @param bubble Whether or not the instruction is a bubble (NOP)
+     */
+    void recordFetch(dword_t sequence, Memory::addr_t pc, const std::string& name, bool bubble);
+
+    /**
+     * Records an instruction occupying a stage this cycle.
+     * @param stage The stage
+     * @param sequence The sequence number of the instruction
+     */
+    void recordStage(PipelineStage stage, dword_t sequence);
+
+    /**
+     * Records an operand being forwarded to an instruction.
+     * @param sequence The sequence number of the instruction receiving the value
+     * @param reg The register being forwarded
+     * @param from The stage the value was forwarded from
+     * @param producer The sequence number of the instruction that produced the value
+     */
+    void recordForward(dword_t sequence, sword_t reg, PipelineStage from, dword_t producer);
+
+    /**
+     * Records an instruction leaving the pipeline.
+     * @param sequence The sequence number of the instruction
+     */
+    void recordRetire(dword_t sequence);
+
+    /**
+     * Returns whether or not the current cycle is being recorded.
+     * @return Whether or not we are recording
+     */
+    bool isRecording() const;
+
+protected:
+
+    // MARK: -- Protected Types
+
+    /** An instruction in flight. */
+    struct InFlight {
+
+        /** Whether or not this slot is in use. */
+        bool bValid = false;
+
+        /** Whether or not the instruction has been written to the trace yet. */
+        bool bIntroduced = false;
+
+        /** Whether or not the instruction is a bubble. */
+        bool bBubble = false;
+
+        /** The sequence number. */
+        dword_t dwSequence = 0;
+
+        /** The id of the instruction in the trace (in order of introduction). */
+        dword_t dwTraceId = 0;
+
+        /** The address of the instruction. */
+        Memory::addr_t wPC = 0;
+
+        /** The instruction name. */
+        std::string strName;
+    };
+
+
+    // MARK: -- Protected Variables
+
+    /** The stream to write the trace to. */
+    std::ofstream m_stream;
+
+
+    // MARK: -- Protected Event Methods
+
+    /**
+     * Called once the file is open, to write any header.
+     */
+    virtual void onOpen() = 0;
+
+    /**
+     * Called on each recorded cycle.
+     * @param cycle The cycle
+     */
+    virtual void onCycle(dword_t cycle) = 0;
+
+    /**
+     * Called the first time an instruction appears in the recorded window.
+     * @param cycle The cycle
+     * @param instr The instruction
+     */
+    virtual void onIntroduce(dword_t cycle, const InFlight& instr) = 0;
+
+    /**
+     * Called when an instruction occupies a stage.
+     * @param cycle The cycle
+     * @param stage The stage
+     * @param instr The instruction
+     */
+    virtual void onStage(dword_t cycle, PipelineStage stage, const InFlight& instr) = 0;
+
+    /**
+     * Called when an operand is forwarded.
+     * @param cycle The cycle
+     * @param instr The instruction receiving the value
+     * @param reg The register
+     * @param from The stage the value came from
+     * @param producer The sequence number of the producing instruction
+     */
+    virtual void onForward(dword_t cycle, const InFlight& instr, sword_t reg, PipelineStage from, dword_t producer) = 0;
+
+    /**
+     * Called when an instruction leaves the pipeline.
+     * @param cycle The cycle
+     * @param instr The instruction
+     * @param flushed Whether it was thrown away rather than completed
+     */
+    virtual void onRetire(dword_t cycle, const InFlight& instr, bool flushed) = 0;
+
+    /**
+     * Called once everything has been retired, to write any footer.
+     */
+    virtual void onFinish() = 0;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The instructions in flight, indexed by sequence number. */
+    std::array<InFlight, MAX_IN_FLIGHT> m_arrInFlight;
+
+    /** The stream buffer (large, so we are not writing every event). */
+    std::vector<char> m_vecBuffer;
+
+    /** The first cycle to record. */
+    dword_t m_dwStartCycle;
+
+    /** The cycle to stop recording at (0 for never). */
+    dword_t m_dwEndCycle;
+
+    /** The current cycle. */
+    dword_t m_dwCycle;
+
+    /** The next trace id to hand out. */
+    dword_t m_dwNextTraceId;
+
+    /** Whether or not the trace is open. */
+    bool m_bOpen;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Finds an instruction in flight, introducing it to the trace if needed.
+     * @param sequence The sequence number
+     * @return The instruction, or nullptr if it is not in flight
+     */
+    InFlight * find(dword_t sequence);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "instr/instruction_handler.hpp"
+#include "types.hpp"
+
+/**
+ * One instruction of the text segment, decoded once at load (see StaticAnalyzer)
+ * so the decode stage only has to read its registers, along with what it needs
+ * from the instructions that fall through into it.
+ */
+struct PredecodedInstruction {
+
+    /** The instruction it was decoded from, so a changed word is never mistaken for it. */
+    word_t wInstruction = 0;
+
+    /** The handler, or nullptr if the instruction is illegal (or a breakpoint's trap). */
+    InstructionHandler * ptrHandler = nullptr;
+
+    /** The opcode. */
+    word_t wOpcode = 0;
+
+    /** The funct (R-Type instructions only). */
+    word_t wFunct = 0;
+
+    /** The immediate, address or shift amount, as the decode stage reads it. */
+    word_t wImmediate = 0;
+
+    /** The destination register, as decoded (before the handler's post decode). -1 if unused */
+    sword_t wRegDest = -1;
+
+    /** The first source register. -1 if unused */
+    sword_t wRegSrc1 = -1;
+
+    /** The second source register. -1 if unused */
+    sword_t wRegSrc2 = -1;
+
+    /** Whether or not its operands are read (and forwarded) in decode, as branches and jumps through a register are. */
+    bool bReadsInDecode = false;
+
+    /** Whether or not either of the two instructions falling through into it may write an operand it reads in decode. */
+    bool bDecodeHazard = false;
+
+    /** The distance back to the nearest of those two that writes one of its sources, or 0 for neither. */
+    dword_t dwRawDistance = 0;
+
+    /** Whether or not the instruction before it is a load of one of its sources. */
+    bool bLoadUse = false;
+
+    /** The cycles it waits in decode for its operands, when reached by falling through. */
+    dword_t dwDecodeStall = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "instr/instruction_set.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_fetch_buffer.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "pipeline/retire_record.hpp"
+#include "types.hpp"
+
+/**
+ * The instrumentation policy for a functional front end. It builds a
+ * RetireRecord of the instruction run each cycle (registers from the fetched
+ * instruction, and the effective address once it has executed), for a timing
+ * model to consume.
+ *
+ * See NullInstrumentation for the hooks and the order they are called in.
+ */
+class RecordInstrumentation {
+public:
+
+    // MARK: -- Public Constants
+
+    /** Whether or not this policy records anything. */
+    static constexpr bool ENABLED = true;
+
+
+    // MARK: -- Construction
+    RecordInstrumentation() = default;
+    ~RecordInstrumentation() = default;
+
+
+    // MARK: -- Record Methods
+
+    /**
+     * Fills in everything a record can know from the instruction alone.
+     * @param instruction The instruction
+     * @param pc The address it was fetched from
+     * @param instrSet The instruction set, to find the instruction type
+     * @param record The record to fill in
+     */
+    static void decode(word_t instruction, Memory::addr_t pc, const InstructionSet& instrSet, RetireRecord& record);
+
+    /**
+     * Returns the record of the instruction run in the last cycle.
+     * @return The record
+     */
+    const RetireRecord& getRecord() const { return this->m_record; }
+
+
+    // MARK: -- Hook Methods
+    void beginCycle(dword_t cycle) { }
+    void onStage(PipelineStage stage, dword_t sequence, Memory::addr_t pc) { }
+    void onForward(dword_t sequence, sword_t reg, PipelineStage from, dword_t producer) { }
+    void onRetire(dword_t sequence) { }
+    void onFinish() { }
+
+    void onFetch(const InstructionFetchBuffer& fetchBuffer, const InstructionSet& instrSet) {
+        decode(fetchBuffer.wInstruction, fetchBuffer.wPC, instrSet, this->m_record);
+        this->m_record.dwSequence = fetchBuffer.dwSequence;
+    }
+
+    void onExecute(const ExecutionBuffer& executionBuffer) {
+        if (this->m_record.bLoad || this->m_record.bStore)
+            this->m_record.wAddress = executionBuffer.wOutput;
+    }
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The record of the instruction run in the last cycle. */
+    RetireRecord m_record;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * What a timing model needs to know about one instruction, as it was executed
+ * by a functional simulator (or, on the wrong path, merely decoded).
+ */
+struct RetireRecord {
+
+    /** The sequence number of the instruction (in program order). */
+    dword_t dwSequence = 0;
+
+    /** The address the instruction was fetched from. */
+    Memory::addr_t wPC = 0;
+
+    /** The instruction itself. */
+    word_t wInstruction = 0;
+
+    /** The opcode. */
+    word_t wOpcode = 0;
+
+    /** The function (R-type instructions only). */
+    word_t wFunct = 0;
+
+    /** The register written, or -1 for none. */
+    word_t wRegDest = -1;
+
+    /** The first register read, or -1 for none. */
+    word_t wRegSrc1 = -1;
+
+    /** The second register read, or -1 for none. */
+    word_t wRegSrc2 = -1;
+
+    /** The address loaded from or stored to (loads and stores only). */
+    Memory::addr_t wAddress = 0;
+
+    /** The address a branch goes to if taken, or a J-Type jump goes to (branches and J-Type jumps only). */
+    Memory::addr_t wTarget = 0;
+
+    /** Whether or not the instruction loads from memory. */
+    bool bLoad = false;
+
+    /** Whether or not the instruction stores to memory. */
+    bool bStore = false;
+
+    /** Whether or not the instruction is a conditional branch. */
+    bool bBranch = false;
+
+    /** Whether or not the instruction is an unconditional jump (J, JAL, JR or JALR). */
+    bool bJump = false;
+
+    /** Whether or not the jump goes through a register (JR or JALR). */
+    bool bIndirect = false;
+
+    /** Whether or not the jump links a return address (JAL or JALR). */
+    bool bCall = false;
+
+    /** Whether or not the instruction is a system call. */
+    bool bSyscall = false;
+
+    /** Whether or not this is the last instruction of the program. */
+    bool bExit = false;
+
+    /** Whether or not the instruction was only fetched down a mispredicted path. */
+    bool bWrongPath = false;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+
+#include "instr/instruction_set.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/predecoded_instruction.hpp"
+#include "types.hpp"
+
+/**
+ * Walks a loaded text segment once, before it runs, decoding every instruction
+ * and classifying its hazards against the two instructions that fall through
+ * into it: how far back its nearest producer is, whether it uses a load
+ * straight away, and how long a branch (or jump through a register) would wait
+ * in decode for its operands.
+ *
+ * The simulator decodes from what this produces, so its decode stage never goes
+ * through the instruction set, and skips forwarding into decode altogether for
+ * branches nothing falls through to a hazard on. Hazards are only known along
+ * the fall-through path, so anything reached another way is forwarded as usual.
+ *
+ * A producer is assumed to write the destination it decodes with, or $31 for
+ * a J-Type jump (which may link) - the handlers only ever clear a destination
+ * besides - and an illegal instruction may write anything, since it may be a
+ * breakpoint's trap standing in for a real one.
+ */
+class StaticAnalyzer {
+public:
+
+    // MARK: -- Public Types
+
+    /** What the analysis found. */
+    struct Report {
+
+        /** The number of instructions in the text segment. */
+        dword_t dwInstructions = 0;
+
+        /** The addresses of any instructions the instruction set does not know. */
+        std::vector<Memory::addr_t> vecIllegal;
+
+        /** The number of instructions reading a register written by one of the two before them. */
+        dword_t dwRawHazards = 0;
+
+        /** The number of instructions reading a register loaded by the one before them. */
+        dword_t dwLoadUses = 0;
+
+        /** The number of branches and jumps through a register whose operands may be forwarded into decode. */
+        dword_t dwDecodeHazards = 0;
+
+        /** The cycles those would wait in decode, if each were reached by falling through. */
+        dword_t dwDecodeStalls = 0;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param instrSet The instruction set to decode with
+     */
+    explicit StaticAnalyzer(const InstructionSet& instrSet);
+    ~StaticAnalyzer() = default;
+
+
+    // MARK: -- Analysis Methods
+
+    /**
+     * Decodes and classifies every instruction of the text segment.
+     * @param memory The memory, with its text segment loaded
+     * @param stream A placeholder for the instructions, one per word of the text segment
+     * @param report A placeholder for what was found
+     * @return Whether or not every instruction is legal
+     */
+    bool analyze(const Memory& memory, std::vector<PredecodedInstruction>& stream, Report& report) const;
+
+    /**
+     * Returns whether an I-Type instruction compares its operands in decode, as branches do.
+     * @param opcode The opcode
+     * @return Whether or not it does
+     */
+    static bool comparesInDecode(word_t opcode);
+
+    /**
+     * Returns whether an R-Type instruction jumps to its operand in decode.
+     * @param funct The funct
+     * @return Whether or not it does
+     */
+    static bool jumpsInDecode(word_t funct);
+
+private:
+
+    // MARK: -- Private Constants
+
+    /** Stands in for whichever register an illegal instruction may turn out to write. */
+    static constexpr sword_t ANY_REGISTER = -2;
+
+
+    // MARK: -- Private Dependency Variables
+
+    /** The instruction set. */
+    const InstructionSet& m_instrSet;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Decodes an instruction, as the decode stage would.
+     * @param word The instruction
+     * @param entry The entry to fill
+     * @return The register the instruction may write, or ANY_REGISTER if it is illegal
+     */
+    sword_t decode(word_t word, PredecodedInstruction& entry) const;
+
+    /**
+     * Classifies an instruction's hazards against the two before it.
+     * @param stream The instructions
+     * @param writes The register each instruction may write
+     * @param index The index of the instruction
+     * @param report The report to add to
+     */
+    static void classify(std::vector<PredecodedInstruction>& stream, const std::vector<sword_t>& writes, size_t index, Report& report);
+};
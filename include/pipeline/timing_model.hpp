@@ -0,0 +1,251 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "memory/memory.hpp"
+#include "pipeline/jump_predictor.hpp"
+#include "pipeline/multiply_divide_unit.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "pipeline/retire_record.hpp"
+#include "registers/register_bank.hpp"
+#include "types.hpp"
+
+/**
+ * The timing back end of a decoupled run: an in-order pipeline model fed the
+ * instructions a functional front end has already run, in program order.
+ *
+ * The pipeline is described by its list of stages, so any stage but decode
+ * may be split across several cycles (a 2-cycle execute, a 3-cycle memory
+ * stage and so on). The model issues one instruction per cycle and keeps,
+ * for each register, the cycle its newest value can first be forwarded: the
+ * cycle after the last execute stage for an ALU result, or after the last
+ * memory stage for a load. An instruction stalls until every register it
+ * reads is ready by the time it needs it - in its first execute stage, or in
+ * decode for branches and system calls, which this simulator
+ * runs in decode. Stalls therefore follow from the stage latencies alone,
+ * besides those of the multiply/divide unit, whose latencies are its own: a
+ * multiply or divide waits for the unit to be free, and a move to or from HI
+ * or LO for the last result, as they reach execute.
+ *
+ * Conditional branches are predicted with a table of 2-bit counters and
+ * resolve at the end of decode, so a wrong prediction costs the instructions
+ * fetched down the wrong path meanwhile (one per stage ahead of that point);
+ * the model asks its wrong-path source for those instructions, so they can be
+ * counted (and, later, charged to caches and the like). A branch's outcome is
+ * only known from the address of the next record, so each branch is scored
+ * when the next record arrives.
+ *
+ * Fetch finds the target of a J-Type jump in the instruction itself, so those
+ * never cost anything. Jumps through a register also resolve in decode, and
+ * are predicted by a return-address stack and a target table (JumpPredictor);
+ * a wrong target costs the same as a mispredicted branch.
+ */
+class TimingModel {
+public:
+
+    // MARK: -- Public Types
+
+    /** The shape of the modelled pipeline. */
+    struct Config {
+
+        /**
+         * The stages in order, one per cycle; a stage listed more than once is split
+         * across that many cycles. Every stage must appear, in the classic order, and
+         * decode only once (a split decode is rejected).
+         */
+        std::vector<PipelineStage> vecStages = { PipelineStage::IF, PipelineStage::ID, PipelineStage::EX, PipelineStage::MEM, PipelineStage::WB };
+
+        /** The number of 2-bit counters in the branch predictor (a power of two). */
+        size_t szPredictorEntries = 256;
+
+        /** The number of return addresses the return-address stack holds. */
+        size_t szReturnStackEntries = 16;
+
+        /** The number of entries in the jump target table (a power of two). */
+        size_t szIndirectEntries = 64;
+
+        /** The latencies of the multiply/divide unit. */
+        MultiplyDivideUnit::Config mdu;
+
+        /**
+         * Returns the classic 5-stage pipeline (IF, ID, EX, MEM, WB).
+         * @return The configuration
+         */
+        static Config fiveStage();
+
+        /**
+         * Returns an 8-stage pipeline, with fetch, execute and memory each split in two.
+         * @return The configuration
+         */
+        static Config eightStage();
+    };
+
+    /** The timing results. */
+    struct Stats {
+
+        /** The number of cycles. */
+        dword_t dwCycles = 0;
+
+        /** The number of instructions retired. */
+        dword_t dwInstructions = 0;
+
+        /** The cycles lost waiting on loads. */
+        dword_t dwLoadUseStalls = 0;
+
+        /** The cycles lost waiting on ALU results. */
+        dword_t dwAluStalls = 0;
+
+        /** The cycles lost waiting on the multiply/divide unit. */
+        dword_t dwMduStalls = 0;
+
+        /** The number of conditional branches. */
+        dword_t dwBranches = 0;
+
+        /** The number of those that were mispredicted. */
+        dword_t dwMispredictions = 0;
+
+        /** The number of unconditional jumps. */
+        dword_t dwJumps = 0;
+
+        /** The number of jumps through a register whose target was mispredicted. */
+        dword_t dwJumpMispredictions = 0;
+
+        /** The number of instructions fetched down mispredicted paths. */
+        dword_t dwWrongPathRecords = 0;
+    };
+
+    /** Decodes the instructions down a wrong path: (start address, count, records out). */
+    using wrong_path_fn_t = std::function<void(Memory::addr_t, size_t, std::vector<RetireRecord>&)>;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument if the predictor or jump target
+     * table size is not a power of two, the return-address stack is empty, the stages are out of order or missing one, or a multiply/divide
+     * latency is 0.
+     * @param config The shape of the pipeline
+     */
+    explicit TimingModel(const Config& config);
+    ~TimingModel() = default;
+
+
+    // MARK: -- Setup Methods
+
+    /**
+     * Sets where wrong-path instructions come from.
+     * @param source The wrong-path source, or nullptr to only count mispredictions
+     */
+    void setWrongPathSource(wrong_path_fn_t source);
+
+
+    // MARK: -- Timing Methods
+
+    /**
+     * Times the next instruction in program order.
+     * @param record The instruction
+     */
+    void consume(const RetireRecord& record);
+
+    /**
+     * Finishes the run, scoring the last branch and draining the pipeline.
+     */
+    void finish();
+
+    /**
+     * Returns the timing results.
+     * @return The results
+     */
+    const Stats& getStats() const;
+
+    /**
+     * Clears the results and the branch predictor.
+     */
+    void reset();
+
+    /**
+     * Returns the number of pipeline stages.
+     * @return The depth
+     */
+    size_t getDepth() const;
+
+    /**
+     * Returns the cycles a mispredicted branch costs (the stages ahead of the end of decode).
+     * @return The penalty
+     */
+    dword_t getMispredictPenalty() const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The shape of the pipeline. */
+    Config m_config;
+
+    /** The branch predictor counters (0-1 predict not taken, 2-3 taken). */
+    std::vector<uint8_t> m_vecPredictor;
+
+    /** Where wrong-path instructions come from (if anywhere). */
+    wrong_path_fn_t m_fnWrongPath;
+
+    /** A scratch list of wrong-path instructions. */
+    std::vector<RetireRecord> m_vecWrongPath;
+
+    /** The predictor for jumps through a register. */
+    JumpPredictor m_jumpPredictor;
+
+    /** The last branch or jump through a register, waiting on the next record to learn its outcome. */
+    RetireRecord m_pendingBranch;
+
+    /** Where fetch went after the waiting branch or jump. */
+    Memory::addr_t m_wPredictedPC;
+
+    /** Whether or not there is a branch waiting. */
+    bool m_bPendingBranch;
+
+    /** The stage (from 0) of the decode cycle, where branches resolve. */
+    size_t m_szDecodeStage;
+
+    /** The stage of the first execute cycle, where most instructions read their operands. */
+    size_t m_szExecuteStage;
+
+    /** The stage after which an ALU result can be forwarded. */
+    size_t m_szAluReadyStage;
+
+    /** The stage after which a loaded value can be forwarded. */
+    size_t m_szLoadReadyStage;
+
+    /** The first cycle each register's newest value can be forwarded on. */
+    std::array<dword_t, RegisterBank::NUM_REGISTERS> m_arrReady;
+
+    /** Whether each register's newest value is being loaded. */
+    std::array<bool, RegisterBank::NUM_REGISTERS> m_arrLoaded;
+
+    /** The multiply/divide unit. */
+    MultiplyDivideUnit m_mdu;
+
+    /** The timing results. */
+    Stats m_stats;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Scores the waiting branch or jump now that the next address is known.
+     * @param nextPC The address of the instruction after it
+     */
+    void resolveBranch(Memory::addr_t nextPC);
+
+    /**
+     * Returns the cycle an instruction could issue on for its register to be ready.
+     * @param reg The register read, or -1
+     * @param useStage The stage it is read in
+     * @param bLoad A placeholder set when a load is what it waits on
+     * @return The earliest issue cycle
+     */
+    dword_t readyToIssue(word_t reg, size_t useStage, bool& bLoad) const;
+};
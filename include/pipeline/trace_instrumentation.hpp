@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+
+#include "instr/instruction_set.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/instruction_fetch_buffer.hpp"
+#include "pipeline/pipeline_profiler.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "pipeline/pipeline_tracer.hpp"
+#include "types.hpp"
+
+/**
+ * The instrumentation policy for diagnosis runs. It counts bubbles and
+ * forwarded operands, logs every stage of every cycle at trace level, and
+ * feeds a pipeline tracer and a profiler if they are set.
+ *
+ * See NullInstrumentation for the hooks and the order they are called in.
+ */
+class TraceInstrumentation {
+public:
+
+    // MARK: -- Public Constants
+
+    /** Whether or not this policy records anything. */
+    static constexpr bool ENABLED = true;
+
+
+    // MARK: -- Construction
+    TraceInstrumentation();
+    ~TraceInstrumentation() = default;
+
+
+    // MARK: -- Setup Methods
+
+    /**
+     * Sets a tracer to record the pipeline to, or nullptr for none.
+     * @param tracer The tracer (already opened)
+     */
+    void setTracer(std::unique_ptr<PipelineTracer> tracer);
+
+    /**
+     * Sets a profiler to attribute cycles to, or nullptr for none.
+     * @param profiler The profiler
+     */
+    void setProfiler(std::unique_ptr<PipelineProfiler> profiler);
+
+    /**
+     * Returns the profiler, if any.
+     * @return The profiler, or nullptr
+     */
+    const PipelineProfiler * getProfiler() const;
+
+
+    // MARK: -- Counter Methods
+
+    /**
+     * Returns the number of bubbles (NOPs) fetched.
+     * @return The number of bubbles
+     */
+    dword_t getBubbles() const;
+
+    /**
+     * Returns the number of operands forwarded from a stage.
+     * @param from The stage
+     * @return The number of operands
+     */
+    dword_t getForwards(PipelineStage from) const;
+
+
+    // MARK: -- Hook Methods
+    void beginCycle(dword_t cycle);
+    void onFetch(const InstructionFetchBuffer& fetchBuffer, const InstructionSet& instrSet);
+    void onStage(PipelineStage stage, dword_t sequence, Memory::addr_t pc);
+    void onForward(dword_t sequence, sword_t reg, PipelineStage from, dword_t producer);
+    void onExecute(const ExecutionBuffer& executionBuffer) { }
+    void onRetire(dword_t sequence);
+    void onFinish();
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The pipeline tracer, if any. */
+    std::unique_ptr<PipelineTracer> m_tracer;
+
+    /** The profiler, if any. */
+    std::unique_ptr<PipelineProfiler> m_profiler;
+
+    /** Whether or not we are logging this cycle. */
+    bool m_bLog;
+
+    /** The current cycle. */
+    dword_t m_dwCycle;
+
+    /** The number of bubbles fetched. */
+    dword_t m_dwBubbles;
+
+    /** The number of operands forwarded from each stage. */
+    dword_t m_arrForwards[NUM_PIPELINE_STAGES];
+};
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+
+#include "memory/memory.hpp"
+#include "reader/instruction_scheduler.hpp"
+#include "reader/peephole_optimizer.hpp"
 
 // Forward Declarations
 class InstructionSet;
-class Memory;
 
 /**
  * A class to read our input files.
@@ -17,7 +22,7 @@ class FileReader {
 public:
 
     // MARK: -- Construction
-    FileReader() = default;
+    FileReader();
     ~FileReader() = default;
 
     
@@ -30,5 +35,60 @@ public:
      * @param memory The memory
      * @return Whether or not the file was read successfully
      */
-    bool readFile(const std::string& filename, const InstructionSet& instrSet, Memory& memory) const;
+    bool readFile(const std::string& filename, const InstructionSet& instrSet, Memory& memory);
+
+
+    // MARK: -- Optimization Methods
+
+    /**
+     * Sets whether to tidy up each file's pseudo-instruction expansions as it is read.
+     * @param peephole Whether or not to run the peephole optimizer (off by default)
+     */
+    void setPeephole(bool peephole);
+
+    /**
+     * Returns what the peephole optimizer did to the last file read.
+     * @return The statistics (all 0 without the optimizer)
+     */
+    const PeepholeOptimizer::Stats& getPeepholeStats() const;
+
+    /**
+     * Sets a scheduler to reorder each file's text for the pipeline as it is read.
+     * @param scheduler The scheduler, or nullptr to keep the text as written (the default)
+     */
+    void setScheduler(std::unique_ptr<InstructionScheduler> scheduler);
+
+    /**
+     * Returns what the scheduler did to the last file read.
+     * @return The statistics (all 0 without a scheduler)
+     */
+    const InstructionScheduler::Stats& getScheduleStats() const;
+
+
+    // MARK: -- Symbol Methods
+
+    /**
+     * Returns the symbols of the last file read successfully, e.g. for profiling.
+     * @return The symbols and their addresses
+     */
+    const std::unordered_map<std::string, Memory::addr_t>& getSymbols() const;
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The symbols of the last file read. */
+    std::unordered_map<std::string, Memory::addr_t> m_mapSymbols;
+
+    /** Whether or not to run the peephole optimizer. */
+    bool m_bPeephole;
+
+    /** What the peephole optimizer did to the last file read. */
+    PeepholeOptimizer::Stats m_peepholeStats;
+
+    /** The scheduler, if any. */
+    std::unique_ptr<InstructionScheduler> m_ptrScheduler;
+
+    /** What the scheduler did to the last file read. */
+    InstructionScheduler::Stats m_scheduleStats;
 };
\ No newline at end of file
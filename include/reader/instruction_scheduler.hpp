@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "instr/instruction.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "registers/register_bank.hpp"
+#include "types.hpp"
+
+/**
+ * An optional assembler pass that reorders each basic block for the pipeline,
+ * run on the instructions once pseudo-instructions have been expanded.
+ *
+ * A basic block starts at the first instruction and at every text label, and
+ * ends after a branch, jump or system call. The pass drops every NOP in the
+ * block (nothing in this simulator needs them, since every instruction has
+ * retired before the next is decoded, a system call included), builds the
+ * block's dependency graph, and list
+ * schedules it: on each cycle it issues whichever ready instruction stalls
+ * least, breaking ties by the longest path to the end of the block, then by
+ * the original order. The branch, jump or system call ending a block stays
+ * last. Loads and stores keep their order with each other (a load may be
+ * reading a device), and so do the instructions of the multiply/divide unit.
+ *
+ * Stalls follow the same rules as the decoupled TimingModel: a result can be
+ * forwarded on the cycle after the last execute stage, or after the last
+ * memory stage for a load, and is read in the first execute stage, or in
+ * decode for branches, jumps through a register and system calls. Each block
+ * is timed on its own, as if every register were ready as it starts, and the
+ * new order is only kept when it is faster than the old one without its NOPs.
+ */
+class InstructionScheduler {
+public:
+
+    // MARK: -- Public Types
+
+    /** What the pass did. */
+    struct Stats {
+
+        /** The number of basic blocks. */
+        dword_t dwBlocks = 0;
+
+        /** The number of blocks whose instructions were reordered. */
+        dword_t dwBlocksReordered = 0;
+
+        /** The number of NOPs removed. */
+        dword_t dwNopsRemoved = 0;
+
+        /** The cycles to run every block once, before the pass. */
+        dword_t dwCyclesBefore = 0;
+
+        /** The cycles to run every block once, after the pass. */
+        dword_t dwCyclesAfter = 0;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor, for the classic 5-stage pipeline (IF, ID, EX, MEM, WB).
+     */
+    InstructionScheduler();
+
+    /**
+     * Constructor. Throws std::invalid_argument if the stages are out of order or missing one.
+     * @param stages The stages of the pipeline in order, one per cycle, as for TimingModel::Config
+     */
+    explicit InstructionScheduler(const std::vector<PipelineStage>& stages);
+    ~InstructionScheduler() = default;
+
+
+    // MARK: -- Schedule Methods
+
+    /**
+     * Schedules every basic block of a program.
+     * @param instructions The instructions, with their labels still unresolved; rewritten in place
+     * @param labels The index of the instruction each text label names; moved to where its block now starts
+     * @return What the pass did
+     */
+    Stats schedule(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels) const;
+
+private:
+
+    // MARK: -- Private Types
+
+    /** The registers and resources an instruction uses. */
+    struct Node {
+
+        /** The registers read, or -1. */
+        std::array<word_t, 2> arrReads;
+
+        /** The register written, or -1. */
+        word_t wWrite;
+
+        /** Whether or not the instruction is a load. */
+        bool bLoad;
+
+        /** Whether or not the instruction reads or writes memory. */
+        bool bMemory;
+
+        /** Whether or not the instruction reads its registers in decode. */
+        bool bReadsInDecode;
+
+        /** Whether or not the instruction ends a basic block. */
+        bool bEndsBlock;
+    };
+
+
+    // MARK: -- Private Constants
+
+    /** HI and LO, which the scheduler keeps in order as one extra register. */
+    static constexpr word_t REG_HILO = RegisterBank::NUM_REGISTERS;
+
+
+    // MARK: -- Private Variables
+
+    /** The stage branches, jumps through a register and system calls read their registers in. */
+    size_t m_szDecodeStage;
+
+    /** The stage everything else reads its registers in. */
+    size_t m_szExecuteStage;
+
+    /** The last stage before an ALU result can be forwarded. */
+    size_t m_szAluReadyStage;
+
+    /** The last stage before a load's result can be forwarded. */
+    size_t m_szLoadReadyStage;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Describes the registers and resources an instruction uses.
+     * @param instr The instruction
+     * @return The node
+     */
+    static Node describe(const Instruction& instr);
+
+    /**
+     * Returns whether one instruction must stay ahead of another that follows it.
+     * @param first The earlier instruction
+     * @param second The later instruction
+     * @return Whether or not the second depends on the first
+     */
+    static bool dependsOn(const Node& first, const Node& second);
+
+    /**
+     * Returns the cycle an instruction can issue on, and marks when its result is ready.
+     * @param node The instruction
+     * @param cycle The first cycle it could issue on
+     * @param ready The cycle each register can first be forwarded on, updated with its result
+     * @return The cycle it issues on
+     */
+    dword_t issue(const Node& node, dword_t cycle, std::array<dword_t, REG_HILO + 1>& ready) const;
+
+    /**
+     * Returns how many cycles a block takes to issue.
+     * @param nodes The instructions of the block
+     * @param order The order to issue them in
+     * @return The number of cycles
+     */
+    dword_t time(const std::vector<Node>& nodes, const std::vector<size_t>& order) const;
+
+    /**
+     * List schedules a block.
+     * @param nodes The instructions of the block, without NOPs
+     * @return The order to issue them in
+     */
+    std::vector<size_t> order(const std::vector<Node>& nodes) const;
+};
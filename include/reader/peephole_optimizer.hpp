@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "instr/instruction.hpp"
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * An optional assembler pass that tidies up what the pseudo-instruction
+ * parsers expand into, once they have all run. The parsers expand each line
+ * on its own and without looking at their operands, so:
+ *
+ *      li $r, <value> whose lui + ori fits one instruction becomes ori $r, $0, <value>,
+ *          addi $r, $0, <value> for a small negative value, or a lone lui
+ *      la $r, <label> of an address below 64 KiB loses its lui, so the ori reads $0
+ *      subi $r, $r, 0 (and addi $r, $r, 0, which it expands into) is removed
+ *      a run of NOPs becomes a single NOP, since the pipeline forwards or interlocks
+ *          every operand and never needs more than one slot of padding
+ *
+ * Nothing is folded across a label, since a branch may land between the two
+ * halves, and labels move down to wherever their instruction ends up. The
+ * address rewrites need every symbol placed, so they run separately, once
+ * the segments have been sized; text only shrinks after that, so an address
+ * found to fit in 16 bits still does once the text below it has moved.
+ */
+class PeepholeOptimizer {
+public:
+
+    // MARK: -- Public Types
+
+    /** What the pass did. */
+    struct Stats {
+
+        /** The number of instructions before the pass. */
+        dword_t dwInstructionsBefore = 0;
+
+        /** The number of instructions after the pass. */
+        dword_t dwInstructionsAfter = 0;
+
+        /** The number of li expansions folded. */
+        dword_t dwConstantsFolded = 0;
+
+        /** The number of la expansions folded. */
+        dword_t dwAddressesFolded = 0;
+
+        /** The number of additions of 0 to a register into itself removed. */
+        dword_t dwMovesRemoved = 0;
+
+        /** The number of NOPs removed from runs. */
+        dword_t dwNopsRemoved = 0;
+    };
+
+
+    // MARK: -- Construction
+    PeepholeOptimizer() = default;
+    ~PeepholeOptimizer() = default;
+
+
+    // MARK: -- Optimize Methods
+
+    /**
+     * Does the rewrites that only need the instructions: li, subi and NOP runs.
+     * @param instructions The instructions, with their labels still unresolved; rewritten in place
+     * @param labels The index of the instruction each text label names; moved with it
+     * @param stats The statistics to add to
+     */
+    void optimize(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels, Stats& stats) const;
+
+    /**
+     * Does the rewrites that need every symbol's address: la.
+     * @param instructions The instructions, with their labels still unresolved; rewritten in place
+     * @param labels The index of the instruction each text label names; moved with it
+     * @param symbols The address of every symbol, as the text is laid out now
+     * @param stats The statistics to add to
+     */
+    void optimizeAddresses(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels,
+                           const std::unordered_map<std::string, Memory::addr_t>& symbols, Stats& stats) const;
+
+private:
+
+    // MARK: -- Private Methods
+
+    /**
+     * Returns whether two instructions are the lui and ori that load a register.
+     * @param upper The first instruction
+     * @param lower The second instruction
+     * @return Whether or not they are lui $r then ori $r, $r
+     */
+    static bool isUpperLower(const Instruction& upper, const Instruction& lower);
+
+    /**
+     * Removes instructions, moving each label to the next instruction left.
+     * @param instructions The instructions
+     * @param labels The index of the instruction each text label names
+     * @param removed Whether or not to remove each instruction
+     */
+    static void remove(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels, const std::vector<bool>& removed);
+};
@@ -3,6 +3,8 @@
 #include <array>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "types.hpp"
 
@@ -12,11 +14,24 @@
 class RegisterBank {
 public:
 
+    // MARK: -- Typedefs
+    using undo_log_t = std::vector<std::pair<word_t, word_t>>;  // Registers written, with their old values, in order
+
+
     // MARK: -- Public Constants
 
     /** The number of registers. */
     static constexpr word_t NUM_REGISTERS = 32;
 
+    /** The HI register's number in the undo log (HI and LO have no number in programs). */
+    static constexpr word_t REG_HI = NUM_REGISTERS;
+
+    /** The LO register's number in the undo log. */
+    static constexpr word_t REG_LO = NUM_REGISTERS + 1;
+
+    /** Every register, followed by HI and LO. */
+    using registers_t = std::array<word_t, NUM_REGISTERS + 2>;
+
 
     // MARK: -- Construction
     RegisterBank();
@@ -64,10 +79,62 @@ public:
      */
     bool writeRegister(word_t num, word_t value);
 
+    /**
+     * Reads the HI register (the high word of a product, or a remainder).
+     * @return The value
+     */
+    word_t readHi() const;
+
+    /**
+     * Reads the LO register (the low word of a product, or a quotient).
+     * @return The value
+     */
+    word_t readLo() const;
+
+    /**
+     * Writes the HI register.
+     * @param value The value
+     */
+    void writeHi(word_t value);
+
+    /**
+     * Writes the LO register.
+     * @param value The value
+     */
+    void writeLo(word_t value);
+
+    /**
+     * Returns every register at once, followed by HI and LO.
+     * @return The registers
+     */
+    const registers_t& getRegisters() const;
+
+
+    // MARK: -- Undo Methods
+
+    /**
+     * Starts (or stops) recording the old value of every register before it is
+     * written, so the writes can be undone in reverse.
+     * @param log The log to append to, or nullptr to stop recording
+     */
+    void setUndoLog(undo_log_t * log);
+
+    /**
+     * Puts back an old value from an undo log, without logging it. Unlike
+     * writeRegister, this also takes REG_HI and REG_LO.
+     * @param num The register number
+     * @param value The old value
+     * @return True if the value was put back, false if the number is out of bounds
+     */
+    bool restoreRegister(word_t num, word_t value);
+
 private:
 
     // MARK: -- Private Variables
 
-    /** The register bank. */
-    std::array<word_t, NUM_REGISTERS> m_arrRegisters;
+    /** The register bank, followed by HI and LO. */
+    registers_t m_arrRegisters;
+
+    /** The log old values are recorded into (if any). */
+    undo_log_t * m_ptrUndoLog;
 };
\ No newline at end of file
@@ -1,45 +1,319 @@
 #pragma once
 
+#include <array>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
+#include "instr/instruction.hpp"
 #include "instr/instruction_set.hpp"
 #include "memory/memory.hpp"
 #include "pipeline/execution_buffer.hpp"
 #include "pipeline/instruction_decode_buffer.hpp"
 #include "pipeline/instruction_fetch_buffer.hpp"
+#include "pipeline/livelock_detector.hpp"
+#include "pipeline/load_store_unit.hpp"
 #include "pipeline/memory_buffer.hpp"
+#include "pipeline/multiply_divide_unit.hpp"
+#include "pipeline/null_instrumentation.hpp"
+#include "pipeline/pipeline_latches.hpp"
+#include "pipeline/predecoded_instruction.hpp"
+#include "pipeline/record_instrumentation.hpp"
+#include "pipeline/trace_instrumentation.hpp"
 #include "registers/register_bank.hpp"
 
+/**
+ * The statistics of a simulator run.
+ */
+struct SimulatorStats {
+
+    /** The number of clock cycles. */
+    dword_t dwClockCycles = 0;
+
+    /** The number of instructions (including NOPs). */
+    dword_t dwInstructions = 0;
+
+    /** The number of NOPs fetched. */
+    dword_t dwNops = 0;
+
+    /** The number of branch operands forwarded into the decode stage. */
+    dword_t dwDecodeForwards = 0;
+
+    /** The cycles a pipelined branch would wait in decode for its operands. */
+    dword_t dwDecodeStalls = 0;
+
+    /** The number of system calls run. */
+    dword_t dwSyscalls = 0;
+};
+
+/**
+ * Why a simulator stopped running.
+ */
+enum class StopReason {
+    NONE,                   // Still running
+    BREAKPOINT,             // About to run an instruction with a breakpoint
+    WATCHPOINT,             // An instruction touched a watched address
+    EXITED,                 // The program finished
+    CYCLE_LIMIT,            // The run reached its cycle limit, and stops for good
+    LIVELOCK                // The run came back to a state it was in, and stops for good
+};
+
+/**
+ * Where and why a simulator stopped running.
+ */
+struct SimulatorStop {
+
+    /** Why we stopped. */
+    StopReason reason = StopReason::NONE;
+
+    /** The instruction with the breakpoint, or the one that touched the watched address (or the program counter, for other stops). */
+    Memory::addr_t wPC = 0;
+
+    /** The number of cycles run before the stop. */
+    dword_t dwCycle = 0;
+
+    /** The access that touched the watched address (for watchpoints). */
+    Memory::WatchHit watch;
+
+    /** The number of cycles the run repeats every (for livelocks). */
+    dword_t dwPeriod = 0;
+};
+
+/**
+ * Everything a simulator carries from one cycle to the next, besides its
+ * registers and memory.
+ */
+struct SimulatorState {
+
+    /** The program counter. */
+    Memory::addr_t wPC = 0;
+
+    /** Whether or not the program is still running. */
+    bool bRunning = false;
+
+    /** The number of cycles left to drain the pipeline once the program exits. */
+    int iFlush = 0;
+
+    /** The statistics so far. */
+    SimulatorStats stats;
+
+    /** The pipeline latches, from the last cycle and this one. */
+    std::array<PipelineLatches, 2> arrLatches = {};
+
+    /** The index of this cycle's latches. */
+    size_t szLatch = 0;
+
+    /** The load/store unit, with its store buffer. */
+    LoadStoreUnit lsu;
+
+    /** The multiply/divide unit. */
+    MultiplyDivideUnit mdu;
+
+    /** The last stop, so a run stopped for good stays stopped. */
+    SimulatorStop stop;
+};
+
 /**
  * The main simulator class. Responsible for opening, running, and
  * controlling all aspects of the simulation.
+ * 
+ * The simulator is templated over an instrumentation policy (see
+ * NullInstrumentation), which it calls into from every stage of every cycle.
+ * Production runs use Simulator, where the policy does nothing and compiles
+ * away; diagnosis runs use InstrumentedSimulator, which runs exactly the same
+ * loop with the hooks filled in.
  */
-class Simulator {
+template <typename Instrumentation>
+class BasicSimulator {
 public:
 
+    // MARK: -- Public Types
+
+    /** The statistics of the last run. */
+    using Stats = SimulatorStats;
+
+    /** The state carried between cycles. */
+    using State = SimulatorState;
+
+    /** Where and why a run stopped. */
+    using Stop = SimulatorStop;
+
+
+    // MARK: -- Public Constants
+
+    /** The opcode breakpoints are planted as (it must not be in the instruction set). */
+    static constexpr word_t TRAP_OPCODE = Instruction::LIMIT_OPCODE;
+
+
     // MARK: -- Construction
 
     /**
      * Constructor.
      * @param instrSet The instruction set
-     * @param memory The memory for the simulator to use
+     * @param memory The memory for the simulator to use (which may be shared with other cores)
      * @param registerBank The register bank to use
      */
-    Simulator(std::unique_ptr<InstructionSet> instrSet, std::unique_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank);
+    BasicSimulator(std::unique_ptr<InstructionSet> instrSet, std::shared_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank);
 
     /**
-     * Destructor
+     * Destructor. Puts back any instructions replaced by breakpoints, since the
+     * memory may outlive us.
      */
-    ~Simulator() = default;
+    ~BasicSimulator();
 
     
     // MARK: -- Execution Methods
 
     /**
-     * Runs the simulator.
+     * Runs the simulator from start to finish.
      */
     void run();
 
+    /**
+     * Sets the address the next run starts at.
+     * @param entry The entry point (the start of the text segment by default)
+     */
+    void setEntryPoint(Memory::addr_t entry);
+
+    /**
+     * Sets the latencies of the multiply/divide unit, from the next reset on.
+     * Throws std::invalid_argument for a latency of 0.
+     * @param config The latencies
+     */
+    void setMultiplyDivideConfig(const MultiplyDivideUnit::Config& config);
+
+    /**
+     * Sets the most cycles a run may take before it stops for good, with a
+     * StopReason::CYCLE_LIMIT stop.
+     * @param limit The cycle limit (0 for none)
+     */
+    void setCycleLimit(dword_t limit);
+
+    /**
+     * Sets whether or not a run that livelocks (comes back to exactly the same
+     * state with no system call in between) stops for good, with a
+     * StopReason::LIVELOCK stop.
+     * @param detect Whether or not to watch for livelocks
+     */
+    void setLivelockDetection(bool detect);
+
+    /**
+     * Resets the pipeline and statistics, ready to step through a run from the entry point,
+     * decoding the text segment again if it has been written since it last was.
+     */
+    void reset();
+
+    /**
+     * Runs a single clock cycle.
+     * @return Whether or not the program is still running afterwards
+     */
+    bool step();
+
+    /**
+     * Retires every buffered store, for when memory is written behind the
+     * simulator's back (e.g. by other cores), so no load is forwarded a stale value.
+     */
+    void drainStores();
+
+    /**
+     * Returns whether or not the program is still running.
+     * @return Whether or not we are running
+     */
+    bool isRunning() const;
+
+    /**
+     * Returns the program counter.
+     * @return The address of the next instruction to fetch
+     */
+    Memory::addr_t getPC() const;
+
+    /**
+     * Returns the statistics of the last run.
+     * @return The statistics
+     */
+    const Stats& getStats() const;
+
+    /**
+     * Returns the load/store unit, e.g. for its forwarding statistics.
+     * @return The load/store unit
+     */
+    const LoadStoreUnit& getLoadStoreUnit() const;
+
+    /**
+     * Returns the multiply/divide unit, e.g. for its stall statistics. Its stalls
+     * are what a pipelined run would lose, and are not counted as clock cycles.
+     * @return The multiply/divide unit
+     */
+    const MultiplyDivideUnit& getMultiplyDivideUnit() const;
+
+    /**
+     * Copies out the state carried between cycles (registers and memory aside).
+     * @param state A placeholder for the state
+     */
+    void saveState(State& state) const;
+
+    /**
+     * Puts back a state copied out by saveState.
+     * @param state The state
+     */
+    void restoreState(const State& state);
+
+
+    // MARK: -- Debugging Methods
+
+    /**
+     * Sets a breakpoint, by replacing the instruction at an address with a trap
+     * the decoder only looks at when it meets one, so runs without breakpoints
+     * pay nothing. A run stops before the instruction each time it reaches it.
+     * @param addr The address of the instruction
+     * @return Whether or not the breakpoint was set
+     */
+    bool addBreakpoint(Memory::addr_t addr);
+
+    /**
+     * Removes a breakpoint, putting back the instruction it replaced.
+     * @param addr The address of the instruction
+     * @return Whether or not there was a breakpoint there
+     */
+    bool removeBreakpoint(Memory::addr_t addr);
+
+    /**
+     * Sets a watchpoint in the data segment. A run stops after the cycle of each
+     * access to it.
+     * @param addr The first address to watch
+     * @param size The number of bytes to watch
+     * @param kind The accesses to stop on
+     * @return Whether or not the watchpoint was set
+     */
+    bool addWatchpoint(Memory::addr_t addr, size_t size, Memory::WatchKind kind);
+
+    /**
+     * Removes the watchpoint starting at an address.
+     * @param addr The first address watched
+     * @return Whether or not there was a watchpoint there
+     */
+    bool removeWatchpoint(Memory::addr_t addr);
+
+    /**
+     * Runs until a breakpoint or watchpoint stops us, or the program finishes.
+     * Resuming from a breakpoint runs the instruction it stopped before.
+     * @return Where and why we stopped
+     */
+    const Stop& resume();
+
+    /**
+     * Returns where and why the last run or resume stopped, e.g. to tell a run
+     * that reached its cycle limit from one that finished.
+     * @return The last stop
+     */
+    const Stop& getStop() const;
+
+    /**
+     * Returns the instrumentation policy, e.g. to set it up before a run.
+     * @return The instrumentation
+     */
+    Instrumentation& getInstrumentation();
+
 private:
 
     // MARK: -- Private Dependency Variables
@@ -48,48 +322,178 @@ private:
     std::unique_ptr<InstructionSet> m_instrSet;
 
     /** The memory of the program. */
-    std::unique_ptr<Memory> m_memory;
+    std::shared_ptr<Memory> m_memory;
 
     /** The register bank of the program. */
     std::unique_ptr<RegisterBank> m_registerBank;
 
 
+    // MARK: -- Private Variables
+
+    /** The statistics of the last run (the instruction count doubles as the next sequence number). */
+    Stats m_stats;
+
+    /** The address runs start at. */
+    Memory::addr_t m_wEntryPoint;
+
+    /** The most cycles a run may take (0 for no limit). */
+    dword_t m_dwCycleLimit;
+
+    /** Whether or not to watch for livelocks. */
+    bool m_bDetectLivelock;
+
+    /** Watches for livelocks. */
+    LivelockDetector m_livelock;
+
+    /** The program counter. */
+    Memory::addr_t m_wPC;
+
+    /** Whether or not the program is still running. */
+    bool m_bRunning;
+
+    /** The number of cycles left to drain the pipeline once the program exits. */
+    int m_iFlush;
+
+
+    // MARK: -- Private Pipeline Variables
+
+    /** The pipeline latches, from the last cycle and this one (swapped by index). */
+    std::array<PipelineLatches, 2> m_arrLatches;
+
+    /** The index of this cycle's latches. */
+    size_t m_szLatch;
+
+    /** The load/store unit every load and store goes through. */
+    LoadStoreUnit m_lsu;
+
+    /** The multiply/divide unit every MULT, DIV and move to or from HI and LO goes through. */
+    MultiplyDivideUnit m_mdu;
+
+    /** The instrumentation. */
+    Instrumentation m_instrumentation;
+
+
+    // MARK: -- Private Predecode Variables
+
+    /** The text segment, decoded ahead of the run (see StaticAnalyzer). */
+    std::vector<PredecodedInstruction> m_vecPredecoded;
+
+    /** The writes the text segment had taken when it was decoded, to tell when its hazards have gone stale. */
+    dword_t m_dwPredecodedWrites;
+
+
+    // MARK: -- Private Debugging Variables
+
+    /** The instructions replaced by breakpoints, by address. */
+    std::unordered_map<Memory::addr_t, word_t> m_mapBreakpoints;
+
+    /** Whether we are stopped before a breakpoint (so the next decode of it runs the instruction). */
+    bool m_bAtBreakpoint;
+
+    /** Whether we set the memory's watch handler. */
+    bool m_bWatching;
+
+    /** The last stop. */
+    Stop m_stop;
+
+
     // MARK: -- Private Handler Methods (in order of cycle)
 
     /**
      * Handles the instruction fetch.
      * @param PC The program counter (will be updated by 4)
-     * @return A buffer with the fetched insruction.
+     * @param buffer The buffer to fill with the fetched instruction
      */
-    InstructionFetchBuffer handleInstructionFetch(Memory::addr_t& PC);
+    void handleInstructionFetch(Memory::addr_t& PC, InstructionFetchBuffer& buffer);
 
     /**
      * Handles the instruction decoding.
-     * @param fetchBuffer The buffer from the previous fetch
+     * @param fetchBuffer The buffer from the fetch
+     * @param PC The program counter (will be updated if we are branching)
+     * @param buffer The buffer to fill with the decoded instruction
+     */
+    void handleInstructionDecode(const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC, InstructionDecodeBuffer& buffer);
+
+    /**
+     * Handles the decoding of an instruction decoded ahead of the run, forwarding
+     * into decode only where the analysis could not rule a hazard out.
+     * @param entry The instruction, as decoded
+     * @param fetchBuffer The buffer from the fetch
+     * @param PC The program counter (will be updated if we are branching)
+     * @param buffer The buffer to fill with the decoded instruction
+     */
+    void handlePredecoded(const PredecodedInstruction& entry, const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC, InstructionDecodeBuffer& buffer);
+
+    /**
+     * Handles the decoding of a breakpoint's trap: stops before the instruction
+     * it replaced, or runs it if we already stopped there.
+     * @param fetchBuffer The buffer holding the trap
      * @param PC The program counter (will be updated if we are branching)
-     * @return A buffer with the decoded instruction.
+     * @param buffer The buffer to fill with the decoded instruction, or an exiting one to stop
      */
-    InstructionDecodeBuffer handleInstructionDecode(const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC);
+    void handleBreakpoint(const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC, InstructionDecodeBuffer& buffer);
+
+    /**
+     * Counts the forwards of a branch's operands into the decode stage from the two
+     * instructions ahead of it, and the cycles it would stall for any not yet produced.
+     * The operands themselves are read from the register bank, as every producer has retired.
+     * @param decodeBuffer The decode buffer of the branch
+     */
+    void handleDecodeForwarding(InstructionDecodeBuffer& decodeBuffer);
 
     /**
      * Handles the instruction execution.
      * @param decodeBuffer The decode buffer
-     * @param oldExecutionBuffer The old execution buffer
-     * @param newMemoryBuffer The new memory buffer
-     * @return A buffer with any output from the execution
+     * @param lastExecutionBuffer The last cycle's execution buffer
+     * @param lastMemoryBuffer The last cycle's memory buffer
+     * @param buffer The buffer to fill with any output from the execution
      */
-    ExecutionBuffer handleExecution(InstructionDecodeBuffer& decodeBuffer, ExecutionBuffer& oldExecutionBuffer, MemoryBuffer& newMemoryBuffer);
+    void handleExecution(InstructionDecodeBuffer& decodeBuffer, const ExecutionBuffer& lastExecutionBuffer, const MemoryBuffer& lastMemoryBuffer, ExecutionBuffer& buffer);
 
     /**
      * Handles the instruction memory stage.
      * @param executionBuffer The execution buffer
-     * @return A buffer with any read memory and/or data to write back
+     * @param buffer The buffer to fill with any read memory and/or data to write back
      */
-    MemoryBuffer handleMemory(const ExecutionBuffer& executionBuffer);
+    void handleMemory(const ExecutionBuffer& executionBuffer, MemoryBuffer& buffer);
 
     /**
      * Handles the instruction write back stage.
      * @param memoryBuffer The memory buffer
      */
     void handleWriteBack(const MemoryBuffer& memoryBuffer);
-};
\ No newline at end of file
+
+
+    // MARK: -- Private Predecode Methods
+
+    /**
+     * Decodes and analyzes the text segment, unless it has not changed since we last did.
+     */
+    void predecode();
+
+
+    // MARK: -- Private Debugging Methods
+
+    /**
+     * Stops the run for good, so every later step does nothing.
+     * @param reason Why we stopped
+     */
+    void halt(StopReason reason);
+
+};
+
+// MARK: -- Instantiations
+
+// Each is compiled once, in simulator.cpp
+extern template class BasicSimulator<NullInstrumentation>;
+extern template class BasicSimulator<TraceInstrumentation>;
+extern template class BasicSimulator<RecordInstrumentation>;
+
+/** The production simulator, with no instrumentation. */
+using Simulator = BasicSimulator<NullInstrumentation>;
+
+/** The diagnosis simulator, with counters, trace logging and pipeline tracing. */
+using InstrumentedSimulator = BasicSimulator<TraceInstrumentation>;
+
+/** The functional front end of a decoupled run, recording each instruction for a timing model. */
+using FunctionalSimulator = BasicSimulator<RecordInstrumentation>;
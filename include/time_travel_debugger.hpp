@@ -0,0 +1,290 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "instr/handlers/syscall_handler.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/syscall_log.hpp"
+#include "memory/memory.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+/**
+ * A debugger that can run a program backwards as well as forwards.
+ *
+ * Every interval cycles, the debugger takes a checkpoint: the simulator's
+ * state, the registers, and a snapshot of memory. Memory snapshots are taken a
+ * page at a time, and a page no one wrote since the last checkpoint is shared
+ * with it rather than copied, so checkpoints of long runs stay small.
+ *
+ * Between checkpoints, an undo log keeps the old value of every register and
+ * memory byte written in each cycle, along with the simulator's state before
+ * it. Stepping back within the interval just undoes the last cycle. Going back
+ * any further restores the checkpoint before the target and runs forward to
+ * it, as does going forward over cycles already run, so any cycle up to the
+ * furthest one reached is reached in at most one interval of work.
+ *
+ * System calls are kept in a history, so cycles that are run again take their
+ * results from it: nothing is printed, read or written to the host twice. Only
+ * the cycles past the furthest one ever reached run system calls for real.
+ */
+class TimeTravelDebugger {
+public:
+
+    // MARK: -- Public Types
+
+    /** Decides whether to stop before running the instruction at an address. */
+    using stop_fn_t = std::function<bool(Memory::addr_t)>;
+
+    /** The cost of the history. */
+    struct Stats {
+
+        /** The number of checkpoints taken. */
+        dword_t dwCheckpoints = 0;
+
+        /** The number of memory pages copied into checkpoints (the rest are shared). */
+        dword_t dwPagesCopied = 0;
+
+        /** The number of cycles run again after going back. */
+        dword_t dwCyclesReplayed = 0;
+    };
+
+
+    // MARK: -- Public Constants
+
+    /** The number of cycles between checkpoints by default. */
+    static constexpr dword_t DEFAULT_INTERVAL = 1024;
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument for an interval of 0.
+     * @param instrSet The instruction set
+     * @param memory The memory (already loaded)
+     * @param registerBank The register bank
+     * @param interval The number of cycles between checkpoints
+     */
+    TimeTravelDebugger(std::unique_ptr<InstructionSet> instrSet, std::shared_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank,
+                       dword_t interval = DEFAULT_INTERVAL);
+    ~TimeTravelDebugger();
+
+
+    // MARK: -- Forward Methods
+
+    /**
+     * Sets the most cycles the run may take before it stops for good (see Simulator::setCycleLimit).
+     * @param limit The cycle limit (0 for none)
+     */
+    void setCycleLimit(dword_t limit);
+
+    /**
+     * Sets whether or not the run stops for good on a livelock (see Simulator::setLivelockDetection).
+     * Going back forgets the states seen, so a livelock is only caught running forward over it.
+     * @param detect Whether or not to watch for livelocks
+     */
+    void setLivelockDetection(bool detect);
+
+    /**
+     * Runs a single cycle.
+     * @return Whether or not the program is still running afterwards
+     */
+    bool step();
+
+    /**
+     * Runs until the next instruction to run is one to stop at, or the program finishes.
+     * @param stop Whether to stop before an address
+     * @return Whether or not we stopped before an address (rather than at the end)
+     */
+    bool forwardContinue(const stop_fn_t& stop);
+
+
+    // MARK: -- Reverse Methods
+
+    /**
+     * Goes back a single cycle.
+     * @return Whether or not we went back (false at the start of the run)
+     */
+    bool reverseStep();
+
+    /**
+     * Goes back to the latest earlier cycle whose next instruction is one to
+     * stop at, or to the start of the run if there is none.
+     * @param stop Whether to stop before an address
+     * @return Whether or not we stopped before an address (rather than at the start)
+     */
+    bool reverseContinue(const stop_fn_t& stop);
+
+    /**
+     * Goes to a cycle, backwards or forwards.
+     * @param cycle The cycle (the number of cycles run)
+     * @return Whether or not we reached it (false if the program finishes first)
+     */
+    bool seek(dword_t cycle);
+
+
+    // MARK: -- State Methods
+
+    /**
+     * Returns the current cycle.
+     * @return The number of cycles run
+     */
+    dword_t getCycle() const;
+
+    /**
+     * Returns the furthest cycle the run has reached.
+     * @return The furthest cycle
+     */
+    dword_t getFrontier() const;
+
+    /**
+     * Returns the program counter.
+     * @return The address of the next instruction to run
+     */
+    Memory::addr_t getPC() const;
+
+    /**
+     * Returns whether or not the program is still running.
+     * @return Whether or not we are running
+     */
+    bool isRunning() const;
+
+    /**
+     * Returns why the run stopped for good at the current cycle, if it did.
+     * @return The stop (StopReason::NONE if none)
+     */
+    const SimulatorStop& getStop() const;
+
+    /**
+     * Returns the registers.
+     * @return The register bank
+     */
+    const RegisterBank& getRegisters() const;
+
+    /**
+     * Returns the memory.
+     * @return The memory
+     */
+    const Memory& getMemory() const;
+
+    /**
+     * Returns the statistics of the run up to the current cycle.
+     * @return The statistics
+     */
+    const SimulatorStats& getSimulatorStats() const;
+
+    /**
+     * Returns the cost of the history.
+     * @return The counters
+     */
+    const Stats& getStats() const;
+
+private:
+
+    // MARK: -- Private Types
+
+    /** Everything needed to go back to a cycle. */
+    struct Checkpoint {
+
+        /** The simulator's state. */
+        SimulatorState state;
+
+        /** The registers, then HI and LO. */
+        std::array<word_t, RegisterBank::NUM_REGISTERS + 2> arrRegisters;
+
+        /** The memory. */
+        Memory::Snapshot memory;
+
+        /** The number of system calls made. */
+        size_t szSyscalls;
+    };
+
+    /** Everything needed to undo a cycle. */
+    struct UndoRecord {
+
+        /** The simulator's state before the cycle. */
+        SimulatorState state;
+
+        /** The size of the register undo log before the cycle. */
+        size_t szRegisters;
+
+        /** The size of the memory undo log before the cycle. */
+        size_t szMemory;
+
+        /** The number of system calls made before the cycle. */
+        size_t szSyscalls;
+    };
+
+
+    // MARK: -- Private Variables
+
+    /** The simulator. */
+    std::unique_ptr<Simulator> m_ptrSimulator;
+
+    /** The memory (shared with the simulator). */
+    std::shared_ptr<Memory> m_ptrMemory;
+
+    /** The registers (owned by the simulator). */
+    RegisterBank * m_ptrRegisters;
+
+    /** The system call handler (owned by the simulator's instruction set, if any). */
+    SyscallHandler * m_ptrSyscalls;
+
+    /** Every system call made so far. */
+    std::shared_ptr<SyscallLog> m_ptrHistory;
+
+    /** The number of cycles between checkpoints. */
+    dword_t m_dwInterval;
+
+    /** The checkpoints, one per interval. */
+    std::vector<Checkpoint> m_vecCheckpoints;
+
+    /** A record per cycle run since the last checkpoint. */
+    std::vector<UndoRecord> m_vecUndo;
+
+    /** The old values of registers written since the last checkpoint. */
+    RegisterBank::undo_log_t m_vecRegisterUndo;
+
+    /** The old values of memory written since the last checkpoint. */
+    Memory::journal_t m_vecMemoryUndo;
+
+    /** The furthest cycle reached. */
+    dword_t m_dwFrontier;
+
+    /** The cost of the history. */
+    Stats m_stats;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Runs a cycle, keeping what is needed to undo it.
+     * @return Whether or not a cycle was run
+     */
+    bool stepForward();
+
+    /**
+     * Undoes the last cycle run since the last checkpoint.
+     */
+    void undoCycle();
+
+    /**
+     * Takes a checkpoint of the current cycle.
+     */
+    void takeCheckpoint();
+
+    /**
+     * Goes back to a checkpoint.
+     * @param index The checkpoint
+     */
+    void restoreCheckpoint(size_t index);
+
+    /**
+     * Forgets the undo log, at a checkpoint.
+     */
+    void clearUndo();
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * A reusable barrier for a fixed number of threads.
+ *
+ * Every thread that calls wait() blocks until the last of them arrives, at
+ * which point they are all released together and the barrier is ready for
+ * the next round.
+ */
+class Barrier {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param count The number of threads that meet at the barrier (at least 1)
+     */
+    Barrier(size_t count);
+    ~Barrier() = default;
+
+    Barrier(const Barrier&) = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+
+    // MARK: -- Synchronisation Methods
+
+    /**
+     * Waits until every thread has arrived.
+     * @return Whether or not this thread was the last to arrive
+     */
+    bool wait();
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** Guards the counters. */
+    std::mutex m_mutex;
+
+    /** Wakes the waiting threads. */
+    std::condition_variable m_condition;
+
+    /** The number of threads that meet at the barrier. */
+    size_t m_szCount;
+
+    /** The number of threads still to arrive this round. */
+    size_t m_szWaiting;
+
+    /** The current round, so threads can tell their round is over. */
+    size_t m_szGeneration;
+};
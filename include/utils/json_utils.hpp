@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A namespace containing the little JSON the batch runner reads and writes:
+ * one flat object per line, whose values are strings, numbers, booleans,
+ * null, or arrays of strings.
+ */
+namespace JsonUtils {
+
+    // MARK: -- Types
+
+    /**
+     * A value of a flat object.
+     */
+    struct Value {
+
+        /** The kinds of value. */
+        enum class Kind {
+            NONE,                   // null
+            STRING,                 // A string
+            NUMBER,                 // A number (kept as written)
+            BOOLEAN,                // true or false
+            ARRAY                   // An array of strings
+        };
+
+        /** The kind of value. */
+        Kind kind = Kind::NONE;
+
+        /** The string, or the number as it was written. */
+        std::string str;
+
+        /** The boolean. */
+        bool b = false;
+
+        /** The strings of an array. */
+        std::vector<std::string> vecItems;
+    };
+
+
+    // MARK: -- Parsing Methods
+
+    /**
+     * Parses a flat object.
+     * @param text The object (surrounding whitespace is ignored)
+     * @param object A placeholder for its values, by key
+     * @param error A placeholder for what was wrong with it, if anything
+     * @return Whether or not it could be parsed
+     */
+    bool parseObject(const std::string& text, std::unordered_map<std::string, Value>& object, std::string& error);
+
+
+    // MARK: -- Writing Methods
+
+    /**
+     * Quotes a string, escaping anything JSON needs escaped.
+     * @param str The string
+     * @return The quoted string
+     */
+    std::string quote(const std::string& str);
+}
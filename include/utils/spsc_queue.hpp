@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * A bounded, lock-free queue for exactly one producer thread and one consumer
+ * thread.
+ *
+ * The queue is a ring buffer whose size is a power of two. The producer only
+ * ever writes the tail and the consumer only ever writes the head, so neither
+ * needs a lock or a read-modify-write, and each side keeps a cached copy of the
+ * other's index so it only touches the shared one when the ring looks full (or
+ * empty). Each side's variables are padded a cache line apart from the other's
+ * (rather than aligned, which a C++11 new would not honour), so the two threads
+ * do not keep stealing each other's line wherever the queue is allocated.
+ */
+template <typename T>
+class SpscQueue {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Throws std::invalid_argument unless the capacity is a power of two.
+     * @param capacity The number of elements the queue holds
+     */
+    explicit SpscQueue(size_t capacity)
+    : m_vecSlots(capacity)
+    , m_szMask(capacity - 1)
+    , m_szHead(0)
+    , m_szCachedTail(0)
+    , m_szTail(0)
+    , m_szCachedHead(0)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument("Queue capacity must be a power of two of at least 2");
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+
+    // MARK: -- Producer Methods
+
+    /**
+     * Adds an element, unless the queue is full. Only call from the producer.
+     * @param value The element
+     * @return Whether or not the element was added
+     */
+    bool tryPush(const T& value) {
+
+        size_t tail = this->m_szTail.load(std::memory_order_relaxed);
+        if (tail - this->m_szCachedHead == this->m_vecSlots.size()) {
+            this->m_szCachedHead = this->m_szHead.load(std::memory_order_acquire);
+            if (tail - this->m_szCachedHead == this->m_vecSlots.size())
+                return false;
+        }
+
+        this->m_vecSlots[tail & this->m_szMask] = value;
+        this->m_szTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    // MARK: -- Consumer Methods
+
+    /**
+     * Takes the oldest element, unless the queue is empty. Only call from the consumer.
+     * @param value A placeholder for the element
+     * @return Whether or not an element was taken
+     */
+    bool tryPop(T& value) {
+
+        size_t head = this->m_szHead.load(std::memory_order_relaxed);
+        if (head == this->m_szCachedTail) {
+            this->m_szCachedTail = this->m_szTail.load(std::memory_order_acquire);
+            if (head == this->m_szCachedTail)
+                return false;
+        }
+
+        value = this->m_vecSlots[head & this->m_szMask];
+        this->m_szHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    // MARK: -- Size Methods
+
+    /**
+     * Returns the number of elements the queue holds.
+     * @return The capacity
+     */
+    size_t getCapacity() const {
+        return this->m_vecSlots.size();
+    }
+
+    /**
+     * Returns whether the queue looks empty. Only exact when neither side is running.
+     * @return Whether or not the queue is empty
+     */
+    bool isEmpty() const {
+        return this->m_szHead.load(std::memory_order_acquire) == this->m_szTail.load(std::memory_order_acquire);
+    }
+
+private:
+
+    // MARK: -- Private Constants
+
+    /** The size of a cache line, to keep the two sides apart. */
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+
+    // MARK: -- Private Variables
+
+    /** The ring of elements. */
+    std::vector<T> m_vecSlots;
+
+    /** The mask taking an index to its slot. */
+    size_t m_szMask;
+
+    /** Keeps the consumer's variables off the line of those before them. */
+    char m_arrPadHead[CACHE_LINE_SIZE];
+
+    /** The next element to take (written by the consumer). */
+    std::atomic<size_t> m_szHead;
+
+    /** The consumer's copy of the tail. */
+    size_t m_szCachedTail;
+
+    /** Keeps the producer's variables off the consumer's line. */
+    char m_arrPadTail[CACHE_LINE_SIZE];
+
+    /** The next slot to fill (written by the producer). */
+    std::atomic<size_t> m_szTail;
+
+    /** The producer's copy of the head. */
+    size_t m_szCachedHead;
+
+    /** Keeps the producer's variables off the line of whatever comes after the queue. */
+    char m_arrPadEnd[CACHE_LINE_SIZE];
+};
+
+template <typename T>
+constexpr size_t SpscQueue<T>::CACHE_LINE_SIZE;
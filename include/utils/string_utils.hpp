@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "types.hpp"
 
@@ -60,4 +61,15 @@ namespace StringUtils {
      * @return The trimmed string
      */
     std::string trim(std::string str);
+
+
+    // MARK: -- Splitting Methods
+
+    /**
+     * Splits a string on a separator, trimming each piece and dropping empty ones.
+     * @param str The string to split
+     * @param separator The separator
+     * @return The pieces
+     */
+    std::vector<std::string> split(const std::string& str, char separator);
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "types.hpp"
+
+/**
+ * A pool of host threads that runs a numbered list of tasks.
+ *
+ * The tasks are dealt out round-robin, each thread to its own queue, which it
+ * works through from the front. A thread whose queue runs dry steals the oldest
+ * task left in any other queue, so a few slow tasks never leave threads idle
+ * behind them. Tasks are long (each is a whole run), so the queues share a
+ * single lock.
+ *
+ * No task starts more than a window of tasks ahead of the oldest one still
+ * unfinished, so whoever collects the results in order never holds more than
+ * the window of them at once.
+ */
+class WorkStealingPool {
+public:
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor.
+     * @param threads The number of threads (at least 1)
+     * @param window The most tasks that may be started past the oldest unfinished one (at least 1)
+     * @param pin Whether or not to pin each thread to its own host CPU (where the host allows it)
+     */
+    WorkStealingPool(size_t threads, size_t window, bool pin);
+    ~WorkStealingPool() = default;
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+
+    // MARK: -- Execution Methods
+
+    /**
+     * Runs tasks 0 to count - 1, returning once every one has finished.
+     * @param count The number of tasks
+     * @param task Runs a task, given its number (called from the pool's threads)
+     */
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * Returns the number of threads.
+     * @return The number of threads
+     */
+    size_t getThreads() const;
+
+    /**
+     * Returns the number of tasks stolen in the last run.
+     * @return The number of steals
+     */
+    dword_t getSteals() const;
+
+    /**
+     * Returns the number of threads the host can run at once.
+     * @return The number of threads (at least 1)
+     */
+    static size_t getHostThreads();
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The number of threads. */
+    size_t m_szThreads;
+
+    /** The most tasks that may be started past the oldest unfinished one. */
+    size_t m_szWindow;
+
+    /** Whether or not each thread is pinned to a host CPU. */
+    bool m_bPin;
+
+    /** Guards the queues and the progress of the run. */
+    std::mutex m_mutex;
+
+    /** Wakes threads waiting for the window to move. */
+    std::condition_variable m_condition;
+
+    /** The tasks still to start, one queue per thread. */
+    std::vector<std::deque<size_t>> m_vecQueues;
+
+    /** Whether or not each task has finished. */
+    std::vector<bool> m_vecFinished;
+
+    /** The oldest unfinished task. */
+    size_t m_szOldest;
+
+    /** The number of tasks stolen. */
+    dword_t m_dwSteals;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Runs tasks on one thread until there are none left.
+     * @param worker The index of the thread
+     * @param task Runs a task
+     */
+    void work(size_t worker, const std::function<void(size_t)>& task);
+
+    /**
+     * Takes the next task for a thread, from its own queue or (failing that)
+     * the oldest of another's. Must be called holding the lock.
+     * @param worker The index of the thread
+     * @param index A placeholder for the task
+     * @return Whether or not there was a task left
+     */
+    bool take(size_t worker, size_t& index);
+};
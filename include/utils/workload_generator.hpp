@@ -0,0 +1,187 @@
+#pragma once
+
+#include <ostream>
+#include <random>
+#include <string>
+
+#include "types.hpp"
+
+/**
+ * Generates synthetic (but valid) assembly programs for scaling tests.
+ *
+ * A program is a sequence of blocks. Each block is a nest of counted loops
+ * around a straight-line body of ALU operations, byte loads, and short forward
+ * branches. Blocks are kept small enough that every branch stays within the
+ * 16-bit branch range, so programs can be made as large as needed simply by
+ * adding more blocks. Output is streamed, so generating a program of hundreds
+ * of megabytes does not hold it in memory.
+ *
+ * The same options and seed always produce the same program.
+ */
+class WorkloadGenerator {
+public:
+
+    // MARK: -- Public Constants
+
+    /** The deepest loop nest we allow (one counter register per level). */
+    static constexpr size_t MAX_NESTING = 8;
+
+    /** The largest body per block, keeping loop branches within range. */
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+    /** The largest chunk of data reachable from a single base register. */
+    static constexpr size_t DATA_CHUNK_SIZE = 32768;
+
+    /** The number of registers values rotate through. */
+    static constexpr size_t NUM_WORK_REGISTERS = 10;
+
+
+    // MARK: -- Public Types
+
+    /** The shape of the generated program. */
+    struct Options {
+
+        /** The number of statements to generate (scaffolding included). */
+        size_t szInstructions = 1000;
+
+        /** Stops once this many bytes of source are written instead (0 to ignore). */
+        size_t szTargetBytes = 0;
+
+        /** The loop nesting depth of each block (0 for straight-line code). */
+        size_t szNesting = 1;
+
+        /** The number of iterations of each loop. */
+        size_t szIterations = 4;
+
+        /** The number of body statements in each block. */
+        size_t szBlockSize = 256;
+
+        /** The fraction of body statements that are forward branches. */
+        double dBranchDensity = 0.1;
+
+        /** The fraction of body statements that are loads. */
+        double dLoadDensity = 0.2;
+
+        /** How many statements back each statement's first operand was produced. */
+        size_t szDependencyDistance = 1;
+
+        /** The size of the data segment in bytes. */
+        size_t szDataSize = 4096;
+
+        /** The random seed. */
+        word_t wSeed = 1;
+    };
+
+    /** A summary of a generated program. */
+    struct Summary {
+
+        /** The number of statements written. */
+        size_t szInstructions = 0;
+
+        /** The number of blocks written. */
+        size_t szBlocks = 0;
+
+        /** The number of lines written. */
+        size_t szLines = 0;
+
+        /** The number of bytes written. */
+        size_t szBytes = 0;
+    };
+
+
+    // MARK: -- Construction
+
+    /**
+     * Constructor. Out of range options are clamped.
+     * @param options The program options
+     */
+    explicit WorkloadGenerator(const Options& options);
+    ~WorkloadGenerator() = default;
+
+
+    // MARK: -- Generation Methods
+
+    /**
+     * Returns the (clamped) options used to generate programs.
+     * @return The options
+     */
+    const Options& getOptions() const;
+
+    /**
+     * Generates a program.
+     * @param out The stream to write the program to
+     * @return A summary of what was written
+     */
+    Summary generate(std::ostream& out);
+
+private:
+
+    // MARK: -- Private Variables
+
+    /** The options. */
+    Options m_options;
+
+    /** The random number generator. */
+    std::mt19937 m_rng;
+
+    /** The output stream (only set while generating). */
+    std::ostream * m_ptrOut;
+
+    /** The summary of the program being generated. */
+    Summary m_summary;
+
+    /** The number of values produced so far (picks the destination register). */
+    size_t m_szProduced;
+
+    /** The number of forward branch labels used so far. */
+    size_t m_szLabels;
+
+
+    // MARK: -- Private Methods
+
+    /**
+     * Writes a line.
+     * @param line The line (without the newline)
+     * @param statement Whether or not the line is a statement
+     */
+    void emit(const std::string& line, bool statement = true);
+
+    /**
+     * Writes a single block.
+     * @param block The block number
+     * @param budget The number of statements the block may use
+     */
+    void emitBlock(size_t block, size_t budget);
+
+    /**
+     * Writes a single ALU or load statement.
+     * @param chunkSize The size of the data chunk loads can reach (0 for no loads)
+     */
+    void emitOperation(size_t chunkSize);
+
+    /**
+     * Returns whether or not we have generated enough.
+     * @return Whether or not the budget is used up
+     */
+    bool isDone() const;
+
+    /**
+     * Returns a random number in [0, bound).
+     * @param bound The upper bound (must be above 0)
+     * @return The number
+     */
+    word_t random(word_t bound);
+
+    /**
+     * Returns a random number in [0, 1).
+     * @return The number
+     */
+    double randomFraction();
+
+    /**
+     * Returns the name of a working register.
+     * @param index The index (wraps around)
+     * @return The register name
+     */
+    static std::string workRegister(size_t index);
+};
@@ -0,0 +1,564 @@
+#include "batch_runner.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "spdlog/spdlog.h"
+
+#include "utils/json_utils.hpp"
+#include "utils/string_utils.hpp"
+#include "utils/work_stealing_pool.hpp"
+
+// MARK: -- Helpers
+
+// The rule run() prints above and below the program's output
+static const std::string OUTPUT_RULE = "------------\n";
+
+// What run() prints as the program's output starts
+static const std::string OUTPUT_START = "Output:\n" + OUTPUT_RULE;
+
+// The FNV-1a offset basis and prime the output is hashed with
+static const dword_t HASH_BASIS = 14695981039346656037ull;
+static const dword_t HASH_PRIME = 1099511628211ull;
+
+// Reads a non-negative whole number from a job
+static bool readCount(const JsonUtils::Value& value, const std::string& key, dword_t& count, std::string& error) {
+
+    if (value.kind != JsonUtils::Value::Kind::NUMBER || value.str.empty() || value.str.find_first_not_of("0123456789") != std::string::npos) {
+        error = "\"" + key + "\" must be a whole number";
+        return false;
+    }
+
+    try {
+        count = std::stoull(value.str);
+        return true;
+    }
+    catch (const std::out_of_range& e) {
+        error = "\"" + key + "\" is too large";
+        return false;
+    }
+}
+
+// Removes the time, logger and level spdlog puts before a message
+static std::string stripLogPrefix(std::string line) {
+
+    for (int field = 0; field < 3 && !line.empty() && line[0] == '['; ++field) {
+        size_t close = line.find("] ");
+        if (close == std::string::npos)
+            break;
+        line = line.substr(close + 2);
+    }
+
+    return line;
+}
+
+// Returns the signal a fault names at its start (e.g. "SIGLOOP: ..."), if any
+static std::string getSignal(const std::string& trap) {
+
+    size_t length = 3;
+    if (trap.compare(0, length, "SIG") != 0)
+        return "";
+
+    while (length < trap.length() && std::isupper(static_cast<unsigned char>(trap[length])))
+        length++;
+
+    return (length > 3 && trap.compare(length, 1, ":") == 0) ? trap.substr(0, length) : "";
+}
+
+// Turns a statistic's label into a name (e.g. "Branch Forwards (ID)" to "branch_forwards_id")
+static std::string toCounterName(const std::string& label) {
+
+    std::string name;
+    for (char c : label) {
+        if (std::isalnum(static_cast<unsigned char>(c)))
+            name += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        else if (!name.empty() && name.back() != '_')
+            name += '_';
+    }
+
+    while (!name.empty() && name.back() == '_')
+        name.pop_back();
+    return name;
+}
+
+
+// MARK: -- Construction
+
+// Constructs the runner
+BatchRunner::BatchRunner(const Config& config)
+: m_config(config)
+{
+    if (this->m_config.strExecutable.empty())
+        throw std::invalid_argument("Cannot run a batch without a simulator executable");
+}
+
+
+// MARK: -- Job Methods
+
+// Parses a job
+bool BatchRunner::parseJob(const std::string& line, size_t number, Job& job, std::string& error) {
+
+    std::unordered_map<std::string, JsonUtils::Value> object;
+    if (!JsonUtils::parseObject(line, object, error))
+        return false;
+
+    job = Job();
+    job.strId = std::to_string(number);
+    for (const auto& field : object) {
+
+        const std::string& key = field.first;
+        const JsonUtils::Value& value = field.second;
+        if (key == "id" && (value.kind == JsonUtils::Value::Kind::STRING || value.kind == JsonUtils::Value::Kind::NUMBER))
+            job.strId = value.str;
+        else if (key == "program" && value.kind == JsonUtils::Value::Kind::STRING)
+            job.strProgram = value.str;
+        else if (key == "input" && value.kind == JsonUtils::Value::Kind::STRING)
+            job.strInput = value.str;
+        else if (key == "options" && value.kind == JsonUtils::Value::Kind::ARRAY)
+            job.vecOptions = value.vecItems;
+        else if (key == "max_cycles") {
+            if (!readCount(value, key, job.dwMaxCycles, error))
+                return false;
+        }
+        else if (key == "timeout_ms") {
+            if (!readCount(value, key, job.dwTimeoutMs, error))
+                return false;
+        }
+        else {
+            error = "unknown or mistyped field \"" + key + "\"";
+            return false;
+        }
+    }
+
+    if (job.strProgram.empty()) {
+        error = "no \"program\" to run";
+        return false;
+    }
+
+    return true;
+}
+
+// Reads jobs
+bool BatchRunner::readJobs(const std::string& path, std::vector<Job>& jobs) {
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        spdlog::error("Unable to open jobs file {}", path);
+        return false;
+    }
+
+    jobs.clear();
+    std::string line;
+    size_t number = 0;
+    bool valid = true;
+    while (std::getline(file, line)) {
+
+        number++;
+        if (StringUtils::trim(line).empty())
+            continue;
+
+        Job job;
+        std::string error;
+        if (!parseJob(line, number, job, error)) {
+            spdlog::error("{}:{}: {}", path, number, error);
+            valid = false;
+            continue;
+        }
+
+        jobs.push_back(job);
+    }
+
+    return valid;
+}
+
+
+// MARK: -- Execution Methods
+
+// Runs every job
+BatchRunner::Stats BatchRunner::run(const std::vector<Job>& jobs, std::ostream& results) const {
+
+    size_t threads = (this->m_config.szThreads > 0) ? this->m_config.szThreads : WorkStealingPool::getHostThreads();
+    WorkStealingPool pool(threads, this->m_config.szWindow, this->m_config.bPin);
+
+    // Results wait here until every job before them has one (the pool keeps them within its window)
+    std::mutex mutex;
+    std::map<size_t, Result> held;
+    size_t next = 0;
+    Stats stats;
+    stats.dwJobs = jobs.size();
+
+    pool.run(jobs.size(), [&](size_t index) {
+
+        Result result = this->runJob(index, jobs[index]);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        held.emplace(index, std::move(result));
+        for (auto search = held.find(next); search != held.end(); search = held.find(++next)) {
+
+            writeResult(results, search->second);
+            switch (search->second.status) {
+                case Status::OK:        stats.dwOk++; break;
+                case Status::TRAP:
+                    stats.dwTraps++;
+                    if (search->second.strSignal == "SIGLOOP") stats.dwLivelocks++;
+                    if (search->second.strSignal == "SIGXCPU") stats.dwCycleLimits++;
+                    break;
+                case Status::TIMEOUT:   stats.dwTimeouts++; break;
+                case Status::ERROR:     stats.dwErrors++; break;
+            }
+            held.erase(search);
+        }
+        results.flush();
+    });
+
+    stats.dwSteals = pool.getSteals();
+    return stats;
+}
+
+
+// MARK: -- Result Methods
+
+// Parses a job's output
+void BatchRunner::parseOutput(const std::string& output, Result& result) {
+
+    OutputParser parser;
+    parser.append(output.data(), output.length());
+    parser.finish(result);
+}
+
+// Writes a result
+void BatchRunner::writeResult(std::ostream& stream, const Result& result) {
+
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(result.dwOutputHash));
+
+    std::string cycles = "null";
+    std::string counters;
+    for (const auto& counter : result.vecCounters) {
+        if (counter.first == "clock_cycles")
+            cycles = std::to_string(counter.second);
+        counters += (counters.empty() ? "" : ", ") + JsonUtils::quote(counter.first) + ": " + std::to_string(counter.second);
+    }
+
+    stream << "{\"job\": " << result.szJob
+           << ", \"id\": " << JsonUtils::quote(result.strId)
+           << ", \"status\": \"" << getStatusName(result.status) << "\""
+           << ", \"exit_code\": " << result.iExitCode
+           << ", \"cycles\": " << cycles
+           << ", \"counters\": {" << counters << "}"
+           << ", \"output_hash\": \"" << hash << "\""
+           << ", \"output_bytes\": " << result.dwOutputBytes
+           << ", \"trap\": " << (result.strTrap.empty() ? "null" : JsonUtils::quote(result.strTrap))
+           << ", \"signal\": " << (result.strSignal.empty() ? "null" : JsonUtils::quote(result.strSignal))
+           << "}\n";
+}
+
+// Returns the name of a status
+const char * BatchRunner::getStatusName(Status status) {
+
+    switch (status) {
+        case Status::OK:        return "ok";
+        case Status::TRAP:      return "trap";
+        case Status::TIMEOUT:   return "timeout";
+        case Status::ERROR:     return "error";
+    }
+
+    return "error";
+}
+
+
+// MARK: -- Output Parser
+
+// Constructs the parser
+BatchRunner::OutputParser::OutputParser()
+: m_bInOutput(false)
+, m_dwLength(0)
+, m_dwHash(HASH_BASIS)
+, m_dwBytes(0)
+, m_bLineStart(true)
+, m_dwLineHash(HASH_BASIS)
+, m_dwLineBytes(0)
+, m_bLastLine(false)
+, m_dwLastLineHash(HASH_BASIS)
+, m_dwLastLineBytes(0)
+, m_iRuleMatch(0)
+, m_bFinished(false)
+, m_dwRuleHash(HASH_BASIS)
+, m_dwRuleBytes(0)
+, m_dwRuleEnd(0)
+, m_dwTailStart(0)
+{ }
+
+// Reads the next part of the output
+void BatchRunner::OutputParser::append(const char * data, size_t length) {
+
+    for (size_t i = 0; i < length; ++i) {
+
+        char c = data[i];
+        this->m_dwLength++;
+
+        // Until the program's output starts, only the bytes that might start it are kept
+        if (!this->m_bInOutput) {
+            this->m_strWindow += c;
+            if (this->m_strWindow.length() > OUTPUT_START.length())
+                this->m_strWindow.erase(0, 1);
+            this->m_bInOutput = this->m_strWindow == OUTPUT_START;
+            continue;
+        }
+
+        if (this->m_bLineStart) {
+            this->m_dwLineHash = this->m_dwHash;
+            this->m_dwLineBytes = this->m_dwBytes;
+            this->m_iRuleMatch = 0;
+            this->m_bLineStart = false;
+        }
+
+        // Everything is hashed, since the program may print a rule itself and only the last one ends its output
+        this->m_dwHash ^= static_cast<byte_t>(c);
+        this->m_dwHash *= HASH_PRIME;
+        this->m_dwBytes++;
+
+        if (this->m_iRuleMatch >= 0 && static_cast<size_t>(this->m_iRuleMatch) < OUTPUT_RULE.length() && OUTPUT_RULE[this->m_iRuleMatch] == c)
+            this->m_iRuleMatch++;
+        else
+            this->m_iRuleMatch = -1;
+
+        if (c == '\n') {
+            if (this->m_iRuleMatch == static_cast<sdword_t>(OUTPUT_RULE.length())) {
+                this->m_bFinished = true;
+                this->m_dwRuleHash = this->m_dwLineHash;
+                this->m_dwRuleBytes = this->m_dwLineBytes;
+                this->m_dwRuleEnd = this->m_dwLength;
+            }
+
+            this->m_bLastLine = true;
+            this->m_dwLastLineHash = this->m_dwLineHash;
+            this->m_dwLastLineBytes = this->m_dwLineBytes;
+            this->m_bLineStart = true;
+        }
+    }
+
+    // The tail is trimmed once it has grown to twice what is kept, so each byte is only moved once
+    this->m_strTail.append(data, length);
+    if (this->m_strTail.length() > 2 * TAIL_BYTES) {
+        size_t extra = this->m_strTail.length() - TAIL_BYTES;
+        this->m_strTail.erase(0, extra);
+        this->m_dwTailStart += extra;
+    }
+}
+
+// Returns the number of bytes read
+dword_t BatchRunner::OutputParser::getLength() const {
+    return this->m_dwLength;
+}
+
+// Fills in a result
+void BatchRunner::OutputParser::finish(Result& result) const {
+
+    result.vecCounters.clear();
+    result.dwOutputHash = HASH_BASIS;
+    result.dwOutputBytes = 0;
+
+    // A fault ends the run with its message, which is the last thing it prints
+    const std::string& tail = this->m_strTail;
+    size_t lastLine = tail.rfind('\n', tail.empty() ? 0 : tail.length() - 2);
+    lastLine = (lastLine == std::string::npos) ? 0 : lastLine + 1;
+    if (result.status != Status::OK && lastLine < tail.length()) {
+        std::string trap = tail.substr(lastLine);
+        if (!trap.empty() && trap.back() == '\n')
+            trap.pop_back();
+        result.strTrap = stripLogPrefix(trap);
+        result.strSignal = getSignal(result.strTrap);
+    }
+
+    if (!this->m_bInOutput)
+        return;
+
+    // The program's output ends at the last rule, unless a fault cut it short before the second
+    if (this->m_bFinished) {
+        result.dwOutputHash = this->m_dwRuleHash;
+        result.dwOutputBytes = this->m_dwRuleBytes;
+    }
+    else if (result.status != Status::OK && !this->m_bLineStart) {
+        result.dwOutputHash = this->m_dwLineHash;
+        result.dwOutputBytes = this->m_dwLineBytes;
+    }
+    else if (result.status != Status::OK && this->m_bLastLine) {
+        result.dwOutputHash = this->m_dwLastLineHash;
+        result.dwOutputBytes = this->m_dwLastLineBytes;
+    }
+    else {
+        result.dwOutputHash = this->m_dwHash;
+        result.dwOutputBytes = this->m_dwBytes;
+    }
+
+    if (!this->m_bFinished)
+        return;
+
+    // Every statistic reported after the output is a "Total <label>: <count>" line, starting
+    // from the first whole line kept if the rule itself has been cut off
+    size_t start = 0;
+    if (this->m_dwRuleEnd >= this->m_dwTailStart)
+        start = static_cast<size_t>(this->m_dwRuleEnd - this->m_dwTailStart);
+    else {
+        start = tail.find('\n');
+        start = (start == std::string::npos) ? tail.length() : start + 1;
+    }
+
+    std::string line;
+    for (size_t pos = start; pos < tail.length(); pos += line.length() + 1) {
+
+        size_t newline = tail.find('\n', pos);
+        line = tail.substr(pos, (newline == std::string::npos) ? std::string::npos : newline - pos);
+
+        std::string message = stripLogPrefix(line);
+        size_t colon = message.find(": ");
+        if (message.compare(0, 6, "Total ") != 0 || colon == std::string::npos)
+            continue;
+
+        size_t digits = colon + 2;
+        size_t length = 0;
+        while (digits + length < message.length() && std::isdigit(static_cast<unsigned char>(message[digits + length])))
+            length++;
+        if (length == 0)
+            continue;
+
+        result.vecCounters.emplace_back(toCounterName(message.substr(6, colon - 6)), std::stoull(message.substr(digits, length)));
+    }
+}
+
+
+// MARK: -- Private Methods
+
+// Runs a job
+BatchRunner::Result BatchRunner::runJob(size_t index, const Job& job) const {
+
+    Result result;
+    result.szJob = index;
+    result.strId = job.strId;
+
+    dword_t maxCycles = (job.dwMaxCycles > 0) ? job.dwMaxCycles : this->m_config.dwMaxCycles;
+    dword_t timeout = (job.dwTimeoutMs > 0) ? job.dwTimeoutMs : this->m_config.dwTimeoutMs;
+
+    // Everything the child needs is built before it is forked, since it may only exec
+    std::vector<std::string> args = { this->m_config.strExecutable, job.strProgram };
+    if (!job.strInput.empty()) {
+        args.push_back("--stdin-file");
+        args.push_back(job.strInput);
+    }
+    if (maxCycles > 0) {
+        args.push_back("--max-cycles");
+        args.push_back(std::to_string(maxCycles));
+    }
+    if (this->m_config.bDetectLivelock)
+        args.push_back("--detect-livelock");
+    args.insert(args.end(), job.vecOptions.begin(), job.vecOptions.end());
+
+    std::vector<char *> argv;
+    for (auto& arg : args)
+        argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    // Other threads fork too, so the pipe must not leak into their children
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        result.strTrap = "unable to create a pipe for the job";
+        return result;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        result.strTrap = "unable to start the job";
+        return result;
+    }
+
+    if (pid == 0) {
+        int input = open("/dev/null", O_RDONLY);
+        if (input >= 0)
+            dup2(input, STDIN_FILENO);
+        dup2(fds[1], STDOUT_FILENO);
+        dup2(fds[1], STDERR_FILENO);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    close(fds[1]);
+
+    // Read everything the child writes as it comes, until it exits or runs out of time
+    OutputParser parser;
+    bool timedOut = false, failed = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    char buffer[4096];
+    while (true) {
+
+        int wait = -1;
+        if (timeout > 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                timedOut = true;
+                break;
+            }
+            wait = static_cast<int>(left);
+        }
+
+        struct pollfd fd = { fds[0], POLLIN, 0 };
+        int ready = poll(&fd, 1, wait);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready < 0) {
+            failed = true;
+            break;
+        }
+        if (ready == 0)
+            continue;
+
+        ssize_t count = read(fds[0], buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            break;
+        parser.append(buffer, count);
+    }
+
+    if (timedOut || failed)
+        kill(pid, SIGKILL);
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) { }
+    result.iExitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+
+    if (failed) {
+        result.strTrap = "unable to read the output of the job";
+    }
+    else if (timedOut) {
+        result.status = Status::TIMEOUT;
+        parser.finish(result);
+        result.strTrap = "timed out after " + std::to_string(timeout) + " ms";
+        result.strSignal.clear();
+    }
+    else if (result.iExitCode == 127 && parser.getLength() == 0) {
+        result.strTrap = "unable to run " + this->m_config.strExecutable;
+    }
+    else {
+        result.status = (result.iExitCode == 0) ? Status::OK : Status::TRAP;
+        parser.finish(result);
+    }
+
+    return result;
+}
@@ -0,0 +1,174 @@
+#include "decoupled_simulator.hpp"
+
+#include <thread>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+#include "pipeline/record_instrumentation.hpp"
+
+// MARK: -- Constants
+constexpr size_t DecoupledSimulator::DEFAULT_QUEUE_SIZE;
+
+
+// MARK: -- Construction
+
+// Constructor
+DecoupledSimulator::DecoupledSimulator(std::unique_ptr<InstructionSet> instrSet, std::shared_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank,
+                                       const TimingModel::Config& config, size_t queueSize)
+: m_ptrInstrSet(instrSet.get())
+, m_timing(config)
+, m_queue(queueSize)
+, m_bParallel(true)
+{
+    // Does the snapshot of the text segment before anything can write to it
+    if (memory != nullptr) {
+        this->m_vecText.resize(memory->getTextSize());
+        memory->readBlock(Memory::MEM_USER_START, this->m_vecText.data(), this->m_vecText.size());
+    }
+
+    // The front end checks its own arguments
+    this->m_ptrFrontEnd = std::unique_ptr<FunctionalSimulator>(new FunctionalSimulator(std::move(instrSet), std::move(memory), std::move(registerBank)));
+    this->m_timing.setWrongPathSource([this](Memory::addr_t pc, size_t count, std::vector<RetireRecord>& records) {
+        this->decodeWrongPath(pc, count, records);
+    });
+}
+
+
+// MARK: -- Execution Methods
+
+// Runs the program
+void DecoupledSimulator::run() {
+
+    this->m_ptrFrontEnd->reset();
+    this->m_timing.reset();
+
+    // Output
+    spdlog::info("Running Simulator (decoupled{})...", this->m_bParallel ? ", parallel" : "");
+    spdlog::set_pattern("%v");
+
+    spdlog::info("");
+    spdlog::info("Output:");
+    spdlog::info("------------");
+
+    if (this->m_bParallel) {
+        std::thread frontEnd(&DecoupledSimulator::runFrontEnd, this);
+        this->runBackEnd();
+        frontEnd.join();
+    }
+    else {
+
+        // Does both halves in turn, handing each record straight over
+        while (true) {
+            bool running = this->m_ptrFrontEnd->step();
+            RetireRecord record = this->m_ptrFrontEnd->getInstrumentation().getRecord();
+            record.bExit = !running;
+            this->m_timing.consume(record);
+            if (!running) break;
+        }
+        this->m_timing.finish();
+    }
+
+    spdlog::info("------------");
+    spdlog::info("");
+    spdlog::set_pattern("%+");
+
+    // Now print our stats
+    const SimulatorStats& functional = this->getFunctionalStats();
+    const TimingModel::Stats& timing = this->getTimingStats();
+    spdlog::info("Total Clock Cycles: {}", timing.dwCycles);
+    spdlog::info("Total NOP Count: {}", functional.dwNops);
+    spdlog::info("Total Instruction Count: {}", functional.dwInstructions);
+    spdlog::info("CPI: {:.3f} ({} stages)", timing.dwInstructions > 0 ? static_cast<double>(timing.dwCycles) / timing.dwInstructions : 0.0, this->m_timing.getDepth());
+    spdlog::info("Load-Use Stalls: {}", timing.dwLoadUseStalls);
+    spdlog::info("ALU Stalls: {}", timing.dwAluStalls);
+    if (timing.dwMduStalls > 0)
+        spdlog::info("Multiply/Divide Stalls: {}", timing.dwMduStalls);
+    spdlog::info("Branches: {} ({} mispredicted, {} wrong-path instructions)", timing.dwBranches, timing.dwMispredictions, timing.dwWrongPathRecords);
+    if (timing.dwJumps > 0)
+        spdlog::info("Jumps: {} ({} mispredicted)", timing.dwJumps, timing.dwJumpMispredictions);
+}
+
+// Sets whether runs are parallel
+void DecoupledSimulator::setParallel(bool parallel) {
+    this->m_bParallel = parallel;
+}
+
+// Returns whether runs are parallel
+bool DecoupledSimulator::isParallel() const {
+    return this->m_bParallel;
+}
+
+
+// MARK: -- Stats Methods
+
+// Returns the functional results
+const SimulatorStats& DecoupledSimulator::getFunctionalStats() const {
+    return this->m_ptrFrontEnd->getStats();
+}
+
+// Returns the timing results
+const TimingModel::Stats& DecoupledSimulator::getTimingStats() const {
+    return this->m_timing.getStats();
+}
+
+
+// MARK: -- Wrong Path Methods
+
+// Decodes a wrong path
+void DecoupledSimulator::decodeWrongPath(Memory::addr_t pc, size_t count, std::vector<RetireRecord>& records) const {
+
+    for (size_t i = 0; i < count; ++i, pc += 4) {
+
+        size_t offset = pc - Memory::MEM_USER_START;
+        if (pc < Memory::MEM_USER_START || offset + 4 > this->m_vecText.size() || pc % 4 != 0)
+            return;
+
+        word_t instruction = this->m_vecText[offset]
+                            | (this->m_vecText[offset+1] << 8)
+                            | (this->m_vecText[offset+2] << 16)
+                            | (this->m_vecText[offset+3] << 24);
+
+        RetireRecord record;
+        RecordInstrumentation::decode(instruction, pc, *this->m_ptrInstrSet, record);
+        record.bWrongPath = true;
+        records.push_back(record);
+    }
+}
+
+
+// MARK: -- Private Methods
+
+// Runs the front end
+void DecoupledSimulator::runFrontEnd() {
+
+    while (true) {
+
+        bool running = this->m_ptrFrontEnd->step();
+        RetireRecord record = this->m_ptrFrontEnd->getInstrumentation().getRecord();
+        record.bExit = !running;
+
+        while (!this->m_queue.tryPush(record))
+            std::this_thread::yield();
+
+        if (!running) break;
+    }
+}
+
+// Runs the back end
+void DecoupledSimulator::runBackEnd() {
+
+    RetireRecord record;
+    while (true) {
+
+        if (!this->m_queue.tryPop(record)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        this->m_timing.consume(record);
+        if (record.bExit) break;
+    }
+
+    this->m_timing.finish();
+}
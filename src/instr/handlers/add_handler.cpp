@@ -2,7 +2,7 @@
 
 
 // Handles the post decode
-void AddHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void AddHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 }
 
 // Handles the execution
@@ -13,6 +13,6 @@ word_t AddHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t AddHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t AddHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return executionBuffer.wOutput;
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 #include <iostream>
 
 // Handles the post decode
-void AddiHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void AddiHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 }
 
 // Handles the execution
@@ -14,6 +14,6 @@ word_t AddiHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t AddiHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t AddiHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return executionBuffer.wOutput;
 }
\ No newline at end of file
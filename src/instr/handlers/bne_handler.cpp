@@ -3,13 +3,10 @@
 #include "registers/register_bank.hpp"
 
 // Handles the post decode
-void BneHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void BneHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
     
-    // Get the destination register value
-    word_t destVal;
-    registerBank.readRegister(decodeBuffer.wRegDest, destVal);
-
-    if (destVal != decodeBuffer.wValSrc1) {
+    // Compare RS with RT, which decode reads as our second source (forwarded like the first)
+    if (decodeBuffer.wValSrc2 != decodeBuffer.wValSrc1) {
         PC += static_cast<shword_t>(decodeBuffer.wImmediate);
     }
 
@@ -30,6 +27,6 @@ word_t BneHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t BneHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t BneHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "instr/handlers/jump_handler.hpp"
+
+#include "registers/register_bank.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+JumpHandler::JumpHandler(bool bLink)
+: m_bLink(bLink)
+{ }
+
+
+// MARK: -- Handler Methods
+
+// Handles the post decode
+void JumpHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+
+    // PC already points past the jump, and the target keeps its top 4 bits
+    Memory::addr_t target = (PC & 0xF0000000) | (decodeBuffer.wImmediate << 2);
+    decodeBuffer.wImmediate = PC;
+    decodeBuffer.wRegDest = this->m_bLink ? 31 : -1;
+    PC = target;
+}
+
+// Handles the execution
+word_t JumpHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
+    return this->m_bLink ? decodeBuffer.wImmediate : 0;
+}
+
+// Handles the memory stage
+word_t JumpHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
+    return executionBuffer.wOutput;
+}
@@ -0,0 +1,33 @@
+#include "instr/handlers/jump_register_handler.hpp"
+
+#include "registers/register_bank.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+JumpRegisterHandler::JumpRegisterHandler(bool bLink)
+: m_bLink(bLink)
+{ }
+
+
+// MARK: -- Handler Methods
+
+// Handles the post decode
+void JumpRegisterHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+
+    // PC already points past the jump, which is the return address
+    decodeBuffer.wImmediate = PC;
+    if (!this->m_bLink)
+        decodeBuffer.wRegDest = -1;
+    PC = decodeBuffer.wValSrc1;
+}
+
+// Handles the execution
+word_t JumpRegisterHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
+    return this->m_bLink ? decodeBuffer.wImmediate : 0;
+}
+
+// Handles the memory stage
+word_t JumpRegisterHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
+    return executionBuffer.wOutput;
+}
@@ -0,0 +1,63 @@
+#include "instr/handlers/load_handler.hpp"
+
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#include "registers/register_bank.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+LoadHandler::LoadHandler(size_t size, bool bSigned)
+: m_szSize(size)
+, m_bSigned(bSigned)
+{
+    if (size != 1 && size != 2 && size != 4)
+        throw std::invalid_argument("Cannot load other than 1, 2 or 4 bytes");
+}
+
+
+// MARK: -- Handler Methods
+
+// Handles the post decode
+void LoadHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+}
+
+// Handles the execution
+word_t LoadHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
+
+    // Get the address by adding the value in RS to the offset
+    return decodeBuffer.wValSrc1 + static_cast<shword_t>(decodeBuffer.wImmediate);
+}
+
+// Handles the memory stage
+word_t LoadHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
+
+    // Bytes and words have their own reads; halfwords are read as a block, little-endian
+    word_t val = 0;
+    bool read = false;
+    if (this->m_szSize == 1) {
+        byte_t byte = 0;
+        read = memory.readByte(executionBuffer.wOutput, byte);
+        val = byte;
+    }
+    else if (this->m_szSize == 4)
+        read = memory.readWord(executionBuffer.wOutput, val);
+    else {
+        byte_t bytes[2] = {};
+        read = memory.readBlock(executionBuffer.wOutput, bytes, 2);
+        val = bytes[0] | (bytes[1] << 8);
+    }
+
+    if (!read) {
+        spdlog::critical("SIGSEGV: Unable to read memory at address {}", executionBuffer.wOutput);
+        exit(1);
+    }
+
+    if (this->m_bSigned && this->m_szSize == 1)
+        return static_cast<word_t>(static_cast<sword_t>(static_cast<sbyte_t>(val)));
+    if (this->m_bSigned && this->m_szSize == 2)
+        return static_cast<word_t>(static_cast<sword_t>(static_cast<shword_t>(val)));
+    return val;
+}
@@ -5,7 +5,7 @@
 #include "registers/register_bank.hpp"
 
 // Handles the post decode
-void LuiHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void LuiHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 }
 
 // Handles the execution
@@ -16,7 +16,7 @@ word_t LuiHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t LuiHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t LuiHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     
     // Just return the address
     return executionBuffer.wOutput;
@@ -0,0 +1,103 @@
+#include "instr/handlers/multiply_divide_handler.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+#include "instr/functions.hpp"
+#include "pipeline/multiply_divide_unit.hpp"
+#include "registers/register_bank.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+MultiplyDivideHandler::MultiplyDivideHandler(word_t funct)
+: m_wFunct(funct)
+{
+    if (!MultiplyDivideUnit::isMultiplyDivide(funct))
+        throw std::invalid_argument("Funct is not run by the multiply/divide unit");
+}
+
+
+// MARK: -- Handler Methods
+
+// Handles the post decode
+void MultiplyDivideHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+
+    word_t rs = decodeBuffer.wValSrc1;
+    word_t rt = decodeBuffer.wValSrc2;
+
+    switch (static_cast<Functions>(this->m_wFunct)) {
+
+        case Functions::FUNCT_MFHI:
+            decodeBuffer.wImmediate = registerBank.readHi();
+            return;
+
+        case Functions::FUNCT_MFLO:
+            decodeBuffer.wImmediate = registerBank.readLo();
+            return;
+
+        case Functions::FUNCT_MTHI:
+            registerBank.writeHi(rs);
+            break;
+
+        case Functions::FUNCT_MTLO:
+            registerBank.writeLo(rs);
+            break;
+
+        case Functions::FUNCT_MULT: {
+            dword_t product = static_cast<dword_t>(static_cast<sdword_t>(static_cast<sword_t>(rs)) * static_cast<sword_t>(rt));
+            registerBank.writeHi(static_cast<word_t>(product >> 32));
+            registerBank.writeLo(static_cast<word_t>(product));
+            break;
+        }
+
+        case Functions::FUNCT_MULTU: {
+            dword_t product = static_cast<dword_t>(rs) * rt;
+            registerBank.writeHi(static_cast<word_t>(product >> 32));
+            registerBank.writeLo(static_cast<word_t>(product));
+            break;
+        }
+
+        case Functions::FUNCT_DIV: {
+
+            // INT_MIN / -1 overflows in C++, so it gets the result the hardware gives
+            sword_t dividend = static_cast<sword_t>(rs);
+            sword_t divisor = static_cast<sword_t>(rt);
+            if (divisor == 0)
+                break;
+            if (dividend == std::numeric_limits<sword_t>::min() && divisor == -1) {
+                registerBank.writeHi(0);
+                registerBank.writeLo(rs);
+                break;
+            }
+
+            registerBank.writeHi(static_cast<word_t>(dividend % divisor));
+            registerBank.writeLo(static_cast<word_t>(dividend / divisor));
+            break;
+        }
+
+        default:
+            if (rt == 0)
+                break;
+            registerBank.writeHi(rs % rt);
+            registerBank.writeLo(rs / rt);
+            break;
+    }
+
+    // Nothing is written back to the general registers
+    decodeBuffer.wRegDest = -1;
+}
+
+// Handles the execution
+word_t MultiplyDivideHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
+
+    // Moves from HI or LO pass on the value read in decode
+    if (this->m_wFunct == static_cast<word_t>(Functions::FUNCT_MFHI) || this->m_wFunct == static_cast<word_t>(Functions::FUNCT_MFLO))
+        return decodeBuffer.wImmediate;
+    return 0;
+}
+
+// Handles the memory stage
+word_t MultiplyDivideHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
+    return executionBuffer.wOutput;
+}
@@ -3,7 +3,7 @@
 #include "registers/register_bank.hpp"
 
 // Handles the post decode
-void OriHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void OriHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 }
 
 // Handles the execution
@@ -12,6 +12,6 @@ word_t OriHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t OriHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t OriHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return executionBuffer.wOutput;
 }
\ No newline at end of file
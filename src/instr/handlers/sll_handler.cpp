@@ -3,7 +3,7 @@
 #include "registers/register_bank.hpp"
 
 // Handles the post decode
-void SllHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void SllHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 }
 
 // Handles the execution
@@ -12,6 +12,6 @@ word_t SllHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t SllHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t SllHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return executionBuffer.wOutput;
 }
\ No newline at end of file
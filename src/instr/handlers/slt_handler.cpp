@@ -5,7 +5,7 @@
 #include "registers/register_bank.hpp"
 
 // Handles the post decode
-void SltHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void SltHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 }
 
 // Handles the execution
@@ -14,6 +14,6 @@ word_t SltHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t SltHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t SltHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return executionBuffer.wOutput;
 }
\ No newline at end of file
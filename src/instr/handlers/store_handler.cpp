@@ -0,0 +1,60 @@
+#include "instr/handlers/store_handler.hpp"
+
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#include "registers/register_bank.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+StoreHandler::StoreHandler(size_t size)
+: m_szSize(size)
+{
+    if (size != 1 && size != 2 && size != 4)
+        throw std::invalid_argument("Cannot store other than 1, 2 or 4 bytes");
+}
+
+
+// MARK: -- Handler Methods
+
+// Handles the post decode
+void StoreHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+
+    // RT holds the value to store rather than a destination, so read it as our second
+    // source (which is forwarded like any other) and write nothing back
+    decodeBuffer.wRegSrc2 = decodeBuffer.wRegDest;
+    registerBank.readRegister(decodeBuffer.wRegSrc2, decodeBuffer.wValSrc2);
+    decodeBuffer.wRegDest = -1;
+}
+
+// Handles the execution
+word_t StoreHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
+
+    // Get the address by adding the value in RS to the offset
+    return decodeBuffer.wValSrc1 + static_cast<shword_t>(decodeBuffer.wImmediate);
+}
+
+// Handles the memory stage
+word_t StoreHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
+
+    // Store the low bytes of RT at the address; halfwords are written as a block, little-endian
+    word_t val = executionBuffer.wRegValue;
+    bool written = false;
+    if (this->m_szSize == 1)
+        written = memory.writeByte(executionBuffer.wOutput, static_cast<byte_t>(val));
+    else if (this->m_szSize == 4)
+        written = memory.writeWord(executionBuffer.wOutput, val);
+    else {
+        byte_t bytes[2] = { static_cast<byte_t>(val), static_cast<byte_t>(val >> 8) };
+        written = memory.writeBlock(executionBuffer.wOutput, bytes, 2);
+    }
+
+    if (!written) {
+        spdlog::critical("SIGSEGV: Unable to write memory at address {}", executionBuffer.wOutput);
+        exit(1);
+    }
+
+    return 0;
+}
@@ -1,21 +1,57 @@
 #include "instr/handlers/syscall_handler.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <fcntl.h>
 #include <iostream>
+#include <unistd.h>
 
 #include "spdlog/spdlog.h"
 
+#include "instr/functions.hpp"
+#include "instr/syscalls.hpp"
 #include "memory/memory.hpp"
 #include "registers/register_bank.hpp"
 
+// MARK: -- Static Constants
+constexpr word_t SyscallHandler::LIMIT_SYSCALL;
+constexpr size_t SyscallHandler::IO_CHUNK_SIZE;
+
+
+// MARK: -- Construction
+
+// Constructor
+SyscallHandler::SyscallHandler()
+: m_vecFileDescriptors({ STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO })
+, m_wCoreId(0)
+, m_ptrHeapBreak(new heap_break_t(0))
+, m_szReplayIndex(0)
+, m_szHistoryIndex(0)
+{
+    this->registerDefaultSyscalls();
+}
+
+// Destructor - close anything the guest left open
+SyscallHandler::~SyscallHandler() {
+
+    for (size_t fd = 3; fd < this->m_vecFileDescriptors.size(); ++fd) {
+        if (this->m_vecFileDescriptors[fd] != -1)
+            ::close(this->m_vecFileDescriptors[fd]);
+    }
+}
+
+
+// MARK: -- Handler Methods
+
 // Handles the post decode
-void SyscallHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
+void SyscallHandler::onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) {
 
     // Handle the system call here
     this->handleSystemCall(decodeBuffer, registerBank, memory);
 
-    // Now change this to a NOP (SLL)
-    decodeBuffer.wFunct = 0;
+    // Now change this to a NOP, though still a system call, so the later stages know it as one
+    decodeBuffer.wFunct = static_cast<word_t>(Functions::FUNCT_SYSCALL);
     decodeBuffer.wImmediate = 0;
     decodeBuffer.wOpcode = 0;
     decodeBuffer.wRegDest = 0;
@@ -31,101 +67,503 @@ word_t SyscallHandler::onExecute(const InstructionDecodeBuffer& decodeBuffer) {
 }
 
 // Handles the memory stage
-word_t SyscallHandler::onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) {
+word_t SyscallHandler::onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) {
     return 0;
 }
 
 
+// MARK: -- Registration Methods
+
+// Registers a system call
+bool SyscallHandler::registerSyscall(word_t code, const std::string& name, syscall_fn_t syscall, bool usesHost) {
+
+    if (code > LIMIT_SYSCALL) {
+        spdlog::error("Unable to register system call {} ({}) - code out of bounds", code, name);
+        return false;
+    }
+
+    if (!syscall) {
+        spdlog::error("Unable to register system call {} ({}) - cannot register null implementation", code, name);
+        return false;
+    }
+
+    if (code >= this->m_vecSyscalls.size())
+        this->m_vecSyscalls.resize(code + 1);
+
+    this->m_vecSyscalls[code].strName = name;
+    this->m_vecSyscalls[code].fnSyscall = std::move(syscall);
+    this->m_vecSyscalls[code].bUsesHost = usesHost;
+    return true;
+}
+
+// Returns whether a system call exists
+bool SyscallHandler::hasSyscall(word_t code) const {
+    return code < this->m_vecSyscalls.size() && this->m_vecSyscalls[code].fnSyscall;
+}
+
+
+// MARK: -- Input Methods
+
+// Returns the input feed
+InputFeed& SyscallHandler::getInputFeed() {
+    return this->m_inputFeed;
+}
+
+
+// MARK: -- Core Methods
+
+// Sets the core id
+void SyscallHandler::setCoreId(word_t coreId) {
+    this->m_wCoreId = coreId;
+}
+
+// Returns the core id
+word_t SyscallHandler::getCoreId() const {
+    return this->m_wCoreId;
+}
+
+
+// MARK: -- Heap Methods
+
+// Shares the program break
+void SyscallHandler::setHeapBreak(std::shared_ptr<heap_break_t> heapBreak) {
+    this->m_ptrHeapBreak = std::move(heapBreak);
+}
+
+
+// MARK: -- Record / Replay Methods
+
+// Sets the record log
+void SyscallHandler::setRecordLog(std::shared_ptr<SyscallLog> log) {
+    this->m_ptrRecordLog = std::move(log);
+}
+
+// Sets the replay log
+void SyscallHandler::setReplayLog(std::shared_ptr<const SyscallLog> log) {
+    this->m_ptrReplayLog = std::move(log);
+    this->m_szReplayIndex = 0;
+}
+
+
+// MARK: -- History Methods
+
+// Sets the history
+void SyscallHandler::setHistory(std::shared_ptr<SyscallLog> history) {
+    this->m_ptrHistory = std::move(history);
+    this->m_szHistoryIndex = (this->m_ptrHistory != nullptr) ? this->m_ptrHistory->size() : 0;
+}
+
+// Moves through the history
+void SyscallHandler::setHistoryPosition(size_t position) {
+    this->m_szHistoryIndex = position;
+}
+
+// Returns the position in the history
+size_t SyscallHandler::getHistoryPosition() const {
+    return this->m_szHistoryIndex;
+}
+
+
 // MARK: -- Private Syscall Methods
 
-void SyscallHandler::handleSystemCall(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory) {
+// Dispatches a system call through the table
+void SyscallHandler::handleSystemCall(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory) {
 
     // First, get the syscall type from $v0 (2)
     word_t type;
-    if (!registerBank.readRegister(2, type)) {
+    if (!registerBank.readRegister(SyscallContext::REG_RESULT, type)) {
         spdlog::critical("SIGSYS: Bad argument for SYSCALL type");
         exit(1);
     }
 
-    // Now, handle based on the type
-    switch (type) {
+    // Now, find it in the table
+    if (!this->hasSyscall(type)) {
+        spdlog::critical("SIGSYS: Bad SYSCALL type: {}", type);
+        exit(1);
+    }
 
-        // Print Integer
-        case 1: {
+    SyscallContext context(registerBank, memory);
+    const SyscallEntry& syscall = this->m_vecSyscalls[type];
 
-            // Get the integer to print
-            word_t integer;
-            if (!registerBank.readRegister(4, integer)) {
-                spdlog::critical("SIGSYS: Invalid arguments for SYSCALL 4");
-                exit(1);
-            }
+    // A call we already made before the run was rewound is never run (or logged) twice
+    if (this->m_ptrHistory != nullptr && this->m_szHistoryIndex < this->m_ptrHistory->size()) {
 
-            spdlog::info(std::to_string(integer));
-            break;
+        const SyscallLog::Entry& entry = this->m_ptrHistory->at(this->m_szHistoryIndex++);
+        if (entry.wCode != type) {
+            spdlog::critical("SIGSYS: Rewound run diverged at call {} - expected SYSCALL {} but program made SYSCALL {}", this->m_szHistoryIndex - 1, entry.wCode, type);
+            exit(1);
         }
 
-        // Print string
-        case 4: {
-
-            // Address of output: $a0
-            word_t addr;
-            if (!registerBank.readRegister(4, addr)) {
-                spdlog::critical("SIGSYS: Invalid arguments for SYSCALL 4");
-                exit(1);
-            }
-
-            // Read the string
-            std::string str;
-            if (!memory.readString(addr, str)) {
-                spdlog::critical("SIGSEGV: Unable to read string at address {}", addr);
-                exit(1);
-            }
-
-            // Print the string
-            spdlog::info(str);
-            break;
+        this->applyEntry(context, entry);
+        if (context.shouldExit())
+            decodeBuffer.bExit = true;
+        return;
+    }
+
+    // Record every side effect if we are recording
+    SyscallLog::Entry record;
+    record.wCode = type;
+    if (this->m_ptrRecordLog != nullptr || this->m_ptrHistory != nullptr)
+        context.setRecord(&record);
+
+    // When replaying, host-dependent calls are never run. Everything else still
+    // runs, but consumes its entry so we stay in step with the log.
+    if (this->m_ptrReplayLog != nullptr)
+        this->replaySyscall(context, type, syscall.bUsesHost);
+
+    if (this->m_ptrReplayLog == nullptr || !syscall.bUsesHost)
+        syscall.fnSyscall(context);
+
+    record.bExit = context.shouldExit();
+    if (this->m_ptrRecordLog != nullptr)
+        this->m_ptrRecordLog->append(record);
+
+    if (this->m_ptrHistory != nullptr) {
+        this->m_ptrHistory->append(record);
+        this->m_szHistoryIndex++;
+    }
+
+    if (context.shouldExit())
+        decodeBuffer.bExit = true;
+}
+
+// Registers the SPIM / MARS system calls
+void SyscallHandler::registerDefaultSyscalls() {
+
+    using namespace std::placeholders;
+
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_PRINT_INT), "print_int", std::bind(&SyscallHandler::syscallPrintInt, this, _1), false);
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_PRINT_STRING), "print_string", std::bind(&SyscallHandler::syscallPrintString, this, _1), false);
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_READ_INT), "read_int", std::bind(&SyscallHandler::syscallReadInt, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_READ_STRING), "read_string", std::bind(&SyscallHandler::syscallReadString, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_SBRK), "sbrk", std::bind(&SyscallHandler::syscallSbrk, this, _1), false);
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_EXIT), "exit", std::bind(&SyscallHandler::syscallExit, this, _1), false);
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_PRINT_CHAR), "print_char", std::bind(&SyscallHandler::syscallPrintChar, this, _1), false);
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_READ_CHAR), "read_char", std::bind(&SyscallHandler::syscallReadChar, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_OPEN), "open", std::bind(&SyscallHandler::syscallOpen, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_READ), "read", std::bind(&SyscallHandler::syscallRead, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_WRITE), "write", std::bind(&SyscallHandler::syscallWrite, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_CLOSE), "close", std::bind(&SyscallHandler::syscallClose, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_TIME), "time", std::bind(&SyscallHandler::syscallTime, this, _1));
+    this->registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_CORE_ID), "core_id", std::bind(&SyscallHandler::syscallCoreId, this, _1), false);
+}
+
+// Replays an entry
+void SyscallHandler::replaySyscall(SyscallContext& context, word_t code, bool apply) {
+
+    if (this->m_szReplayIndex >= this->m_ptrReplayLog->size()) {
+        spdlog::critical("SIGSYS: Replay log exhausted at SYSCALL {} (entry {})", code, this->m_szReplayIndex);
+        exit(1);
+    }
+
+    const SyscallLog::Entry& entry = this->m_ptrReplayLog->at(this->m_szReplayIndex++);
+    if (entry.wCode != code) {
+        spdlog::critical("SIGSYS: Replay diverged at entry {} - expected SYSCALL {} but program made SYSCALL {}", this->m_szReplayIndex - 1, entry.wCode, code);
+        exit(1);
+    }
+
+    if (apply)
+        this->applyEntry(context, entry);
+}
+
+// Applies an entry
+void SyscallHandler::applyEntry(SyscallContext& context, const SyscallLog::Entry& entry) {
+
+    for (const auto& reg : entry.vecRegisters)
+        context.setRegister(reg.first, reg.second);
+
+    for (const SyscallLog::MemoryWrite& write : entry.vecMemory) {
+        if (!context.writeMemory(write.wAddr, write.vecData.data(), write.vecData.size())) {
+            spdlog::critical("SIGSEGV: Unable to replay {} bytes to memory at address {}", write.vecData.size(), write.wAddr);
+            exit(1);
         }
+    }
 
-        // Read string
-        case 8: {
-
-            // Address of Input: $a0
-            // Max Numbr of Chars: $a1
-            word_t addr;
-            word_t num;
-
-            if (!registerBank.readRegister(4, addr) || !registerBank.readRegister(5, num)) {
-                spdlog::critical("SIGSYS: Invalid arguments for SYSCALL 8");
-                exit(1);
-            }
-
-            // Create our buffer
-            char buffer[num];
-            memset(buffer, 0, num);
-            std::cin >> buffer;
-            
-            size_t len = strlen(buffer);
-            buffer[(len == num) ? num-1 : len] = '\0';
-
-            // Now write this to the location
-            for (int i = 0; i < num; ++i) {
-                if (!memory.writeByte(addr+i, buffer[i])) {
-                    spdlog::critical("SIGSEGV: Unable to write to memory at address {}", addr+i);
-                    exit(1);
-                }
-            }
-            break;
+    if (entry.bExit)
+        context.requestExit();
+}
+
+// Reads a raw C string from guest memory
+bool SyscallHandler::readCString(const SyscallContext& context, Memory::addr_t addr, std::string& str) const {
+
+    str.clear();
+
+    byte_t ch;
+    while (context.readMemory(addr++, &ch, 1)) {
+        if (ch == '\0') return true;
+        str.push_back(static_cast<char_t>(ch));
+    }
+
+    return false;
+}
+
+// Returns the host file descriptor
+int SyscallHandler::getHostDescriptor(word_t guestFd) const {
+    return (guestFd < this->m_vecFileDescriptors.size()) ? this->m_vecFileDescriptors[guestFd] : -1;
+}
+
+
+// MARK: -- Private System Call Methods
+
+// Print Integer
+void SyscallHandler::syscallPrintInt(SyscallContext& context) {
+    spdlog::info(std::to_string(context.getArgument(0)));
+}
+
+// Print String
+void SyscallHandler::syscallPrintString(SyscallContext& context) {
+
+    // Address of output: $a0
+    word_t addr = context.getArgument(0);
+
+    // Read the string
+    std::string str;
+    if (!context.getMemory().readString(addr, str)) {
+        spdlog::critical("SIGSEGV: Unable to read string at address {}", addr);
+        exit(1);
+    }
+
+    // Print the string
+    spdlog::info(str);
+}
+
+// Read Integer
+void SyscallHandler::syscallReadInt(SyscallContext& context) {
+
+    sword_t value = 0;
+    if (!this->m_inputFeed.readInt(value))
+        value = 0;
+
+    context.setResult(static_cast<word_t>(value));
+}
+
+// Read String
+void SyscallHandler::syscallReadString(SyscallContext& context) {
+
+    // Address of Input: $a0
+    // Max Number of Chars: $a1
+    word_t addr = context.getArgument(0);
+    word_t num = context.getArgument(1);
+    if (num == 0) return;
+
+    // Read the input and truncate it to fit (leaving room for the null terminator)
+    std::string input;
+    this->m_inputFeed.readToken(input);
+    if (input.length() > num - 1)
+        input.resize(num - 1);
+
+    // Now write this (and the terminator) to the location in one go
+    if (!context.writeMemory(addr, reinterpret_cast<const byte_t *>(input.c_str()), input.length() + 1)) {
+        spdlog::critical("SIGSEGV: Unable to write {} bytes to memory at address {}", input.length() + 1, addr);
+        exit(1);
+    }
+}
+
+// SBRK
+void SyscallHandler::syscallSbrk(SyscallContext& context) {
+
+    Memory& memory = context.getMemory();
+    sword_t amount = static_cast<sword_t>(context.getArgument(0));
+    if (amount < 0) {
+        spdlog::critical("SIGSYS: SBRK cannot shrink the heap (requested {} bytes)", amount);
+        exit(1);
+    }
+
+    // The heap starts at the end of the loaded program. The break may be shared with
+    // cores on other threads, so it is only ever moved with a compare-and-swap
+    heap_break_t& heapBreak = *this->m_ptrHeapBreak.get();
+    Memory::addr_t unset = 0;
+    heapBreak.compare_exchange_strong(unset, static_cast<Memory::addr_t>(Memory::MEM_USER_START + memory.getTotalSize()));
+
+    Memory::addr_t oldBreak = heapBreak.load();
+    size_t newBreak = static_cast<size_t>(oldBreak) + amount;
+    while (!heapBreak.compare_exchange_weak(oldBreak, static_cast<Memory::addr_t>(newBreak)))
+        newBreak = static_cast<size_t>(oldBreak) + amount;
+
+    // Grow memory if the new break runs past the end of it
+    size_t memoryEnd = Memory::MEM_USER_START + memory.getTotalSize();
+    if (newBreak > memoryEnd && !memory.growData(newBreak - memoryEnd)) {
+        spdlog::critical("SIGSEGV: SBRK unable to grow the heap by {} bytes", amount);
+        exit(1);
+    }
+
+    context.setResult(oldBreak);
+}
+
+// Exit
+void SyscallHandler::syscallExit(SyscallContext& context) {
+    context.requestExit();
+}
+
+// Print Character
+void SyscallHandler::syscallPrintChar(SyscallContext& context) {
+    spdlog::info(std::string(1, static_cast<char_t>(context.getArgument(0) & 0xFF)));
+}
+
+// Read Character
+void SyscallHandler::syscallReadChar(SyscallContext& context) {
+
+    int ch = this->m_inputFeed.get();
+    context.setResult((ch == EOF) ? static_cast<word_t>(-1) : static_cast<word_t>(ch));
+}
+
+// Open File
+void SyscallHandler::syscallOpen(SyscallContext& context) {
+
+    // Get the path ($a0) and flags ($a1)
+    std::string path;
+    if (!this->readCString(context, context.getArgument(0), path)) {
+        spdlog::critical("SIGSEGV: Unable to read file name at address {}", context.getArgument(0));
+        exit(1);
+    }
+
+    // MARS flags: 0 = read, 1 = write (create / truncate), 9 = write (create / append)
+    int flags;
+    switch (context.getArgument(1)) {
+        case 0: flags = O_RDONLY; break;
+        case 1: flags = O_WRONLY | O_CREAT | O_TRUNC; break;
+        case 9: flags = O_WRONLY | O_CREAT | O_APPEND; break;
+        default: {
+            context.setResult(static_cast<word_t>(-1));
+            return;
         }
+    }
 
-        // Exit
-        case 10: {
-            decodeBuffer.bExit = true;
+    int hostFd = ::open(path.c_str(), flags, 0644);
+    if (hostFd == -1) {
+        spdlog::debug("Unable to open file '{}' for the guest", path);
+        context.setResult(static_cast<word_t>(-1));
+        return;
+    }
+
+    // Reuse the lowest free guest descriptor
+    auto free = std::find(this->m_vecFileDescriptors.begin() + 3, this->m_vecFileDescriptors.end(), -1);
+    word_t guestFd = static_cast<word_t>(free - this->m_vecFileDescriptors.begin());
+    if (free == this->m_vecFileDescriptors.end())
+        this->m_vecFileDescriptors.push_back(hostFd);
+    else
+        *free = hostFd;
+
+    context.setResult(guestFd);
+}
+
+// Read File
+void SyscallHandler::syscallRead(SyscallContext& context) {
+
+    // Descriptor ($a0), buffer ($a1) and length ($a2)
+    word_t guestFd = context.getArgument(0);
+    Memory::addr_t addr = context.getArgument(1);
+    word_t length = context.getArgument(2);
+
+    int hostFd = this->getHostDescriptor(guestFd);
+    if (hostFd == -1) {
+        context.setResult(static_cast<word_t>(-1));
+        return;
+    }
+
+    // Stream the data through in chunks so large reads do not need a buffer of their own
+    word_t total = 0;
+    while (total < length) {
+
+        size_t chunk = std::min<size_t>(IO_CHUNK_SIZE, length - total);
+        this->m_vecScratch.resize(chunk);
+
+        ssize_t count;
+        if (hostFd == STDIN_FILENO)
+            count = static_cast<ssize_t>(this->m_inputFeed.read(this->m_vecScratch.data(), chunk));
+        else
+            count = ::read(hostFd, this->m_vecScratch.data(), chunk);
+
+        if (count < 0) {
+            if (total == 0) total = static_cast<word_t>(-1);
             break;
         }
+        if (count == 0) break;
 
-        default: {
-            spdlog::critical("SIGSYS: Bad SYSCALL type: {}", type);
+        if (!context.writeMemory(addr + total, this->m_vecScratch.data(), count)) {
+            spdlog::critical("SIGSEGV: Unable to write {} bytes to memory at address {}", count, addr + total);
+            exit(1);
+        }
+
+        total += count;
+        if (static_cast<size_t>(count) < chunk) break;
+    }
+
+    context.setResult(total);
+}
+
+// Write File
+void SyscallHandler::syscallWrite(SyscallContext& context) {
+
+    // Descriptor ($a0), buffer ($a1) and length ($a2)
+    word_t guestFd = context.getArgument(0);
+    Memory::addr_t addr = context.getArgument(1);
+    word_t length = context.getArgument(2);
+
+    int hostFd = this->getHostDescriptor(guestFd);
+    if (hostFd == -1) {
+        context.setResult(static_cast<word_t>(-1));
+        return;
+    }
+
+    word_t total = 0;
+    while (total < length) {
+
+        size_t chunk = std::min<size_t>(IO_CHUNK_SIZE, length - total);
+        this->m_vecScratch.resize(chunk);
+
+        if (!context.readMemory(addr + total, this->m_vecScratch.data(), chunk)) {
+            spdlog::critical("SIGSEGV: Unable to read {} bytes from memory at address {}", chunk, addr + total);
             exit(1);
         }
+
+        // Keep the console streams ordered with the rest of our output
+        ssize_t count;
+        if (hostFd == STDOUT_FILENO || hostFd == STDERR_FILENO) {
+            std::ostream& stream = (hostFd == STDOUT_FILENO) ? std::cout : std::cerr;
+            stream.write(reinterpret_cast<const char *>(this->m_vecScratch.data()), chunk);
+            count = stream.good() ? static_cast<ssize_t>(chunk) : -1;
+        }
+        else
+            count = ::write(hostFd, this->m_vecScratch.data(), chunk);
+
+        if (count < 0) {
+            if (total == 0) total = static_cast<word_t>(-1);
+            break;
+        }
+
+        total += count;
+        if (static_cast<size_t>(count) < chunk) break;
     }
-}
\ No newline at end of file
+
+    context.setResult(total);
+}
+
+// Close File
+void SyscallHandler::syscallClose(SyscallContext& context) {
+
+    // Never close the host's standard streams
+    word_t guestFd = context.getArgument(0);
+    int hostFd = this->getHostDescriptor(guestFd);
+    if (hostFd == -1 || guestFd < 3) return;
+
+    ::close(hostFd);
+    this->m_vecFileDescriptors[guestFd] = -1;
+}
+
+// System Time
+void SyscallHandler::syscallTime(SyscallContext& context) {
+
+    std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    );
+
+    dword_t time = static_cast<dword_t>(ms.count());
+    context.setRegister(SyscallContext::REG_ARG_START, static_cast<word_t>(time & 0xFFFFFFFF));
+    context.setRegister(SyscallContext::REG_ARG_START + 1, static_cast<word_t>(time >> 32));
+}
+
+// Core ID
+void SyscallHandler::syscallCoreId(SyscallContext& context) {
+    context.setResult(this->m_wCoreId);
+}
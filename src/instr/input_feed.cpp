@@ -0,0 +1,127 @@
+#include "instr/input_feed.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// MARK: -- Construction
+
+// Constructor
+InputFeed::InputFeed()
+: m_pFallback(&std::cin)
+{ }
+
+
+// MARK: -- Queue Methods
+
+// Queues a string
+void InputFeed::queueInput(const std::string& data) {
+    this->m_queStreams.emplace_back(new std::istringstream(data));
+}
+
+// Queues a file
+bool InputFeed::queueFile(const std::string& filename) {
+
+    std::unique_ptr<std::ifstream> stream(new std::ifstream(filename, std::ios_base::in | std::ios_base::binary));
+    if (!stream->is_open())
+        return false;
+
+    this->m_queStreams.push_back(std::move(stream));
+    return true;
+}
+
+// Sets the fallback
+void InputFeed::setFallback(std::istream * stream) {
+    this->m_pFallback = stream;
+}
+
+
+// MARK: -- Read Methods
+
+// Reads a character
+int InputFeed::get() {
+
+    std::istream * stream = this->currentStream();
+    return (stream == nullptr) ? EOF : stream->get();
+}
+
+// Reads a token
+bool InputFeed::readToken(std::string& token) {
+
+    token.clear();
+
+    // Skip leading whitespace, then take everything up to the next whitespace
+    while (this->peek() != EOF && std::isspace(this->peek()))
+        this->get();
+
+    while (this->peek() != EOF && !std::isspace(this->peek()))
+        token.push_back(static_cast<char_t>(this->get()));
+
+    return !token.empty();
+}
+
+// Reads an integer
+bool InputFeed::readInt(sword_t& value) {
+
+    std::string token;
+    if (!this->readToken(token))
+        return false;
+
+    try {
+        size_t end = 0;
+        value = static_cast<sword_t>(std::stol(token, &end, 10));
+        return end == token.length();
+    }
+    catch (std::exception& e) {
+        return false;
+    }
+}
+
+// Reads in bulk
+size_t InputFeed::read(byte_t * data, size_t size) {
+
+    size_t total = 0;
+    while (total < size) {
+
+        std::istream * stream = this->currentStream();
+        if (stream == nullptr) break;
+
+        stream->read(reinterpret_cast<char *>(data + total), size - total);
+        size_t count = static_cast<size_t>(stream->gcount());
+        total += count;
+
+        // Only keep going if this stream is a queued one that just ran out
+        if (count == 0 || stream == this->m_pFallback) {
+            if (stream == this->m_pFallback && stream->eof()) stream->clear();
+            break;
+        }
+    }
+
+    return total;
+}
+
+
+// MARK: -- Private Methods
+
+// Returns the current stream
+std::istream * InputFeed::currentStream() {
+
+    while (!this->m_queStreams.empty()) {
+
+        std::istream * stream = this->m_queStreams.front().get();
+        if (stream->peek() != EOF)
+            return stream;
+
+        this->m_queStreams.pop_front();
+    }
+
+    return this->m_pFallback;
+}
+
+// Peeks at the next character
+int InputFeed::peek() {
+
+    std::istream * stream = this->currentStream();
+    return (stream == nullptr) ? EOF : stream->peek();
+}
@@ -54,6 +54,20 @@ InstructionParser * InstructionSet::getInstructionParser(const std::string& name
     return parser->second->ptrParser.get();
 }
 
+// Returns the name of an instruction
+std::string InstructionSet::getInstructionName(word_t opcode, word_t funct) const {
+
+    if (opcode > Instruction::LIMIT_OPCODE || funct > Instruction::LIMIT_FUNCT)
+        return "";
+
+    hword_t key = (opcode & ~0xFF00) | ((funct << 8) & 0xFF00);
+    auto metadata = this->m_mapIDToMetadata.find(key);
+    if (metadata == this->m_mapIDToMetadata.end())
+        return "";
+
+    return metadata->second->strName;
+}
+
 
 // MARK: -- Registration Methods
 
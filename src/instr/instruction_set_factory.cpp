@@ -0,0 +1,137 @@
+#include "instr/instruction_set_factory.hpp"
+
+#include "instr/functions.hpp"
+#include "instr/opcodes.hpp"
+
+#include "instr/handlers/add_handler.hpp"
+#include "instr/handlers/addi_handler.hpp"
+#include "instr/handlers/beq_handler.hpp"
+#include "instr/handlers/bne_handler.hpp"
+#include "instr/handlers/jump_handler.hpp"
+#include "instr/handlers/jump_register_handler.hpp"
+#include "instr/handlers/load_handler.hpp"
+#include "instr/handlers/lui_handler.hpp"
+#include "instr/handlers/multiply_divide_handler.hpp"
+#include "instr/handlers/ori_handler.hpp"
+#include "instr/handlers/sll_handler.hpp"
+#include "instr/handlers/slt_handler.hpp"
+#include "instr/handlers/store_handler.hpp"
+#include "instr/handlers/syscall_handler.hpp"
+
+#include "instr/parsers/add_parser.hpp"
+#include "instr/parsers/addi_parser.hpp"
+#include "instr/parsers/b_parser.hpp"
+#include "instr/parsers/beq_parser.hpp"
+#include "instr/parsers/beqz_parser.hpp"
+#include "instr/parsers/bge_parser.hpp"
+#include "instr/parsers/bne_parser.hpp"
+#include "instr/parsers/jump_parser.hpp"
+#include "instr/parsers/jump_register_parser.hpp"
+#include "instr/parsers/la_parser.hpp"
+#include "instr/parsers/li_parser.hpp"
+#include "instr/parsers/load_store_parser.hpp"
+#include "instr/parsers/lui_parser.hpp"
+#include "instr/parsers/multiply_divide_parser.hpp"
+#include "instr/parsers/nop_parser.hpp"
+#include "instr/parsers/ori_parser.hpp"
+#include "instr/parsers/sll_parser.hpp"
+#include "instr/parsers/slt_parser.hpp"
+#include "instr/parsers/subi_parser.hpp"
+#include "instr/parsers/syscall_parser.hpp"
+
+
+// MARK: -- Helper Methods
+
+// Registers a load
+static void registerLoad(InstructionSet& instrSet, const std::string& name, Opcodes opcode, size_t size, bool bSigned) {
+    word_t op = static_cast<word_t>(opcode);
+    instrSet.registerIType(name, op, std::unique_ptr<LoadStoreParser>(new LoadStoreParser(name, op)), std::unique_ptr<LoadHandler>(new LoadHandler(size, bSigned)));
+}
+
+// Registers a store
+static void registerStore(InstructionSet& instrSet, const std::string& name, Opcodes opcode, size_t size) {
+    word_t op = static_cast<word_t>(opcode);
+    instrSet.registerIType(name, op, std::unique_ptr<LoadStoreParser>(new LoadStoreParser(name, op)), std::unique_ptr<StoreHandler>(new StoreHandler(size)));
+}
+
+// Registers a J-Type jump
+static void registerJump(InstructionSet& instrSet, const std::string& name, Opcodes opcode, bool bLink) {
+    word_t op = static_cast<word_t>(opcode);
+    instrSet.registerJType(name, op, std::unique_ptr<JumpParser>(new JumpParser(name, op)), std::unique_ptr<JumpHandler>(new JumpHandler(bLink)));
+}
+
+// Registers a jump through a register
+static void registerJumpRegister(InstructionSet& instrSet, const std::string& name, Functions funct, bool bLink) {
+    word_t fn = static_cast<word_t>(funct);
+    instrSet.registerRType(name, static_cast<word_t>(Opcodes::OPCODE_R_TYPE), fn, std::unique_ptr<JumpRegisterParser>(new JumpRegisterParser(name, fn)), std::unique_ptr<JumpRegisterHandler>(new JumpRegisterHandler(bLink)));
+}
+
+// Registers an instruction of the multiply/divide unit
+static void registerMultiplyDivide(InstructionSet& instrSet, const std::string& name, Functions funct) {
+    word_t fn = static_cast<word_t>(funct);
+    instrSet.registerRType(name, static_cast<word_t>(Opcodes::OPCODE_R_TYPE), fn, std::unique_ptr<MultiplyDivideParser>(new MultiplyDivideParser(name, fn)), std::unique_ptr<MultiplyDivideHandler>(new MultiplyDivideHandler(fn)));
+}
+
+
+// MARK: -- Factory Methods
+
+// Creates the default instruction set
+std::unique_ptr<InstructionSet> InstructionSetFactory::createDefault(std::unique_ptr<SyscallHandler> syscallHandler) {
+
+    // Fall back to a fresh system call handler
+    if (syscallHandler == nullptr)
+        syscallHandler = std::unique_ptr<SyscallHandler>(new SyscallHandler());
+
+    // Create our instruction set
+    std::unique_ptr<InstructionSet> instrSet(new InstructionSet());
+
+    // R-Type
+    instrSet->registerRType("add", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_ADD), std::unique_ptr<AddParser>(new AddParser()), std::unique_ptr<AddHandler>(new AddHandler()));
+    instrSet->registerRType("sll", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SLL), std::unique_ptr<SllParser>(new SllParser()), std::unique_ptr<SllHandler>(new SllHandler()));
+    instrSet->registerRType("slt", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SLT), std::unique_ptr<SltParser>(new SltParser()), std::unique_ptr<SltHandler>(new SltHandler()));
+    instrSet->registerRType("syscall", static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SYSCALL), std::unique_ptr<SyscallParser>(new SyscallParser()), std::move(syscallHandler));
+
+    // I-Type
+    instrSet->registerIType("addi", static_cast<word_t>(Opcodes::OPCODE_ADDI), std::unique_ptr<AddiParser>(new AddiParser()), std::unique_ptr<AddiHandler>(new AddiHandler()));
+    instrSet->registerIType("beq", static_cast<word_t>(Opcodes::OPCODE_BEQ), std::unique_ptr<BeqParser>(new BeqParser()), std::unique_ptr<BeqHandler>(new BeqHandler()));
+    instrSet->registerIType("bne", static_cast<word_t>(Opcodes::OPCODE_BNE), std::unique_ptr<BneParser>(new BneParser()), std::unique_ptr<BneHandler>(new BneHandler()));
+    instrSet->registerIType("lui", static_cast<word_t>(Opcodes::OPCODE_LUI), std::unique_ptr<LuiParser>(new LuiParser()), std::unique_ptr<LuiHandler>(new LuiHandler()));
+    instrSet->registerIType("ori", static_cast<word_t>(Opcodes::OPCODE_ORI), std::unique_ptr<OriParser>(new OriParser()), std::unique_ptr<OriHandler>(new OriHandler()));
+
+    // Jumps
+    registerJump(*instrSet, "j", Opcodes::OPCODE_J, false);
+    registerJump(*instrSet, "jal", Opcodes::OPCODE_JAL, true);
+    registerJumpRegister(*instrSet, "jr", Functions::FUNCT_JR, false);
+    registerJumpRegister(*instrSet, "jalr", Functions::FUNCT_JALR, true);
+
+    // Loads & Stores
+    registerLoad(*instrSet, "lb", Opcodes::OPCODE_LB, 1, true);
+    registerLoad(*instrSet, "lh", Opcodes::OPCODE_LH, 2, true);
+    registerLoad(*instrSet, "lw", Opcodes::OPCODE_LW, 4, false);
+    registerLoad(*instrSet, "lbu", Opcodes::OPCODE_LBU, 1, false);
+    registerLoad(*instrSet, "lhu", Opcodes::OPCODE_LHU, 2, false);
+    registerStore(*instrSet, "sb", Opcodes::OPCODE_SB, 1);
+    registerStore(*instrSet, "sh", Opcodes::OPCODE_SH, 2);
+    registerStore(*instrSet, "sw", Opcodes::OPCODE_SW, 4);
+
+    // Multiply & Divide
+    registerMultiplyDivide(*instrSet, "mult", Functions::FUNCT_MULT);
+    registerMultiplyDivide(*instrSet, "multu", Functions::FUNCT_MULTU);
+    registerMultiplyDivide(*instrSet, "div", Functions::FUNCT_DIV);
+    registerMultiplyDivide(*instrSet, "divu", Functions::FUNCT_DIVU);
+    registerMultiplyDivide(*instrSet, "mfhi", Functions::FUNCT_MFHI);
+    registerMultiplyDivide(*instrSet, "mflo", Functions::FUNCT_MFLO);
+    registerMultiplyDivide(*instrSet, "mthi", Functions::FUNCT_MTHI);
+    registerMultiplyDivide(*instrSet, "mtlo", Functions::FUNCT_MTLO);
+
+    // Psuedo-Type
+    instrSet->registerPsuedoType("b", std::unique_ptr<BParser>(new BParser()));
+    instrSet->registerPsuedoType("beqz", std::unique_ptr<BeqzParser>(new BeqzParser()));
+    instrSet->registerPsuedoType("bge", std::unique_ptr<BgeParser>(new BgeParser()));
+    instrSet->registerPsuedoType("la", std::unique_ptr<LaParser>(new LaParser()));
+    instrSet->registerPsuedoType("li", std::unique_ptr<LiParser>(new LiParser()));
+    instrSet->registerPsuedoType("nop", std::unique_ptr<NopParser>(new NopParser()));
+    instrSet->registerPsuedoType("subi", std::unique_ptr<SubiParser>(new SubiParser()));
+
+    return instrSet;
+}
@@ -0,0 +1,59 @@
+#include "instr/parsers/jump_parser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+#include "exception/syntax_error.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_type.hpp"
+#include "utils/string_utils.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+JumpParser::JumpParser(const std::string& name, word_t opcode)
+: m_strName(StringUtils::toLowerCase(name))
+, m_strMnemonic(name)
+, m_wOpcode(opcode)
+{
+    std::transform(this->m_strMnemonic.begin(), this->m_strMnemonic.end(), this->m_strMnemonic.begin(), ::toupper);
+}
+
+
+// MARK: -- Parse Methods
+
+// Parses a jump instruction
+std::vector<Instruction> JumpParser::parse(const std::string& line) const {
+
+    std::vector<Instruction> instructions;
+    const std::string& mnemonic = this->m_strMnemonic;
+
+    // First, trim the line and convert to lower case
+    std::string trimmedLine = StringUtils::toLowerCase(StringUtils::trim(line));
+    if (trimmedLine.length() == 0)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Empty input", trimmedLine);
+
+    // Now try to use our regex expression for the form
+    //
+    //      j label
+    //
+    std::regex rgx("^(" + this->m_strName + ")\\s+(\\w+)\\s*$");
+    std::smatch match;
+
+    if (!std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, rgx))
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid format", trimmedLine);
+
+    // Check our size
+    if (match.size() != 3 || match[1] != this->m_strName)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Line does not start with '" + this->m_strName + "'", trimmedLine);
+
+    // The address is filled in from the label once the file is read
+    Instruction instr;
+    instr.setType(InstructionType::J_FORMAT);
+    instr.setOpcode(this->m_wOpcode);
+    instr.setLabel(match[2]);
+    instructions.emplace_back(instr);
+
+    return instructions;
+}
@@ -0,0 +1,84 @@
+#include "instr/parsers/jump_register_parser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+#include "exception/syntax_error.hpp"
+#include "instr/functions.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/opcodes.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/string_utils.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+JumpRegisterParser::JumpRegisterParser(const std::string& name, word_t funct)
+: m_strName(StringUtils::toLowerCase(name))
+, m_strMnemonic(name)
+, m_wFunct(funct)
+{
+    std::transform(this->m_strMnemonic.begin(), this->m_strMnemonic.end(), this->m_strMnemonic.begin(), ::toupper);
+}
+
+
+// MARK: -- Parse Methods
+
+// Parses a jump through a register
+std::vector<Instruction> JumpRegisterParser::parse(const std::string& line) const {
+
+    std::vector<Instruction> instructions;
+    const std::string& mnemonic = this->m_strMnemonic;
+
+    // First, trim the line and convert to lower case
+    std::string trimmedLine = StringUtils::toLowerCase(StringUtils::trim(line));
+    if (trimmedLine.length() == 0)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Empty input", trimmedLine);
+
+    // Only JALR may name the register it links into
+    bool link = this->m_wFunct == static_cast<word_t>(Functions::FUNCT_JALR);
+    std::regex rgx_1("^(" + this->m_strName + ")\\s+(\\$\\w+)\\s*$");
+    std::regex rgx_2("^(" + this->m_strName + ")\\s+(\\$\\w+),\\s*(\\$\\w+)\\s*$");
+    std::smatch match;
+
+    sword_t regDest = link ? 31 : 0;
+    sword_t regSrc = -1;
+
+    if (std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, rgx_1)) {
+
+        // Check our size
+        if (match.size() != 3 || match[1] != this->m_strName)
+            throw SyntaxError("Invalid Syntax for " + mnemonic + ": Line does not start with '" + this->m_strName + "'", trimmedLine);
+
+        regSrc = RegisterBank::getRegister(match[2]);
+    }
+    else if (link && std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, rgx_2)) {
+
+        // Check our size
+        if (match.size() != 4 || match[1] != this->m_strName)
+            throw SyntaxError("Invalid Syntax for " + mnemonic + ": Line does not start with '" + this->m_strName + "'", trimmedLine);
+
+        regDest = RegisterBank::getRegister(match[2]);
+        regSrc = RegisterBank::getRegister(match[3]);
+    }
+    else
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid format", trimmedLine);
+
+    if (regDest == -1 || regSrc == -1)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid register(s)", trimmedLine);
+
+    // Otherwise, emplace back a new instruction
+    Instruction instr;
+    instr.setType(InstructionType::R_FORMAT);
+    instr.setOpcode(static_cast<word_t>(Opcodes::OPCODE_R_TYPE));
+    instr.setRd(regDest);
+    instr.setRs(regSrc);
+    instr.setRt(0);
+    instr.setShamt(0);
+    instr.setFunct(this->m_wFunct);
+    instructions.emplace_back(instr);
+
+    return instructions;
+}
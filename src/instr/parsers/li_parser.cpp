@@ -53,15 +53,31 @@ std::vector<Instruction> LiParser::parse(const std::string& line) const {
     if (regDest == -1)
         throw SyntaxError("Invalid Syntax for LI: Invalid register(s)", trimmedLine);
 
-    // Get the lower 16-bits of the value
+    // A value that fits in 16 bits is a single ORI. Anything else, negative values
+    // included, expands into
+    //
+    //  lui $rt, upper 16 bits of value
+    //  ori $rt, $rt, lower 16 bits of value
+    //
     word_t newImm = static_cast<word_t>(imm);
     hword_t val = newImm & 0xFFFF;
+    word_t regSrc = 0;
+
+    if (newImm > Instruction::LIMIT_IMM) {
+        Instruction upper;
+        upper.setType(InstructionType::I_FORMAT);
+        upper.setOpcode(static_cast<word_t>(Opcodes::OPCODE_LUI));
+        upper.setRs(0);
+        upper.setRt(regDest);
+        upper.setImmediate(newImm >> 16);
+        instructions.emplace_back(upper);
+        regSrc = regDest;
+    }
 
-    // Otherwise, emplace back a new instruction
     Instruction instr;
     instr.setType(InstructionType::I_FORMAT);
     instr.setOpcode(static_cast<word_t>(Opcodes::OPCODE_ORI));
-    instr.setRs(0);
+    instr.setRs(regSrc);
     instr.setRt(regDest);
     instr.setImmediate(val);
     instructions.emplace_back(instr);
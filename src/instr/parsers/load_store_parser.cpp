@@ -0,0 +1,95 @@
+#include "instr/parsers/load_store_parser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+#include "exception/syntax_error.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_type.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/string_utils.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+LoadStoreParser::LoadStoreParser(const std::string& name, word_t opcode)
+: m_strName(StringUtils::toLowerCase(name))
+, m_strMnemonic(name)
+, m_wOpcode(opcode)
+{
+    std::transform(this->m_strMnemonic.begin(), this->m_strMnemonic.end(), this->m_strMnemonic.begin(), ::toupper);
+}
+
+
+// MARK: -- Parse Methods
+
+// Parses a load or store instruction
+std::vector<Instruction> LoadStoreParser::parse(const std::string& line) const {
+
+    std::vector<Instruction> instructions;
+    const std::string& mnemonic = this->m_strMnemonic;
+
+    // First, trim the line and convert to lower case
+    std::string trimmedLine = StringUtils::toLowerCase(StringUtils::trim(line));
+    if (trimmedLine.length() == 0)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Empty input", trimmedLine);
+
+    sword_t regValue = -1;
+    sword_t regBase = -1;
+    sword_t imm = 0;
+
+
+    // First, try to load the common "offset" version
+    std::regex rgx_1("^(" + this->m_strName + ")\\s+(\\$\\w+),\\s+(-?\\b(0x[0-9a-fA-F]+|0[0-7]*|[1-9][0-9]*|0b[0-1]+)\\b)\\((\\$\\w+)\\)");
+    std::regex rgx_2("^(" + this->m_strName + ")\\s+(\\$\\w+),\\s+(\\$\\w+)");
+    std::smatch match;
+
+    if (std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, rgx_1)) {
+
+        // Check our size
+        if (match.size() != 6 || match[1] != this->m_strName)
+            throw SyntaxError("Invalid Syntax for " + mnemonic + ": Line does not start with '" + this->m_strName + "'", trimmedLine);
+
+        regValue = RegisterBank::getRegister(match[2]);
+        regBase = RegisterBank::getRegister(match[5]);
+
+        // Get our immediate
+        try {
+            imm = StringUtils::toNumber(match[3]);
+        }
+        catch (std::exception& e) {
+            throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid immediate value", trimmedLine);
+        }
+    }
+    else if (std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, rgx_2)) {
+
+        // Check our size
+        if (match.size() != 4 || match[1] != this->m_strName)
+            throw SyntaxError("Invalid Syntax for " + mnemonic + ": Line does not start with '" + this->m_strName + "'", trimmedLine);
+
+        regValue = RegisterBank::getRegister(match[2]);
+        regBase = RegisterBank::getRegister(match[3]);
+        imm = 0;
+    }
+    else
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid format", trimmedLine);
+
+    if (regValue == -1 || regBase == -1)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid register(s)", trimmedLine);
+
+    // Get the lower 16-bits of the value
+    word_t newImm = static_cast<word_t>(imm);
+    hword_t val = newImm & 0xFFFF;
+
+    // Otherwise, emplace back a new instruction
+    Instruction instr;
+    instr.setType(InstructionType::I_FORMAT);
+    instr.setOpcode(this->m_wOpcode);
+    instr.setRs(regBase);
+    instr.setRt(regValue);
+    instr.setImmediate(val);
+    instructions.emplace_back(instr);
+
+    return instructions;
+}
@@ -47,14 +47,15 @@ std::vector<Instruction> LuiParser::parse(const std::string& line) const {
     // Get our immediate
     sword_t imm = 0;
     try {
-        imm = StringUtils::toNumber(match[4]);
+        imm = StringUtils::toNumber(match[3]);
     }
     catch (std::exception& e) {
         throw SyntaxError("Invalid Syntax for LUI: Invalid immediate value", trimmedLine);
     }
 
+    // The upper half may be given signed or unsigned (e.g. -1 or 0xffff for 0xffff0000)
     sword_t limit = (Instruction::LIMIT_IMM + 1) / 2;
-    if (imm >= limit || imm < -limit)
+    if (imm > static_cast<sword_t>(Instruction::LIMIT_IMM) || imm < -limit)
         throw SyntaxError("Invalid Syntax for LUI: Out of bounds immediate", trimmedLine);
 
     // Otherwise, emplace back a new instruction
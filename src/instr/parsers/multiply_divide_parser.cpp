@@ -0,0 +1,73 @@
+#include "instr/parsers/multiply_divide_parser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+#include "exception/syntax_error.hpp"
+#include "instr/functions.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/opcodes.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/string_utils.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+MultiplyDivideParser::MultiplyDivideParser(const std::string& name, word_t funct)
+: m_strName(StringUtils::toLowerCase(name))
+, m_strMnemonic(name)
+, m_wFunct(funct)
+{
+    std::transform(this->m_strMnemonic.begin(), this->m_strMnemonic.end(), this->m_strMnemonic.begin(), ::toupper);
+}
+
+
+// MARK: -- Parse Methods
+
+// Parses a multiply/divide instruction
+std::vector<Instruction> MultiplyDivideParser::parse(const std::string& line) const {
+
+    std::vector<Instruction> instructions;
+    const std::string& mnemonic = this->m_strMnemonic;
+
+    // First, trim the line and convert to lower case
+    std::string trimmedLine = StringUtils::toLowerCase(StringUtils::trim(line));
+    if (trimmedLine.length() == 0)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Empty input", trimmedLine);
+
+    // Moves to and from HI and LO take one register, the rest two
+    Functions funct = static_cast<Functions>(this->m_wFunct);
+    bool single = funct == Functions::FUNCT_MFHI || funct == Functions::FUNCT_MFLO || funct == Functions::FUNCT_MTHI || funct == Functions::FUNCT_MTLO;
+
+    std::regex rgx(single ? "^(" + this->m_strName + ")\\s+(\\$\\w+)\\s*$" : "^(" + this->m_strName + ")\\s+(\\$\\w+),\\s*(\\$\\w+)\\s*$");
+    std::smatch match;
+
+    if (!std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, rgx))
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid format", trimmedLine);
+
+    // Check our size
+    if (match.size() != (single ? 3u : 4u) || match[1] != this->m_strName)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Line does not start with '" + this->m_strName + "'", trimmedLine);
+
+    sword_t reg1 = RegisterBank::getRegister(match[2]);
+    sword_t reg2 = single ? 0 : RegisterBank::getRegister(match[3]);
+    if (reg1 == -1 || reg2 == -1)
+        throw SyntaxError("Invalid Syntax for " + mnemonic + ": Invalid register(s)", trimmedLine);
+
+    // Moves from HI and LO write RD; everything else reads RS (and RT)
+    bool moveFrom = funct == Functions::FUNCT_MFHI || funct == Functions::FUNCT_MFLO;
+
+    Instruction instr;
+    instr.setType(InstructionType::R_FORMAT);
+    instr.setOpcode(static_cast<word_t>(Opcodes::OPCODE_R_TYPE));
+    instr.setRd(moveFrom ? reg1 : 0);
+    instr.setRs(moveFrom ? 0 : reg1);
+    instr.setRt(reg2);
+    instr.setShamt(0);
+    instr.setFunct(this->m_wFunct);
+    instructions.emplace_back(instr);
+
+    return instructions;
+}
@@ -29,7 +29,7 @@ std::vector<Instruction> SllParser::parse(const std::string& line) const {
     //
     //      add dest, src1, imm
     //
-    std::regex sll_rgx("^(ori)\\s+(\\$\\w+),\\s*(\\$\\w+),\\s*\\b(0x[0-9a-fA-F]+|0[0-7]*|[1-9][0-9]*|0b[0-1]+)\\b");
+    std::regex sll_rgx("^(sll)\\s+(\\$\\w+),\\s*(\\$\\w+),\\s*\\b(0x[0-9a-fA-F]+|0[0-7]*|[1-9][0-9]*|0b[0-1]+)\\b");
     std::smatch match;
 
     if (!std::regex_search(trimmedLine.cbegin(), trimmedLine.cend(), match, sll_rgx))
@@ -37,7 +37,7 @@ std::vector<Instruction> SllParser::parse(const std::string& line) const {
 
     // Do a quick sanity check for the size (should be exactly 4)
     if (match.size() != 5 || match[1] != "sll")
-        throw SyntaxError("Invalid Syntax for SLL: Line does not start with 'ori'", trimmedLine);
+        throw SyntaxError("Invalid Syntax for SLL: Line does not start with 'sll'", trimmedLine);
 
     // Now, create our instructions
     sword_t regDest = RegisterBank::getRegister(match[2]);
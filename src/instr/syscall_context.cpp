@@ -0,0 +1,94 @@
+#include "instr/syscall_context.hpp"
+
+#include "registers/register_bank.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+SyscallContext::SyscallContext(RegisterBank& registerBank, Memory& memory)
+: m_registerBank(registerBank)
+, m_memory(memory)
+, m_bExit(false)
+, m_pRecord(nullptr)
+{ }
+
+
+// MARK: -- Argument Methods
+
+// Returns an argument
+word_t SyscallContext::getArgument(word_t index) const {
+
+    word_t value = 0;
+    if (index < NUM_ARGS)
+        this->m_registerBank.readRegister(REG_ARG_START + index, value);
+
+    return value;
+}
+
+
+// MARK: -- Result Methods
+
+// Writes a register
+void SyscallContext::setRegister(word_t num, word_t value) {
+
+    this->m_registerBank.writeRegister(num, value);
+    if (this->m_pRecord != nullptr)
+        this->m_pRecord->vecRegisters.emplace_back(num, value);
+}
+
+// Writes the result
+void SyscallContext::setResult(word_t value) {
+    this->setRegister(REG_RESULT, value);
+}
+
+// Returns whether a system call may write a register
+bool SyscallContext::writesRegister(sword_t num) {
+    return num == static_cast<sword_t>(REG_RESULT) || num == static_cast<sword_t>(REG_ARG_START) || num == static_cast<sword_t>(REG_ARG_START + 1);
+}
+
+// Requests an exit
+void SyscallContext::requestExit() {
+    this->m_bExit = true;
+}
+
+// Returns whether to exit
+bool SyscallContext::shouldExit() const {
+    return this->m_bExit;
+}
+
+
+// MARK: -- Memory Methods
+
+// Reads memory
+bool SyscallContext::readMemory(Memory::addr_t addr, byte_t * data, size_t size) const {
+    return this->m_memory.readBlock(addr, data, size);
+}
+
+// Writes memory
+bool SyscallContext::writeMemory(Memory::addr_t addr, const byte_t * data, size_t size) {
+
+    if (!this->m_memory.writeBlock(addr, data, size))
+        return false;
+
+    if (this->m_pRecord != nullptr) {
+        SyscallLog::MemoryWrite write;
+        write.wAddr = addr;
+        write.vecData.assign(data, data + size);
+        this->m_pRecord->vecMemory.push_back(std::move(write));
+    }
+
+    return true;
+}
+
+// Returns the memory
+Memory& SyscallContext::getMemory() {
+    return this->m_memory;
+}
+
+
+// MARK: -- Recording Methods
+
+// Sets the record entry
+void SyscallContext::setRecord(SyscallLog::Entry * entry) {
+    this->m_pRecord = entry;
+}
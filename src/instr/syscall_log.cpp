@@ -0,0 +1,152 @@
+#include "instr/syscall_log.hpp"
+
+#include <cstring>
+
+#include "spdlog/spdlog.h"
+
+// MARK: -- Static Constants
+constexpr const char * SyscallLog::LOG_MAGIC;
+
+
+// MARK: -- Static Helpers
+
+// Writes a little-endian word
+static void writeWord(std::ostream& stream, word_t word) {
+
+    byte_t bytes[4] = {
+        static_cast<byte_t>(word & 0xFF),
+        static_cast<byte_t>((word >> 8) & 0xFF),
+        static_cast<byte_t>((word >> 16) & 0xFF),
+        static_cast<byte_t>((word >> 24) & 0xFF)
+    };
+    stream.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+// Reads a little-endian word
+static bool readWord(std::istream& stream, word_t& word) {
+
+    byte_t bytes[4];
+    if (!stream.read(reinterpret_cast<char *>(bytes), sizeof(bytes)))
+        return false;
+
+    word = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<word_t>(bytes[3]) << 24);
+    return true;
+}
+
+
+// MARK: -- File Methods
+
+// Opens a file for recording
+bool SyscallLog::openForRecording(const std::string& filename) {
+
+    this->m_fileRecord.open(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!this->m_fileRecord.is_open()) {
+        spdlog::error("Unable to open system call log '{}' for recording", filename);
+        return false;
+    }
+
+    this->m_fileRecord.write(LOG_MAGIC, std::strlen(LOG_MAGIC));
+    return true;
+}
+
+// Loads a recorded file
+bool SyscallLog::load(const std::string& filename) {
+
+    std::ifstream stream(filename, std::ios_base::in | std::ios_base::binary);
+    if (!stream.is_open()) {
+        spdlog::error("Unable to open system call log '{}' for replay", filename);
+        return false;
+    }
+
+    // Lengths in the log are checked against what is left of it before anything is allocated for them
+    stream.seekg(0, std::ios_base::end);
+    std::streamoff size = stream.tellg();
+    stream.seekg(0, std::ios_base::beg);
+
+    char magic[8];
+    if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, LOG_MAGIC, sizeof(magic)) != 0) {
+        spdlog::error("System call log '{}' is not a valid log", filename);
+        return false;
+    }
+
+    // Each entry: code, exit, register count, (register, value)*, memory count, (address, length, bytes)*.
+    // Only the end of the file between two entries ends the log - anywhere else it is cut short
+    this->m_vecEntries.clear();
+    while (stream.peek() != std::char_traits<char>::eof()) {
+
+        Entry entry;
+        word_t exit = 0, numRegisters = 0, numWrites = 0;
+        bool valid = readWord(stream, entry.wCode) && readWord(stream, exit) && readWord(stream, numRegisters);
+        entry.bExit = (exit != 0);
+
+        for (word_t i = 0; i < numRegisters && valid; ++i) {
+            word_t reg, value;
+            valid = readWord(stream, reg) && readWord(stream, value);
+            entry.vecRegisters.emplace_back(reg, value);
+        }
+
+        valid = valid && readWord(stream, numWrites);
+        for (word_t i = 0; i < numWrites && valid; ++i) {
+            MemoryWrite write;
+            word_t length;
+            valid = readWord(stream, write.wAddr) && readWord(stream, length);
+            if (!valid) break;
+
+            if (static_cast<std::streamoff>(length) > size - static_cast<std::streamoff>(stream.tellg())) {
+                spdlog::error("System call log '{}' is not a valid log", filename);
+                return false;
+            }
+
+            write.vecData.resize(length);
+            valid = static_cast<bool>(stream.read(reinterpret_cast<char *>(write.vecData.data()), length));
+            entry.vecMemory.push_back(std::move(write));
+        }
+
+        if (!valid) {
+            spdlog::error("System call log '{}' is truncated after {} entries", filename, this->m_vecEntries.size());
+            return false;
+        }
+
+        this->m_vecEntries.push_back(std::move(entry));
+    }
+
+    return true;
+}
+
+
+// MARK: -- Entry Methods
+
+// Appends an entry
+void SyscallLog::append(const Entry& entry) {
+
+    if (!this->m_fileRecord.is_open()) {
+        this->m_vecEntries.push_back(entry);
+        return;
+    }
+
+    writeWord(this->m_fileRecord, entry.wCode);
+    writeWord(this->m_fileRecord, entry.bExit ? 1 : 0);
+
+    writeWord(this->m_fileRecord, static_cast<word_t>(entry.vecRegisters.size()));
+    for (const auto& reg : entry.vecRegisters) {
+        writeWord(this->m_fileRecord, reg.first);
+        writeWord(this->m_fileRecord, reg.second);
+    }
+
+    writeWord(this->m_fileRecord, static_cast<word_t>(entry.vecMemory.size()));
+    for (const MemoryWrite& write : entry.vecMemory) {
+        writeWord(this->m_fileRecord, write.wAddr);
+        writeWord(this->m_fileRecord, static_cast<word_t>(write.vecData.size()));
+        this->m_fileRecord.write(reinterpret_cast<const char *>(write.vecData.data()), write.vecData.size());
+    }
+}
+
+// Returns the size
+size_t SyscallLog::size() const {
+    return this->m_vecEntries.size();
+}
+
+// Returns an entry
+const SyscallLog::Entry& SyscallLog::at(size_t index) const {
+    return this->m_vecEntries.at(index);
+}
@@ -0,0 +1,220 @@
+#include "memory/coherence_bus.hpp"
+
+#include <algorithm>
+
+// MARK: -- Construction
+
+// Constructor
+CoherenceBus::CoherenceBus(const Config& config)
+: m_config(config)
+, m_wDataStart(Memory::MEM_USER_START)
+, m_szActiveCore(0)
+, m_dwCycle(0)
+, m_dwBusyUntil(0)
+{
+    // Builds a throwaway cache, so a bad geometry is caught before any core is added
+    L1Cache(config.szLineSize, config.szSets, config.szWays);
+}
+
+
+// MARK: -- Cache Methods
+
+// Adds a cache
+size_t CoherenceBus::addCache() {
+    this->m_vecCaches.emplace_back(new L1Cache(this->m_config.szLineSize, this->m_config.szSets, this->m_config.szWays));
+    return this->m_vecCaches.size() - 1;
+}
+
+// Returns the number of caches
+size_t CoherenceBus::getNumCaches() const {
+    return this->m_vecCaches.size();
+}
+
+// Returns a cache
+const L1Cache& CoherenceBus::getCache(size_t core) const {
+    return *this->m_vecCaches.at(core);
+}
+
+// Returns the configuration
+const CoherenceBus::Config& CoherenceBus::getConfig() const {
+    return this->m_config;
+}
+
+
+// MARK: -- Cycle Methods
+
+// Sets the start of the data segment
+void CoherenceBus::setDataStart(Memory::addr_t addr) {
+    this->m_wDataStart = addr;
+}
+
+// Starts a core's cycle
+void CoherenceBus::beginCycle(size_t core, dword_t cycle) {
+    this->m_szActiveCore = core;
+    this->m_dwCycle = cycle;
+}
+
+// Returns the bus counters
+const CoherenceBus::Stats& CoherenceBus::getStats() const {
+    return this->m_stats;
+}
+
+// Resets every cache
+void CoherenceBus::reset() {
+
+    for (auto& cache : this->m_vecCaches)
+        cache->reset();
+
+    this->m_szActiveCore = 0;
+    this->m_dwCycle = 0;
+    this->m_dwBusyUntil = 0;
+    this->m_stats = Stats();
+}
+
+
+// MARK: -- Observer Methods
+
+// Runs a read
+void CoherenceBus::onRead(word_t addr, size_t size) {
+    this->access(addr, size, false);
+}
+
+// Runs a write
+void CoherenceBus::onWrite(word_t addr, size_t size) {
+    this->access(addr, size, true);
+}
+
+
+// MARK: -- Private Methods
+
+// Runs an access
+void CoherenceBus::access(Memory::addr_t addr, size_t size, bool write) {
+
+    // Instruction fetches (and anything else in the text segment) are not ours
+    if (addr < this->m_wDataStart || this->m_szActiveCore >= this->m_vecCaches.size() || size == 0)
+        return;
+
+    // Does the split into lines, with a mask of the bytes touched in each
+    size_t lineSize = this->m_config.szLineSize;
+    Memory::addr_t end = addr + static_cast<Memory::addr_t>(size);
+    while (addr < end) {
+
+        Memory::addr_t lineAddr = addr & ~static_cast<Memory::addr_t>(lineSize - 1);
+        size_t first = addr - lineAddr;
+        size_t count = std::min<size_t>(lineSize - first, end - addr);
+        uint64_t mask = ((count == 64) ? ~0ULL : ((1ULL << count) - 1)) << first;
+
+        this->accessLine(lineAddr, mask, write);
+        addr += static_cast<Memory::addr_t>(count);
+    }
+}
+
+// Runs an access to one line
+void CoherenceBus::accessLine(Memory::addr_t lineAddr, uint64_t mask, bool write) {
+
+    L1Cache& cache = *this->m_vecCaches[this->m_szActiveCore];
+    L1Cache::Stats& stats = cache.getStats();
+    if (write)  stats.dwWrites++;
+    else        stats.dwReads++;
+
+    L1Cache::Line * line = cache.find(lineAddr);
+    if (line != nullptr) {
+
+        stats.dwHits++;
+
+        // Writing a shared line needs every other copy gone first
+        if (write && line->state == MesiState::SHARED) {
+
+            this->m_stats.dwUpgrades++;
+            stats.dwBusTransactions++;
+            this->transact(this->m_config.dwInvalidateLatency);
+
+            for (size_t core = 0; core < this->m_vecCaches.size(); ++core) {
+
+                L1Cache::Line * other = (core == this->m_szActiveCore) ? nullptr : this->m_vecCaches[core]->snoop(lineAddr);
+                if (other == nullptr) continue;
+
+                this->m_vecCaches[core]->invalidate(*other, mask);
+                stats.dwInvalidationsSent++;
+            }
+        }
+
+        if (write) line->state = MesiState::MODIFIED;
+    }
+    else {
+
+        stats.dwMisses++;
+
+        // A line another core took away from us is a coherence miss, and it is only true
+        // sharing if we touch bytes they wrote since
+        uint64_t written = 0;
+        if (cache.takeInvalidation(lineAddr, written)) {
+            stats.dwCoherenceMisses++;
+            if (written & mask)     stats.dwTrueSharingMisses++;
+            else                    stats.dwFalseSharingMisses++;
+        }
+
+        // Make room, writing back the victim if it was modified
+        MesiState evicted = MesiState::INVALID;
+        line = &cache.allocate(lineAddr, evicted);
+        if (evicted == MesiState::MODIFIED) {
+            stats.dwWriteBacks++;
+            stats.dwBusTransactions++;
+            this->m_stats.dwWriteBacks++;
+            this->transact(this->m_config.dwMemoryLatency);
+        }
+
+        // Snoop every other cache: a read leaves them sharing, a write takes the line away
+        bool shared = false;
+        for (size_t core = 0; core < this->m_vecCaches.size(); ++core) {
+
+            L1Cache::Line * other = (core == this->m_szActiveCore) ? nullptr : this->m_vecCaches[core]->snoop(lineAddr);
+            if (other == nullptr) continue;
+
+            shared = true;
+            if (other->state == MesiState::MODIFIED) {
+                this->m_vecCaches[core]->getStats().dwWriteBacks++;
+                this->m_stats.dwWriteBacks++;
+            }
+
+            if (write) {
+                this->m_vecCaches[core]->invalidate(*other, mask);
+                stats.dwInvalidationsSent++;
+            }
+            else
+                other->state = MesiState::SHARED;
+        }
+
+        if (write)  this->m_stats.dwReadExclusives++;
+        else        this->m_stats.dwReads++;
+        if (shared) this->m_stats.dwCacheToCache++;
+
+        stats.dwBusTransactions++;
+        this->transact(shared ? this->m_config.dwCacheToCacheLatency : this->m_config.dwMemoryLatency);
+        line->state = write ? MesiState::MODIFIED : (shared ? MesiState::SHARED : MesiState::EXCLUSIVE);
+    }
+
+    line->dwAccessed |= mask;
+
+    // Other cores waiting to get this line back need to know which bytes changed
+    if (write) {
+        for (size_t core = 0; core < this->m_vecCaches.size(); ++core) {
+            if (core != this->m_szActiveCore)
+                this->m_vecCaches[core]->noteRemoteWrite(lineAddr, mask);
+        }
+    }
+}
+
+// Holds the bus
+void CoherenceBus::transact(dword_t occupancy) {
+
+    // Each core's clock is the global clock plus however long it has already stalled
+    L1Cache::Stats& stats = this->m_vecCaches[this->m_szActiveCore]->getStats();
+    dword_t now = this->m_dwCycle + stats.dwStallCycles;
+    dword_t start = std::max(now, this->m_dwBusyUntil) + this->m_config.dwArbitrationLatency;
+
+    this->m_stats.dwWaitCycles += std::max(now, this->m_dwBusyUntil) - now;
+    this->m_stats.dwBusyCycles += occupancy;
+    this->m_dwBusyUntil = start + occupancy;
+    stats.dwStallCycles += this->m_dwBusyUntil - now;
+}
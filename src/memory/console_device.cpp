@@ -0,0 +1,44 @@
+#include "memory/console_device.hpp"
+
+#include <cstring>
+
+// MARK: -- Constants
+constexpr word_t ConsoleDevice::REG_DATA;
+constexpr size_t ConsoleDevice::SIZE;
+constexpr dword_t ConsoleDevice::DEFAULT_LATENCY;
+
+
+// MARK: -- Construction
+
+// Constructor
+ConsoleDevice::ConsoleDevice(std::ostream& output, InputFeed * input, dword_t latency)
+: m_output(output)
+, m_ptrInput(input)
+, m_dwLatency(latency)
+{ }
+
+
+// MARK: -- Device Methods
+
+// Takes a character of input
+bool ConsoleDevice::read(word_t offset, byte_t * data, size_t size, dword_t& cycles) {
+
+    if (offset != REG_DATA || size > SIZE) return false;
+
+    int ch = (this->m_ptrInput != nullptr) ? this->m_ptrInput->get() : EOF;
+    std::memset(data, 0, size);
+    data[0] = (ch == EOF) ? 0xFF : static_cast<byte_t>(ch);
+
+    cycles = this->m_dwLatency;
+    return true;
+}
+
+// Prints a character
+bool ConsoleDevice::write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) {
+
+    if (offset != REG_DATA || size > SIZE) return false;
+
+    this->m_output.put(static_cast<char>(data[0]));
+    cycles = this->m_dwLatency;
+    return true;
+}
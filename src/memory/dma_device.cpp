@@ -0,0 +1,93 @@
+#include "memory/dma_device.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+// MARK: -- Constants
+constexpr word_t DmaDevice::REG_SOURCE;
+constexpr word_t DmaDevice::REG_DEST;
+constexpr word_t DmaDevice::REG_LENGTH;
+constexpr word_t DmaDevice::REG_CONTROL;
+constexpr size_t DmaDevice::SIZE;
+constexpr byte_t DmaDevice::STATUS_ERROR;
+constexpr dword_t DmaDevice::DEFAULT_SETUP_CYCLES;
+constexpr dword_t DmaDevice::DEFAULT_BYTES_PER_CYCLE;
+
+
+// MARK: -- Construction
+
+// Constructor
+DmaDevice::DmaDevice(Memory& memory, dword_t setupCycles, dword_t bytesPerCycle)
+: m_memory(memory)
+, m_dwSetupCycles(setupCycles)
+, m_dwBytesPerCycle(bytesPerCycle)
+, m_bBusy(false)
+{
+    if (bytesPerCycle == 0)
+        throw std::invalid_argument("Cannot copy 0 bytes per cycle");
+
+    this->m_arrRegisters.fill(0);
+}
+
+
+// MARK: -- Device Methods
+
+// Reads the registers
+bool DmaDevice::read(word_t offset, byte_t * data, size_t size, dword_t& cycles) {
+
+    if (offset >= SIZE || size > SIZE - offset) return false;
+
+    std::memcpy(data, this->m_arrRegisters.data() + offset, size);
+    cycles = 1;
+    return true;
+}
+
+// Writes the registers, starting a copy on a write to the control register
+bool DmaDevice::write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) {
+
+    if (offset >= SIZE || size > SIZE - offset || this->m_bBusy) return false;
+
+    std::memcpy(this->m_arrRegisters.data() + offset, data, size);
+    cycles = 1;
+
+    bool start = offset <= REG_CONTROL && offset + size > REG_CONTROL && this->m_arrRegisters[REG_CONTROL] != 0;
+    if (start) cycles += this->runCopy();
+    return true;
+}
+
+
+// MARK: -- Private Methods
+
+// Reads a register
+word_t DmaDevice::readRegister(word_t reg) const {
+    return this->m_arrRegisters[reg]
+            | (this->m_arrRegisters[reg+1] << 8)
+            | (this->m_arrRegisters[reg+2] << 16)
+            | (static_cast<word_t>(this->m_arrRegisters[reg+3]) << 24);
+}
+
+// Runs a copy
+dword_t DmaDevice::runCopy() {
+
+    word_t source = this->readRegister(REG_SOURCE);
+    word_t dest = this->readRegister(REG_DEST);
+    word_t length = this->readRegister(REG_LENGTH);
+
+    // Does the copy through a buffer, so overlapping ranges copy as memmove would
+    bool success = (length <= this->m_memory.getTotalSize());
+    if (success) {
+        this->m_bBusy = true;
+        this->m_vecScratch.resize(length);
+        success = this->m_memory.readBlock(source, this->m_vecScratch.data(), length)
+               && this->m_memory.writeBlock(dest, this->m_vecScratch.data(), length);
+        this->m_bBusy = false;
+    }
+
+    std::memset(this->m_arrRegisters.data() + REG_CONTROL, 0, sizeof(word_t));
+    if (!success) {
+        this->m_arrRegisters[REG_CONTROL] = STATUS_ERROR;
+        return this->m_dwSetupCycles;
+    }
+
+    return this->m_dwSetupCycles + (length + this->m_dwBytesPerCycle - 1) / this->m_dwBytesPerCycle;
+}
@@ -0,0 +1,192 @@
+#include "memory/l1_cache.hpp"
+
+#include <stdexcept>
+
+// MARK: -- Constants
+constexpr size_t L1Cache::MAX_LINE_SIZE;
+
+
+// MARK: -- MESI States
+
+// Returns a state's name
+const char * getMesiStateName(MesiState state) {
+    switch (state) {
+        case MesiState::INVALID:    return "I";
+        case MesiState::SHARED:     return "S";
+        case MesiState::EXCLUSIVE:  return "E";
+        case MesiState::MODIFIED:   return "M";
+    }
+    return "?";
+}
+
+
+// MARK: -- Construction
+
+// Constructor
+L1Cache::L1Cache(size_t lineSize, size_t numSets, size_t numWays)
+: m_szLineSize(lineSize)
+, m_szSets(numSets)
+, m_szWays(numWays)
+, m_dwTick(0)
+{
+    auto isPowerOfTwo = [](size_t value) { return value != 0 && (value & (value - 1)) == 0; };
+
+    if (!isPowerOfTwo(lineSize) || lineSize > MAX_LINE_SIZE)
+        throw std::invalid_argument("Cache line size must be a power of two of at most 64 bytes");
+
+    if (!isPowerOfTwo(numSets))
+        throw std::invalid_argument("Cache set count must be a power of two");
+
+    if (numWays == 0)
+        throw std::invalid_argument("Cache must have at least one way");
+
+    this->m_vecLines.resize(numSets * numWays);
+}
+
+
+// MARK: -- Line Methods
+
+// Returns the line address of an address
+Memory::addr_t L1Cache::getLineAddress(Memory::addr_t addr) const {
+    return addr & ~static_cast<Memory::addr_t>(this->m_szLineSize - 1);
+}
+
+// Returns the line size
+size_t L1Cache::getLineSize() const {
+    return this->m_szLineSize;
+}
+
+// Finds a line
+L1Cache::Line * L1Cache::find(Memory::addr_t lineAddr) {
+
+    size_t set = this->getSetIndex(lineAddr);
+    for (size_t way = 0; way < this->m_szWays; ++way) {
+
+        Line& line = this->m_vecLines[set + way];
+        if (line.state != MesiState::INVALID && line.wAddress == lineAddr) {
+            line.dwLastUsed = ++this->m_dwTick;
+            return &line;
+        }
+    }
+
+    return nullptr;
+}
+
+// Snoops a line
+L1Cache::Line * L1Cache::snoop(Memory::addr_t lineAddr) {
+
+    size_t set = this->getSetIndex(lineAddr);
+    for (size_t way = 0; way < this->m_szWays; ++way) {
+
+        Line& line = this->m_vecLines[set + way];
+        if (line.state != MesiState::INVALID && line.wAddress == lineAddr)
+            return &line;
+    }
+
+    return nullptr;
+}
+
+// Returns the state of a line
+MesiState L1Cache::getState(Memory::addr_t addr) const {
+
+    Memory::addr_t lineAddr = this->getLineAddress(addr);
+    size_t set = this->getSetIndex(lineAddr);
+    for (size_t way = 0; way < this->m_szWays; ++way) {
+
+        const Line& line = this->m_vecLines[set + way];
+        if (line.state != MesiState::INVALID && line.wAddress == lineAddr)
+            return line.state;
+    }
+
+    return MesiState::INVALID;
+}
+
+// Allocates a line
+L1Cache::Line& L1Cache::allocate(Memory::addr_t lineAddr, MesiState& evicted) {
+
+    // Does the replacement: an invalid way if there is one, otherwise the least recently used
+    size_t set = this->getSetIndex(lineAddr);
+    Line * victim = &this->m_vecLines[set];
+    for (size_t way = 0; way < this->m_szWays; ++way) {
+
+        Line& line = this->m_vecLines[set + way];
+        if (line.state == MesiState::INVALID) {
+            victim = &line;
+            break;
+        }
+
+        if (line.dwLastUsed < victim->dwLastUsed)
+            victim = &line;
+    }
+
+    evicted = victim->state;
+    victim->wAddress = lineAddr;
+    victim->state = MesiState::INVALID;
+    victim->dwAccessed = 0;
+    victim->dwLastUsed = ++this->m_dwTick;
+    return *victim;
+}
+
+// Invalidates a line
+void L1Cache::invalidate(Line& line, uint64_t written) {
+
+    line.state = MesiState::INVALID;
+    line.dwAccessed = 0;
+    this->m_mapInvalidated[line.wAddress] = written;
+    this->m_stats.dwInvalidationsReceived++;
+}
+
+
+// MARK: -- Sharing Methods
+
+// Notes a remote write
+void L1Cache::noteRemoteWrite(Memory::addr_t lineAddr, uint64_t written) {
+
+    auto search = this->m_mapInvalidated.find(lineAddr);
+    if (search != this->m_mapInvalidated.end())
+        search->second |= written;
+}
+
+// Forgets an invalidated line
+bool L1Cache::takeInvalidation(Memory::addr_t lineAddr, uint64_t& written) {
+
+    auto search = this->m_mapInvalidated.find(lineAddr);
+    if (search == this->m_mapInvalidated.end())
+        return false;
+
+    written = search->second;
+    this->m_mapInvalidated.erase(search);
+    return true;
+}
+
+
+// MARK: -- Stats Methods
+
+// Returns the counters
+L1Cache::Stats& L1Cache::getStats() {
+    return this->m_stats;
+}
+
+// Returns the counters
+const L1Cache::Stats& L1Cache::getStats() const {
+    return this->m_stats;
+}
+
+// Resets the cache
+void L1Cache::reset() {
+
+    for (Line& line : this->m_vecLines)
+        line = Line();
+
+    this->m_mapInvalidated.clear();
+    this->m_dwTick = 0;
+    this->m_stats = Stats();
+}
+
+
+// MARK: -- Private Methods
+
+// Returns the set of a line
+size_t L1Cache::getSetIndex(Memory::addr_t lineAddr) const {
+    return ((lineAddr / this->m_szLineSize) & (this->m_szSets - 1)) * this->m_szWays;
+}
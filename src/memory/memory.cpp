@@ -1,6 +1,16 @@
 #include "memory/memory.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
+
+// MARK: -- Constants
+constexpr Memory::addr_t Memory::MEM_USER_START;
+constexpr size_t Memory::PAGE_SIZE;
+constexpr Memory::addr_t Memory::MMIO_START;
+constexpr size_t Memory::MMIO_PAGES;
+
 
 // MARK: -- Construction
 
@@ -8,10 +18,19 @@
 Memory::Memory(size_t dataSize, size_t textSize)
 : m_szDataSegment(dataSize)
 , m_szTextSegment(textSize)
+, m_dwTextWrites(0)
+, m_dwWriteGeneration(0)
+, m_ptrJournal(nullptr)
+, m_ptrUndoLog(nullptr)
+, m_ptrObserver(nullptr)
+, m_bTrackPages(false)
+, m_bWatching(false)
+, m_dwDeviceCycles(0)
 { 
-    // Initialise our vector
+    // Initialise our vector (zeroed, so that bulk copies always land inside it)
     size_t totalSize = this->m_szDataSegment + this->m_szTextSegment;
-    this->m_vecMemory.reserve(totalSize);
+    this->m_vecMemory.resize(totalSize, 0);
+    this->m_arrDevices.fill({ nullptr, 0 });
 }
 
 
@@ -21,9 +40,27 @@ Memory::Memory(size_t dataSize, size_t textSize)
 bool Memory::readByte(addr_t addr, byte_t& byte) const {
 
     auto offset = this->addressToOffset(addr, sizeof(byte_t));
-    if (offset == -1) return false;
+    if (offset == -1) return this->readDevice(addr, &byte, sizeof(byte_t));
 
     byte = this->m_vecMemory[offset];
+    if (this->m_ptrObserver != nullptr) this->m_ptrObserver->onRead(addr, sizeof(byte_t));
+    if (this->m_bWatching && this->checkWatch(offset, sizeof(byte_t), WatchKind::READ)) this->reportWatch(offset, sizeof(byte_t), false, byte);
+    return true;
+}
+
+// Read a block of bytes from memory
+bool Memory::readBlock(addr_t addr, byte_t * data, size_t size) const {
+
+    // Zero-length reads always succeed, and anything larger than memory can never fit
+    if (size == 0) return true;
+    if (data == nullptr || size > this->getTotalSize()) return false;
+
+    auto offset = this->addressToOffset(addr, size);
+    if (offset == -1) return this->readDevice(addr, data, size);
+
+    std::memcpy(data, this->m_vecMemory.data() + offset, size);
+    if (this->m_ptrObserver != nullptr) this->m_ptrObserver->onRead(addr, size);
+    if (this->m_bWatching && this->checkWatch(offset, size, WatchKind::READ)) this->reportWatch(offset, size, false, this->valueAt(offset, size));
     return true;
 }
 
@@ -40,7 +77,7 @@ bool Memory::readString(addr_t addr, ascii_t& str) {
 
     // Now iterate through until we hit a null terminator or end of memory
     bool specialChar = false;
-    while (offset < this->m_vecMemory.capacity() && this->m_vecMemory[offset] != '\0') {
+    while (offset < this->m_vecMemory.size() && this->m_vecMemory[offset] != '\0') {
 
         if (specialChar) {
 
@@ -75,6 +112,14 @@ bool Memory::readString(addr_t addr, ascii_t& str) {
         offset++;
     }
 
+    // Includes the terminator, if we reached one
+    if (this->m_ptrObserver != nullptr || this->m_bWatching) {
+        auto start = addr - MEM_USER_START;
+        size_t size = std::min(offset - start + 1, this->getTotalSize() - start);
+        if (this->m_ptrObserver != nullptr) this->m_ptrObserver->onRead(addr, size);
+        if (this->m_bWatching && this->checkWatch(start, size, WatchKind::READ)) this->reportWatch(start, size, false, this->valueAt(start, size));
+    }
+
     return true;
 }
 
@@ -83,7 +128,12 @@ bool Memory::readWord(addr_t addr, word_t& word) const {
 
     // Now get the offset
     auto offset = this->addressToOffset(addr, sizeof(word_t));
-    if (offset == -1) return false;
+    if (offset == -1) {
+        byte_t bytes[sizeof(word_t)];
+        if (!this->readDevice(addr, bytes, sizeof(word_t))) return false;
+        word = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<word_t>(bytes[3]) << 24);
+        return true;
+    }
 
     // Get the starting address
     word = this->m_vecMemory[offset+0]
@@ -91,6 +141,8 @@ bool Memory::readWord(addr_t addr, word_t& word) const {
             | (this->m_vecMemory[offset+2] << 16)
             | (this->m_vecMemory[offset+3] << 24);
 
+    if (this->m_ptrObserver != nullptr) this->m_ptrObserver->onRead(addr, sizeof(word_t));
+    if (this->m_bWatching && this->checkWatch(offset, sizeof(word_t), WatchKind::READ)) this->reportWatch(offset, sizeof(word_t), false, word);
     return true;
 }
 
@@ -98,9 +150,35 @@ bool Memory::readWord(addr_t addr, word_t& word) const {
 bool Memory::writeByte(addr_t addr, byte_t byte) {
 
     auto offset = this->addressToOffset(addr, sizeof(byte_t));
-    if (offset == -1) return false;
+    if (offset == -1) return this->writeDevice(addr, &byte, sizeof(byte_t));
+
+    bool watched = this->m_bWatching && this->checkWatch(offset, sizeof(byte_t), WatchKind::WRITE);
+    word_t old = watched ? this->m_vecMemory[offset] : 0;
 
+    if (this->m_ptrUndoLog != nullptr) this->recordUndo(offset, sizeof(byte_t));
     this->m_vecMemory[offset] = byte;
+    this->recordWrite(offset, sizeof(byte_t));
+    if (watched) this->reportWatch(offset, sizeof(byte_t), true, old);
+    return true;
+}
+
+// Write a block of bytes to memory
+bool Memory::writeBlock(addr_t addr, const byte_t * data, size_t size) {
+
+    // Zero-length writes always succeed, and anything larger than memory can never fit
+    if (size == 0) return true;
+    if (data == nullptr || size > this->getTotalSize()) return false;
+
+    auto offset = this->addressToOffset(addr, size);
+    if (offset == -1) return this->writeDevice(addr, data, size);
+
+    bool watched = this->m_bWatching && this->checkWatch(offset, size, WatchKind::WRITE);
+    word_t old = watched ? this->valueAt(offset, size) : 0;
+
+    if (this->m_ptrUndoLog != nullptr) this->recordUndo(offset, size);
+    std::memcpy(this->m_vecMemory.data() + offset, data, size);
+    this->recordWrite(offset, size);
+    if (watched) this->reportWatch(offset, size, true, old);
     return true;
 }
 
@@ -114,11 +192,19 @@ bool Memory::writeString(addr_t addr, const ascii_t& str) {
     auto offset = this->addressToOffset(addr, size);
     if (offset == -1) return false;
 
+    bool watched = this->m_bWatching && this->checkWatch(offset, size, WatchKind::WRITE);
+    word_t old = watched ? this->valueAt(offset, size) : 0;
+
+    if (this->m_ptrUndoLog != nullptr) this->recordUndo(offset, size);
+
     // Otherwise, start at the offset and write each character
+    auto start = offset;
     for (const char& c : str) {
         this->m_vecMemory[offset++] = c;
     }
     this->m_vecMemory[offset] = '\0';
+    this->recordWrite(start, size);
+    if (watched) this->reportWatch(start, size, true, old);
     return true;
 }
 
@@ -126,13 +212,38 @@ bool Memory::writeString(addr_t addr, const ascii_t& str) {
 bool Memory::writeWord(addr_t addr, word_t word) {
 
     // Now get the offset
+    auto offset = this->addressToOffset(addr, sizeof(word_t));
+    if (offset == -1) {
+        byte_t bytes[sizeof(word_t)] = { byte_t(word), byte_t(word >> 8), byte_t(word >> 16), byte_t(word >> 24) };
+        return this->writeDevice(addr, bytes, sizeof(word_t));
+    }
+
+    bool watched = this->m_bWatching && this->checkWatch(offset, sizeof(word_t), WatchKind::WRITE);
+    word_t old = watched ? this->valueAt(offset, sizeof(word_t)) : 0;
+
+    if (this->m_ptrUndoLog != nullptr) this->recordUndo(offset, sizeof(word_t));
+    this->m_vecMemory[offset+0] = word & 0xFF;
+    this->m_vecMemory[offset+1] = (word >> 8) & 0xFF;
+    this->m_vecMemory[offset+2] = (word >> 16) & 0xFF;
+    this->m_vecMemory[offset+3] = (word >> 24) & 0xFF;
+    this->recordWrite(offset, sizeof(word_t));
+    if (watched) this->reportWatch(offset, sizeof(word_t), true, old);
+    return true;
+}
+
+// Patch a word in memory
+bool Memory::patchWord(addr_t addr, word_t word, word_t& old) {
+
     auto offset = this->addressToOffset(addr, sizeof(word_t));
     if (offset == -1) return false;
 
+    // Snapshots still need to see the change
+    old = this->valueAt(offset, sizeof(word_t));
     this->m_vecMemory[offset+0] = word & 0xFF;
     this->m_vecMemory[offset+1] = (word >> 8) & 0xFF;
     this->m_vecMemory[offset+2] = (word >> 16) & 0xFF;
     this->m_vecMemory[offset+3] = (word >> 24) & 0xFF;
+    if (this->m_bTrackPages) this->markDirty(offset, sizeof(word_t));
     return true;
 }
 
@@ -154,6 +265,233 @@ size_t Memory::getTotalSize() const {
     return this->m_szDataSegment + this->m_szTextSegment;
 }
 
+// Returns the writes to the text segment
+dword_t Memory::getTextWrites() const {
+    return this->m_dwTextWrites;
+}
+
+// Returns the writes anywhere
+dword_t Memory::getWriteGeneration() const {
+    return this->m_dwWriteGeneration;
+}
+
+
+// Grows the data segment
+bool Memory::growData(size_t bytes) {
+
+    // Make sure the new end of memory stays below the MMIO region
+    size_t totalSize = this->getTotalSize() + bytes;
+    if (totalSize > MMIO_START - MEM_USER_START)
+        return false;
+
+    this->m_szDataSegment += bytes;
+    this->m_vecMemory.resize(totalSize, 0);
+    return true;
+}
+
+// Grows the text segment
+bool Memory::growText(size_t bytes) {
+
+    // Make sure the new end of memory stays below the MMIO region
+    size_t totalSize = this->getTotalSize() + bytes;
+    if (totalSize > MMIO_START - MEM_USER_START)
+        return false;
+
+    // The data segment sits right after the text segment, so shift it up
+    this->m_vecMemory.insert(this->m_vecMemory.begin() + this->m_szTextSegment, bytes, 0);
+    this->m_szTextSegment += bytes;
+
+    // Every page past the text segment has moved
+    if (this->m_bTrackPages)
+        this->m_vecDirtyPages.assign(this->m_vecDirtyPages.size(), true);
+    return true;
+}
+
+
+// MARK: -- Journal Methods
+
+// Sets the journal
+void Memory::setJournal(journal_t * journal) {
+    this->m_ptrJournal = journal;
+}
+
+// Replays a journal
+bool Memory::applyJournal(const journal_t& journal) {
+
+    bool success = true;
+    for (const auto& write : journal) {
+
+        // The other copy may have grown its data segment (e.g. through SBRK)
+        auto offset = this->addressToOffset(write.first, sizeof(byte_t));
+        if (offset == -1) {
+            size_t end = static_cast<size_t>(write.first) + 1 - MEM_USER_START;
+            if (write.first < MEM_USER_START || !this->growData(end - this->getTotalSize())) {
+                success = false;
+                continue;
+            }
+            offset = this->addressToOffset(write.first, sizeof(byte_t));
+        }
+
+        this->m_vecMemory[offset] = write.second;
+        this->m_dwWriteGeneration++;
+        if (offset < this->m_szTextSegment) this->m_dwTextWrites++;
+        if (this->m_bTrackPages) this->markDirty(offset, sizeof(byte_t));
+    }
+
+    return success;
+}
+
+// Sets the undo log
+void Memory::setUndoLog(journal_t * log) {
+    this->m_ptrUndoLog = log;
+}
+
+
+// MARK: -- Snapshot Methods
+
+// Takes a snapshot
+void Memory::takeSnapshot(Snapshot& snapshot) {
+
+    size_t numPages = (this->getTotalSize() + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    snapshot.szDataSegment = this->m_szDataSegment;
+    snapshot.szTextSegment = this->m_szTextSegment;
+    snapshot.vecPages.resize(numPages);
+
+    for (size_t page = 0; page < numPages; ++page) {
+
+        // Does the sharing: a page no one wrote since the last snapshot is still the same
+        bool dirty = page >= this->m_vecDirtyPages.size() || this->m_vecDirtyPages[page];
+        if (this->m_bTrackPages && !dirty && page < this->m_vecSnapshotPages.size()) {
+            snapshot.vecPages[page] = this->m_vecSnapshotPages[page];
+            continue;
+        }
+
+        size_t start = page * PAGE_SIZE;
+        size_t size = std::min(PAGE_SIZE, this->getTotalSize() - start);
+        std::shared_ptr<std::vector<byte_t>> copy(new std::vector<byte_t>(PAGE_SIZE, 0));
+        std::memcpy(copy->data(), this->m_vecMemory.data() + start, size);
+        snapshot.vecPages[page] = copy;
+    }
+
+    this->setSnapshotPages(snapshot);
+}
+
+// Restores a snapshot
+void Memory::restoreSnapshot(const Snapshot& snapshot) {
+
+    // Keeps anything grown since (zeroed), so addresses handed out since stay valid
+    this->m_szTextSegment = snapshot.szTextSegment;
+    this->m_szDataSegment = std::max(snapshot.szDataSegment, this->getTotalSize() - std::min(this->getTotalSize(), snapshot.szTextSegment));
+    this->m_vecMemory.resize(this->getTotalSize());
+
+    size_t restored = 0;
+    for (size_t page = 0; page < snapshot.vecPages.size() && restored < this->m_vecMemory.size(); ++page) {
+        size_t size = std::min(PAGE_SIZE, this->m_vecMemory.size() - restored);
+        if (restored < this->m_szTextSegment && std::memcmp(this->m_vecMemory.data() + restored, snapshot.vecPages[page]->data(), size) != 0)
+            this->m_dwTextWrites++;
+        std::memcpy(this->m_vecMemory.data() + restored, snapshot.vecPages[page]->data(), size);
+        restored += size;
+    }
+
+    std::fill(this->m_vecMemory.begin() + restored, this->m_vecMemory.end(), 0);
+    this->m_dwWriteGeneration++;
+    this->setSnapshotPages(snapshot);
+}
+
+// Matches a snapshot
+void Memory::matchSnapshot(const Snapshot& snapshot) {
+    this->setSnapshotPages(snapshot);
+}
+
+
+// MARK: -- Watchpoint Methods
+
+// Adds a watchpoint
+bool Memory::addWatchpoint(addr_t addr, size_t size, WatchKind kind) {
+
+    if (size == 0 || size > this->getTotalSize()) return false;
+
+    auto offset = this->addressToOffset(addr, size);
+    if (offset == -1) return false;
+
+    this->m_vecWatchpoints.push_back({ addr, size, kind });
+
+    // Marks the pages, so only accesses to them are checked
+    size_t last = (offset + size - 1) / PAGE_SIZE;
+    if (last >= this->m_vecWatchedPages.size())
+        this->m_vecWatchedPages.resize(last + 1, false);
+
+    for (size_t page = offset / PAGE_SIZE; page <= last; ++page)
+        this->m_vecWatchedPages[page] = true;
+
+    this->m_bWatching = true;
+    return true;
+}
+
+// Removes a watchpoint
+bool Memory::removeWatchpoint(addr_t addr) {
+
+    auto search = std::find_if(this->m_vecWatchpoints.begin(), this->m_vecWatchpoints.end(), [addr](const Watchpoint& watch) {
+        return watch.wAddress == addr;
+    });
+    if (search == this->m_vecWatchpoints.end()) return false;
+    this->m_vecWatchpoints.erase(search);
+
+    // Marks the pages of the watchpoints that are left again
+    this->m_vecWatchedPages.assign(this->m_vecWatchedPages.size(), false);
+    for (const auto& watch : this->m_vecWatchpoints) {
+        size_t offset = watch.wAddress - MEM_USER_START;
+        for (size_t page = offset / PAGE_SIZE; page <= (offset + watch.szSize - 1) / PAGE_SIZE; ++page)
+            this->m_vecWatchedPages[page] = true;
+    }
+
+    this->m_bWatching = !this->m_vecWatchpoints.empty();
+    return true;
+}
+
+// Sets the watch handler
+void Memory::setWatchHandler(watch_fn_t handler) {
+    this->m_fnWatchHandler = std::move(handler);
+}
+
+
+// MARK: -- Device Methods
+
+// Maps a device
+bool Memory::mapDevice(addr_t addr, size_t size, std::shared_ptr<MemoryDevice> device) {
+
+    if (device == nullptr || size == 0 || addr < MMIO_START || (addr - MMIO_START) % PAGE_SIZE != 0)
+        return false;
+
+    size_t first = (addr - MMIO_START) / PAGE_SIZE;
+    size_t last = (static_cast<size_t>(addr - MMIO_START) + size - 1) / PAGE_SIZE;
+    if (last >= MMIO_PAGES) return false;
+
+    for (size_t page = first; page <= last; ++page) {
+        if (this->m_arrDevices[page].ptrDevice != nullptr) return false;
+    }
+
+    for (size_t page = first; page <= last; ++page)
+        this->m_arrDevices[page] = { device.get(), addr };
+
+    this->m_vecDevices.push_back(std::move(device));
+    return true;
+}
+
+// Returns the device cycles
+dword_t Memory::getDeviceCycles() const {
+    return this->m_dwDeviceCycles;
+}
+
+
+// MARK: -- Observer Methods
+
+// Sets the observer
+void Memory::setObserver(MemoryObserver * observer) {
+    this->m_ptrObserver = observer;
+}
+
 
 // MARK: -- Private Methods
 
@@ -167,4 +505,139 @@ std::vector<uint8_t>::size_type Memory::addressToOffset(addr_t addr, size_t expS
         return -1;
 
     return addr - memoryStart;
-}
\ No newline at end of file
+}
+
+// Records written bytes
+void Memory::recordWrite(std::vector<byte_t>::size_type offset, size_t size) {
+
+    this->m_dwWriteGeneration++;
+    if (offset < this->m_szTextSegment)
+        this->m_dwTextWrites++;
+
+    if (this->m_ptrObserver != nullptr)
+        this->m_ptrObserver->onWrite(static_cast<addr_t>(MEM_USER_START + offset), size);
+
+    if (this->m_bTrackPages)
+        this->markDirty(offset, size);
+
+    if (this->m_ptrJournal == nullptr) return;
+
+    for (size_t i = 0; i < size; ++i)
+        this->m_ptrJournal->emplace_back(static_cast<addr_t>(MEM_USER_START + offset + i), this->m_vecMemory[offset + i]);
+}
+
+// Records old bytes
+void Memory::recordUndo(std::vector<byte_t>::size_type offset, size_t size) {
+
+    for (size_t i = 0; i < size; ++i)
+        this->m_ptrUndoLog->emplace_back(static_cast<addr_t>(MEM_USER_START + offset + i), this->m_vecMemory[offset + i]);
+}
+
+// Marks written pages
+void Memory::markDirty(std::vector<byte_t>::size_type offset, size_t size) {
+
+    size_t last = (offset + size - 1) / PAGE_SIZE;
+    if (last >= this->m_vecDirtyPages.size())
+        this->m_vecDirtyPages.resize(last + 1, true);
+
+    for (size_t page = offset / PAGE_SIZE; page <= last; ++page)
+        this->m_vecDirtyPages[page] = true;
+}
+
+// Remembers the last snapshot
+void Memory::setSnapshotPages(const Snapshot& snapshot) {
+
+    // Pages memory has grown past the snapshot by are not in it, so count as written
+    size_t numPages = (this->getTotalSize() + PAGE_SIZE - 1) / PAGE_SIZE;
+    this->m_vecDirtyPages.assign(numPages, true);
+    for (size_t page = 0; page < numPages && page < snapshot.vecPages.size(); ++page)
+        this->m_vecDirtyPages[page] = (snapshot.szTextSegment != this->m_szTextSegment);
+
+    this->m_vecSnapshotPages = snapshot.vecPages;
+    this->m_bTrackPages = true;
+}
+
+// Checks an access against the watchpoints
+bool Memory::checkWatch(std::vector<byte_t>::size_type offset, size_t size, WatchKind kind) const {
+
+    // Does the page check first: accesses to unwatched pages never look at the watchpoints
+    bool watchedPage = false;
+    size_t last = (offset + size - 1) / PAGE_SIZE;
+    for (size_t page = offset / PAGE_SIZE; page <= last && page < this->m_vecWatchedPages.size(); ++page)
+        watchedPage = watchedPage || this->m_vecWatchedPages[page];
+    if (!watchedPage) return false;
+
+    addr_t addr = static_cast<addr_t>(MEM_USER_START + offset);
+    for (const auto& watch : this->m_vecWatchpoints) {
+        if ((static_cast<int>(watch.kind) & static_cast<int>(kind)) == 0) continue;
+        if (addr < watch.wAddress + watch.szSize && watch.wAddress < addr + size)
+            return true;
+    }
+
+    return false;
+}
+
+// Reports a watched access
+void Memory::reportWatch(std::vector<byte_t>::size_type offset, size_t size, bool write, word_t old) const {
+
+    if (!this->m_fnWatchHandler) return;
+
+    WatchHit hit;
+    hit.wAddress = static_cast<addr_t>(MEM_USER_START + offset);
+    hit.szSize = size;
+    hit.bWrite = write;
+    hit.wOldValue = old;
+    hit.wNewValue = this->valueAt(offset, size);
+    this->m_fnWatchHandler(hit);
+}
+
+// Reads a value
+word_t Memory::valueAt(std::vector<byte_t>::size_type offset, size_t size) const {
+
+    word_t value = 0;
+    for (size_t i = 0; i < size && i < sizeof(word_t); ++i)
+        value |= static_cast<word_t>(this->m_vecMemory[offset + i]) << (8 * i);
+    return value;
+}
+
+// Finds a device
+MemoryDevice * Memory::findDevice(addr_t addr, size_t size, word_t& offset) const {
+
+    // Does the page lookup; the whole range must be on the same device
+    if (addr < MMIO_START || size == 0 || size - 1 > std::numeric_limits<addr_t>::max() - addr)
+        return nullptr;
+
+    const DeviceMapping& first = this->m_arrDevices[(addr - MMIO_START) / PAGE_SIZE];
+    const DeviceMapping& last = this->m_arrDevices[(addr + size - 1 - MMIO_START) / PAGE_SIZE];
+    if (first.ptrDevice == nullptr || last.ptrDevice != first.ptrDevice)
+        return nullptr;
+
+    offset = addr - first.wBase;
+    return first.ptrDevice;
+}
+
+// Reads a device
+bool Memory::readDevice(addr_t addr, byte_t * data, size_t size) const {
+
+    word_t offset = 0;
+    MemoryDevice * device = this->findDevice(addr, size, offset);
+    if (device == nullptr) return false;
+
+    dword_t cycles = 0;
+    if (!device->read(offset, data, size, cycles)) return false;
+    this->m_dwDeviceCycles += cycles;
+    return true;
+}
+
+// Writes a device
+bool Memory::writeDevice(addr_t addr, const byte_t * data, size_t size) {
+
+    word_t offset = 0;
+    MemoryDevice * device = this->findDevice(addr, size, offset);
+    if (device == nullptr) return false;
+
+    dword_t cycles = 0;
+    if (!device->write(offset, data, size, cycles)) return false;
+    this->m_dwDeviceCycles += cycles;
+    return true;
+}
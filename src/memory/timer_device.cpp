@@ -0,0 +1,46 @@
+#include "memory/timer_device.hpp"
+
+// MARK: -- Constants
+constexpr word_t TimerDevice::REG_CYCLES_LO;
+constexpr word_t TimerDevice::REG_CYCLES_HI;
+constexpr size_t TimerDevice::SIZE;
+constexpr dword_t TimerDevice::DEFAULT_LATENCY;
+
+
+// MARK: -- Construction
+
+// Constructor
+TimerDevice::TimerDevice(dword_t latency)
+: m_ptrClock(nullptr)
+, m_dwLatency(latency)
+{ }
+
+
+// MARK: -- Clock Methods
+
+// Sets the clock
+void TimerDevice::setClock(const dword_t * clock) {
+    this->m_ptrClock = clock;
+}
+
+
+// MARK: -- Device Methods
+
+// Reads the cycle count
+bool TimerDevice::read(word_t offset, byte_t * data, size_t size, dword_t& cycles) {
+
+    if (offset >= SIZE || size > SIZE - offset) return false;
+
+    // Does the read little-endian, as memory is
+    dword_t count = (this->m_ptrClock != nullptr) ? *this->m_ptrClock : 0;
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<byte_t>(count >> (8 * (offset + i)));
+
+    cycles = this->m_dwLatency;
+    return true;
+}
+
+// The timer cannot be written
+bool TimerDevice::write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) {
+    return false;
+}
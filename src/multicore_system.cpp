@@ -0,0 +1,394 @@
+#include "multicore_system.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set_factory.hpp"
+#include "utils/barrier.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+MulticoreSystem::MulticoreSystem(std::shared_ptr<Memory> memory, dword_t quantum)
+: m_memory(std::move(memory))
+, m_dwQuantum(quantum)
+, m_bParallel(true)
+, m_dwSinceSync(0)
+, m_ptrHeapBreak(new SyscallHandler::heap_break_t(0))
+, m_dwClockCycles(0)
+, m_dwCycleLimit(0)
+, m_bDetectLivelock(false)
+, m_stop()
+{
+    if (this->m_memory == nullptr)
+        throw std::invalid_argument("Cannot pass a null memory to the multicore system");
+}
+
+// Destructor
+MulticoreSystem::~MulticoreSystem() {
+    if (this->m_ptrBus != nullptr)
+        this->m_memory->setObserver(nullptr);
+}
+
+
+// MARK: -- Core Methods
+
+// Adds a core
+size_t MulticoreSystem::addCore(Memory::addr_t entry, std::unique_ptr<SyscallHandler> syscallHandler) {
+
+    // Every core gets its own system call handler, which knows which core it is,
+    // but they share one heap
+    size_t core = this->m_vecCores.size();
+    if (syscallHandler == nullptr)
+        syscallHandler = std::unique_ptr<SyscallHandler>(new SyscallHandler());
+    syscallHandler->setCoreId(static_cast<word_t>(core));
+    syscallHandler->setHeapBreak(this->m_ptrHeapBreak);
+
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+    this->m_vecRegisterBanks.push_back(registerBank.get());
+
+    // With a quantum, the core works on its own copy of memory, recording its stores
+    std::shared_ptr<Memory> memory = this->m_memory;
+    if (this->m_dwQuantum > 0) {
+
+        memory = std::shared_ptr<Memory>(new Memory(*this->m_memory));
+        std::unique_ptr<Memory::journal_t> journal(new Memory::journal_t());
+        memory->setJournal(journal.get());
+
+        this->m_vecReplicas.push_back(memory);
+        this->m_vecJournals.push_back(std::move(journal));
+    }
+
+    std::unique_ptr<Simulator> simulator(new Simulator(InstructionSetFactory::createDefault(std::move(syscallHandler)), memory, std::move(registerBank)));
+    simulator->setEntryPoint(entry);
+    simulator->setCycleLimit(this->m_dwCycleLimit);
+    simulator->reset();
+    this->m_vecCores.push_back(std::move(simulator));
+    this->m_vecLivelocks.emplace_back();
+
+    if (this->m_ptrBus != nullptr)
+        this->m_ptrBus->addCache();
+    return core;
+}
+
+// Returns the number of cores
+size_t MulticoreSystem::getNumCores() const {
+    return this->m_vecCores.size();
+}
+
+// Returns a core
+Simulator& MulticoreSystem::getCore(size_t core) {
+    return *this->m_vecCores.at(core);
+}
+
+// Returns a core's register bank
+RegisterBank& MulticoreSystem::getRegisterBank(size_t core) {
+    return *this->m_vecRegisterBanks.at(core);
+}
+
+
+// MARK: -- Execution Methods
+
+// Runs every core
+void MulticoreSystem::run() {
+
+    // Start from clean pipelines
+    this->reset();
+
+    // Output
+    spdlog::info("Running Simulator on {} cores...", this->m_vecCores.size());
+    spdlog::set_pattern("%v");
+
+    spdlog::info("");
+    spdlog::info("Output:");
+    spdlog::info("------------");
+
+    if (this->m_dwQuantum > 0 && this->m_bParallel && this->m_vecCores.size() > 1)
+        this->runParallel();
+    else
+        while (this->step()) { }
+
+    spdlog::info("------------");
+    spdlog::info("");
+    spdlog::set_pattern("%+");
+
+    // Now print our stats, for each core and overall
+    dword_t instructions = 0;
+    for (size_t core = 0; core < this->m_vecCores.size(); ++core) {
+        const Simulator::Stats& stats = this->m_vecCores[core]->getStats();
+        spdlog::info("Core {}: {} cycles, {} instructions, {} NOPs", core, stats.dwClockCycles, stats.dwInstructions, stats.dwNops);
+        instructions += stats.dwInstructions;
+
+        if (this->m_ptrBus == nullptr) continue;
+
+        const L1Cache::Stats& cache = this->m_ptrBus->getCache(core).getStats();
+        spdlog::info("    L1D: {} reads, {} writes, {} hits, {} misses ({} coherence: {} true sharing, {} false sharing)",
+            cache.dwReads, cache.dwWrites, cache.dwHits, cache.dwMisses, cache.dwCoherenceMisses, cache.dwTrueSharingMisses, cache.dwFalseSharingMisses);
+        spdlog::info("    L1D: {} invalidations received, {} sent, {} write backs, {} bus transactions, {} stall cycles",
+            cache.dwInvalidationsReceived, cache.dwInvalidationsSent, cache.dwWriteBacks, cache.dwBusTransactions, cache.dwStallCycles);
+    }
+
+    if (this->m_ptrBus != nullptr) {
+        const CoherenceBus::Stats& bus = this->m_ptrBus->getStats();
+        spdlog::info("Bus: {} BusRd, {} BusRdX, {} BusUpgr, {} write backs, {} cache to cache, {} busy cycles, {} wait cycles",
+            bus.dwReads, bus.dwReadExclusives, bus.dwUpgrades, bus.dwWriteBacks, bus.dwCacheToCache, bus.dwBusyCycles, bus.dwWaitCycles);
+    }
+
+    spdlog::info("Total Clock Cycles: {}", this->m_dwClockCycles);
+    spdlog::info("Total Instruction Count: {}", instructions);
+}
+
+// Resets every core
+void MulticoreSystem::reset() {
+
+    for (auto& core : this->m_vecCores)
+        core->reset();
+
+    // Drop anything not yet committed, so every copy starts the same
+    for (size_t core = 0; core < this->m_vecReplicas.size(); ++core) {
+        this->m_vecJournals[core]->clear();
+        *this->m_vecReplicas[core] = *this->m_memory;
+        this->m_vecReplicas[core]->setJournal(this->m_vecJournals[core].get());
+    }
+
+    if (this->m_ptrBus != nullptr)
+        this->m_ptrBus->reset();
+
+    for (auto& livelock : this->m_vecLivelocks)
+        livelock.reset();
+
+    this->m_dwSinceSync = 0;
+    this->m_dwClockCycles = 0;
+    this->m_stop = SimulatorStop();
+}
+
+// Runs a single global cycle
+bool MulticoreSystem::step() {
+
+    if (this->m_stop.reason != StopReason::NONE)
+        return false;
+
+    // Cores are always stepped in the same order, so stores from lower cores are seen
+    // by higher cores in the same cycle
+    bool stepped = false;
+    bool running = false;
+    for (size_t core = 0; core < this->m_vecCores.size(); ++core) {
+        if (!this->m_vecCores[core]->isRunning()) continue;
+
+        // Every access this core makes is charged to its own cache
+        if (this->m_ptrBus != nullptr)
+            this->m_ptrBus->beginCycle(core, this->m_dwClockCycles);
+
+        stepped = true;
+        running |= this->m_vecCores[core]->step();
+    }
+
+    if (stepped)
+        this->m_dwClockCycles++;
+
+    // Commit at each quantum boundary, and once more when the last core exits
+    if (this->m_dwQuantum > 0 && stepped && (++this->m_dwSinceSync == this->m_dwQuantum || !running))
+        this->synchronise();
+
+    // Only look for a livelock once every core sees the same memory
+    if (this->m_bDetectLivelock && running && this->m_dwSinceSync == 0 && this->checkLivelock())
+        return false;
+
+    return running;
+}
+
+// Returns the number of global cycles
+dword_t MulticoreSystem::getClockCycles() const {
+    return this->m_dwClockCycles;
+}
+
+// Sets the cycle limit
+void MulticoreSystem::setCycleLimit(dword_t limit) {
+
+    // Every running core has run the same number of cycles, so each core's own limit stops them all together
+    this->m_dwCycleLimit = limit;
+    for (auto& core : this->m_vecCores)
+        core->setCycleLimit(limit);
+}
+
+// Sets livelock detection
+void MulticoreSystem::setLivelockDetection(bool detect) {
+    this->m_bDetectLivelock = detect;
+}
+
+// Returns the stop
+const SimulatorStop& MulticoreSystem::getStop() const {
+
+    if (this->m_stop.reason == StopReason::NONE) {
+        for (const auto& core : this->m_vecCores) {
+            if (core->getStop().reason == StopReason::CYCLE_LIMIT)
+                return core->getStop();
+        }
+    }
+
+    return this->m_stop;
+}
+
+
+// MARK: -- Quantum Methods
+
+// Returns the quantum
+dword_t MulticoreSystem::getQuantum() const {
+    return this->m_dwQuantum;
+}
+
+// Sets whether runs are parallel
+void MulticoreSystem::setParallel(bool parallel) {
+    this->m_bParallel = parallel;
+}
+
+// Returns whether runs are parallel
+bool MulticoreSystem::isParallel() const {
+    return this->m_bParallel;
+}
+
+// Commits every core's stores
+void MulticoreSystem::synchronise() {
+
+    // Cores are always committed in the same order, so later cores win conflicting stores
+    for (size_t core = 0; core < this->m_vecJournals.size(); ++core) {
+
+        const Memory::journal_t& journal = *this->m_vecJournals[core];
+        if (journal.empty()) continue;
+
+        if (!this->m_memory->applyJournal(journal))
+            spdlog::error("Unable to commit every store of core {} to shared memory", core);
+
+        for (size_t other = 0; other < this->m_vecReplicas.size(); ++other) {
+            if (other != core)
+                this->m_vecReplicas[other]->applyJournal(journal);
+        }
+    }
+
+    for (auto& journal : this->m_vecJournals)
+        journal->clear();
+
+    // Every copy may now hold other cores' stores, so none can be forwarded from a store buffer
+    for (auto& core : this->m_vecCores)
+        core->drainStores();
+
+    this->m_dwSinceSync = 0;
+}
+
+
+// MARK: -- Cache Methods
+
+// Enables caches
+bool MulticoreSystem::enableCaches(const CoherenceBus::Config& config) {
+
+    // Cores running a quantum apart have no single order of accesses to snoop
+    if (this->m_dwQuantum > 0) {
+        spdlog::error("Caches can only be modelled on cores running in lockstep");
+        return false;
+    }
+
+    try {
+        this->m_ptrBus = std::unique_ptr<CoherenceBus>(new CoherenceBus(config));
+    }
+    catch (std::invalid_argument& e) {
+        spdlog::error("Unable to enable caches: {}", e.what());
+        return false;
+    }
+
+    for (size_t core = 0; core < this->m_vecCores.size(); ++core)
+        this->m_ptrBus->addCache();
+
+    this->m_ptrBus->setDataStart(Memory::MEM_USER_START + static_cast<Memory::addr_t>(this->m_memory->getTextSize()));
+    this->m_memory->setObserver(this->m_ptrBus.get());
+    return true;
+}
+
+// Returns the bus
+const CoherenceBus * MulticoreSystem::getBus() const {
+    return this->m_ptrBus.get();
+}
+
+
+// MARK: -- Private Methods
+
+// Runs every core on its own thread
+void MulticoreSystem::runParallel() {
+
+    // Each round, every thread runs its core for a quantum, then the first thread
+    // commits while the others wait, so no thread ever sees another's memory mid-round
+    size_t numCores = this->m_vecCores.size();
+    Barrier barrier(numCores);
+    bool running = true;
+
+    auto worker = [this, &barrier, &running](size_t core) {
+
+        Simulator& simulator = *this->m_vecCores[core];
+        while (true) {
+
+            for (dword_t cycle = 0; cycle < this->m_dwQuantum && simulator.isRunning(); ++cycle)
+                simulator.step();
+
+            barrier.wait();
+            if (core == 0) {
+                this->synchronise();
+                running = std::any_of(this->m_vecCores.begin(), this->m_vecCores.end(),
+                    [](const std::unique_ptr<Simulator>& other) { return other->isRunning(); });
+                if (running && this->m_bDetectLivelock && this->checkLivelock())
+                    running = false;
+            }
+            barrier.wait();
+
+            if (!running) break;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t core = 1; core < numCores; ++core)
+        threads.emplace_back(worker, core);
+
+    worker(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    // The global clock is that of the longest running core, as it is in lockstep
+    this->m_dwClockCycles = 0;
+    for (const auto& core : this->m_vecCores)
+        this->m_dwClockCycles = std::max(this->m_dwClockCycles, core->getStats().dwClockCycles);
+}
+
+// Checks for a livelock
+bool MulticoreSystem::checkLivelock() {
+
+    // Every detector is checked on the same cycle, so they all compare against the same one
+    dword_t cycle = 0;
+    for (const auto& core : this->m_vecCores)
+        cycle = std::max(cycle, core->getStats().dwClockCycles);
+
+    bool repeated = true;
+    size_t first = this->m_vecCores.size();
+    for (size_t core = 0; core < this->m_vecCores.size(); ++core) {
+
+        const Simulator& simulator = *this->m_vecCores[core];
+        if (!simulator.isRunning()) continue;
+        first = std::min(first, core);
+
+        // Stores still buffered count as writes, as they do on a single core
+        dword_t writes = this->m_memory->getWriteGeneration() + simulator.getLoadStoreUnit().getStats().dwStores + this->m_memory->getDeviceCycles();
+        repeated = this->m_vecLivelocks[core].check(cycle, simulator.getPC(), *this->m_vecRegisterBanks[core], writes, simulator.getStats().dwSyscalls)
+                   && repeated;
+    }
+
+    if (first == this->m_vecCores.size() || !repeated)
+        return false;
+
+    this->m_stop.reason = StopReason::LIVELOCK;
+    this->m_stop.wPC = this->m_vecCores[first]->getPC();
+    this->m_stop.dwCycle = cycle;
+    this->m_stop.dwPeriod = this->m_vecLivelocks[first].getPeriod();
+    return true;
+}
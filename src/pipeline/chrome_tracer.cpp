@@ -0,0 +1,80 @@
+#include "pipeline/chrome_tracer.hpp"
+
+#include <iomanip>
+
+// MARK: -- Construction
+
+// Constructor
+ChromeTracer::ChromeTracer(dword_t startCycle, dword_t numCycles)
+: PipelineTracer(startCycle, numCycles)
+, m_bFirstEvent(true)
+{ }
+
+// Destructor
+ChromeTracer::~ChromeTracer() {
+    this->finish();
+}
+
+
+// MARK: -- Protected Event Methods
+
+// Writes the header
+void ChromeTracer::onOpen() {
+
+    this->m_stream << "[";
+
+    // Name and order our rows after the stages
+    for (size_t i = 0; i < NUM_PIPELINE_STAGES; ++i) {
+
+        const char * name = getPipelineStageName(static_cast<PipelineStage>(i));
+        this->beginEvent();
+        this->m_stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"" << name << "\"}}";
+        this->beginEvent();
+        this->m_stream << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"sort_index\":" << i << "}}";
+    }
+}
+
+// Nothing to do per cycle, since every event carries its own time
+void ChromeTracer::onCycle(dword_t cycle) { }
+
+// Nothing to do for new instructions either
+void ChromeTracer::onIntroduce(dword_t cycle, const InFlight& instr) { }
+
+// Writes a slice for a stage
+void ChromeTracer::onStage(dword_t cycle, PipelineStage stage, const InFlight& instr) {
+
+    this->beginEvent();
+    this->m_stream << "{\"name\":\"" << (instr.bBubble ? "nop" : (instr.strName.empty() ? "???" : instr.strName)) << "\""
+                   << ",\"cat\":\"" << (instr.bBubble ? "bubble" : getPipelineStageName(stage)) << "\""
+                   << ",\"ph\":\"X\",\"ts\":" << cycle << ",\"dur\":1,\"pid\":1,\"tid\":" << static_cast<size_t>(stage)
+                   << ",\"args\":{\"seq\":" << instr.dwSequence
+                   << ",\"pc\":\"0x" << std::hex << std::setw(8) << std::setfill('0') << instr.wPC << std::dec << std::setfill(' ') << "\"}}";
+}
+
+// Writes an instant event for a forwarded operand
+void ChromeTracer::onForward(dword_t cycle, const InFlight& instr, sword_t reg, PipelineStage from, dword_t producer) {
+
+    this->beginEvent();
+    this->m_stream << "{\"name\":\"forward $" << reg << " from " << getPipelineStageName(from) << "\""
+                   << ",\"cat\":\"forward\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << cycle
+                   << ",\"pid\":1,\"tid\":" << static_cast<size_t>(PipelineStage::EX)
+                   << ",\"args\":{\"seq\":" << instr.dwSequence << ",\"producer\":" << producer << "}}";
+}
+
+// Nothing to do on retirement, since the slices already end there
+void ChromeTracer::onRetire(dword_t cycle, const InFlight& instr, bool flushed) { }
+
+// Closes the array
+void ChromeTracer::onFinish() {
+    this->m_stream << "\n]\n";
+}
+
+
+// MARK: -- Private Methods
+
+// Starts a new event
+void ChromeTracer::beginEvent() {
+
+    this->m_stream << (this->m_bFirstEvent ? "\n" : ",\n");
+    this->m_bFirstEvent = false;
+}
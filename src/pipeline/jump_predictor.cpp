@@ -0,0 +1,56 @@
+#include "pipeline/jump_predictor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// MARK: -- Construction
+
+// Constructor
+JumpPredictor::JumpPredictor(size_t returnStackEntries, size_t indirectEntries)
+: m_vecReturnStack(returnStackEntries, 0)
+, m_szTop(0)
+, m_szDepth(0)
+, m_vecTargets(indirectEntries, 0)
+{
+    if (returnStackEntries == 0)
+        throw std::invalid_argument("Return-address stack must hold at least one entry");
+    if (indirectEntries == 0 || (indirectEntries & (indirectEntries - 1)) != 0)
+        throw std::invalid_argument("Jump target table size must be a power of two");
+}
+
+
+// MARK: -- Prediction Methods
+
+// Pushes a return address
+void JumpPredictor::pushReturn(Memory::addr_t addr) {
+
+    // A full stack overwrites its oldest entry
+    this->m_vecReturnStack[this->m_szTop] = addr;
+    this->m_szTop = (this->m_szTop + 1) % this->m_vecReturnStack.size();
+    if (this->m_szDepth < this->m_vecReturnStack.size())
+        this->m_szDepth++;
+}
+
+// Predicts a jump target
+Memory::addr_t JumpPredictor::predict(Memory::addr_t pc, bool bReturn) {
+
+    if (bReturn && this->m_szDepth > 0) {
+        this->m_szTop = (this->m_szTop + this->m_vecReturnStack.size() - 1) % this->m_vecReturnStack.size();
+        this->m_szDepth--;
+        return this->m_vecReturnStack[this->m_szTop];
+    }
+
+    return this->m_vecTargets[(pc >> 2) & (this->m_vecTargets.size() - 1)];
+}
+
+// Records a jump target
+void JumpPredictor::update(Memory::addr_t pc, Memory::addr_t target) {
+    this->m_vecTargets[(pc >> 2) & (this->m_vecTargets.size() - 1)] = target;
+}
+
+// Empties the predictor
+void JumpPredictor::reset() {
+    this->m_szTop = 0;
+    this->m_szDepth = 0;
+    std::fill(this->m_vecTargets.begin(), this->m_vecTargets.end(), 0);
+}
@@ -0,0 +1,66 @@
+#include "pipeline/konata_tracer.hpp"
+
+#include <iomanip>
+
+// MARK: -- Construction
+
+// Constructor
+KonataTracer::KonataTracer(dword_t startCycle, dword_t numCycles)
+: PipelineTracer(startCycle, numCycles)
+, m_bStarted(false)
+, m_dwLastCycle(0)
+, m_dwRetired(0)
+{ }
+
+// Destructor
+KonataTracer::~KonataTracer() {
+    this->finish();
+}
+
+
+// MARK: -- Protected Event Methods
+
+// Writes the header
+void KonataTracer::onOpen() {
+    this->m_stream << "Kanata\t0004\n";
+}
+
+// Moves time forward
+void KonataTracer::onCycle(dword_t cycle) {
+
+    // The first cycle is absolute, and every one after it is relative
+    if (!this->m_bStarted)
+        this->m_stream << "C=\t" << cycle << "\n";
+    else if (cycle > this->m_dwLastCycle)
+        this->m_stream << "C\t" << (cycle - this->m_dwLastCycle) << "\n";
+
+    this->m_bStarted = true;
+    this->m_dwLastCycle = cycle;
+}
+
+// Adds and labels an instruction
+void KonataTracer::onIntroduce(dword_t cycle, const InFlight& instr) {
+
+    this->m_stream << "I\t" << instr.dwTraceId << "\t" << instr.dwSequence << "\t0\n";
+    this->m_stream << "L\t" << instr.dwTraceId << "\t0\t"
+                   << std::hex << std::setw(8) << std::setfill('0') << instr.wPC << std::dec << std::setfill(' ')
+                   << " " << (instr.bBubble ? "nop" : (instr.strName.empty() ? "???" : instr.strName)) << "\n";
+}
+
+// Starts a stage (which ends the last one)
+void KonataTracer::onStage(dword_t cycle, PipelineStage stage, const InFlight& instr) {
+    this->m_stream << "S\t" << instr.dwTraceId << "\t0\t" << getPipelineStageName(stage) << "\n";
+}
+
+// Notes a forwarded operand in the hover text
+void KonataTracer::onForward(dword_t cycle, const InFlight& instr, sword_t reg, PipelineStage from, dword_t producer) {
+    this->m_stream << "L\t" << instr.dwTraceId << "\t1\tforward $" << reg << " from " << getPipelineStageName(from) << " (seq " << producer << "); \n";
+}
+
+// Retires (or flushes) an instruction
+void KonataTracer::onRetire(dword_t cycle, const InFlight& instr, bool flushed) {
+    this->m_stream << "R\t" << instr.dwTraceId << "\t" << (flushed ? instr.dwTraceId : this->m_dwRetired++) << "\t" << (flushed ? 1 : 0) << "\n";
+}
+
+// Nothing to close off
+void KonataTracer::onFinish() { }
@@ -0,0 +1,56 @@
+#include "pipeline/livelock_detector.hpp"
+
+#include <algorithm>
+
+// MARK: -- Construction
+
+// Constructor
+LivelockDetector::LivelockDetector()
+: m_bSaved(false)
+, m_dwSavedCycle(0)
+, m_dwNextSave(1)
+, m_wPC(0)
+, m_arrRegisters()
+, m_dwWrites(0)
+, m_dwSyscalls(0)
+, m_dwPeriod(0)
+{ }
+
+
+// MARK: -- Detection Methods
+
+// Checks the state
+bool LivelockDetector::check(dword_t cycle, Memory::addr_t pc, const RegisterBank& registers, dword_t writes, dword_t syscalls) {
+
+    // Compare the cheap parts first, as they differ on nearly every cycle
+    bool repeated = this->m_bSaved && pc == this->m_wPC && writes == this->m_dwWrites && syscalls == this->m_dwSyscalls
+                    && registers.getRegisters() == this->m_arrRegisters;
+    if (repeated)
+        this->m_dwPeriod = cycle - this->m_dwSavedCycle;
+
+    // Saves on every power of two even when the state repeats, so detectors checked on the same cycles
+    // (one per core) always compare against the same cycle
+    if (cycle < this->m_dwNextSave)
+        return repeated;
+
+    this->m_bSaved = true;
+    this->m_dwSavedCycle = cycle;
+    this->m_dwNextSave = std::max<dword_t>(2 * cycle, 1);
+    this->m_wPC = pc;
+    this->m_arrRegisters = registers.getRegisters();
+    this->m_dwWrites = writes;
+    this->m_dwSyscalls = syscalls;
+    return repeated;
+}
+
+// Returns the length of the loop
+dword_t LivelockDetector::getPeriod() const {
+    return this->m_dwPeriod;
+}
+
+// Forgets the saved state
+void LivelockDetector::reset() {
+    this->m_bSaved = false;
+    this->m_dwNextSave = 1;
+    this->m_dwPeriod = 0;
+}
@@ -0,0 +1,129 @@
+#include "pipeline/load_store_unit.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include "instr/opcodes.hpp"
+
+// MARK: -- Constants
+constexpr size_t LoadStoreUnit::BUFFER_SIZE;
+
+
+// MARK: -- Construction
+
+// Constructor
+LoadStoreUnit::LoadStoreUnit()
+: m_arrEntries()
+, m_szHead(0)
+, m_szCount(0)
+{ }
+
+
+// MARK: -- Access Methods
+
+// Returns whether an opcode is a load or a store
+bool LoadStoreUnit::isLoadStore(word_t opcode) {
+    return opcode - static_cast<word_t>(Opcodes::OPCODE_LB) <= static_cast<word_t>(Opcodes::OPCODE_SW) - static_cast<word_t>(Opcodes::OPCODE_LB);
+}
+
+// Returns whether an opcode is a load
+bool LoadStoreUnit::isLoad(word_t opcode) {
+    return opcode - static_cast<word_t>(Opcodes::OPCODE_LB) <= static_cast<word_t>(Opcodes::OPCODE_LHU) - static_cast<word_t>(Opcodes::OPCODE_LB);
+}
+
+// Does the memory stage of a load or store
+word_t LoadStoreUnit::access(const ExecutionBuffer& executionBuffer, InstructionHandler& handler, Memory& memory) {
+
+    size_t size = 0;
+    bool store = describe(executionBuffer.wOpcode, size);
+
+    Memory::addr_t addr = executionBuffer.wOutput;
+    if (addr % size != 0) {
+        spdlog::critical("SIGBUS: Unaligned {}-byte {} at address {}", size, store ? "store" : "load", addr);
+        exit(1);
+    }
+
+    if (store) {
+
+        // Writes through, then buffers the store - unless it went to a device, which drains the buffer
+        this->m_stats.dwStores++;
+        handler.onMemory(executionBuffer, memory);
+        if (addr - Memory::MEM_USER_START >= memory.getTotalSize()) {
+            this->flush();
+            return 0;
+        }
+
+        if (this->m_szCount == BUFFER_SIZE)
+            this->drain();
+
+        this->m_arrEntries[(this->m_szHead + this->m_szCount) % BUFFER_SIZE] = { addr, size };
+        this->m_szCount++;
+        return 0;
+    }
+
+    // Counts a forwarding hit, but still loads through memory (which the store wrote
+    // through to) so watchpoints and observers see every load
+    this->m_stats.dwLoads++;
+    if (this->forward(addr, size))
+        this->m_stats.dwForwards++;
+
+    return handler.onMemory(executionBuffer, memory);
+}
+
+// Retires the oldest store
+void LoadStoreUnit::drain() {
+
+    if (this->m_szCount == 0) return;
+    this->m_szHead = (this->m_szHead + 1) % BUFFER_SIZE;
+    this->m_szCount--;
+}
+
+// Retires every store
+void LoadStoreUnit::flush() {
+    this->m_szHead = 0;
+    this->m_szCount = 0;
+}
+
+// Returns the number of buffered stores
+size_t LoadStoreUnit::getBufferedStores() const {
+    return this->m_szCount;
+}
+
+// Returns the statistics
+const LoadStoreUnit::Stats& LoadStoreUnit::getStats() const {
+    return this->m_stats;
+}
+
+
+// MARK: -- Private Methods
+
+// Describes an access
+bool LoadStoreUnit::describe(word_t opcode, size_t& size) {
+
+    switch (static_cast<Opcodes>(opcode)) {
+        case Opcodes::OPCODE_LB:  size = 1; return false;
+        case Opcodes::OPCODE_LH:  size = 2; return false;
+        case Opcodes::OPCODE_LW:  size = 4; return false;
+        case Opcodes::OPCODE_LBU: size = 1; return false;
+        case Opcodes::OPCODE_LHU: size = 2; return false;
+        case Opcodes::OPCODE_SB:  size = 1; return true;
+        case Opcodes::OPCODE_SH:  size = 2; return true;
+        default:                  size = 4; return true;
+    }
+}
+
+// Looks for a store to forward
+bool LoadStoreUnit::forward(Memory::addr_t addr, size_t size) const {
+
+    // Does the search youngest first, since only the youngest overlapping store holds the latest bytes
+    for (size_t i = this->m_szCount; i > 0; --i) {
+
+        const Entry& entry = this->m_arrEntries[(this->m_szHead + i - 1) % BUFFER_SIZE];
+        if (addr >= entry.wAddress + entry.szSize || entry.wAddress >= addr + size)
+            continue;
+
+        // A store covering only part of the load cannot supply it, so memory must
+        return addr >= entry.wAddress && addr + size <= entry.wAddress + entry.szSize;
+    }
+
+    return false;
+}
@@ -0,0 +1,84 @@
+#include "pipeline/multiply_divide_unit.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "instr/functions.hpp"
+
+// MARK: -- Construction
+
+// Constructor
+MultiplyDivideUnit::MultiplyDivideUnit()
+: MultiplyDivideUnit(Config())
+{ }
+
+// Constructor
+MultiplyDivideUnit::MultiplyDivideUnit(const Config& config)
+: m_config(config)
+, m_dwReady(0)
+, m_dwFree(0)
+{
+    if (config.dwMultiplyLatency == 0 || config.dwDivideLatency == 0)
+        throw std::invalid_argument("Multiply and divide latencies must be at least 1 cycle");
+}
+
+
+// MARK: -- Issue Methods
+
+// Returns whether a funct uses the unit
+bool MultiplyDivideUnit::isMultiplyDivide(word_t funct) {
+
+    switch (static_cast<Functions>(funct)) {
+        case Functions::FUNCT_MFHI:
+        case Functions::FUNCT_MTHI:
+        case Functions::FUNCT_MFLO:
+        case Functions::FUNCT_MTLO:
+        case Functions::FUNCT_MULT:
+        case Functions::FUNCT_MULTU:
+        case Functions::FUNCT_DIV:
+        case Functions::FUNCT_DIVU:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Issues an instruction
+dword_t MultiplyDivideUnit::issue(word_t funct, dword_t cycle) {
+
+    Functions function = static_cast<Functions>(funct);
+    dword_t stall = 0;
+
+    if (function == Functions::FUNCT_MULT || function == Functions::FUNCT_MULTU || function == Functions::FUNCT_DIV || function == Functions::FUNCT_DIVU) {
+
+        // Waits for the unit, then holds it - for one cycle if the multiplier is pipelined
+        bool divide = function == Functions::FUNCT_DIV || function == Functions::FUNCT_DIVU;
+        dword_t start = std::max(cycle, this->m_dwFree);
+        stall = start - cycle;
+
+        this->m_dwReady = start + (divide ? this->m_config.dwDivideLatency : this->m_config.dwMultiplyLatency);
+        this->m_dwFree = (divide || !this->m_config.bPipelinedMultiply) ? this->m_dwReady : start + 1;
+        if (divide)
+            this->m_stats.dwDivides++;
+        else
+            this->m_stats.dwMultiplies++;
+    }
+    else if (this->m_dwReady > cycle) {
+
+        // Moves to or from HI and LO wait for the last result
+        stall = this->m_dwReady - cycle;
+    }
+
+    this->m_stats.dwStalls += stall;
+    return stall;
+}
+
+// Returns the latencies
+const MultiplyDivideUnit::Config& MultiplyDivideUnit::getConfig() const {
+    return this->m_config;
+}
+
+// Returns the statistics
+const MultiplyDivideUnit::Stats& MultiplyDivideUnit::getStats() const {
+    return this->m_stats;
+}
@@ -0,0 +1,195 @@
+#include "pipeline/pipeline_profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+
+// The name used for addresses before the first label
+static const std::string NO_LABEL = "[no label]";
+
+// The name used for cycles spent outside the text segment
+static const std::string OUTSIDE_TEXT = "[outside text]";
+
+
+// MARK: -- Construction
+
+// Constructor
+PipelineProfiler::PipelineProfiler(PipelineStage stage, size_t textSize)
+: m_stage(stage)
+, m_vecCycles(textSize / 4, 0)
+, m_dwOutside(0)
+{ }
+
+
+// MARK: -- Setup Methods
+
+// Sets the symbols
+void PipelineProfiler::setSymbols(const std::unordered_map<std::string, Memory::addr_t>& symbols) {
+
+    this->m_vecSymbols.clear();
+    for (const auto& symbol : symbols) {
+        size_t index = static_cast<size_t>(symbol.second - Memory::MEM_USER_START) >> 2;
+        if (index < this->m_vecCycles.size())
+            this->m_vecSymbols.emplace_back(symbol.second, symbol.first);
+    }
+
+    // Labels sharing an address are ordered by name, so the output is always the same
+    std::sort(this->m_vecSymbols.begin(), this->m_vecSymbols.end());
+}
+
+// Returns the stage
+PipelineStage PipelineProfiler::getStage() const {
+    return this->m_stage;
+}
+
+
+// MARK: -- Result Methods
+
+// Returns the cycles at an address
+dword_t PipelineProfiler::getCycles(Memory::addr_t pc) const {
+
+    size_t index = static_cast<size_t>(pc - Memory::MEM_USER_START) >> 2;
+    return (index < this->m_vecCycles.size()) ? this->m_vecCycles[index] : 0;
+}
+
+// Returns the cycles outside the text segment
+dword_t PipelineProfiler::getOutsideCycles() const {
+    return this->m_dwOutside;
+}
+
+// Returns the total cycles
+dword_t PipelineProfiler::getTotalCycles() const {
+
+    dword_t total = this->m_dwOutside;
+    for (dword_t cycles : this->m_vecCycles)
+        total += cycles;
+
+    return total;
+}
+
+// Returns the label of an address
+std::string PipelineProfiler::getLabel(Memory::addr_t pc) const {
+
+    // Find the first label after the address, and step back one (when several labels
+    // share an address, the last of them wins)
+    auto search = std::upper_bound(this->m_vecSymbols.begin(), this->m_vecSymbols.end(), pc,
+        [](Memory::addr_t addr, const std::pair<Memory::addr_t, std::string>& symbol) { return addr < symbol.first; });
+
+    if (search == this->m_vecSymbols.begin())
+        return "";
+
+    return (search - 1)->second;
+}
+
+// Returns the hottest labels
+std::vector<PipelineProfiler::Entry> PipelineProfiler::getHotLabels(size_t count) const {
+
+    // Walk the text segment in order, moving on to the next label as we pass it
+    std::vector<Entry> entries;
+    Entry current;
+    current.strName = NO_LABEL;
+
+    size_t next = 0;
+    for (size_t index = 0; index < this->m_vecCycles.size(); ++index) {
+
+        Memory::addr_t pc = Memory::MEM_USER_START + static_cast<Memory::addr_t>(index * 4);
+        if (next < this->m_vecSymbols.size() && this->m_vecSymbols[next].first <= pc) {
+
+            if (current.dwCycles > 0)
+                entries.push_back(current);
+
+            while (next < this->m_vecSymbols.size() && this->m_vecSymbols[next].first <= pc)
+                current.strName = this->m_vecSymbols[next++].second;
+            current.dwCycles = 0;
+        }
+
+        current.dwCycles += this->m_vecCycles[index];
+    }
+
+    if (current.dwCycles > 0)
+        entries.push_back(current);
+
+    if (this->m_dwOutside > 0) {
+        Entry outside;
+        outside.strName = OUTSIDE_TEXT;
+        outside.dwCycles = this->m_dwOutside;
+        entries.push_back(outside);
+    }
+
+    sortEntries(entries, count);
+    return entries;
+}
+
+// Returns the hottest addresses
+std::vector<PipelineProfiler::Entry> PipelineProfiler::getHotAddresses(size_t count) const {
+
+    std::vector<Entry> entries;
+    for (size_t index = 0; index < this->m_vecCycles.size(); ++index) {
+        if (this->m_vecCycles[index] == 0) continue;
+
+        Entry entry;
+        entry.strName = formatAddress(Memory::MEM_USER_START + static_cast<Memory::addr_t>(index * 4));
+        entry.dwCycles = this->m_vecCycles[index];
+        entries.push_back(entry);
+    }
+
+    sortEntries(entries, count);
+    return entries;
+}
+
+
+// MARK: -- Output Methods
+
+// Writes the folded stacks
+void PipelineProfiler::writeFolded(std::ostream& out) const {
+
+    for (size_t index = 0; index < this->m_vecCycles.size(); ++index) {
+        if (this->m_vecCycles[index] == 0) continue;
+
+        Memory::addr_t pc = Memory::MEM_USER_START + static_cast<Memory::addr_t>(index * 4);
+        std::string label = this->getLabel(pc);
+        out << (label.empty() ? NO_LABEL : label) << ';' << formatAddress(pc) << ' ' << this->m_vecCycles[index] << '\n';
+    }
+
+    if (this->m_dwOutside > 0)
+        out << OUTSIDE_TEXT << ' ' << this->m_dwOutside << '\n';
+}
+
+// Writes the hot spot tables
+void PipelineProfiler::writeTable(std::ostream& out, size_t count) const {
+
+    dword_t total = std::max<dword_t>(this->getTotalCycles(), 1);
+    auto writeEntries = [&out, total](const std::string& title, const std::vector<Entry>& entries) {
+
+        out << std::left << std::setw(32) << title << std::right << std::setw(12) << "cycles" << std::setw(9) << "%" << '\n';
+        for (const Entry& entry : entries) {
+            out << std::left << std::setw(32) << entry.strName << std::right << std::setw(12) << entry.dwCycles
+                << std::setw(9) << std::fixed << std::setprecision(2) << (100.0 * entry.dwCycles / total) << '\n';
+        }
+    };
+
+    out << "Cycles attributed to " << getPipelineStageName(this->m_stage) << ": " << this->getTotalCycles() << "\n\n";
+    writeEntries("label", this->getHotLabels(count));
+    out << '\n';
+    writeEntries("address", this->getHotAddresses(count));
+}
+
+
+// MARK: -- Private Methods
+
+// Formats an address
+std::string PipelineProfiler::formatAddress(Memory::addr_t pc) {
+
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "0x%08x", pc);
+    return buffer;
+}
+
+// Sorts and trims entries
+void PipelineProfiler::sortEntries(std::vector<Entry>& entries, size_t count) {
+
+    // Ties keep their order in the text segment
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.dwCycles > b.dwCycles; });
+    if (count > 0 && entries.size() > count)
+        entries.resize(count);
+}
@@ -0,0 +1,143 @@
+#include "pipeline/pipeline_tracer.hpp"
+
+#include "spdlog/spdlog.h"
+
+// MARK: -- Constants
+constexpr size_t PipelineTracer::MAX_IN_FLIGHT;
+
+// The size of the stream buffer
+static const size_t TRACE_BUFFER_SIZE = 1 << 20;
+
+
+// MARK: -- Construction
+
+// Constructor
+PipelineTracer::PipelineTracer(dword_t startCycle, dword_t numCycles)
+: m_vecBuffer(TRACE_BUFFER_SIZE)
+, m_dwStartCycle(startCycle)
+, m_dwEndCycle((numCycles == 0) ? 0 : startCycle + numCycles)
+, m_dwCycle(0)
+, m_dwNextTraceId(0)
+, m_bOpen(false)
+{ }
+
+
+// MARK: -- File Methods
+
+// Opens the trace file
+bool PipelineTracer::open(const std::string& filename) {
+
+    this->m_stream.rdbuf()->pubsetbuf(this->m_vecBuffer.data(), this->m_vecBuffer.size());
+    this->m_stream.open(filename, std::ios_base::out | std::ios_base::trunc);
+    if (!this->m_stream.is_open()) {
+        spdlog::error("Unable to open trace file '{}' for writing", filename);
+        return false;
+    }
+
+    this->m_bOpen = true;
+    this->onOpen();
+    return true;
+}
+
+// Finishes the trace
+void PipelineTracer::finish() {
+
+    if (!this->m_bOpen) return;
+
+    // Anything still in flight never made it out of the pipeline
+    for (InFlight& instr : this->m_arrInFlight) {
+        if (instr.bValid && instr.bIntroduced)
+            this->onRetire(this->m_dwCycle, instr, true);
+
+        instr.bValid = false;
+    }
+
+    this->onFinish();
+    this->m_stream.close();
+    this->m_bOpen = false;
+}
+
+
+// MARK: -- Record Methods
+
+// Starts a new cycle
+void PipelineTracer::beginCycle(dword_t cycle) {
+
+    this->m_dwCycle = cycle;
+    if (this->isRecording())
+        this->onCycle(cycle);
+}
+
+// Records a fetched instruction
+void PipelineTracer::recordFetch(dword_t sequence, Memory::addr_t pc, const std::string& name, bool bubble) {
+
+    // Anything left in this slot is long gone (it would have had to spend more
+    // cycles in flight than the pipeline is deep)
+    InFlight& instr = this->m_arrInFlight[sequence % MAX_IN_FLIGHT];
+    if (instr.bValid && instr.bIntroduced && this->m_bOpen)
+        this->onRetire(this->m_dwCycle, instr, true);
+
+    instr.bValid = true;
+    instr.bIntroduced = false;
+    instr.bBubble = bubble;
+    instr.dwSequence = sequence;
+    instr.wPC = pc;
+    instr.strName = name;
+}
+
+// Records an instruction occupying a stage
+void PipelineTracer::recordStage(PipelineStage stage, dword_t sequence) {
+
+    if (!this->isRecording()) return;
+
+    InFlight * instr = this->find(sequence);
+    if (instr != nullptr)
+        this->onStage(this->m_dwCycle, stage, *instr);
+}
+
+// Records a forwarded operand
+void PipelineTracer::recordForward(dword_t sequence, sword_t reg, PipelineStage from, dword_t producer) {
+
+    if (!this->isRecording()) return;
+
+    InFlight * instr = this->find(sequence);
+    if (instr != nullptr)
+        this->onForward(this->m_dwCycle, *instr, reg, from, producer);
+}
+
+// Records an instruction leaving the pipeline
+void PipelineTracer::recordRetire(dword_t sequence) {
+
+    InFlight& instr = this->m_arrInFlight[sequence % MAX_IN_FLIGHT];
+    if (!instr.bValid || instr.dwSequence != sequence) return;
+
+    if (instr.bIntroduced && this->m_bOpen)
+        this->onRetire(this->m_dwCycle, instr, false);
+
+    instr.bValid = false;
+}
+
+// Returns whether or not we are recording
+bool PipelineTracer::isRecording() const {
+    return this->m_bOpen && this->m_dwCycle >= this->m_dwStartCycle && (this->m_dwEndCycle == 0 || this->m_dwCycle < this->m_dwEndCycle);
+}
+
+
+// MARK: -- Private Methods
+
+// Finds an instruction in flight
+PipelineTracer::InFlight * PipelineTracer::find(dword_t sequence) {
+
+    InFlight& instr = this->m_arrInFlight[sequence % MAX_IN_FLIGHT];
+    if (!instr.bValid || instr.dwSequence != sequence)
+        return nullptr;
+
+    // The first time we see an instruction in our window, introduce it
+    if (!instr.bIntroduced) {
+        instr.bIntroduced = true;
+        instr.dwTraceId = this->m_dwNextTraceId++;
+        this->onIntroduce(this->m_dwCycle, instr);
+    }
+
+    return &instr;
+}
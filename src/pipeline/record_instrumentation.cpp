@@ -0,0 +1,85 @@
+#include "pipeline/record_instrumentation.hpp"
+
+#include "instr/functions.hpp"
+#include "instr/instruction_encoder.hpp"
+#include "instr/opcodes.hpp"
+
+// MARK: -- Constants
+constexpr bool RecordInstrumentation::ENABLED;
+
+
+// MARK: -- Record Methods
+
+// Decodes a record
+void RecordInstrumentation::decode(word_t instruction, Memory::addr_t pc, const InstructionSet& instrSet, RetireRecord& record) {
+
+    record = RetireRecord();
+    record.wPC = pc;
+    record.wInstruction = instruction;
+    record.wOpcode = instruction & ((1 << 6) - 1);
+
+    InstructionType type = instrSet.getType(record.wOpcode);
+    if (type == InstructionType::UNKNOWN)
+        return;
+
+    Instruction instr = InstructionEncoder::decode(instruction, type);
+    if (type == InstructionType::R_FORMAT) {
+
+        record.wFunct = instr.getFunct();
+
+        // System calls read their code and arguments, and may write a result
+        if (record.wFunct == static_cast<word_t>(Functions::FUNCT_SYSCALL)) {
+            record.bSyscall = true;
+            record.wRegDest = 2;
+            record.wRegSrc1 = 2;
+            record.wRegSrc2 = 4;
+            return;
+        }
+
+        record.wRegDest = instr.getRd();
+        record.wRegSrc1 = instr.getRs();
+        record.wRegSrc2 = instr.getRt();
+
+        // Jumps through a register read only RS, and JALR links into RD
+        if (record.wFunct == static_cast<word_t>(Functions::FUNCT_JR) || record.wFunct == static_cast<word_t>(Functions::FUNCT_JALR)) {
+            record.bJump = true;
+            record.bIndirect = true;
+            record.bCall = record.wFunct == static_cast<word_t>(Functions::FUNCT_JALR);
+            record.wRegSrc2 = -1;
+            if (!record.bCall)
+                record.wRegDest = -1;
+        }
+    }
+    else if (type == InstructionType::J_FORMAT) {
+
+        // J-Type jumps keep the top 4 bits of the address after them, and JAL links into $ra
+        record.bJump = true;
+        record.bCall = record.wOpcode == static_cast<word_t>(Opcodes::OPCODE_JAL);
+        record.wTarget = ((pc + 4) & 0xF0000000) | (instr.getAddr() << 2);
+        if (record.bCall)
+            record.wRegDest = 31;
+    }
+    else if (type == InstructionType::I_FORMAT) {
+
+        // Does the split between the I-type instructions that read rt and those that write it
+        Opcodes opcode = static_cast<Opcodes>(record.wOpcode);
+        record.wRegSrc1 = instr.getRs();
+        if (opcode == Opcodes::OPCODE_BEQ || opcode == Opcodes::OPCODE_BNE) {
+            record.bBranch = true;
+            record.wRegSrc2 = instr.getRt();
+            record.wTarget = pc + 4 + static_cast<shword_t>(instr.getImmediate());
+        }
+        else if (opcode >= Opcodes::OPCODE_SB && opcode <= Opcodes::OPCODE_SW) {
+            record.bStore = true;
+            record.wRegSrc2 = instr.getRt();
+        }
+        else {
+            record.bLoad = (opcode >= Opcodes::OPCODE_LB && opcode <= Opcodes::OPCODE_LHU);
+            record.wRegDest = instr.getRt();
+        }
+    }
+
+    // Writes to $zero go nowhere, so nothing can depend on them
+    if (record.wRegDest == 0)
+        record.wRegDest = -1;
+}
@@ -0,0 +1,142 @@
+#include "pipeline/static_analyzer.hpp"
+
+#include "instr/functions.hpp"
+#include "instr/instruction_encoder.hpp"
+#include "instr/opcodes.hpp"
+#include "pipeline/load_store_unit.hpp"
+
+// MARK: -- Constants
+constexpr sword_t StaticAnalyzer::ANY_REGISTER;
+
+
+// MARK: -- Construction
+
+// Constructs the analyzer
+StaticAnalyzer::StaticAnalyzer(const InstructionSet& instrSet)
+: m_instrSet(instrSet)
+{ }
+
+
+// MARK: -- Analysis Methods
+
+// Analyzes the text segment
+bool StaticAnalyzer::analyze(const Memory& memory, std::vector<PredecodedInstruction>& stream, Report& report) const {
+
+    report = Report();
+    report.dwInstructions = memory.getTextSize() / 4;
+
+    // Decode everything first, since each instruction is classified against those before it
+    stream.assign(report.dwInstructions, PredecodedInstruction());
+    std::vector<sword_t> writes(stream.size(), -1);
+    for (size_t i = 0; i < stream.size(); ++i) {
+
+        Memory::addr_t addr = Memory::MEM_USER_START + 4 * i;
+        word_t word = 0;
+        memory.readWord(addr, word);
+
+        writes[i] = this->decode(word, stream[i]);
+        if (writes[i] == ANY_REGISTER)
+            report.vecIllegal.push_back(addr);
+    }
+
+    for (size_t i = 0; i < stream.size(); ++i)
+        classify(stream, writes, i, report);
+
+    return report.vecIllegal.empty();
+}
+
+// Returns whether an instruction compares in decode
+bool StaticAnalyzer::comparesInDecode(word_t opcode) {
+    return opcode == static_cast<word_t>(Opcodes::OPCODE_BEQ) || opcode == static_cast<word_t>(Opcodes::OPCODE_BNE);
+}
+
+// Returns whether an instruction jumps in decode
+bool StaticAnalyzer::jumpsInDecode(word_t funct) {
+    return funct == static_cast<word_t>(Functions::FUNCT_JR) || funct == static_cast<word_t>(Functions::FUNCT_JALR);
+}
+
+
+// MARK: -- Private Methods
+
+// Decodes an instruction
+sword_t StaticAnalyzer::decode(word_t word, PredecodedInstruction& entry) const {
+
+    entry.wInstruction = word;
+    entry.wOpcode = word & Instruction::LIMIT_OPCODE;
+
+    InstructionType type = this->m_instrSet.getType(entry.wOpcode);
+    if (type == InstructionType::UNKNOWN)
+        return ANY_REGISTER;
+
+    // Fill in the fields just as the decode stage does
+    Instruction instr = InstructionEncoder::decode(word, type);
+    if (type == InstructionType::I_FORMAT) {
+        entry.wImmediate = instr.getImmediate();
+        entry.wRegDest = instr.getRt();
+        entry.wRegSrc1 = instr.getRs();
+        entry.bReadsInDecode = comparesInDecode(entry.wOpcode);
+        entry.wRegSrc2 = entry.bReadsInDecode ? entry.wRegDest : -1;
+    }
+    else if (type == InstructionType::J_FORMAT)
+        entry.wImmediate = instr.getAddr();
+    else if (type == InstructionType::R_FORMAT) {
+        entry.wFunct = instr.getFunct();
+        entry.wImmediate = instr.getShamt();
+        entry.wRegDest = instr.getRd();
+        entry.wRegSrc1 = instr.getRs();
+        entry.wRegSrc2 = instr.getRt();
+        entry.bReadsInDecode = jumpsInDecode(entry.wFunct);
+    }
+
+    entry.ptrHandler = this->m_instrSet.getInstructionHandler(entry.wOpcode, entry.wFunct);
+    if (entry.ptrHandler == nullptr)
+        return ANY_REGISTER;
+
+    // A J-Type jump has no destination until its handler links the return address
+    return (type == InstructionType::J_FORMAT) ? 31 : entry.wRegDest;
+}
+
+// Classifies an instruction's hazards
+void StaticAnalyzer::classify(std::vector<PredecodedInstruction>& stream, const std::vector<sword_t>& writes, size_t index, Report& report) {
+
+    PredecodedInstruction& entry = stream[index];
+    if (entry.ptrHandler == nullptr)
+        return;
+
+    // Stores read the register they store from as their second source, once their handler has decoded them
+    bool store = LoadStoreUnit::isLoadStore(entry.wOpcode) && !LoadStoreUnit::isLoad(entry.wOpcode);
+    sword_t reads[] = { entry.wRegSrc1, store ? entry.wRegDest : entry.wRegSrc2 };
+    bool found[] = { false, false };
+
+    for (size_t distance = 1; distance <= 2 && distance <= index; ++distance) {
+
+        // The nearest producer of each source wins, just as in forwarding; $0 is never produced
+        sword_t dest = writes[index - distance];
+        bool src1 = !found[0] && reads[0] > 0 && (dest == ANY_REGISTER || dest == reads[0]);
+        bool src2 = !found[1] && reads[1] > 0 && (dest == ANY_REGISTER || dest == reads[1]);
+        if (!src1 && !src2)
+            continue;
+
+        found[0] = found[0] || src1;
+        found[1] = found[1] || src2;
+        if (entry.dwRawDistance == 0)
+            entry.dwRawDistance = distance;
+
+        // Branches wait in decode for ALU results to reach EX/MEM and loads to reach MEM/WB
+        const PredecodedInstruction& producer = stream[index - distance];
+        bool load = producer.ptrHandler != nullptr && LoadStoreUnit::isLoad(producer.wOpcode);
+        if (entry.bReadsInDecode) {
+            dword_t wait = (load ? 3 : 2) - distance;
+            entry.bDecodeHazard = true;
+            if (wait > entry.dwDecodeStall)
+                entry.dwDecodeStall = wait;
+        }
+        else if (load && distance == 1)
+            entry.bLoadUse = true;
+    }
+
+    report.dwRawHazards += (entry.dwRawDistance != 0) ? 1 : 0;
+    report.dwLoadUses += entry.bLoadUse ? 1 : 0;
+    report.dwDecodeHazards += entry.bDecodeHazard ? 1 : 0;
+    report.dwDecodeStalls += entry.dwDecodeStall;
+}
@@ -0,0 +1,228 @@
+#include "pipeline/timing_model.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "instr/opcodes.hpp"
+
+// MARK: -- Presets
+
+// Returns the classic 5-stage pipeline
+TimingModel::Config TimingModel::Config::fiveStage() {
+    return Config();
+}
+
+// Returns an 8-stage pipeline
+TimingModel::Config TimingModel::Config::eightStage() {
+
+    Config config;
+    config.vecStages = { PipelineStage::IF, PipelineStage::IF, PipelineStage::ID, PipelineStage::EX, PipelineStage::EX,
+                         PipelineStage::MEM, PipelineStage::MEM, PipelineStage::WB };
+    return config;
+}
+
+
+// MARK: -- Construction
+
+// Constructor
+TimingModel::TimingModel(const Config& config)
+: m_config(config)
+, m_fnWrongPath(nullptr)
+, m_jumpPredictor(config.szReturnStackEntries, config.szIndirectEntries)
+, m_wPredictedPC(0)
+, m_bPendingBranch(false)
+, m_szDecodeStage(0)
+, m_szExecuteStage(0)
+, m_szAluReadyStage(0)
+, m_szLoadReadyStage(0)
+, m_mdu(config.mdu)
+{
+    size_t entries = config.szPredictorEntries;
+    if (entries == 0 || (entries & (entries - 1)) != 0)
+        throw std::invalid_argument("Branch predictor size must be a power of two");
+
+    // Each stage follows the one before it, or repeats it
+    const std::vector<PipelineStage>& stages = config.vecStages;
+    if (stages.empty() || stages.front() != PipelineStage::IF || stages.back() != PipelineStage::WB)
+        throw std::invalid_argument("Pipeline must run from IF to WB");
+
+    for (size_t i = 1; i < stages.size(); ++i) {
+        if (static_cast<size_t>(stages[i]) - static_cast<size_t>(stages[i - 1]) > 1)
+            throw std::invalid_argument("Pipeline stages must be IF, ID, EX, MEM and WB, in order");
+    }
+
+    // Branches resolve at the end of decode, which is only well defined as a single cycle
+    if (std::count(stages.begin(), stages.end(), PipelineStage::ID) > 1)
+        throw std::invalid_argument("Pipeline decode stage cannot be split");
+
+    // Finds where operands are read and results produced
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (stages[i] == PipelineStage::ID)
+            this->m_szDecodeStage = i;
+        if (stages[i] == PipelineStage::EX && stages[i - 1] != PipelineStage::EX)
+            this->m_szExecuteStage = i;
+        if (stages[i] == PipelineStage::EX)
+            this->m_szAluReadyStage = i;
+        if (stages[i] == PipelineStage::MEM)
+            this->m_szLoadReadyStage = i;
+    }
+
+    this->reset();
+}
+
+
+// MARK: -- Setup Methods
+
+// Sets the wrong-path source
+void TimingModel::setWrongPathSource(wrong_path_fn_t source) {
+    this->m_fnWrongPath = std::move(source);
+}
+
+
+// MARK: -- Timing Methods
+
+// Times an instruction
+void TimingModel::consume(const RetireRecord& record) {
+
+    if (this->m_bPendingBranch)
+        this->resolveBranch(record.wPC);
+
+    // Issues on the next cycle, unless a register read is not ready by the stage that reads it
+    // (branches, jumps and system calls read theirs in decode, everything else in execute)
+    Stats& stats = this->m_stats;
+    size_t useStage = (record.bBranch || record.bIndirect || record.bSyscall) ? this->m_szDecodeStage : this->m_szExecuteStage;
+    bool load1 = false, load2 = false;
+    dword_t issue1 = this->readyToIssue(record.wRegSrc1, useStage, load1);
+    dword_t issue2 = this->readyToIssue(record.wRegSrc2, useStage, load2);
+    dword_t issue = std::max(issue1, issue2);
+
+    if (issue > stats.dwCycles) {
+        bool load = (issue1 >= issue2) ? load1 : load2;
+        (load ? stats.dwLoadUseStalls : stats.dwAluStalls) += issue - stats.dwCycles;
+        stats.dwCycles = issue;
+    }
+
+    // Instructions of the multiply/divide unit may also wait on the unit
+    if (record.wOpcode == static_cast<word_t>(Opcodes::OPCODE_R_TYPE) && MultiplyDivideUnit::isMultiplyDivide(record.wFunct)) {
+        dword_t stall = this->m_mdu.issue(record.wFunct, stats.dwCycles);
+        stats.dwMduStalls += stall;
+        stats.dwCycles += stall;
+    }
+
+    if (record.wRegDest < RegisterBank::NUM_REGISTERS && record.wRegDest != 0) {
+        size_t readyStage = record.bLoad ? this->m_szLoadReadyStage : this->m_szAluReadyStage;
+        this->m_arrReady[record.wRegDest] = stats.dwCycles + readyStage + 1;
+        this->m_arrLoaded[record.wRegDest] = record.bLoad;
+    }
+
+    stats.dwInstructions++;
+    stats.dwCycles++;
+
+    if (record.bBranch) {
+
+        // Every counter of 2 or more predicts taken
+        uint8_t counter = this->m_vecPredictor[(record.wPC >> 2) & (this->m_config.szPredictorEntries - 1)];
+        stats.dwBranches++;
+        this->m_pendingBranch = record;
+        this->m_wPredictedPC = (counter >= 2) ? record.wTarget : record.wPC + 4;
+        this->m_bPendingBranch = true;
+    }
+    else if (record.bJump) {
+
+        // Only jumps through a register can go somewhere fetch did not expect; returns
+        // pop the stack before a JALR pushes its own return address
+        stats.dwJumps++;
+        if (record.bIndirect) {
+            bool isReturn = !record.bCall && record.wRegSrc1 == 31;
+            this->m_pendingBranch = record;
+            this->m_wPredictedPC = this->m_jumpPredictor.predict(record.wPC, isReturn);
+            this->m_bPendingBranch = true;
+        }
+
+        if (record.bCall)
+            this->m_jumpPredictor.pushReturn(record.wPC + 4);
+    }
+}
+
+// Finishes the run
+void TimingModel::finish() {
+
+    // A branch that ends the program has nothing after it to be wrong about
+    this->m_bPendingBranch = false;
+    this->m_stats.dwCycles += this->m_config.vecStages.size() - 1;
+}
+
+// Returns the results
+const TimingModel::Stats& TimingModel::getStats() const {
+    return this->m_stats;
+}
+
+// Resets the model
+void TimingModel::reset() {
+
+    // Every counter starts weakly not taken
+    this->m_vecPredictor.assign(this->m_config.szPredictorEntries, 1);
+    this->m_jumpPredictor.reset();
+    this->m_bPendingBranch = false;
+    this->m_arrReady.fill(0);
+    this->m_arrLoaded.fill(false);
+    this->m_mdu = MultiplyDivideUnit(this->m_config.mdu);
+    this->m_stats = Stats();
+}
+
+// Returns the depth
+size_t TimingModel::getDepth() const {
+    return this->m_config.vecStages.size();
+}
+
+// Returns the misprediction penalty
+dword_t TimingModel::getMispredictPenalty() const {
+    return this->m_szDecodeStage;
+}
+
+
+// MARK: -- Private Methods
+
+// Scores a branch or jump
+void TimingModel::resolveBranch(Memory::addr_t nextPC) {
+
+    this->m_bPendingBranch = false;
+
+    // Trains the counter of a branch, or the target table on a jump
+    const RetireRecord& branch = this->m_pendingBranch;
+    if (branch.bBranch) {
+        uint8_t& counter = this->m_vecPredictor[(branch.wPC >> 2) & (this->m_config.szPredictorEntries - 1)];
+        bool taken = nextPC != branch.wPC + 4;
+        if (taken && counter < 3)   counter++;
+        if (!taken && counter > 0)  counter--;
+    }
+    else
+        this->m_jumpPredictor.update(branch.wPC, nextPC);
+
+    // A branch whose target is the next instruction can never send fetch the wrong way
+    Memory::addr_t predictedPC = this->m_wPredictedPC;
+    if (predictedPC == nextPC)
+        return;
+
+    Stats& stats = this->m_stats;
+    (branch.bBranch ? stats.dwMispredictions : stats.dwJumpMispredictions)++;
+    stats.dwCycles += this->getMispredictPenalty();
+
+    if (this->m_fnWrongPath != nullptr) {
+        this->m_vecWrongPath.clear();
+        this->m_fnWrongPath(predictedPC, this->getMispredictPenalty(), this->m_vecWrongPath);
+        stats.dwWrongPathRecords += this->m_vecWrongPath.size();
+    }
+}
+
+// Returns when a register is ready
+dword_t TimingModel::readyToIssue(word_t reg, size_t useStage, bool& bLoad) const {
+
+    if (reg >= RegisterBank::NUM_REGISTERS)
+        return 0;
+
+    bLoad = this->m_arrLoaded[reg];
+    dword_t ready = this->m_arrReady[reg];
+    return (ready > useStage) ? ready - useStage : 0;
+}
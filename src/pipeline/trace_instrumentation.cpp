@@ -0,0 +1,129 @@
+#include "pipeline/trace_instrumentation.hpp"
+
+#include "spdlog/spdlog.h"
+
+// MARK: -- Constants
+constexpr bool TraceInstrumentation::ENABLED;
+
+
+// MARK: -- Construction
+
+// Constructor
+TraceInstrumentation::TraceInstrumentation()
+: m_bLog(false)
+, m_dwCycle(0)
+, m_dwBubbles(0)
+, m_arrForwards()
+{ }
+
+
+// MARK: -- Setup Methods
+
+// Sets the tracer
+void TraceInstrumentation::setTracer(std::unique_ptr<PipelineTracer> tracer) {
+    this->m_tracer = std::move(tracer);
+}
+
+// Sets the profiler
+void TraceInstrumentation::setProfiler(std::unique_ptr<PipelineProfiler> profiler) {
+    this->m_profiler = std::move(profiler);
+}
+
+// Returns the profiler
+const PipelineProfiler * TraceInstrumentation::getProfiler() const {
+    return this->m_profiler.get();
+}
+
+
+// MARK: -- Counter Methods
+
+// Returns the number of bubbles
+dword_t TraceInstrumentation::getBubbles() const {
+    return this->m_dwBubbles;
+}
+
+// Returns the number of forwarded operands
+dword_t TraceInstrumentation::getForwards(PipelineStage from) const {
+    return this->m_arrForwards[static_cast<size_t>(from)];
+}
+
+
+// MARK: -- Hook Methods
+
+// Starts a cycle
+void TraceInstrumentation::beginCycle(dword_t cycle) {
+
+    // Check the log level once per cycle rather than once per stage
+    this->m_dwCycle = cycle;
+    this->m_bLog = spdlog::should_log(spdlog::level::trace);
+    if (this->m_tracer != nullptr)
+        this->m_tracer->beginCycle(cycle);
+}
+
+// Records a fetched instruction
+void TraceInstrumentation::onFetch(const InstructionFetchBuffer& fetchBuffer, const InstructionSet& instrSet) {
+
+    bool bubble = (fetchBuffer.wInstruction == 0);
+    if (bubble)
+        this->m_dwBubbles++;
+
+    // Only work out the name if someone is going to see it
+    if (this->m_tracer == nullptr && !this->m_bLog)
+        return;
+
+    // R-Type instructions are told apart by their funct
+    word_t opcode = fetchBuffer.wInstruction & ((1 << 6) - 1);
+    word_t funct = 0;
+    if (instrSet.getType(opcode) == InstructionType::R_FORMAT)
+        funct = (fetchBuffer.wInstruction >> 26) & ((1 << 6) - 1);
+
+    std::string name = instrSet.getInstructionName(opcode, funct);
+    if (this->m_bLog)
+        spdlog::trace("[{:>8}] fetch #{} at 0x{:08x}: {} (0x{:08x})", this->m_dwCycle, fetchBuffer.dwSequence, fetchBuffer.wPC, bubble ? "nop" : name, fetchBuffer.wInstruction);
+
+    if (this->m_tracer != nullptr)
+        this->m_tracer->recordFetch(fetchBuffer.dwSequence, fetchBuffer.wPC, name, bubble);
+}
+
+// Records an instruction in a stage
+void TraceInstrumentation::onStage(PipelineStage stage, dword_t sequence, Memory::addr_t pc) {
+
+    if (this->m_profiler != nullptr && stage == this->m_profiler->getStage())
+        this->m_profiler->record(pc);
+
+    if (this->m_bLog)
+        spdlog::trace("[{:>8}] {:<3} #{}", this->m_dwCycle, getPipelineStageName(stage), sequence);
+    if (this->m_tracer != nullptr)
+        this->m_tracer->recordStage(stage, sequence);
+}
+
+// Records a forwarded operand
+void TraceInstrumentation::onForward(dword_t sequence, sword_t reg, PipelineStage from, dword_t producer) {
+
+    // Only real registers are worth counting ($0 never changes)
+    if (reg <= 0) return;
+
+    this->m_arrForwards[static_cast<size_t>(from)]++;
+    if (this->m_bLog)
+        spdlog::trace("[{:>8}] forward ${} from {} (#{}) to #{}", this->m_dwCycle, reg, getPipelineStageName(from), producer, sequence);
+
+    if (this->m_tracer != nullptr)
+        this->m_tracer->recordForward(sequence, reg, from, producer);
+}
+
+// Records an instruction leaving the pipeline
+void TraceInstrumentation::onRetire(dword_t sequence) {
+
+    if (this->m_tracer != nullptr)
+        this->m_tracer->recordRetire(sequence);
+}
+
+// Finishes the run
+void TraceInstrumentation::onFinish() {
+
+    if (this->m_tracer != nullptr)
+        this->m_tracer->finish();
+
+    spdlog::info("Total Bubbles: {}", this->m_dwBubbles);
+    spdlog::info("Total Forwards (EX / MEM): {} / {}", this->getForwards(PipelineStage::EX), this->getForwards(PipelineStage::MEM));
+}
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "spdlog/spdlog.h"
@@ -18,10 +19,21 @@
 
 #include "types.hpp"
 
+// MARK: -- Construction
+
+// Constructor
+FileReader::FileReader()
+: m_bPeephole(false)
+{ }
+
+
 // MARK: -- Reader Methods
 
 // Read a file into memory
-bool FileReader::readFile(const std::string& filename, const InstructionSet& instrSet, Memory& memory) const {
+bool FileReader::readFile(const std::string& filename, const InstructionSet& instrSet, Memory& memory) {
+
+    // Forget anything from the last file
+    this->m_mapSymbols.clear();
 
     // First, try to open our files
     std::ifstream fileStream;
@@ -31,8 +43,16 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
         return false;
     }
 
-    // Now, create a map of our symbols
+    // Now, create a map of our symbols. Text symbols are kept as instruction indices until
+    // the text has been scheduled, and data symbols as offsets into the data segment until
+    // we know how large the text segment is
     std::unordered_map<std::string, Memory::addr_t> symbols;
+    std::unordered_map<std::string, size_t> textSymbols;
+    std::unordered_map<std::string, size_t> dataSymbols;
+
+    // Data is collected into an image and copied into memory in one go once
+    // the segments have been sized
+    std::vector<byte_t> dataImage;
 
     // Also, create a map of our instructions
     std::vector<Instruction> instructions;
@@ -44,10 +64,6 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
     // Get our current section
     std::string section = "none";
 
-    // Set our current addresses
-    Memory::addr_t currText = Memory::MEM_USER_START;
-    Memory::addr_t currData = Memory::MEM_USER_START + memory.getTextSize();
-
     // Now parse each line
     std::string line;
     while (std::getline(fileStream, line)) {
@@ -81,16 +97,19 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
 
             // We have a label — get the current address
             std::string name = first.substr(0, first.length()-1);
-            Memory::addr_t addr = (section == "text") ? currText : currData;
 
             // Make sure this is not a duplicate symbol
-            if (symbols.find(name) != symbols.end()) {
+            if (textSymbols.find(name) != textSymbols.end() || dataSymbols.find(name) != dataSymbols.end()) {
                 spdlog::critical("Attempting to register a duplicate symbol '{}'", name);
                 return false;
             }
 
-            symbols[name] = addr;
-            if (section == "text") continue;
+            if (section == "text") {
+                textSymbols[name] = instructions.size();
+                continue;
+            }
+
+            dataSymbols[name] = dataImage.size();
         }
 
         // Now that we are here, handle things a bit differently
@@ -107,9 +126,6 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
             try {
                 std::vector<Instruction> instrs = parser->parse(line);
                 instructions.insert(instructions.end(), instrs.begin(), instrs.end());
-
-                // Add 4*size to the curr text
-                currText += 4 * instrs.size();
             }
             catch (const SyntaxError& syntaxError) {
                 spdlog::critical(syntaxError.what());
@@ -132,12 +148,10 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
                     return false;
                 }
 
-                // Now get the string and write it to memory
+                // Now get the string and add it (with its null terminator) to the data
                 str = str.substr(1, str.length()-2);
-                memory.writeString(currData, str);
-                
-                // Update with the length of the string + 1 for the null terminator
-                currData += str.length() + 1;
+                dataImage.insert(dataImage.end(), str.begin(), str.end());
+                dataImage.push_back('\0');
             }
             else if (type == ".byte") {
 
@@ -154,8 +168,7 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
                     }
 
                     // Otherwise, write the byte
-                    memory.writeByte(currData, static_cast<byte_t>(num));
-                    currData += 1;
+                    dataImage.push_back(static_cast<byte_t>(num));
                 }
                 catch (std::exception& e) {
                     spdlog::critical("Unable to convert byte data to number.");
@@ -172,11 +185,8 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
                     // Convert to the number
                     word_t num = StringUtils::toNumber(str);
 
-                    // Otherwise, write the bytes
-                    for (int i = 0; i < num; ++i) {
-                        memory.writeByte(currData, 0);
-                        currData += 1;
-                    }
+                    // Otherwise, reserve the (zeroed) bytes
+                    dataImage.resize(dataImage.size() + num, 0);
                 }
                 catch (std::exception& e) {
                     spdlog::critical("Unable to convert space data to number.");
@@ -193,9 +203,11 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
                     // Convert to the number
                     word_t num = StringUtils::toNumber(str);
 
-                    // Otherwise, write the word
-                    memory.writeWord(currData, num);
-                    currData += 4;
+                    // Otherwise, write the word (little endian, like memory)
+                    dataImage.push_back(num & 0xFF);
+                    dataImage.push_back((num >> 8) & 0xFF);
+                    dataImage.push_back((num >> 16) & 0xFF);
+                    dataImage.push_back((num >> 24) & 0xFF);
                 }
                 catch (std::exception& e) {
                     spdlog::critical("Unable to convert word data to number.");
@@ -209,8 +221,51 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
         }
     }
 
+    // Tidy up the pseudo-instruction expansions, if asked
+    PeepholeOptimizer optimizer;
+    this->m_peepholeStats = PeepholeOptimizer::Stats();
+    if (this->m_bPeephole)
+        optimizer.optimize(instructions, textSymbols, this->m_peepholeStats);
+
+    // Grow the segments if the program does not fit in them
+    size_t textSize = 4 * instructions.size();
+    if (textSize > memory.getTextSize() && !memory.growText(textSize - memory.getTextSize())) {
+        spdlog::critical("Unable to fit {} bytes of text into memory", textSize);
+        return false;
+    }
+
+    if (dataImage.size() > memory.getDataSize() && !memory.growData(dataImage.size() - memory.getDataSize())) {
+        spdlog::critical("Unable to fit {} bytes of data into memory", dataImage.size());
+        return false;
+    }
+
+    // Now that the text segment is sized, we can place the data and its symbols
+    Memory::addr_t dataStart = Memory::MEM_USER_START + memory.getTextSize();
+    if (!memory.writeBlock(dataStart, dataImage.data(), dataImage.size())) {
+        spdlog::critical("Unable to write the data segment to memory");
+        return false;
+    }
+
+    for (const auto& symbol : dataSymbols)
+        symbols[symbol.first] = dataStart + symbol.second;
+
+    for (const auto& symbol : textSymbols)
+        symbols[symbol.first] = Memory::MEM_USER_START + 4 * symbol.second;
+
+    // The text can only shrink from here, which moves its symbols down but leaves the data where it is
+    if (this->m_bPeephole)
+        optimizer.optimizeAddresses(instructions, textSymbols, symbols, this->m_peepholeStats);
+
+    // Reorder the text for the pipeline, if asked, then put its symbols where they ended up
+    this->m_scheduleStats = InstructionScheduler::Stats();
+    if (this->m_ptrScheduler != nullptr)
+        this->m_scheduleStats = this->m_ptrScheduler->schedule(instructions, textSymbols);
+
+    for (const auto& symbol : textSymbols)
+        symbols[symbol.first] = Memory::MEM_USER_START + 4 * symbol.second;
+
     // Once we are here, we can write to memory
-    currText = Memory::MEM_USER_START;
+    Memory::addr_t currText = Memory::MEM_USER_START;
     for (Instruction& instr : instructions) {
 
         // If we have a label set, then we need to get an address
@@ -242,13 +297,26 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
                 }
                 else {
 
-                    // Get the signed difference 
-                    shword_t diff = static_cast<shword_t>(addr - (currText + 4));
+                    // Get the signed difference, which has to fit in the immediate
+                    sdword_t diff = static_cast<sdword_t>(addr) - static_cast<sdword_t>(currText + 4);
+                    sdword_t limit = (Instruction::LIMIT_IMM + 1) / 2;
+                    if (diff >= limit || diff < -limit) {
+                        spdlog::critical("Branch to symbol '{}' is out of range ({} bytes)", instr.getLabel(), diff);
+                        return false;
+                    }
+
                     instr.setImmediate(static_cast<hword_t>(diff));
                 }
             }
             else if (instr.getType() == InstructionType::J_FORMAT) {
-                // TODO: Handle this
+
+                // Jumps hold a word address, and can only reach the 256 MB region they are in
+                if (addr % 4 != 0 || (addr & 0xF0000000) != ((currText + 4) & 0xF0000000)) {
+                    spdlog::critical("Jump to symbol '{}' is out of range", instr.getLabel());
+                    return false;
+                }
+
+                instr.setAddr((addr >> 2) & Instruction::LIMIT_ADDR);
             }
         }
 
@@ -260,5 +328,38 @@ bool FileReader::readFile(const std::string& filename, const InstructionSet& ins
         currText += 4;
     }
 
+    // Keep our symbols around for anyone who wants them
+    this->m_mapSymbols = std::move(symbols);
     return true;
+}
+
+
+// MARK: -- Optimization Methods
+
+// Sets whether to run the peephole optimizer
+void FileReader::setPeephole(bool peephole) {
+    this->m_bPeephole = peephole;
+}
+
+// Returns what the peephole optimizer did
+const PeepholeOptimizer::Stats& FileReader::getPeepholeStats() const {
+    return this->m_peepholeStats;
+}
+
+// Sets the scheduler
+void FileReader::setScheduler(std::unique_ptr<InstructionScheduler> scheduler) {
+    this->m_ptrScheduler = std::move(scheduler);
+}
+
+// Returns what the scheduler did
+const InstructionScheduler::Stats& FileReader::getScheduleStats() const {
+    return this->m_scheduleStats;
+}
+
+
+// MARK: -- Symbol Methods
+
+// Returns the symbols
+const std::unordered_map<std::string, Memory::addr_t>& FileReader::getSymbols() const {
+    return this->m_mapSymbols;
 }
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include "reader/instruction_scheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "instr/functions.hpp"
+#include "instr/instruction_encoder.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/opcodes.hpp"
+#include "pipeline/timing_model.hpp"
+
+// MARK: -- Constants
+constexpr word_t InstructionScheduler::REG_HILO;
+
+
+// MARK: -- Construction
+
+// Constructor
+InstructionScheduler::InstructionScheduler()
+: InstructionScheduler(TimingModel::Config::fiveStage().vecStages)
+{ }
+
+// Constructor
+InstructionScheduler::InstructionScheduler(const std::vector<PipelineStage>& stages)
+: m_szDecodeStage(0)
+, m_szExecuteStage(0)
+, m_szAluReadyStage(0)
+, m_szLoadReadyStage(0)
+{
+    // Each stage follows the one before it, or repeats it
+    if (stages.empty() || stages.front() != PipelineStage::IF || stages.back() != PipelineStage::WB)
+        throw std::invalid_argument("Pipeline must run from IF to WB");
+
+    for (size_t i = 1; i < stages.size(); ++i) {
+        if (static_cast<size_t>(stages[i]) - static_cast<size_t>(stages[i - 1]) > 1)
+            throw std::invalid_argument("Pipeline stages must be IF, ID, EX, MEM and WB, in order");
+    }
+
+    // Decode takes a single cycle, as in the timing model
+    if (std::count(stages.begin(), stages.end(), PipelineStage::ID) > 1)
+        throw std::invalid_argument("Pipeline decode stage cannot be split");
+
+    // Finds where operands are read and results produced, as the timing model does
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (stages[i] == PipelineStage::ID)
+            this->m_szDecodeStage = i;
+        if (stages[i] == PipelineStage::EX && stages[i - 1] != PipelineStage::EX)
+            this->m_szExecuteStage = i;
+        if (stages[i] == PipelineStage::EX)
+            this->m_szAluReadyStage = i;
+        if (stages[i] == PipelineStage::MEM)
+            this->m_szLoadReadyStage = i;
+    }
+}
+
+
+// MARK: -- Schedule Methods
+
+// Schedules every basic block
+InstructionScheduler::Stats InstructionScheduler::schedule(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels) const {
+
+    Stats stats;
+
+    // Every label starts a block
+    std::vector<bool> leaders(instructions.size() + 1, false);
+    for (const auto& label : labels)
+        leaders[label.second] = true;
+
+    // Where each old index now starts, for the labels
+    std::vector<size_t> moved(instructions.size() + 1, 0);
+
+    std::vector<Instruction> scheduled;
+    scheduled.reserve(instructions.size());
+
+    size_t start = 0;
+    while (start < instructions.size()) {
+
+        // Finds the end of the block, and describes its instructions without their NOPs
+        size_t end = start;
+        std::vector<Node> nodes, withNops;
+        std::vector<size_t> indices;
+        do {
+            Node node = describe(instructions[end]);
+            withNops.push_back(node);
+
+            if (instructions[end].getLabel().empty() && InstructionEncoder::encode(instructions[end]) == 0)
+                stats.dwNopsRemoved++;
+            else {
+                nodes.push_back(node);
+                indices.push_back(end);
+            }
+            end++;
+        } while (end < instructions.size() && !leaders[end] && !withNops.back().bEndsBlock);
+
+        // Keeps the old order unless the new one is faster
+        std::vector<size_t> original(nodes.size()), allOriginal(withNops.size());
+        for (size_t i = 0; i < original.size(); ++i) original[i] = i;
+        for (size_t i = 0; i < allOriginal.size(); ++i) allOriginal[i] = i;
+
+        std::vector<size_t> best = this->order(nodes);
+        dword_t cycles = this->time(nodes, best);
+        if (cycles >= this->time(nodes, original)) {
+            best = original;
+            cycles = this->time(nodes, original);
+        }
+        else
+            stats.dwBlocksReordered++;
+
+        stats.dwBlocks++;
+        stats.dwCyclesBefore += this->time(withNops, allOriginal);
+        stats.dwCyclesAfter += cycles;
+
+        for (size_t i = start; i < end; ++i)
+            moved[i] = scheduled.size();
+        for (size_t i : best)
+            scheduled.push_back(instructions[indices[i]]);
+        start = end;
+    }
+
+    // A label at the very end stays at the very end
+    moved[instructions.size()] = scheduled.size();
+    for (auto& label : labels)
+        label.second = moved[label.second];
+
+    instructions = std::move(scheduled);
+    return stats;
+}
+
+
+// MARK: -- Private Methods
+
+// Describes an instruction
+InstructionScheduler::Node InstructionScheduler::describe(const Instruction& instr) {
+
+    Node node = { { static_cast<word_t>(-1), static_cast<word_t>(-1) }, static_cast<word_t>(-1), false, false, false, false };
+    word_t opcode = instr.getOpcode();
+
+    if (instr.getType() == InstructionType::R_FORMAT) {
+
+        Functions funct = static_cast<Functions>(instr.getFunct());
+        node.arrReads = { instr.getRs(), instr.getRt() };
+        node.wWrite = instr.getRd();
+
+        switch (funct) {
+
+            // System calls read their code and arguments, and may read and write anything
+            case Functions::FUNCT_SYSCALL:
+                node.arrReads = { 2, 4 };
+                node.wWrite = 2;
+                node.bMemory = true;
+                node.bReadsInDecode = true;
+                node.bEndsBlock = true;
+                break;
+
+            // Jumps through a register read only RS, and JALR links into RD
+            case Functions::FUNCT_JR:
+            case Functions::FUNCT_JALR:
+                node.arrReads = { instr.getRs(), static_cast<word_t>(-1) };
+                node.wWrite = (funct == Functions::FUNCT_JALR) ? instr.getRd() : static_cast<word_t>(-1);
+                node.bReadsInDecode = true;
+                node.bEndsBlock = true;
+                break;
+
+            case Functions::FUNCT_MFHI:
+            case Functions::FUNCT_MFLO:
+                node.arrReads = { REG_HILO, static_cast<word_t>(-1) };
+                break;
+
+            case Functions::FUNCT_MTHI:
+            case Functions::FUNCT_MTLO:
+                node.arrReads = { instr.getRs(), static_cast<word_t>(-1) };
+                node.wWrite = REG_HILO;
+                break;
+
+            case Functions::FUNCT_MULT:
+            case Functions::FUNCT_MULTU:
+            case Functions::FUNCT_DIV:
+            case Functions::FUNCT_DIVU:
+                node.wWrite = REG_HILO;
+                break;
+
+            default:
+                break;
+        }
+    }
+    else if (instr.getType() == InstructionType::J_FORMAT) {
+
+        // JAL links into $ra
+        if (opcode == static_cast<word_t>(Opcodes::OPCODE_JAL))
+            node.wWrite = 31;
+        node.bEndsBlock = true;
+    }
+    else if (instr.getType() == InstructionType::I_FORMAT) {
+
+        // Does the split between the I-type instructions that read rt and those that write it
+        node.arrReads[0] = instr.getRs();
+        if (opcode <= static_cast<word_t>(Opcodes::OPCODE_BGTZ)) {
+            node.arrReads[1] = instr.getRt();
+            node.bReadsInDecode = true;
+            node.bEndsBlock = true;
+        }
+        else if (opcode >= static_cast<word_t>(Opcodes::OPCODE_SB) && opcode <= static_cast<word_t>(Opcodes::OPCODE_SW)) {
+            node.arrReads[1] = instr.getRt();
+            node.bMemory = true;
+        }
+        else {
+            node.bLoad = (opcode >= static_cast<word_t>(Opcodes::OPCODE_LB) && opcode <= static_cast<word_t>(Opcodes::OPCODE_LHU));
+            node.bMemory = node.bLoad;
+            node.wWrite = instr.getRt();
+        }
+    }
+    else
+        node.bEndsBlock = true;
+
+    // $zero never changes, so nothing can depend on it
+    for (word_t& reg : node.arrReads) {
+        if (reg == 0) reg = -1;
+    }
+    if (node.wWrite == 0)
+        node.wWrite = -1;
+
+    return node;
+}
+
+// Returns whether one instruction must stay ahead of another
+bool InstructionScheduler::dependsOn(const Node& first, const Node& second) {
+
+    if (second.bEndsBlock || (first.bMemory && second.bMemory))
+        return true;
+
+    for (word_t reg : second.arrReads) {
+        if (reg != static_cast<word_t>(-1) && reg == first.wWrite)
+            return true;
+    }
+
+    if (second.wWrite == static_cast<word_t>(-1))
+        return false;
+
+    return second.wWrite == first.wWrite || second.wWrite == first.arrReads[0] || second.wWrite == first.arrReads[1];
+}
+
+// Returns the issue cycle of an instruction
+dword_t InstructionScheduler::issue(const Node& node, dword_t cycle, std::array<dword_t, REG_HILO + 1>& ready) const {
+
+    size_t useStage = node.bReadsInDecode ? this->m_szDecodeStage : this->m_szExecuteStage;
+    for (word_t reg : node.arrReads) {
+        if (reg <= REG_HILO && ready[reg] > useStage)
+            cycle = std::max(cycle, ready[reg] - useStage);
+    }
+
+    if (node.wWrite <= REG_HILO)
+        ready[node.wWrite] = cycle + (node.bLoad ? this->m_szLoadReadyStage : this->m_szAluReadyStage) + 1;
+
+    return cycle;
+}
+
+// Returns how many cycles a block takes
+dword_t InstructionScheduler::time(const std::vector<Node>& nodes, const std::vector<size_t>& order) const {
+
+    std::array<dword_t, REG_HILO + 1> ready;
+    ready.fill(0);
+
+    dword_t cycle = 0;
+    for (size_t i : order)
+        cycle = this->issue(nodes[i], cycle, ready) + 1;
+    return cycle;
+}
+
+// List schedules a block
+std::vector<size_t> InstructionScheduler::order(const std::vector<Node>& nodes) const {
+
+    // Builds the dependency graph, with the longest path from each instruction to the end of the block
+    size_t count = nodes.size();
+    std::vector<std::vector<size_t>> successors(count);
+    std::vector<size_t> waiting(count, 0);
+    std::vector<dword_t> heights(count, 0);
+
+    for (size_t j = 0; j < count; ++j) {
+        for (size_t i = 0; i < j; ++i) {
+            if (dependsOn(nodes[i], nodes[j])) {
+                successors[i].push_back(j);
+                waiting[j]++;
+            }
+        }
+    }
+
+    for (size_t i = count; i > 0; --i) {
+        const Node& node = nodes[i - 1];
+        size_t readyStage = node.bLoad ? this->m_szLoadReadyStage : this->m_szAluReadyStage;
+        for (size_t j : successors[i - 1]) {
+
+            // A result is needed a few cycles after it is made, anything else only has to come later
+            size_t useStage = nodes[j].bReadsInDecode ? this->m_szDecodeStage : this->m_szExecuteStage;
+            dword_t distance = 1;
+            for (word_t reg : nodes[j].arrReads) {
+                if (reg != static_cast<word_t>(-1) && reg == node.wWrite && readyStage + 1 > useStage)
+                    distance = std::max<dword_t>(distance, readyStage + 1 - useStage);
+            }
+            heights[i - 1] = std::max(heights[i - 1], distance + heights[j]);
+        }
+    }
+
+    // Issues whichever ready instruction stalls least, then whichever has furthest to go
+    std::array<dword_t, REG_HILO + 1> ready;
+    ready.fill(0);
+
+    std::vector<size_t> order;
+    std::vector<bool> done(count, false);
+    dword_t cycle = 0;
+    while (order.size() < count) {
+
+        size_t best = count;
+        dword_t bestIssue = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (done[i] || waiting[i] > 0)
+                continue;
+
+            std::array<dword_t, REG_HILO + 1> scratch = ready;
+            dword_t at = this->issue(nodes[i], cycle, scratch);
+            if (best == count || at < bestIssue || (at == bestIssue && heights[i] > heights[best])) {
+                best = i;
+                bestIssue = at;
+            }
+        }
+
+        cycle = this->issue(nodes[best], cycle, ready) + 1;
+        done[best] = true;
+        order.push_back(best);
+        for (size_t j : successors[best])
+            waiting[j]--;
+    }
+
+    return order;
+}
@@ -0,0 +1,138 @@
+#include "reader/peephole_optimizer.hpp"
+
+#include <utility>
+
+#include "instr/instruction_encoder.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/opcodes.hpp"
+
+// MARK: -- Optimize Methods
+
+// Does the rewrites that only need the instructions
+void PeepholeOptimizer::optimize(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels, Stats& stats) const {
+
+    stats.dwInstructionsBefore = instructions.size();
+
+    // Nothing is folded into the instruction before a label, since a branch may land on it
+    std::vector<bool> leaders(instructions.size() + 1, false);
+    for (const auto& label : labels)
+        leaders[label.second] = true;
+
+    std::vector<bool> removed(instructions.size(), false);
+    bool lastNop = false;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        Instruction& instr = instructions[i];
+        word_t opcode = instr.getOpcode();
+
+        // Only the first NOP of a run is kept
+        bool nop = instr.getLabel().empty() && InstructionEncoder::encode(instr) == 0;
+        if (nop && lastNop && !leaders[i]) {
+            removed[i] = true;
+            stats.dwNopsRemoved++;
+            continue;
+        }
+        lastNop = nop;
+
+        // subi $r, $r, 0 expands to an addi that changes nothing
+        if (instr.getType() == InstructionType::I_FORMAT && opcode == static_cast<word_t>(Opcodes::OPCODE_ADDI)
+            && instr.getImmediate() == 0 && instr.getRs() == instr.getRt()) {
+            removed[i] = true;
+            stats.dwMovesRemoved++;
+            continue;
+        }
+
+        // li of a constant that one instruction can load
+        if (i + 1 == instructions.size() || leaders[i + 1] || !instr.getLabel().empty() || !instructions[i + 1].getLabel().empty()
+            || !isUpperLower(instr, instructions[i + 1]))
+            continue;
+
+        Instruction& lower = instructions[i + 1];
+        word_t upper = instr.getImmediate();
+        if (upper == 0) {
+            lower.setRs(0);
+            removed[i] = true;
+        }
+        else if (upper == 0xFFFF && (lower.getImmediate() & 0x8000) != 0) {
+
+            // addi sign extends its immediate, which fills the upper half with ones
+            lower.setOpcode(static_cast<word_t>(Opcodes::OPCODE_ADDI));
+            lower.setRs(0);
+            removed[i] = true;
+        }
+        else if (lower.getImmediate() == 0)
+            removed[i + 1] = true;
+        else
+            continue;
+
+        stats.dwConstantsFolded++;
+        lastNop = false;
+        i++;
+    }
+
+    remove(instructions, labels, removed);
+    stats.dwInstructionsAfter = instructions.size();
+}
+
+// Does the rewrites that need every symbol's address
+void PeepholeOptimizer::optimizeAddresses(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels,
+                                          const std::unordered_map<std::string, Memory::addr_t>& symbols, Stats& stats) const {
+
+    std::vector<bool> leaders(instructions.size() + 1, false);
+    for (const auto& label : labels)
+        leaders[label.second] = true;
+
+    // la of an address below 64 KiB only needs its ori
+    std::vector<bool> removed(instructions.size(), false);
+    for (size_t i = 0; i + 1 < instructions.size(); ++i) {
+
+        Instruction& upper = instructions[i];
+        Instruction& lower = instructions[i + 1];
+        if (leaders[i + 1] || upper.getLabel().empty() || upper.getLabel() != lower.getLabel() || !isUpperLower(upper, lower))
+            continue;
+
+        auto search = symbols.find(upper.getLabel());
+        if (search == symbols.end() || (search->second >> 16) != 0)
+            continue;
+
+        lower.setRs(0);
+        removed[i] = true;
+        stats.dwAddressesFolded++;
+        i++;
+    }
+
+    remove(instructions, labels, removed);
+    stats.dwInstructionsAfter = instructions.size();
+}
+
+
+// MARK: -- Private Methods
+
+// Returns whether two instructions are lui $r then ori $r, $r
+bool PeepholeOptimizer::isUpperLower(const Instruction& upper, const Instruction& lower) {
+
+    return upper.getType() == InstructionType::I_FORMAT && upper.getOpcode() == static_cast<word_t>(Opcodes::OPCODE_LUI)
+        && lower.getType() == InstructionType::I_FORMAT && lower.getOpcode() == static_cast<word_t>(Opcodes::OPCODE_ORI)
+        && upper.getRt() != 0 && lower.getRs() == upper.getRt() && lower.getRt() == upper.getRt();
+}
+
+// Removes instructions
+void PeepholeOptimizer::remove(std::vector<Instruction>& instructions, std::unordered_map<std::string, size_t>& labels, const std::vector<bool>& removed) {
+
+    // Where each old index now starts, for the labels
+    std::vector<size_t> moved(instructions.size() + 1, 0);
+    std::vector<Instruction> kept;
+    kept.reserve(instructions.size());
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        moved[i] = kept.size();
+        if (!removed[i])
+            kept.push_back(instructions[i]);
+    }
+
+    moved[instructions.size()] = kept.size();
+    for (auto& label : labels)
+        label.second = moved[label.second];
+
+    instructions = std::move(kept);
+}
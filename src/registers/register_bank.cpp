@@ -6,6 +6,12 @@
 
 #include "utils/string_utils.hpp"
 
+// MARK: -- Constants
+constexpr word_t RegisterBank::NUM_REGISTERS;
+constexpr word_t RegisterBank::REG_HI;
+constexpr word_t RegisterBank::REG_LO;
+
+
 // MARK: -- Static Variables
 
 // A mapping of register names to values
@@ -28,7 +34,9 @@ static std::unordered_map<std::string, word_t> sm_mapNameToRegister = {
 // MARK: -- Registration
 
 // Constructor
-RegisterBank::RegisterBank() {
+RegisterBank::RegisterBank()
+: m_ptrUndoLog(nullptr)
+{
     this->m_arrRegisters.fill(0);
 }
 
@@ -78,10 +86,54 @@ bool RegisterBank::readRegister(word_t num, word_t& value) const {
 bool RegisterBank::writeRegister(word_t num, word_t value) {
 
     if (num >= NUM_REGISTERS) return false;
+    if (this->m_ptrUndoLog != nullptr) this->m_ptrUndoLog->emplace_back(num, this->m_arrRegisters[num]);
     this->m_arrRegisters[num] = value;
 
     // Always reset the zero register to 0
     this->m_arrRegisters[0] = 0;
 
     return true;
-}
\ No newline at end of file
+}
+
+// Reads HI
+word_t RegisterBank::readHi() const {
+    return this->m_arrRegisters[REG_HI];
+}
+
+// Reads LO
+word_t RegisterBank::readLo() const {
+    return this->m_arrRegisters[REG_LO];
+}
+
+// Writes HI
+void RegisterBank::writeHi(word_t value) {
+    if (this->m_ptrUndoLog != nullptr) this->m_ptrUndoLog->emplace_back(REG_HI, this->m_arrRegisters[REG_HI]);
+    this->m_arrRegisters[REG_HI] = value;
+}
+
+// Writes LO
+void RegisterBank::writeLo(word_t value) {
+    if (this->m_ptrUndoLog != nullptr) this->m_ptrUndoLog->emplace_back(REG_LO, this->m_arrRegisters[REG_LO]);
+    this->m_arrRegisters[REG_LO] = value;
+}
+
+// Returns every register
+const RegisterBank::registers_t& RegisterBank::getRegisters() const {
+    return this->m_arrRegisters;
+}
+
+
+// MARK: -- Undo Methods
+
+// Sets the undo log
+void RegisterBank::setUndoLog(undo_log_t * log) {
+    this->m_ptrUndoLog = log;
+}
+
+// Puts back an old value
+bool RegisterBank::restoreRegister(word_t num, word_t value) {
+
+    if (num >= this->m_arrRegisters.size() || num == 0) return num == 0;
+    this->m_arrRegisters[num] = value;
+    return true;
+}
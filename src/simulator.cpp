@@ -6,15 +6,31 @@
 
 #include "spdlog/spdlog.h"
 
+#include "instr/functions.hpp"
 #include "instr/instruction_encoder.hpp"
+#include "instr/opcodes.hpp"
+#include "instr/syscall_context.hpp"
+#include "pipeline/static_analyzer.hpp"
+
+// MARK: -- Constants
+template <typename Instrumentation>
+constexpr word_t BasicSimulator<Instrumentation>::TRAP_OPCODE;
+
 
 // MARK: -- Construction
 
 // Constructs the simulator
-Simulator::Simulator(std::unique_ptr<InstructionSet> instrSet, std::unique_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank)
+template <typename Instrumentation>
+BasicSimulator<Instrumentation>::BasicSimulator(std::unique_ptr<InstructionSet> instrSet, std::shared_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank)
 : m_instrSet(std::move(instrSet))
 , m_memory(std::move(memory))
 , m_registerBank(std::move(registerBank))
+, m_wEntryPoint(Memory::MEM_USER_START)
+, m_dwCycleLimit(0)
+, m_bDetectLivelock(false)
+, m_dwPredecodedWrites(0)
+, m_bAtBreakpoint(false)
+, m_bWatching(false)
 { 
     if (this->m_instrSet == nullptr)
         throw std::invalid_argument("Cannot pass a null instruction set to the simulator");
@@ -24,34 +40,31 @@ Simulator::Simulator(std::unique_ptr<InstructionSet> instrSet, std::unique_ptr<M
 
     if (this->m_registerBank == nullptr)
         throw std::invalid_argument("Cannot pass a null register bank to the simulator");
-}
 
+    this->reset();
+}
 
-// MARK: -- Execution Methods
+// Destructs the simulator
+template <typename Instrumentation>
+BasicSimulator<Instrumentation>::~BasicSimulator() {
 
-// Runs the simulator
-void Simulator::run() { 
+    word_t trap = 0;
+    for (const auto& breakpoint : this->m_mapBreakpoints)
+        this->m_memory->patchWord(breakpoint.first, breakpoint.second, trap);
 
-    // First, create our buffers
-    InstructionFetchBuffer oldBufferIF;
-    InstructionFetchBuffer newBufferIF;
+    if (this->m_bWatching)
+        this->m_memory->setWatchHandler(nullptr);
+}
 
-    InstructionDecodeBuffer oldBufferID;
-    InstructionDecodeBuffer newBufferID;
 
-    ExecutionBuffer oldBufferEX;
-    ExecutionBuffer newBufferEX;
-    
-    MemoryBuffer oldBufferMEM;
-    MemoryBuffer newBufferMEM;
+// MARK: -- Execution Methods
 
-    // Now, set PC to the start of our text section
-    Memory::addr_t PC = Memory::MEM_USER_START;
+// Runs the simulator
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::run() { 
 
-    // Initialise our stats as well
-    word_t clockCycles = 0;
-    word_t instrCountTotal = 0;
-    word_t instrCountNOP = 0;
+    // Start from a clean pipeline
+    this->reset();
 
     // Output
     spdlog::info("Running Simulator...");
@@ -62,65 +75,349 @@ void Simulator::run() {
     spdlog::info("------------");
 
     // Finally, we can begin.
-    bool running = true;            // This will keep track of whether we are still running
-    int flush = 5;
-    while (running && flush > 0) {
-    
-        // First, backup the old buffer and fetch the new instruction
-        oldBufferIF = newBufferIF;
+    while (this->step()) { }
 
-        // If we are running, get instructions. Otherwise, get "NOPs" to finish the buffer
-        if (running)
-            newBufferIF = this->handleInstructionFetch(PC);
-        else
-            newBufferIF.wInstruction = 0x00000000;
+    spdlog::info("------------");
+    spdlog::info("");
+    spdlog::set_pattern("%+");
 
-        // If the instruction is a NOP, increase
-        if (newBufferIF.wInstruction == 0 && running)
-            instrCountNOP++;
+    // Now print our stats
+    spdlog::info("Total Clock Cycles: {}", this->m_stats.dwClockCycles);
+    spdlog::info("Total NOP Count: {}", this->m_stats.dwNops);
+    spdlog::info("Total Instruction Count: {}", this->m_stats.dwInstructions);
+    if (this->m_stats.dwDecodeForwards > 0)
+        spdlog::info("Total Branch Forwards (ID): {}, costing {} stall cycles", this->m_stats.dwDecodeForwards, this->m_stats.dwDecodeStalls);
+    if (this->m_lsu.getStats().dwForwards > 0)
+        spdlog::info("Total Store Forwards: {} of {} loads", this->m_lsu.getStats().dwForwards, this->m_lsu.getStats().dwLoads);
+    if (this->m_mdu.getStats().dwMultiplies + this->m_mdu.getStats().dwDivides > 0)
+        spdlog::info("Total Multiplies / Divides: {} / {}, costing {} stall cycles", this->m_mdu.getStats().dwMultiplies, this->m_mdu.getStats().dwDivides, this->m_mdu.getStats().dwStalls);
+    if (this->m_memory->getDeviceCycles() > 0)
+        spdlog::info("Total Device Cycles: {}", this->m_memory->getDeviceCycles());
+    this->m_instrumentation.onFinish();
+}
 
-        // Now, decode our instruction
-        oldBufferID = newBufferID;
-        newBufferID = this->handleInstructionDecode(newBufferIF, PC);
+// Sets the entry point
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::setEntryPoint(Memory::addr_t entry) {
+    this->m_wEntryPoint = entry;
+}
 
-        // If we want to kill the program, exit
-        if (newBufferID.bExit == true)
-            running = false;
+// Sets the multiply/divide latencies
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::setMultiplyDivideConfig(const MultiplyDivideUnit::Config& config) {
+    this->m_mdu = MultiplyDivideUnit(config);
+}
 
-        // Next, execute the instruction
-        oldBufferEX = newBufferEX;
-        newBufferEX = this->handleExecution(newBufferID, oldBufferEX, newBufferMEM);
+// Sets the cycle limit
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::setCycleLimit(dword_t limit) {
+    this->m_dwCycleLimit = limit;
+}
+
+// Sets livelock detection
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::setLivelockDetection(bool detect) {
+    this->m_bDetectLivelock = detect;
+}
+
+// Resets the pipeline
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::reset() {
+
+    // First, zero our latches
+    this->m_arrLatches = {};
+    this->m_szLatch = 0;
+    this->m_lsu = LoadStoreUnit();
+    this->m_mdu = MultiplyDivideUnit(this->m_mdu.getConfig());
+
+    // Now, set PC to our entry point and clear our stats
+    this->m_wPC = this->m_wEntryPoint;
+    this->m_stats = Stats();
+    this->m_bRunning = true;
+    this->m_iFlush = 5;
+    this->m_bAtBreakpoint = false;
+    this->m_stop = Stop();
+    this->m_livelock.reset();
+
+    // Decode the text again if it has changed since we last did
+    this->predecode();
+}
 
-        // After this, handle any memory
-        oldBufferMEM = newBufferMEM;
-        newBufferMEM = this->handleMemory(newBufferEX);
+// Runs a single cycle
+template <typename Instrumentation>
+bool BasicSimulator<Instrumentation>::step() {
 
-        // Finally, handle the write back stage
-        this->handleWriteBack(newBufferMEM);
+    if (!this->isRunning())
+        return false;
 
-        // Update our clock cycles
-        clockCycles++;
-        instrCountTotal++;
+    Stats& stats = this->m_stats;
+    this->m_instrumentation.beginCycle(stats.dwClockCycles);
 
-        if (!running)
-            flush--;
+    // First, swap the latches, so this cycle's stages write over those from two cycles ago
+    this->m_szLatch ^= 1;
+    PipelineLatches& latches = this->m_arrLatches[this->m_szLatch];
+    const PipelineLatches& last = this->m_arrLatches[this->m_szLatch ^ 1];
+
+    // If we are running, get instructions. Otherwise, get "NOPs" to finish the buffer
+    if (this->m_bRunning)
+        this->handleInstructionFetch(this->m_wPC, latches.bufferIF);
+    else {
+        latches.bufferIF.wInstruction = 0x00000000;
+        latches.bufferIF.wPC = this->m_wPC;
     }
+    latches.bufferIF.dwSequence = stats.dwInstructions;
 
-    spdlog::info("------------");
-    spdlog::info("");
-    spdlog::set_pattern("%+");
+    this->m_instrumentation.onFetch(latches.bufferIF, *this->m_instrSet.get());
+    this->m_instrumentation.onStage(PipelineStage::IF, latches.bufferIF.dwSequence, latches.bufferIF.wPC);
 
-    // Now print our stats
-    spdlog::info("Total Clock Cycles: {}", clockCycles);
-    spdlog::info("Total NOP Count: {}", instrCountNOP);
-    spdlog::info("Total Instruction Count: {}", instrCountTotal);
+    // If the instruction is a NOP, increase
+    if (latches.bufferIF.wInstruction == 0 && this->m_bRunning)
+        stats.dwNops++;
+
+    // Now, decode our instruction
+    this->handleInstructionDecode(latches.bufferIF, this->m_wPC, latches.bufferID);
+    this->m_instrumentation.onStage(PipelineStage::ID, latches.bufferID.dwSequence, latches.bufferID.wPC);
+
+    // If we want to kill the program, exit
+    if (latches.bufferID.bExit == true) {
+
+        // A breakpoint only stops us, so swap back to the last cycle's latches and run nothing else this cycle
+        if (this->m_bAtBreakpoint) {
+            this->m_szLatch ^= 1;
+            this->m_wPC = this->m_stop.wPC;
+            return true;
+        }
+
+        this->m_bRunning = false;
+    }
+
+    // Next, execute the instruction
+    this->handleExecution(latches.bufferID, last.bufferEX, last.bufferMEM, latches.bufferEX);
+    this->m_instrumentation.onExecute(latches.bufferEX);
+    this->m_instrumentation.onStage(PipelineStage::EX, latches.bufferEX.dwSequence, latches.bufferEX.wPC);
+
+    // After this, handle any memory
+    this->handleMemory(latches.bufferEX, latches.bufferMEM);
+    this->m_instrumentation.onStage(PipelineStage::MEM, latches.bufferMEM.dwSequence, latches.bufferMEM.wPC);
+
+    // Finally, handle the write back stage
+    this->handleWriteBack(latches.bufferMEM);
+    this->m_instrumentation.onStage(PipelineStage::WB, latches.bufferMEM.dwSequence, latches.bufferMEM.wPC);
+    this->m_instrumentation.onRetire(latches.bufferMEM.dwSequence);
+
+    // Update our clock cycles
+    stats.dwClockCycles++;
+    stats.dwInstructions++;
+
+    // Stops for good on the cycle that reaches the limit, so every cycle run is a whole one
+    if (this->m_bRunning && this->m_dwCycleLimit > 0 && stats.dwClockCycles >= this->m_dwCycleLimit) {
+        this->halt(StopReason::CYCLE_LIMIT);
+        return false;
+    }
+
+    // Buffered stores and device accesses count as writes too, or a loop making progress through them would look stuck
+    if (this->m_bDetectLivelock && this->m_bRunning) {
+        dword_t writes = this->m_memory->getWriteGeneration() + this->m_lsu.getStats().dwStores + this->m_memory->getDeviceCycles();
+        if (this->m_livelock.check(stats.dwClockCycles, this->m_wPC, *this->m_registerBank.get(), writes, stats.dwSyscalls)) {
+            this->halt(StopReason::LIVELOCK);
+            this->m_stop.dwPeriod = this->m_livelock.getPeriod();
+            return false;
+        }
+    }
+
+    if (!this->m_bRunning)
+        this->m_iFlush--;
+
+    return this->isRunning();
+}
+
+// Retires every buffered store
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::drainStores() {
+    this->m_lsu.flush();
+}
+
+// Returns whether we are running
+template <typename Instrumentation>
+bool BasicSimulator<Instrumentation>::isRunning() const {
+    return this->m_bRunning && this->m_iFlush > 0;
+}
+
+// Returns the program counter
+template <typename Instrumentation>
+Memory::addr_t BasicSimulator<Instrumentation>::getPC() const {
+    return this->m_wPC;
+}
+
+// Returns the statistics of the last run
+template <typename Instrumentation>
+const SimulatorStats& BasicSimulator<Instrumentation>::getStats() const {
+    return this->m_stats;
+}
+
+// Returns the load/store unit
+template <typename Instrumentation>
+const LoadStoreUnit& BasicSimulator<Instrumentation>::getLoadStoreUnit() const {
+    return this->m_lsu;
+}
+
+// Returns the multiply/divide unit
+template <typename Instrumentation>
+const MultiplyDivideUnit& BasicSimulator<Instrumentation>::getMultiplyDivideUnit() const {
+    return this->m_mdu;
+}
+
+// Saves the state
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::saveState(State& state) const {
+
+    state.wPC = this->m_wPC;
+    state.bRunning = this->m_bRunning;
+    state.iFlush = this->m_iFlush;
+    state.stats = this->m_stats;
+    state.arrLatches = this->m_arrLatches;
+    state.szLatch = this->m_szLatch;
+    state.lsu = this->m_lsu;
+    state.mdu = this->m_mdu;
+    state.stop = this->m_stop;
+}
+
+// Restores the state
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::restoreState(const State& state) {
+
+    this->m_wPC = state.wPC;
+    this->m_bRunning = state.bRunning;
+    this->m_iFlush = state.iFlush;
+    this->m_stats = state.stats;
+    this->m_arrLatches = state.arrLatches;
+    this->m_szLatch = state.szLatch;
+    this->m_lsu = state.lsu;
+    this->m_mdu = state.mdu;
+    this->m_bAtBreakpoint = false;
+    this->m_stop = state.stop;
+    this->m_livelock.reset();
+}
+
+
+
+// MARK: -- Debugging Methods
+
+// Adds a breakpoint
+template <typename Instrumentation>
+bool BasicSimulator<Instrumentation>::addBreakpoint(Memory::addr_t addr) {
+
+    if (addr - Memory::MEM_USER_START >= this->m_memory->getTextSize() || addr % 4 != 0) {
+        spdlog::error("Cannot set a breakpoint at 0x{:x} - it is not an instruction in the text segment", addr);
+        return false;
+    }
+
+    if (this->m_instrSet->getType(TRAP_OPCODE) != InstructionType::UNKNOWN) {
+        spdlog::error("Cannot set breakpoints - the instruction set uses opcode {} for an instruction", TRAP_OPCODE);
+        return false;
+    }
+
+    if (this->m_mapBreakpoints.count(addr) > 0)
+        return true;
+
+    word_t original = 0;
+    this->m_memory->patchWord(addr, TRAP_OPCODE, original);
+    this->m_mapBreakpoints[addr] = original;
+    return true;
+}
+
+// Removes a breakpoint
+template <typename Instrumentation>
+bool BasicSimulator<Instrumentation>::removeBreakpoint(Memory::addr_t addr) {
+
+    auto search = this->m_mapBreakpoints.find(addr);
+    if (search == this->m_mapBreakpoints.end())
+        return false;
+
+    word_t trap = 0;
+    this->m_memory->patchWord(addr, search->second, trap);
+    this->m_mapBreakpoints.erase(search);
+
+    // The instruction we stopped before now runs by itself
+    if (this->m_bAtBreakpoint && this->m_stop.wPC == addr)
+        this->m_bAtBreakpoint = false;
+
+    return true;
+}
+
+// Adds a watchpoint
+template <typename Instrumentation>
+bool BasicSimulator<Instrumentation>::addWatchpoint(Memory::addr_t addr, size_t size, Memory::WatchKind kind) {
+
+    // Instruction fetches are not data accesses, so the text segment cannot be watched
+    if (addr - Memory::MEM_USER_START < this->m_memory->getTextSize() || !this->m_memory->addWatchpoint(addr, size, kind)) {
+        spdlog::error("Cannot watch {} bytes at 0x{:x} - they are not all in the data segment", size, addr);
+        return false;
+    }
+
+    // Keeps the first access since we resumed; the instruction fetched this cycle made it
+    if (!this->m_bWatching) {
+        this->m_memory->setWatchHandler([this](const Memory::WatchHit& hit) {
+            if (this->m_stop.reason != StopReason::NONE) return;
+            this->m_stop.reason = StopReason::WATCHPOINT;
+            this->m_stop.wPC = this->m_arrLatches[this->m_szLatch].bufferIF.wPC;
+            this->m_stop.dwCycle = this->m_stats.dwClockCycles;
+            this->m_stop.watch = hit;
+        });
+        this->m_bWatching = true;
+    }
+
+    return true;
+}
+
+// Removes a watchpoint
+template <typename Instrumentation>
+bool BasicSimulator<Instrumentation>::removeWatchpoint(Memory::addr_t addr) {
+    return this->m_memory->removeWatchpoint(addr);
+}
+
+// Runs to the next stop
+template <typename Instrumentation>
+const SimulatorStop& BasicSimulator<Instrumentation>::resume() {
+
+    // A run stopped for good stays stopped
+    if (this->m_stop.reason == StopReason::CYCLE_LIMIT || this->m_stop.reason == StopReason::LIVELOCK)
+        return this->m_stop;
+
+    this->m_stop = Stop();
+    while (this->step()) {
+        if (this->m_stop.reason != StopReason::NONE)
+            return this->m_stop;
+    }
+
+    // A watchpoint touched on the last cycle is still reported first
+    if (this->m_stop.reason == StopReason::NONE) {
+        this->m_stop.reason = StopReason::EXITED;
+        this->m_stop.wPC = this->m_wPC;
+        this->m_stop.dwCycle = this->m_stats.dwClockCycles;
+    }
+
+    return this->m_stop;
+}
+
+// Returns the last stop
+template <typename Instrumentation>
+const SimulatorStop& BasicSimulator<Instrumentation>::getStop() const {
+    return this->m_stop;
+}
+
+// Returns the instrumentation
+template <typename Instrumentation>
+Instrumentation& BasicSimulator<Instrumentation>::getInstrumentation() {
+    return this->m_instrumentation;
 }
 
 
 // MARK: -- Private Handler Methods
 
 // Handles the instruction fetch
-InstructionFetchBuffer Simulator::handleInstructionFetch(Memory::addr_t& PC) {
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleInstructionFetch(Memory::addr_t& PC, InstructionFetchBuffer& buffer) {
 
     // First, check if we are within our memory bounds
     if (PC - Memory::MEM_USER_START >= this->m_memory->getTextSize()) {
@@ -135,21 +432,38 @@ InstructionFetchBuffer Simulator::handleInstructionFetch(Memory::addr_t& PC) {
     }
 
     // Get our instruction
-    InstructionFetchBuffer buffer;
+    buffer.wPC = PC;
     this->m_memory->readWord(PC, buffer.wInstruction);
 
-    // Update PC and return
+    // Update PC
     PC += 4;
-    return buffer;
 }
 
 // Handles the instruction decode
-InstructionDecodeBuffer Simulator::handleInstructionDecode(const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC) {
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleInstructionDecode(const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC, InstructionDecodeBuffer& buffer) {
+
+    // Instructions decoded at load only need their registers read (the word is checked, since the text may have changed)
+    size_t index = (fetchBuffer.wPC - Memory::MEM_USER_START) / 4;
+    if (index < this->m_vecPredecoded.size()) {
+        const PredecodedInstruction& entry = this->m_vecPredecoded[index];
+        if (entry.ptrHandler != nullptr && entry.wInstruction == fetchBuffer.wInstruction) {
+            this->handlePredecoded(entry, fetchBuffer, PC, buffer);
+            return;
+        }
+    }
 
-    // First, get our instruction type
+    // Otherwise, get our instruction type
     word_t opcode = fetchBuffer.wInstruction & ((1 << 6) - 1);
     InstructionType instrType = this->m_instrSet->getType(opcode);
     if (instrType == InstructionType::UNKNOWN) {
+
+        // Breakpoints are traps with an unknown opcode, so are only ever looked for here
+        if (opcode == TRAP_OPCODE && !this->m_mapBreakpoints.empty()) {
+            this->handleBreakpoint(fetchBuffer, PC, buffer);
+            return;
+        }
+
         spdlog::critical("SIGILL: Attempting to decode an invalid or illegal instruction!");
         exit(1);
     }
@@ -157,8 +471,9 @@ InstructionDecodeBuffer Simulator::handleInstructionDecode(const InstructionFetc
     // Decode the instruction
     Instruction instr = InstructionEncoder::decode(fetchBuffer.wInstruction, instrType);
 
-    // Create the instruction buffer
-    InstructionDecodeBuffer buffer;
+    // Fill the instruction buffer
+    buffer.dwSequence = fetchBuffer.dwSequence;
+    buffer.wPC = fetchBuffer.wPC;
     buffer.wOpcode = opcode;
 
     // Now read more depending on the type
@@ -173,6 +488,13 @@ InstructionDecodeBuffer Simulator::handleInstructionDecode(const InstructionFetc
         buffer.wRegSrc2 = -1;
         this->m_registerBank->readRegister(buffer.wRegSrc1, buffer.wValSrc1);
         buffer.wValSrc2 = 0;
+
+        // Branches compare RS with RT here, so read RT as our second source and forward both
+        if (StaticAnalyzer::comparesInDecode(opcode)) {
+            buffer.wRegSrc2 = buffer.wRegDest;
+            this->m_registerBank->readRegister(buffer.wRegSrc2, buffer.wValSrc2);
+            this->handleDecodeForwarding(buffer);
+        }
     }
     else if (instrType == InstructionType::J_FORMAT) {
 
@@ -198,6 +520,10 @@ InstructionDecodeBuffer Simulator::handleInstructionDecode(const InstructionFetc
         buffer.wRegSrc2 = instr.getRt();
         this->m_registerBank->readRegister(buffer.wRegSrc1, buffer.wValSrc1);
         this->m_registerBank->readRegister(buffer.wRegSrc2, buffer.wValSrc2);
+
+        // Jumps through a register need it here, so forward it like a branch's
+        if (StaticAnalyzer::jumpsInDecode(buffer.wFunct))
+            this->handleDecodeForwarding(buffer);
     }
 
     // Finally handle any post decoding (mainly for branches)
@@ -207,32 +533,160 @@ InstructionDecodeBuffer Simulator::handleInstructionDecode(const InstructionFetc
         exit(1);
     }
 
-    // Handle any post decoding and return the buffer (generally handles branches / syscalls)
+    // Handle any post decoding (generally handles branches / syscalls)
     handler->onDecode(buffer, *this->m_registerBank.get(), *this->m_memory.get(), PC);
-    return buffer;
+}
+
+// Handles the decode of a predecoded instruction
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handlePredecoded(const PredecodedInstruction& entry, const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC, InstructionDecodeBuffer& buffer) {
+
+    buffer.dwSequence = fetchBuffer.dwSequence;
+    buffer.wPC = fetchBuffer.wPC;
+    buffer.bExit = false;
+    buffer.wOpcode = entry.wOpcode;
+    buffer.wFunct = entry.wFunct;
+    buffer.wImmediate = entry.wImmediate;
+    buffer.wRegDest = entry.wRegDest;
+    buffer.wRegSrc1 = entry.wRegSrc1;
+    buffer.wRegSrc2 = entry.wRegSrc2;
+    buffer.wValSrc1 = 0;
+    buffer.wValSrc2 = 0;
+
+    if (buffer.wRegSrc1 != -1)
+        this->m_registerBank->readRegister(buffer.wRegSrc1, buffer.wValSrc1);
+    if (buffer.wRegSrc2 != -1)
+        this->m_registerBank->readRegister(buffer.wRegSrc2, buffer.wValSrc2);
+
+    // Nothing falling through into a branch may produce its operands, so it only needs forwarding
+    // if there might be, or it was reached some other way (or the text changed under the analysis)
+    if (entry.bReadsInDecode) {
+        const PipelineLatches& last = this->m_arrLatches[this->m_szLatch ^ 1];
+        const PipelineLatches& latches = this->m_arrLatches[this->m_szLatch];
+        bool fellThrough = last.bufferMEM.wPC == buffer.wPC - 4 && latches.bufferMEM.wPC == buffer.wPC - 8
+            && this->m_memory->getTextWrites() == this->m_dwPredecodedWrites;
+        if (entry.bDecodeHazard || !fellThrough)
+            this->handleDecodeForwarding(buffer);
+    }
+
+    entry.ptrHandler->onDecode(buffer, *this->m_registerBank.get(), *this->m_memory.get(), PC);
+}
+
+// Handles a breakpoint
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleBreakpoint(const InstructionFetchBuffer& fetchBuffer, Memory::addr_t& PC, InstructionDecodeBuffer& buffer) {
+
+    auto search = this->m_mapBreakpoints.find(fetchBuffer.wPC);
+    if (search == this->m_mapBreakpoints.end()) {
+        spdlog::critical("SIGILL: Attempting to decode an invalid or illegal instruction!");
+        exit(1);
+    }
+
+    // Resuming from the breakpoint, so decode the instruction it replaced
+    if (this->m_bAtBreakpoint) {
+        this->m_bAtBreakpoint = false;
+        InstructionFetchBuffer original = fetchBuffer;
+        original.wInstruction = search->second;
+        this->handleInstructionDecode(original, PC, buffer);
+        return;
+    }
+
+    // Otherwise, stop before it (step() takes back the fetch)
+    this->m_bAtBreakpoint = true;
+    this->m_stop.reason = StopReason::BREAKPOINT;
+    this->m_stop.wPC = fetchBuffer.wPC;
+    this->m_stop.dwCycle = this->m_stats.dwClockCycles;
+
+    buffer = {};
+    buffer.bExit = true;
+    buffer.wRegDest = -1;
+    buffer.wRegSrc1 = -1;
+    buffer.wRegSrc2 = -1;
+    buffer.dwSequence = fetchBuffer.dwSequence;
+    buffer.wPC = fetchBuffer.wPC;
+}
+
+// Handles the forwarding into decode
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleDecodeForwarding(InstructionDecodeBuffer& decodeBuffer) {
+
+    // The last instruction is in execution as we decode, and the one before it in memory. Once
+    // an ALU result is computed it sits in the EX/MEM latch, but a load's value only reaches
+    // the MEM/WB latch, so the branch stalls until its producers get there. The memory stage
+    // has not run yet this cycle, so this cycle's memory buffer still holds the older producer
+    const MemoryBuffer * producers[] = { &this->m_arrLatches[this->m_szLatch ^ 1].bufferMEM, &this->m_arrLatches[this->m_szLatch].bufferMEM };
+    bool resolved1 = false, resolved2 = false;
+    dword_t stall = 0;
+
+    for (size_t distance = 1; distance <= 2; ++distance) {
+
+        const MemoryBuffer& producer = *producers[distance - 1];
+
+        // A system call writes its results to the register bank as it decodes, so whatever it
+        // writes is never forwarded, from it or from anything older
+        if (producer.wOpcode == static_cast<word_t>(Opcodes::OPCODE_R_TYPE) && producer.wFunct == static_cast<word_t>(Functions::FUNCT_SYSCALL)) {
+            resolved1 = resolved1 || SyscallContext::writesRegister(decodeBuffer.wRegSrc1);
+            resolved2 = resolved2 || SyscallContext::writesRegister(decodeBuffer.wRegSrc2);
+            continue;
+        }
+
+        bool src1 = !resolved1 && producer.wRegDest == decodeBuffer.wRegSrc1;
+        bool src2 = !resolved2 && producer.wRegDest == decodeBuffer.wRegSrc2;
+        if (producer.wRegDest == 0 || (!src1 && !src2))
+            continue;
+
+        bool load = LoadStoreUnit::isLoad(producer.wOpcode);
+        dword_t wait = (load ? 3 : 2) - distance;
+        if (wait > stall)
+            stall = wait;
+
+        // Every producer has retired by the time we decode, so the values read from the register
+        // bank are already the forwarded ones - only the forward, and what it would cost, is counted.
+        // The nearest producer wins, so an older one is never counted for the same operand
+        PipelineStage from = load ? PipelineStage::MEM : PipelineStage::EX;
+        if (src1) {
+            resolved1 = true;
+            this->m_stats.dwDecodeForwards++;
+            this->m_instrumentation.onForward(decodeBuffer.dwSequence, decodeBuffer.wRegSrc1, from, producer.dwSequence);
+        }
+
+        if (src2) {
+            resolved2 = true;
+            this->m_stats.dwDecodeForwards++;
+            this->m_instrumentation.onForward(decodeBuffer.dwSequence, decodeBuffer.wRegSrc2, from, producer.dwSequence);
+        }
+    }
+
+    this->m_stats.dwDecodeStalls += stall;
 }
 
 // Handles the instruction execution
-ExecutionBuffer Simulator::handleExecution(InstructionDecodeBuffer& decodeBuffer, ExecutionBuffer& oldExecutionBuffer, MemoryBuffer& newMemoryBuffer) {
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleExecution(InstructionDecodeBuffer& decodeBuffer, const ExecutionBuffer& lastExecutionBuffer, const MemoryBuffer& lastMemoryBuffer, ExecutionBuffer& buffer) {
 
     // If this cycle's decode buffer uses a register written to by last cycle's execution,
     // forward the output into the decoded buffer
-    if (oldExecutionBuffer.wRegDest == decodeBuffer.wRegSrc1)
-        decodeBuffer.wValSrc1 = oldExecutionBuffer.wOutput;
+    if (lastExecutionBuffer.wRegDest == decodeBuffer.wRegSrc1) {
+        decodeBuffer.wValSrc1 = lastExecutionBuffer.wOutput;
+        this->m_instrumentation.onForward(decodeBuffer.dwSequence, decodeBuffer.wRegSrc1, PipelineStage::EX, lastExecutionBuffer.dwSequence);
+    }
 
-    if (oldExecutionBuffer.wRegDest == decodeBuffer.wRegSrc2)
-        decodeBuffer.wValSrc2 = oldExecutionBuffer.wOutput;
+    if (lastExecutionBuffer.wRegDest == decodeBuffer.wRegSrc2) {
+        decodeBuffer.wValSrc2 = lastExecutionBuffer.wOutput;
+        this->m_instrumentation.onForward(decodeBuffer.dwSequence, decodeBuffer.wRegSrc2, PipelineStage::EX, lastExecutionBuffer.dwSequence);
+    }
 
     // If this cycle's decode buffer uses a register written to by last cycle's memory read,
     // forward the output into the decoded buffer
-    if (newMemoryBuffer.wRegDest == decodeBuffer.wRegSrc1)
-        decodeBuffer.wValSrc1 = newMemoryBuffer.wOutput;
-
-    if (newMemoryBuffer.wRegDest == decodeBuffer.wRegSrc2)
-        decodeBuffer.wValSrc2 = newMemoryBuffer.wOutput;
+    if (lastMemoryBuffer.wRegDest == decodeBuffer.wRegSrc1) {
+        decodeBuffer.wValSrc1 = lastMemoryBuffer.wOutput;
+        this->m_instrumentation.onForward(decodeBuffer.dwSequence, decodeBuffer.wRegSrc1, PipelineStage::MEM, lastMemoryBuffer.dwSequence);
+    }
 
-    // Create our new buffer
-    ExecutionBuffer buffer;
+    if (lastMemoryBuffer.wRegDest == decodeBuffer.wRegSrc2) {
+        decodeBuffer.wValSrc2 = lastMemoryBuffer.wOutput;
+        this->m_instrumentation.onForward(decodeBuffer.dwSequence, decodeBuffer.wRegSrc2, PipelineStage::MEM, lastMemoryBuffer.dwSequence);
+    }
 
     // Next, get our instruction handler
     InstructionHandler * handler = this->m_instrSet->getInstructionHandler(decodeBuffer.wOpcode, decodeBuffer.wFunct);
@@ -241,6 +695,11 @@ ExecutionBuffer Simulator::handleExecution(InstructionDecodeBuffer& decodeBuffer
         exit(1);
     }
 
+    // Multiplies, divides and moves to or from HI and LO wait on the multiply/divide unit,
+    // timed as though its own stalls had been taken
+    if (decodeBuffer.wOpcode == static_cast<word_t>(Opcodes::OPCODE_R_TYPE) && MultiplyDivideUnit::isMultiplyDivide(decodeBuffer.wFunct))
+        this->m_mdu.issue(decodeBuffer.wFunct, this->m_stats.dwClockCycles + this->m_mdu.getStats().dwStalls);
+
     // Handle our execution
     buffer.wOutput = handler->onExecute(decodeBuffer);
 
@@ -249,11 +708,13 @@ ExecutionBuffer Simulator::handleExecution(InstructionDecodeBuffer& decodeBuffer
     buffer.wOpcode = decodeBuffer.wOpcode;
     buffer.wRegDest = decodeBuffer.wRegDest;
     buffer.wRegValue = decodeBuffer.wValSrc2;
-    return buffer;
+    buffer.dwSequence = decodeBuffer.dwSequence;
+    buffer.wPC = decodeBuffer.wPC;
 }
 
 // Handle the instruction memory stage
-MemoryBuffer Simulator::handleMemory(const ExecutionBuffer& executionBuffer) {
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleMemory(const ExecutionBuffer& executionBuffer, MemoryBuffer& buffer) {
 
     // Get our handler
     InstructionHandler * handler = this->m_instrSet->getInstructionHandler(executionBuffer.wOpcode, executionBuffer.wFunct);
@@ -262,24 +723,73 @@ MemoryBuffer Simulator::handleMemory(const ExecutionBuffer& executionBuffer) {
         exit(1);
     }
 
-    // Create our buffer
-    MemoryBuffer buffer;
-
     // Memory read instructions will put memory output here, other instructions
-    // may just forward ALU output here
-    buffer.wOutput = handler->onMemory(executionBuffer, *this->m_memory.get());
+    // may just forward ALU output here. Loads and stores go through the load/store unit,
+    // which retires a buffered store whenever nothing else uses memory, and all of them
+    // on a system call (which may write memory itself)
+    if (LoadStoreUnit::isLoadStore(executionBuffer.wOpcode))
+        buffer.wOutput = this->m_lsu.access(executionBuffer, *handler, *this->m_memory.get());
+    else {
+        if (executionBuffer.wOpcode == static_cast<word_t>(Opcodes::OPCODE_R_TYPE) && executionBuffer.wFunct == static_cast<word_t>(Functions::FUNCT_SYSCALL)) {
+            this->m_lsu.flush();
+            this->m_stats.dwSyscalls++;
+        }
+        else
+            this->m_lsu.drain();
+        buffer.wOutput = handler->onMemory(executionBuffer, *this->m_memory.get());
+    }
     
     // Set any addition information
     buffer.wFunct = executionBuffer.wFunct;
     buffer.wOpcode = executionBuffer.wOpcode;
     buffer.wRegDest = executionBuffer.wRegDest;
-    return buffer;
+    buffer.dwSequence = executionBuffer.dwSequence;
+    buffer.wPC = executionBuffer.wPC;
 }
 
 // Handle the instruction write back stage
-void Simulator::handleWriteBack(const MemoryBuffer& memoryBuffer) {
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::handleWriteBack(const MemoryBuffer& memoryBuffer) {
 
     // Write back everything
     if (memoryBuffer.wRegDest != -1)
         this->m_registerBank->writeRegister(memoryBuffer.wRegDest, memoryBuffer.wOutput);
-}
\ No newline at end of file
+}
+
+
+
+// MARK: -- Private Predecode Methods
+
+// Predecodes the text segment
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::predecode() {
+
+    if (this->m_vecPredecoded.size() == this->m_memory->getTextSize() / 4 && this->m_memory->getTextWrites() == this->m_dwPredecodedWrites)
+        return;
+
+    // Illegal instructions are only fatal if they are reached, so the report is not needed here
+    StaticAnalyzer::Report report;
+    StaticAnalyzer(*this->m_instrSet.get()).analyze(*this->m_memory.get(), this->m_vecPredecoded, report);
+    this->m_dwPredecodedWrites = this->m_memory->getTextWrites();
+}
+
+
+// MARK: -- Private Debugging Methods
+
+// Stops the run for good
+template <typename Instrumentation>
+void BasicSimulator<Instrumentation>::halt(StopReason reason) {
+
+    this->m_stop.reason = reason;
+    this->m_stop.wPC = this->m_wPC;
+    this->m_stop.dwCycle = this->m_stats.dwClockCycles;
+    this->m_bRunning = false;
+    this->m_iFlush = 0;
+}
+
+
+
+// MARK: -- Instantiations
+template class BasicSimulator<NullInstrumentation>;
+template class BasicSimulator<TraceInstrumentation>;
+template class BasicSimulator<RecordInstrumentation>;
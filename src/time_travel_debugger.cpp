@@ -0,0 +1,324 @@
+#include "time_travel_debugger.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/functions.hpp"
+#include "instr/opcodes.hpp"
+
+// MARK: -- Constants
+constexpr dword_t TimeTravelDebugger::DEFAULT_INTERVAL;
+
+
+// MARK: -- Construction
+
+// Constructor
+TimeTravelDebugger::TimeTravelDebugger(std::unique_ptr<InstructionSet> instrSet, std::shared_ptr<Memory> memory, std::unique_ptr<RegisterBank> registerBank,
+                                       dword_t interval)
+: m_ptrMemory(memory)
+, m_ptrRegisters(registerBank.get())
+, m_ptrSyscalls(nullptr)
+, m_ptrHistory(new SyscallLog())
+, m_dwInterval(interval)
+, m_dwFrontier(0)
+{
+    if (interval == 0)
+        throw std::invalid_argument("Cannot take checkpoints every 0 cycles");
+
+    // Does the lookup of the system call handler before the simulator takes the instruction set
+    if (instrSet != nullptr) {
+        InstructionHandler * handler = instrSet->getInstructionHandler(static_cast<word_t>(Opcodes::OPCODE_R_TYPE), static_cast<word_t>(Functions::FUNCT_SYSCALL));
+        this->m_ptrSyscalls = dynamic_cast<SyscallHandler *>(handler);
+    }
+
+    // The simulator checks its own arguments
+    this->m_ptrSimulator = std::unique_ptr<Simulator>(new Simulator(std::move(instrSet), std::move(memory), std::move(registerBank)));
+
+    if (this->m_ptrSyscalls != nullptr)
+        this->m_ptrSyscalls->setHistory(this->m_ptrHistory);
+    else
+        spdlog::warn("No system call handler found - system calls will run again when going back");
+
+    this->m_ptrRegisters->setUndoLog(&this->m_vecRegisterUndo);
+    this->m_ptrMemory->setUndoLog(&this->m_vecMemoryUndo);
+    this->takeCheckpoint();
+}
+
+// Destructor - the memory may outlive us
+TimeTravelDebugger::~TimeTravelDebugger() {
+    this->m_ptrMemory->setUndoLog(nullptr);
+    this->m_ptrRegisters->setUndoLog(nullptr);
+}
+
+
+// MARK: -- Forward Methods
+
+// Sets the cycle limit
+void TimeTravelDebugger::setCycleLimit(dword_t limit) {
+    this->m_ptrSimulator->setCycleLimit(limit);
+}
+
+// Sets livelock detection
+void TimeTravelDebugger::setLivelockDetection(bool detect) {
+    this->m_ptrSimulator->setLivelockDetection(detect);
+}
+
+// Runs a cycle
+bool TimeTravelDebugger::step() {
+    this->stepForward();
+    return this->isRunning();
+}
+
+// Runs to the next stop
+bool TimeTravelDebugger::forwardContinue(const stop_fn_t& stop) {
+
+    while (this->stepForward()) {
+        if (this->isRunning() && stop(this->getPC()))
+            return true;
+    }
+
+    return false;
+}
+
+
+// MARK: -- Reverse Methods
+
+// Goes back a cycle
+bool TimeTravelDebugger::reverseStep() {
+
+    if (this->getCycle() == 0)
+        return false;
+
+    return this->seek(this->getCycle() - 1);
+}
+
+// Goes back to the last stop
+bool TimeTravelDebugger::reverseContinue(const stop_fn_t& stop) {
+
+    // Does the search an interval at a time, latest first: go to its checkpoint, then
+    // run forward over it, remembering the last cycle to stop at
+    dword_t end = this->getCycle();
+    while (end > 0) {
+
+        dword_t start = ((end - 1) / this->m_dwInterval) * this->m_dwInterval;
+        this->seek(start);
+
+        bool found = false;
+        dword_t latest = start;
+        while (true) {
+
+            if (stop(this->getPC())) {
+                found = true;
+                latest = this->getCycle();
+            }
+
+            if (this->getCycle() + 1 >= end) break;
+            this->stepForward();
+        }
+
+        // Everything since the checkpoint is still in the undo log
+        this->seek(latest);
+        if (found) return true;
+
+        end = start;
+    }
+
+    return false;
+}
+
+// Goes to a cycle
+bool TimeTravelDebugger::seek(dword_t cycle) {
+
+    // Going back within the undo log only undoes cycles; any further starts from
+    // the checkpoint before the target
+    if (cycle < this->getCycle()) {
+
+        if (this->getCycle() - cycle <= this->m_vecUndo.size()) {
+            while (this->getCycle() > cycle)
+                this->undoCycle();
+            return true;
+        }
+
+        this->restoreCheckpoint(static_cast<size_t>(cycle / this->m_dwInterval));
+    }
+
+    // Going forward over cycles already run starts from the latest checkpoint
+    // before the target, when it is past where we are
+    else {
+
+        size_t index = std::min(static_cast<size_t>(cycle / this->m_dwInterval), this->m_vecCheckpoints.size() - 1);
+        if (index * this->m_dwInterval > this->getCycle())
+            this->restoreCheckpoint(index);
+    }
+
+    while (this->getCycle() < cycle) {
+        if (!this->stepForward())
+            return false;
+    }
+
+    return true;
+}
+
+
+// MARK: -- State Methods
+
+// Returns the cycle
+dword_t TimeTravelDebugger::getCycle() const {
+    return this->m_ptrSimulator->getStats().dwClockCycles;
+}
+
+// Returns the furthest cycle
+dword_t TimeTravelDebugger::getFrontier() const {
+    return this->m_dwFrontier;
+}
+
+// Returns the program counter
+Memory::addr_t TimeTravelDebugger::getPC() const {
+    return this->m_ptrSimulator->getPC();
+}
+
+// Returns whether we are running
+bool TimeTravelDebugger::isRunning() const {
+    return this->m_ptrSimulator->isRunning();
+}
+
+// Returns the stop
+const SimulatorStop& TimeTravelDebugger::getStop() const {
+    return this->m_ptrSimulator->getStop();
+}
+
+// Returns the registers
+const RegisterBank& TimeTravelDebugger::getRegisters() const {
+    return *this->m_ptrRegisters;
+}
+
+// Returns the memory
+const Memory& TimeTravelDebugger::getMemory() const {
+    return *this->m_ptrMemory;
+}
+
+// Returns the simulator statistics
+const SimulatorStats& TimeTravelDebugger::getSimulatorStats() const {
+    return this->m_ptrSimulator->getStats();
+}
+
+// Returns the history counters
+const TimeTravelDebugger::Stats& TimeTravelDebugger::getStats() const {
+    return this->m_stats;
+}
+
+
+// MARK: -- Private Methods
+
+// Runs a cycle
+bool TimeTravelDebugger::stepForward() {
+
+    if (!this->m_ptrSimulator->isRunning())
+        return false;
+
+    UndoRecord record;
+    this->m_ptrSimulator->saveState(record.state);
+    record.szRegisters = this->m_vecRegisterUndo.size();
+    record.szMemory = this->m_vecMemoryUndo.size();
+    record.szSyscalls = (this->m_ptrSyscalls != nullptr) ? this->m_ptrSyscalls->getHistoryPosition() : 0;
+    this->m_vecUndo.push_back(record);
+
+    if (this->getCycle() < this->m_dwFrontier)
+        this->m_stats.dwCyclesReplayed++;
+
+    this->m_ptrSimulator->step();
+
+    dword_t cycle = this->getCycle();
+    if (cycle > this->m_dwFrontier)
+        this->m_dwFrontier = cycle;
+
+    // Does the checkpoint at each interval; when running again over one we already
+    // have, memory matches it, so the next one can share its pages
+    if (cycle % this->m_dwInterval == 0) {
+
+        size_t index = static_cast<size_t>(cycle / this->m_dwInterval);
+        if (index == this->m_vecCheckpoints.size())
+            this->takeCheckpoint();
+        else {
+            this->m_ptrMemory->matchSnapshot(this->m_vecCheckpoints[index].memory);
+            this->clearUndo();
+        }
+    }
+
+    return true;
+}
+
+// Undoes a cycle
+void TimeTravelDebugger::undoCycle() {
+
+    const UndoRecord& record = this->m_vecUndo.back();
+
+    // Memory and registers are put back newest first
+    Memory::journal_t undo(this->m_vecMemoryUndo.rbegin(), this->m_vecMemoryUndo.rend() - record.szMemory);
+    this->m_ptrMemory->applyJournal(undo);
+    this->m_vecMemoryUndo.resize(record.szMemory);
+
+    this->m_ptrRegisters->setUndoLog(nullptr);
+    for (size_t i = this->m_vecRegisterUndo.size(); i > record.szRegisters; --i)
+        this->m_ptrRegisters->restoreRegister(this->m_vecRegisterUndo[i-1].first, this->m_vecRegisterUndo[i-1].second);
+    this->m_vecRegisterUndo.resize(record.szRegisters);
+    this->m_ptrRegisters->setUndoLog(&this->m_vecRegisterUndo);
+
+    this->m_ptrSimulator->restoreState(record.state);
+    if (this->m_ptrSyscalls != nullptr)
+        this->m_ptrSyscalls->setHistoryPosition(record.szSyscalls);
+
+    this->m_vecUndo.pop_back();
+}
+
+// Takes a checkpoint
+void TimeTravelDebugger::takeCheckpoint() {
+
+    Checkpoint checkpoint;
+    this->m_ptrSimulator->saveState(checkpoint.state);
+    for (word_t reg = 0; reg < RegisterBank::NUM_REGISTERS; ++reg)
+        this->m_ptrRegisters->readRegister(reg, checkpoint.arrRegisters[reg]);
+    checkpoint.arrRegisters[RegisterBank::REG_HI] = this->m_ptrRegisters->readHi();
+    checkpoint.arrRegisters[RegisterBank::REG_LO] = this->m_ptrRegisters->readLo();
+    this->m_ptrMemory->takeSnapshot(checkpoint.memory);
+    checkpoint.szSyscalls = (this->m_ptrSyscalls != nullptr) ? this->m_ptrSyscalls->getHistoryPosition() : 0;
+
+    // Counts the pages this checkpoint does not share with the last
+    const std::vector<Memory::page_t> * previous = this->m_vecCheckpoints.empty() ? nullptr : &this->m_vecCheckpoints.back().memory.vecPages;
+    for (size_t page = 0; page < checkpoint.memory.vecPages.size(); ++page) {
+        if (previous == nullptr || page >= previous->size() || (*previous)[page] != checkpoint.memory.vecPages[page])
+            this->m_stats.dwPagesCopied++;
+    }
+
+    this->m_vecCheckpoints.push_back(std::move(checkpoint));
+    this->m_stats.dwCheckpoints++;
+    this->clearUndo();
+}
+
+// Restores a checkpoint
+void TimeTravelDebugger::restoreCheckpoint(size_t index) {
+
+    const Checkpoint& checkpoint = this->m_vecCheckpoints[index];
+    this->m_ptrMemory->restoreSnapshot(checkpoint.memory);
+
+    this->m_ptrRegisters->setUndoLog(nullptr);
+    for (word_t reg = 0; reg < checkpoint.arrRegisters.size(); ++reg)
+        this->m_ptrRegisters->restoreRegister(reg, checkpoint.arrRegisters[reg]);
+    this->m_ptrRegisters->setUndoLog(&this->m_vecRegisterUndo);
+
+    this->m_ptrSimulator->restoreState(checkpoint.state);
+    if (this->m_ptrSyscalls != nullptr)
+        this->m_ptrSyscalls->setHistoryPosition(checkpoint.szSyscalls);
+
+    this->clearUndo();
+}
+
+// Forgets the undo log
+void TimeTravelDebugger::clearUndo() {
+    this->m_vecUndo.clear();
+    this->m_vecRegisterUndo.clear();
+    this->m_vecMemoryUndo.clear();
+}
@@ -0,0 +1,33 @@
+#include "utils/barrier.hpp"
+
+#include <algorithm>
+
+// MARK: -- Construction
+
+// Constructor
+Barrier::Barrier(size_t count)
+: m_szCount(std::max<size_t>(count, 1))
+, m_szWaiting(std::max<size_t>(count, 1))
+, m_szGeneration(0)
+{ }
+
+
+// MARK: -- Synchronisation Methods
+
+// Waits for every thread
+bool Barrier::wait() {
+
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+    size_t generation = this->m_szGeneration;
+
+    // Does the release if we are the last to arrive, starting the next round
+    if (--this->m_szWaiting == 0) {
+        this->m_szGeneration++;
+        this->m_szWaiting = this->m_szCount;
+        this->m_condition.notify_all();
+        return true;
+    }
+
+    this->m_condition.wait(lock, [this, generation]() { return this->m_szGeneration != generation; });
+    return false;
+}
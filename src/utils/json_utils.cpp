@@ -0,0 +1,253 @@
+#include "utils/json_utils.hpp"
+
+#include <cctype>
+#include <cstdio>
+
+// MARK: -- Helpers
+
+// Skips whitespace
+static void skipSpace(const std::string& text, size_t& pos) {
+    while (pos < text.length() && std::isspace(static_cast<unsigned char>(text[pos])))
+        pos++;
+}
+
+// Appends a code point as UTF-8
+static void appendUtf8(std::string& str, unsigned long code) {
+
+    if (code < 0x80)
+        str += static_cast<char>(code);
+    else if (code < 0x800) {
+        str += static_cast<char>(0xC0 | (code >> 6));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else {
+        str += static_cast<char>(0xE0 | (code >> 12));
+        str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// Parses a string, starting at its opening quote
+static bool parseString(const std::string& text, size_t& pos, std::string& str, std::string& error) {
+
+    str.clear();
+    pos++;
+    while (pos < text.length() && text[pos] != '"') {
+
+        char c = text[pos++];
+        if (c != '\\') {
+            str += c;
+            continue;
+        }
+
+        if (pos == text.length())
+            break;
+
+        char escape = text[pos++];
+        switch (escape) {
+            case '"':   str += '"'; break;
+            case '\\':  str += '\\'; break;
+            case '/':   str += '/'; break;
+            case 'b':   str += '\b'; break;
+            case 'f':   str += '\f'; break;
+            case 'n':   str += '\n'; break;
+            case 'r':   str += '\r'; break;
+            case 't':   str += '\t'; break;
+            case 'u': {
+                if (pos + 4 > text.length() || !std::isxdigit(static_cast<unsigned char>(text[pos])) || !std::isxdigit(static_cast<unsigned char>(text[pos + 1]))
+                    || !std::isxdigit(static_cast<unsigned char>(text[pos + 2])) || !std::isxdigit(static_cast<unsigned char>(text[pos + 3]))) {
+                    error = "bad \\u escape";
+                    return false;
+                }
+                appendUtf8(str, std::stoul(text.substr(pos, 4), nullptr, 16));
+                pos += 4;
+                break;
+            }
+            default:
+                error = std::string("unknown escape \\") + escape;
+                return false;
+        }
+    }
+
+    if (pos == text.length()) {
+        error = "unterminated string";
+        return false;
+    }
+
+    pos++;
+    return true;
+}
+
+// Parses a value
+static bool parseValue(const std::string& text, size_t& pos, JsonUtils::Value& value, std::string& error) {
+
+    if (pos == text.length()) {
+        error = "missing value";
+        return false;
+    }
+
+    char c = text[pos];
+    if (c == '"') {
+        value.kind = JsonUtils::Value::Kind::STRING;
+        return parseString(text, pos, value.str, error);
+    }
+
+    // Only arrays of strings are needed
+    if (c == '[') {
+        value.kind = JsonUtils::Value::Kind::ARRAY;
+        pos++;
+        skipSpace(text, pos);
+        if (pos < text.length() && text[pos] == ']') {
+            pos++;
+            return true;
+        }
+
+        while (true) {
+            std::string item;
+            if (pos == text.length() || text[pos] != '"') {
+                error = "arrays may only hold strings";
+                return false;
+            }
+
+            if (!parseString(text, pos, item, error))
+                return false;
+            value.vecItems.push_back(item);
+
+            skipSpace(text, pos);
+            if (pos < text.length() && text[pos] == ',') {
+                pos++;
+                skipSpace(text, pos);
+                continue;
+            }
+
+            if (pos < text.length() && text[pos] == ']') {
+                pos++;
+                return true;
+            }
+
+            error = "expected , or ] in array";
+            return false;
+        }
+    }
+
+    if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+        size_t start = pos++;
+        while (pos < text.length() && (std::isdigit(static_cast<unsigned char>(text[pos])) || text[pos] == '.' || text[pos] == 'e'
+               || text[pos] == 'E' || text[pos] == '+' || text[pos] == '-'))
+            pos++;
+        value.kind = JsonUtils::Value::Kind::NUMBER;
+        value.str = text.substr(start, pos - start);
+        return true;
+    }
+
+    for (const char * word : { "true", "false", "null" }) {
+        std::string literal = word;
+        if (text.compare(pos, literal.length(), literal) != 0)
+            continue;
+
+        pos += literal.length();
+        value.kind = (literal == "null") ? JsonUtils::Value::Kind::NONE : JsonUtils::Value::Kind::BOOLEAN;
+        value.b = (literal == "true");
+        return true;
+    }
+
+    error = std::string("unexpected ") + c;
+    return false;
+}
+
+
+// MARK: -- Parsing Methods
+
+// Parses a flat object
+bool JsonUtils::parseObject(const std::string& text, std::unordered_map<std::string, Value>& object, std::string& error) {
+
+    object.clear();
+    size_t pos = 0;
+    skipSpace(text, pos);
+    if (pos == text.length() || text[pos] != '{') {
+        error = "expected an object";
+        return false;
+    }
+
+    pos++;
+    skipSpace(text, pos);
+    bool empty = pos < text.length() && text[pos] == '}';
+    if (empty)
+        pos++;
+
+    while (!empty) {
+
+        std::string key;
+        if (pos == text.length() || text[pos] != '"') {
+            error = "expected a key";
+            return false;
+        }
+
+        if (!parseString(text, pos, key, error))
+            return false;
+
+        skipSpace(text, pos);
+        if (pos == text.length() || text[pos] != ':') {
+            error = "expected : after \"" + key + "\"";
+            return false;
+        }
+
+        pos++;
+        skipSpace(text, pos);
+        Value value;
+        if (!parseValue(text, pos, value, error))
+            return false;
+        object[key] = value;
+
+        skipSpace(text, pos);
+        if (pos < text.length() && text[pos] == ',') {
+            pos++;
+            skipSpace(text, pos);
+            continue;
+        }
+
+        if (pos < text.length() && text[pos] == '}') {
+            pos++;
+            break;
+        }
+
+        error = "expected , or } in object";
+        return false;
+    }
+
+    skipSpace(text, pos);
+    if (pos != text.length()) {
+        error = "unexpected text after the object";
+        return false;
+    }
+
+    return true;
+}
+
+
+// MARK: -- Writing Methods
+
+// Quotes a string
+std::string JsonUtils::quote(const std::string& str) {
+
+    std::string quoted = "\"";
+    for (char c : str) {
+        switch (c) {
+            case '"':   quoted += "\\\""; break;
+            case '\\':  quoted += "\\\\"; break;
+            case '\n':  quoted += "\\n"; break;
+            case '\r':  quoted += "\\r"; break;
+            case '\t':  quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(c));
+                    quoted += escape;
+                }
+                else
+                    quoted += c;
+        }
+    }
+
+    return quoted + "\"";
+}
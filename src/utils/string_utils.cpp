@@ -65,4 +65,28 @@ std::string StringUtils::rtrim(std::string str) {
 // test non-copying string trims).
 std::string StringUtils::trim(std::string str) {
     return ltrim(rtrim(str));
-}
\ No newline at end of file
+}
+
+
+// MARK: -- Splitting Methods
+
+// Splits a string on a separator
+std::vector<std::string> StringUtils::split(const std::string& str, char separator) {
+
+    std::vector<std::string> pieces;
+    size_t start = 0;
+    while (start <= str.length()) {
+
+        size_t end = str.find(separator, start);
+        if (end == std::string::npos)
+            end = str.length();
+
+        std::string piece = trim(str.substr(start, end - start));
+        if (!piece.empty())
+            pieces.push_back(piece);
+
+        start = end + 1;
+    }
+
+    return pieces;
+}
@@ -0,0 +1,118 @@
+#include "utils/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// MARK: -- Construction
+
+// Constructor
+WorkStealingPool::WorkStealingPool(size_t threads, size_t window, bool pin)
+: m_szThreads(std::max<size_t>(threads, 1))
+, m_szWindow(std::max<size_t>(window, 1))
+, m_bPin(pin)
+, m_szOldest(0)
+, m_dwSteals(0)
+{ }
+
+
+// MARK: -- Execution Methods
+
+// Runs every task
+void WorkStealingPool::run(size_t count, const std::function<void(size_t)>& task) {
+
+    // Deal the tasks out, so each queue runs oldest first
+    this->m_vecQueues.assign(this->m_szThreads, std::deque<size_t>());
+    for (size_t index = 0; index < count; ++index)
+        this->m_vecQueues[index % this->m_szThreads].push_back(index);
+
+    this->m_vecFinished.assign(count, false);
+    this->m_szOldest = 0;
+    this->m_dwSteals = 0;
+
+    std::vector<std::thread> threads;
+    for (size_t worker = 0; worker < this->m_szThreads; ++worker)
+        threads.emplace_back(&WorkStealingPool::work, this, worker, std::cref(task));
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Returns the number of threads
+size_t WorkStealingPool::getThreads() const {
+    return this->m_szThreads;
+}
+
+// Returns the number of steals
+dword_t WorkStealingPool::getSteals() const {
+    return this->m_dwSteals;
+}
+
+// Returns the number of host threads
+size_t WorkStealingPool::getHostThreads() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+
+// MARK: -- Private Methods
+
+// Runs tasks on one thread
+void WorkStealingPool::work(size_t worker, const std::function<void(size_t)>& task) {
+
+#ifdef __linux__
+    // Anything the task starts (e.g. a child process) inherits the CPU
+    if (this->m_bPin) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(worker % getHostThreads(), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#endif
+
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+    size_t index = 0;
+    while (this->take(worker, index)) {
+
+        // The oldest task is always in a queue's front or already started, so the window always moves
+        this->m_condition.wait(lock, [this, index]() { return index < this->m_szOldest + this->m_szWindow; });
+
+        lock.unlock();
+        task(index);
+        lock.lock();
+
+        this->m_vecFinished[index] = true;
+        while (this->m_szOldest < this->m_vecFinished.size() && this->m_vecFinished[this->m_szOldest])
+            this->m_szOldest++;
+        this->m_condition.notify_all();
+    }
+}
+
+// Takes the next task
+bool WorkStealingPool::take(size_t worker, size_t& index) {
+
+    std::deque<size_t>& own = this->m_vecQueues[worker];
+    if (!own.empty()) {
+        index = own.front();
+        own.pop_front();
+        return true;
+    }
+
+    // Steal the oldest task anyone has left, which is the one holding up the window
+    std::deque<size_t> * victim = nullptr;
+    for (auto& queue : this->m_vecQueues) {
+        if (!queue.empty() && (victim == nullptr || queue.front() < victim->front()))
+            victim = &queue;
+    }
+
+    if (victim == nullptr)
+        return false;
+
+    index = victim->front();
+    victim->pop_front();
+    this->m_dwSteals++;
+    return true;
+}
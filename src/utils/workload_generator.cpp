@@ -0,0 +1,229 @@
+#include "utils/workload_generator.hpp"
+
+#include <algorithm>
+
+// MARK: -- Constants
+constexpr size_t WorkloadGenerator::MAX_NESTING;
+constexpr size_t WorkloadGenerator::MAX_BLOCK_SIZE;
+constexpr size_t WorkloadGenerator::DATA_CHUNK_SIZE;
+constexpr size_t WorkloadGenerator::NUM_WORK_REGISTERS;
+
+// Registers we rotate values through (temporaries only, so nothing else is disturbed)
+static const char * WORK_REGISTERS[WorkloadGenerator::NUM_WORK_REGISTERS] = {
+    "$8", "$9", "$10", "$11", "$12", "$13", "$14", "$15", "$24", "$25"
+};
+
+// The register holding the base address of the current data chunk
+static const std::string BASE_REGISTER = "$3";
+
+// The first loop counter register (one per nesting level, $16 - $23)
+static const size_t LOOP_REGISTER_START = 16;
+
+// Roughly how many bytes of source a statement takes, for sizing blocks by bytes
+static const size_t STATEMENT_BYTES = 24;
+
+
+// MARK: -- Construction
+
+// Constructor
+WorkloadGenerator::WorkloadGenerator(const Options& options)
+: m_options(options)
+, m_rng(options.wSeed)
+, m_ptrOut(nullptr)
+, m_szProduced(0)
+, m_szLabels(0)
+{
+    // Clamp everything into something we can actually generate
+    this->m_options.szNesting = std::min(this->m_options.szNesting, MAX_NESTING);
+    this->m_options.szIterations = std::max<size_t>(std::min<size_t>(this->m_options.szIterations, 0x7FFF), 1);
+    this->m_options.szBlockSize = std::max<size_t>(std::min(this->m_options.szBlockSize, MAX_BLOCK_SIZE), 1);
+    this->m_options.dBranchDensity = std::max(std::min(this->m_options.dBranchDensity, 1.0), 0.0);
+    this->m_options.dLoadDensity = std::max(std::min(this->m_options.dLoadDensity, 1.0), 0.0);
+    this->m_options.szDependencyDistance = std::max<size_t>(std::min(this->m_options.szDependencyDistance, NUM_WORK_REGISTERS), 1);
+}
+
+
+// MARK: -- Generation Methods
+
+// Returns the options
+const WorkloadGenerator::Options& WorkloadGenerator::getOptions() const {
+    return this->m_options;
+}
+
+// Generates a program
+WorkloadGenerator::Summary WorkloadGenerator::generate(std::ostream& out) {
+
+    // Start fresh every time, so the same generator always gives the same program
+    this->m_rng.seed(this->m_options.wSeed);
+    this->m_ptrOut = &out;
+    this->m_summary = Summary();
+    this->m_szProduced = 0;
+    this->m_szLabels = 0;
+
+    const Options& options = this->m_options;
+    this->emit("# generated workload: " + std::to_string(options.szInstructions) + " statements, nesting "
+        + std::to_string(options.szNesting) + ", " + std::to_string(options.szIterations) + " iterations, block "
+        + std::to_string(options.szBlockSize) + ", seed " + std::to_string(options.wSeed), false);
+
+    this->emit(".text", false);
+    this->emit("main:", false);
+
+    // Every block needs its loop scaffolding (and a base address if it loads), and
+    // the program needs two statements to exit
+    bool loads = options.dLoadDensity > 0.0 && options.szDataSize > 0;
+    size_t overhead = 4 * options.szNesting + (loads ? 1 : 0);
+
+    // Keep adding blocks until we have used our budget (always at least one)
+    size_t block = 0;
+    do {
+        size_t used = this->m_summary.szInstructions + overhead + 2;
+        size_t remaining = (used < options.szInstructions) ? options.szInstructions - used : 0;
+        if (options.szTargetBytes > 0)
+            remaining = (this->m_summary.szBytes < options.szTargetBytes) ? (options.szTargetBytes - this->m_summary.szBytes) / STATEMENT_BYTES : 0;
+
+        this->emitBlock(block++, std::max<size_t>(std::min(remaining, options.szBlockSize), 1));
+    } while (!this->isDone());
+
+    this->emit("    li      $2, 10");
+    this->emit("    syscall");
+
+    // Now the data, split into chunks each reachable from a single base register
+    if (options.szDataSize > 0) {
+
+        this->emit("", false);
+        this->emit(".data", false);
+
+        size_t chunks = (options.szDataSize + DATA_CHUNK_SIZE - 1) / DATA_CHUNK_SIZE;
+        for (size_t i = 0; i < chunks; ++i) {
+            size_t size = std::min(DATA_CHUNK_SIZE, options.szDataSize - i * DATA_CHUNK_SIZE);
+            this->emit("buf" + std::to_string(i) + ": .space " + std::to_string(size), false);
+        }
+    }
+
+    this->m_ptrOut = nullptr;
+    return this->m_summary;
+}
+
+
+// MARK: -- Private Methods
+
+// Writes a line
+void WorkloadGenerator::emit(const std::string& line, bool statement) {
+
+    (*this->m_ptrOut) << line << '\n';
+    this->m_summary.szLines++;
+    this->m_summary.szBytes += line.length() + 1;
+    if (statement)
+        this->m_summary.szInstructions++;
+}
+
+// Writes a single block
+void WorkloadGenerator::emitBlock(size_t block, size_t budget) {
+
+    const Options& options = this->m_options;
+    std::string prefix = "blk" + std::to_string(block);
+
+    // Point the base register at this block's chunk of data
+    size_t chunkSize = 0;
+    if (options.dLoadDensity > 0.0 && options.szDataSize > 0) {
+
+        size_t chunks = (options.szDataSize + DATA_CHUNK_SIZE - 1) / DATA_CHUNK_SIZE;
+        size_t chunk = block % chunks;
+        chunkSize = std::min(DATA_CHUNK_SIZE, options.szDataSize - chunk * DATA_CHUNK_SIZE);
+
+        // la expands into two instructions, but it is still a single statement
+        this->emit("    la      " + BASE_REGISTER + ", buf" + std::to_string(chunk));
+    }
+
+    // Open each loop, resetting the inner counters on every outer iteration
+    for (size_t level = 0; level < options.szNesting; ++level) {
+        this->emit("    li      $" + std::to_string(LOOP_REGISTER_START + level) + ", " + std::to_string(options.szIterations));
+        this->emit(prefix + "_l" + std::to_string(level) + ":", false);
+    }
+
+    // Write the body
+    size_t written = 0;
+    while (written < budget) {
+
+        // Branch forward over a few statements (which need to fit in the block)
+        if (budget - written > 1 && this->randomFraction() < options.dBranchDensity) {
+
+            std::string label = prefix + "_f" + std::to_string(this->m_szLabels++);
+            std::string src1 = workRegister(this->random(NUM_WORK_REGISTERS));
+            std::string src2 = workRegister(this->random(NUM_WORK_REGISTERS));
+            this->emit(std::string(this->random(2) == 0 ? "    beq     " : "    bne     ") + src1 + ", " + src2 + ", " + label);
+            written++;
+
+            size_t skip = std::min<size_t>(1 + this->random(3), budget - written);
+            for (size_t i = 0; i < skip; ++i)
+                this->emitOperation(chunkSize);
+            written += skip;
+
+            this->emit(label + ":", false);
+            continue;
+        }
+
+        this->emitOperation(chunkSize);
+        written++;
+    }
+
+    // Close each loop, innermost first
+    for (size_t level = options.szNesting; level > 0; --level) {
+        std::string counter = "$" + std::to_string(LOOP_REGISTER_START + level - 1);
+        this->emit("    subi    " + counter + ", " + counter + ", 1");
+        this->emit("    bne     " + counter + ", $0, " + prefix + "_l" + std::to_string(level - 1));
+        this->emit("    nop");
+    }
+
+    this->m_summary.szBlocks++;
+}
+
+// Writes a single ALU or load statement
+void WorkloadGenerator::emitOperation(size_t chunkSize) {
+
+    // Our destination rotates through the working registers, and our first operand is
+    // whatever was produced the requested distance ago
+    size_t distance = this->m_options.szDependencyDistance;
+    std::string dest = workRegister(this->m_szProduced);
+    std::string src1 = workRegister(this->m_szProduced + NUM_WORK_REGISTERS - distance);
+    std::string src2 = workRegister(this->random(NUM_WORK_REGISTERS));
+    this->m_szProduced++;
+
+    if (chunkSize > 0 && this->randomFraction() < this->m_options.dLoadDensity) {
+        this->emit("    lb      " + dest + ", " + std::to_string(this->random(static_cast<word_t>(chunkSize))) + "(" + BASE_REGISTER + ")");
+        return;
+    }
+
+    switch (this->random(6)) {
+        case 0:     this->emit("    add     " + dest + ", " + src1 + ", " + src2); break;
+        case 1:     this->emit("    slt     " + dest + ", " + src1 + ", " + src2); break;
+        case 2:     this->emit("    addi    " + dest + ", " + src1 + ", " + std::to_string(static_cast<sword_t>(this->random(512)) - 256)); break;
+        case 3:     this->emit("    ori     " + dest + ", " + src1 + ", " + std::to_string(this->random(0x8000))); break;
+        case 4:     this->emit("    sll     " + dest + ", " + src1 + ", " + std::to_string(this->random(32))); break;
+        default:    this->emit("    subi    " + dest + ", " + src1 + ", " + std::to_string(this->random(256))); break;
+    }
+}
+
+// Returns whether or not we are done
+bool WorkloadGenerator::isDone() const {
+
+    if (this->m_options.szTargetBytes > 0)
+        return this->m_summary.szBytes >= this->m_options.szTargetBytes;
+
+    return this->m_summary.szInstructions + 2 >= this->m_options.szInstructions;
+}
+
+// Returns a random number in [0, bound)
+word_t WorkloadGenerator::random(word_t bound) {
+    return static_cast<word_t>(this->m_rng() % bound);
+}
+
+// Returns a random number in [0, 1)
+double WorkloadGenerator::randomFraction() {
+    return static_cast<double>(this->m_rng()) / (static_cast<double>(std::mt19937::max()) + 1.0);
+}
+
+// Returns the name of a working register
+std::string WorkloadGenerator::workRegister(size_t index) {
+    return WORK_REGISTERS[index % NUM_WORK_REGISTERS];
+}
@@ -0,0 +1,226 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "batch_runner.hpp"
+
+/**
+ * Class: BatchRunner
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      jobs are parsed from lines of JSON, named by their line unless given an id
+ *      a run's output, statistics and fault are read back from what it printed
+ *      output read a piece at a time, longer than the tail kept, gives the same result
+ *      results are written as one line of JSON each
+ *      a batch gives the same results, in job order, on one thread or several
+ *      a job that faults is a trap, typed by the signal it names, and one that takes too long is killed
+ *
+ * Invalid Tests:
+ *      jobs without a program, with unknown fields or with bad counts are rejected
+ *      a runner without an executable throws
+ *      a job whose executable cannot be run is an error
+ */
+TEST_CASE("Batch runs parse jobs, run them and report their results", "[batch]") {
+
+    SECTION("Jobs are parsed from JSON") {
+
+        BatchRunner::Job job;
+        std::string error;
+        REQUIRE(BatchRunner::parseJob("{\"program\": \"a.asm\", \"input\": \"in.txt\", \"options\": [\"--peephole\"], \"max_cycles\": 100, \"timeout_ms\": 5}", 3, job, error));
+        REQUIRE(job.strId == "3");
+        REQUIRE(job.strProgram == "a.asm");
+        REQUIRE(job.strInput == "in.txt");
+        REQUIRE(job.vecOptions == std::vector<std::string>({ "--peephole" }));
+        REQUIRE(job.dwMaxCycles == 100);
+        REQUIRE(job.dwTimeoutMs == 5);
+
+        REQUIRE(BatchRunner::parseJob("{\"id\": \"fib\", \"program\": \"b.asm\"}", 4, job, error));
+        REQUIRE(job.strId == "fib");
+        REQUIRE(job.vecOptions.empty());
+        REQUIRE(job.dwMaxCycles == 0);
+    }
+
+    SECTION("Bad jobs are rejected") {
+
+        BatchRunner::Job job;
+        std::string error;
+        REQUIRE_FALSE(BatchRunner::parseJob("{\"input\": \"in.txt\"}", 1, job, error));
+        REQUIRE_FALSE(BatchRunner::parseJob("{\"program\": \"a.asm\", \"cycles\": 5}", 1, job, error));
+        REQUIRE_FALSE(BatchRunner::parseJob("{\"program\": \"a.asm\", \"max_cycles\": -5}", 1, job, error));
+        REQUIRE_FALSE(BatchRunner::parseJob("{\"program\": \"a.asm\", \"max_cycles\": 123456789012345678901}", 1, job, error));
+        REQUIRE(error.find("max_cycles") != std::string::npos);
+        REQUIRE_FALSE(BatchRunner::parseJob("{\"program\": 5}", 1, job, error));
+        REQUIRE_FALSE(BatchRunner::parseJob("program=a.asm", 1, job, error));
+    }
+
+    SECTION("A finished run's output and statistics are read back") {
+
+        BatchRunner::Result result;
+        result.status = BatchRunner::Status::OK;
+        BatchRunner::parseOutput("[info] Running Simulator...\n\nOutput:\n------------\nhello\n------------\n\n"
+                                 "[2024-01-01 00:00:00.000] [multi_sink] [info] Total Clock Cycles: 42\n"
+                                 "[2024-01-01 00:00:00.000] [multi_sink] [info] Total Branch Forwards (ID): 3, costing 2 stall cycles\n", result);
+
+        REQUIRE(result.dwOutputBytes == 6);
+        REQUIRE(result.vecCounters.size() == 2);
+        REQUIRE(result.vecCounters[0].first == "clock_cycles");
+        REQUIRE(result.vecCounters[0].second == 42);
+        REQUIRE(result.vecCounters[1].first == "branch_forwards_id");
+        REQUIRE(result.vecCounters[1].second == 3);
+        REQUIRE(result.strTrap.empty());
+
+        // The hash covers only the program's own output
+        BatchRunner::Result other;
+        other.status = BatchRunner::Status::OK;
+        BatchRunner::parseOutput("Output:\n------------\nhello\n------------\nTotal Clock Cycles: 7\n", other);
+        REQUIRE(other.dwOutputHash == result.dwOutputHash);
+    }
+
+    SECTION("A faulting run's fault is read back") {
+
+        BatchRunner::Result result;
+        result.status = BatchRunner::Status::TRAP;
+        BatchRunner::parseOutput("Output:\n------------\nhi\n[2024-01-01 00:00:00.000] [multi_sink] [critical] SIGSEGV: Bad address 0x0\n", result);
+
+        REQUIRE(result.dwOutputBytes == 3);
+        REQUIRE(result.vecCounters.empty());
+        REQUIRE(result.strTrap == "SIGSEGV: Bad address 0x0");
+        REQUIRE(result.strSignal == "SIGSEGV");
+
+        // A fault that names no signal has none
+        BatchRunner::Result other;
+        other.status = BatchRunner::Status::TRAP;
+        BatchRunner::parseOutput("Unable to open file a.asm\n", other);
+        REQUIRE(other.strTrap == "Unable to open file a.asm");
+        REQUIRE(other.strSignal.empty());
+    }
+
+    SECTION("Output read a piece at a time gives the same result") {
+
+        // The program prints a rule of its own, and more than the parser keeps
+        std::string program = "------------\n" + std::string(3 * BatchRunner::OutputParser::TAIL_BYTES, 'x') + "\n";
+        std::string output = "Output:\n------------\n" + program + "------------\n"
+                             "[2024-01-01 00:00:00.000] [multi_sink] [info] Total Clock Cycles: 42\n";
+
+        BatchRunner::Result whole;
+        whole.status = BatchRunner::Status::OK;
+        BatchRunner::parseOutput(output, whole);
+
+        BatchRunner::OutputParser parser;
+        for (size_t pos = 0; pos < output.length(); pos += 7)
+            parser.append(output.data() + pos, std::min<size_t>(7, output.length() - pos));
+
+        BatchRunner::Result result;
+        result.status = BatchRunner::Status::OK;
+        parser.finish(result);
+
+        REQUIRE(parser.getLength() == output.length());
+        REQUIRE(result.dwOutputBytes == program.length());
+        REQUIRE(result.dwOutputHash == whole.dwOutputHash);
+        REQUIRE(result.vecCounters.size() == 1);
+        REQUIRE(result.vecCounters[0].second == 42);
+
+        // A fault after a long line is still read back
+        BatchRunner::OutputParser faulted;
+        std::string cut = "Output:\n------------\n" + std::string(3 * BatchRunner::OutputParser::TAIL_BYTES, 'x') + "\nSIGSEGV: Bad address 0x0\n";
+        faulted.append(cut.data(), cut.length());
+        result = BatchRunner::Result();
+        result.status = BatchRunner::Status::TRAP;
+        faulted.finish(result);
+        REQUIRE(result.strSignal == "SIGSEGV");
+        REQUIRE(result.dwOutputBytes == 3 * BatchRunner::OutputParser::TAIL_BYTES + 1);
+    }
+
+    SECTION("Results are written as JSON") {
+
+        BatchRunner::Result result;
+        result.szJob = 2;
+        result.strId = "fib";
+        result.status = BatchRunner::Status::OK;
+        result.vecCounters.emplace_back("clock_cycles", 42);
+        result.dwOutputHash = 0xabc;
+        result.dwOutputBytes = 6;
+
+        std::ostringstream stream;
+        BatchRunner::writeResult(stream, result);
+        REQUIRE(stream.str() == "{\"job\": 2, \"id\": \"fib\", \"status\": \"ok\", \"exit_code\": 0, \"cycles\": 42, \"counters\": {\"clock_cycles\": 42}, "
+                                "\"output_hash\": \"0000000000000abc\", \"output_bytes\": 6, \"trap\": null, \"signal\": null}\n");
+    }
+
+    SECTION("A batch gives the same results on any number of threads") {
+
+        // The shell stands in for the simulator, printing as a run would
+        std::vector<BatchRunner::Job> jobs;
+        for (size_t i = 0; i < 12; ++i) {
+            BatchRunner::Job job;
+            job.strId = std::to_string(i);
+            job.strProgram = "-c";
+            job.vecOptions.push_back("sleep 0.0" + std::to_string(i % 3) + "; printf 'Output:\\n------------\\n" + std::to_string(i)
+                                     + "\\n------------\\nTotal Clock Cycles: " + std::to_string(i * 10) + "\\n'");
+            if (i == 5)
+                job.vecOptions[0] = "printf 'Output:\\n------------\\nSIGLOOP: Livelock at 0x1000\\n'; exit 1";
+            jobs.push_back(job);
+        }
+
+        std::vector<std::string> outputs;
+        for (size_t threads : { 1, 4 }) {
+            BatchRunner::Config config;
+            config.strExecutable = "/bin/sh";
+            config.szThreads = threads;
+            config.szWindow = 2;
+            config.bDetectLivelock = false;
+
+            std::ostringstream stream;
+            BatchRunner::Stats stats = BatchRunner(config).run(jobs, stream);
+            REQUIRE(stats.dwJobs == 12);
+            REQUIRE(stats.dwOk == 11);
+            REQUIRE(stats.dwTraps == 1);
+            REQUIRE(stats.dwLivelocks == 1);
+            REQUIRE(stats.dwCycleLimits == 0);
+            outputs.push_back(stream.str());
+        }
+
+        REQUIRE(outputs[0] == outputs[1]);
+        REQUIRE(outputs[0].find("{\"job\": 0,") == 0);
+        REQUIRE(outputs[0].find("\"cycles\": 110") != std::string::npos);
+        REQUIRE(outputs[0].find("\"status\": \"trap\", \"exit_code\": 1, \"cycles\": null") != std::string::npos);
+        REQUIRE(outputs[0].find("\"trap\": \"SIGLOOP: Livelock at 0x1000\", \"signal\": \"SIGLOOP\"") != std::string::npos);
+    }
+
+    SECTION("A job that takes too long is killed") {
+
+        BatchRunner::Config config;
+        config.strExecutable = "/bin/sleep";
+        config.szThreads = 1;
+        config.dwTimeoutMs = 50;
+        config.bDetectLivelock = false;
+
+        BatchRunner::Job job;
+        job.strProgram = "5";
+
+        std::ostringstream stream;
+        BatchRunner::Stats stats = BatchRunner(config).run({ job }, stream);
+        REQUIRE(stats.dwTimeouts == 1);
+        REQUIRE(stream.str().find("\"status\": \"timeout\"") != std::string::npos);
+        REQUIRE(stream.str().find("\"trap\": \"timed out after 50 ms\"") != std::string::npos);
+    }
+
+    SECTION("Jobs that cannot run are errors, and a runner needs an executable") {
+
+        BatchRunner::Config config;
+        config.strExecutable = "/nonexistent/pipeSim";
+        BatchRunner::Job job;
+        job.strProgram = "a.asm";
+
+        std::ostringstream stream;
+        REQUIRE(BatchRunner(config).run({ job }, stream).dwErrors == 1);
+        REQUIRE(stream.str().find("\"status\": \"error\"") != std::string::npos);
+
+        REQUIRE_THROWS_AS(BatchRunner(BatchRunner::Config()), std::invalid_argument);
+    }
+}
@@ -0,0 +1,134 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "decoupled_simulator.hpp"
+#include "simulator.hpp"
+
+// Sums a string of bytes, using each load straight away
+static const char * SUM_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, values\n"
+    "    li $5, 0\n"
+    "    li $6, 6\n"
+    "loop:\n"
+    "    lb $7, 0($4)\n"
+    "    add $5, $5, $7\n"
+    "    addi $4, $4, 1\n"
+    "    subi $6, $6, 1\n"
+    "    bne $6, $0, loop\n"
+    "    la $4, total\n"
+    "    sb $5, 0($4)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "values: .asciiz \"abcdef\"\n"
+    "total: .space 1\n";
+
+/**
+ * Loads the test program.
+ * @param instrSet A placeholder for the instruction set
+ * @param reader The reader, to find symbols with
+ * @return The loaded memory
+ */
+static std::shared_ptr<Memory> loadProgram(std::unique_ptr<InstructionSet>& instrSet, FileReader& reader) {
+    instrSet = InstructionSetFactory::createDefault();
+    return ProgramLoader::load(SUM_PROGRAM, *instrSet.get(), reader);
+}
+
+/**
+ * Class: DecoupledSimulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      the front end runs the program exactly as the simulator does
+ *      the back end charges load-use stalls and mispredicted branches
+ *      running both halves in parallel gives the same results as running them in turn
+ *      wrong paths are decoded from the text segment
+ *
+ * Invalid Tests:
+ *      wrong paths stop at the end of the text segment
+ */
+TEST_CASE("Decoupled runs time the instructions the front end runs", "[decoupled]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> reference = loadProgram(instrSet, reader);
+    Simulator simulator(std::move(instrSet), reference, std::unique_ptr<RegisterBank>(new RegisterBank()));
+    simulator.run();
+
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader);
+    DecoupledSimulator decoupled(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+    decoupled.setParallel(false);
+    decoupled.run();
+
+    SECTION("The front end runs the program exactly as the simulator does") {
+
+        REQUIRE(decoupled.getFunctionalStats().dwInstructions == simulator.getStats().dwInstructions);
+
+        byte_t expected = 0, total = 0;
+        reference->readByte(reader.getSymbols().at("total"), expected);
+        memory->readByte(reader.getSymbols().at("total"), total);
+        REQUIRE(total == expected);
+        REQUIRE(total == static_cast<byte_t>('a' + 'b' + 'c' + 'd' + 'e' + 'f'));
+    }
+
+    SECTION("The back end charges load-use stalls and mispredicted branches") {
+
+        const TimingModel::Stats& timing = decoupled.getTimingStats();
+        REQUIRE(timing.dwInstructions == decoupled.getFunctionalStats().dwInstructions);
+        REQUIRE(timing.dwLoadUseStalls == 6);
+        REQUIRE(timing.dwBranches == 6);
+        REQUIRE(timing.dwMispredictions >= 1);
+        REQUIRE(timing.dwWrongPathRecords == timing.dwMispredictions);
+        REQUIRE(timing.dwCycles > timing.dwInstructions + timing.dwLoadUseStalls);
+    }
+
+    SECTION("Running both halves in parallel gives the same results as running them in turn") {
+
+        TimingModel::Stats sequential = decoupled.getTimingStats();
+        for (int run = 0; run < 3; ++run) {
+
+            std::shared_ptr<Memory> parallelMemory = loadProgram(instrSet, reader);
+            DecoupledSimulator parallel(std::move(instrSet), parallelMemory, std::unique_ptr<RegisterBank>(new RegisterBank()),
+                                        TimingModel::Config(), 4);
+            REQUIRE(parallel.isParallel() == true);
+            parallel.run();
+
+            REQUIRE(parallel.getTimingStats().dwCycles == sequential.dwCycles);
+            REQUIRE(parallel.getTimingStats().dwMispredictions == sequential.dwMispredictions);
+            REQUIRE(parallel.getTimingStats().dwLoadUseStalls == sequential.dwLoadUseStalls);
+        }
+    }
+
+    SECTION("Wrong paths are decoded from the text segment, and stop at its end") {
+
+        std::vector<RetireRecord> records;
+        decoupled.decodeWrongPath(reader.getSymbols().at("loop"), 2, records);
+        REQUIRE(records.size() == 2);
+        REQUIRE(records[0].bLoad == true);
+        REQUIRE(records[0].bWrongPath == true);
+        REQUIRE(records[1].wPC == reader.getSymbols().at("loop") + 4);
+
+        records.clear();
+        decoupled.decodeWrongPath(Memory::MEM_USER_START + memory->getTextSize() - 4, 3, records);
+        REQUIRE(records.size() == 1);
+    }
+
+    spdlog::set_level(level);
+}
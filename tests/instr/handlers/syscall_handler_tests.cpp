@@ -0,0 +1,429 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "instr/handlers/syscall_handler.hpp"
+#include "instr/syscalls.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/instruction_decode_buffer.hpp"
+#include "registers/register_bank.hpp"
+
+// MARK: -- Helper Methods
+
+/**
+ * Runs a system call through the handler the same way the decode stage does.
+ * @param handler The handler
+ * @param registerBank The register bank (with $v0 / $a0-$a3 already set)
+ * @param memory The memory
+ * @return The decode buffer after the call
+ */
+static InstructionDecodeBuffer runSyscall(SyscallHandler& handler, RegisterBank& registerBank, Memory& memory) {
+
+    InstructionDecodeBuffer buffer = {};
+    Memory::addr_t PC = Memory::MEM_USER_START;
+    handler.onDecode(buffer, registerBank, memory, PC);
+    return buffer;
+}
+
+
+/**
+ * Method: SyscallHandler::registerSyscall(..)
+ * Desired Confidence Level: Boundary value analysis
+ * 
+ * Valid Tests:
+ *      code        -> nominal value (100)
+ *                     max value (LIMIT_SYSCALL)
+ *                     existing value (replaces the old call)
+ * 
+ * Invalid Tests:
+ *      code one above the max value
+ *      null implementation
+ */
+TEST_CASE("Registering system calls works properly", "[syscall]") {
+
+    SyscallHandler handler;
+    RegisterBank registerBank;
+    Memory memory(0x100, 0x100);
+
+    SECTION("default SPIM / MARS system calls are registered") {
+
+        REQUIRE(handler.hasSyscall(static_cast<word_t>(Syscalls::SYSCALL_PRINT_INT)) == true);
+        REQUIRE(handler.hasSyscall(static_cast<word_t>(Syscalls::SYSCALL_SBRK)) == true);
+        REQUIRE(handler.hasSyscall(static_cast<word_t>(Syscalls::SYSCALL_TIME)) == true);
+        REQUIRE(handler.hasSyscall(2) == false);
+    }
+
+    SECTION("registering a nominal and max code dispatches to it") {
+
+        word_t seen = 0;
+        REQUIRE(handler.registerSyscall(100, "custom", [&seen](SyscallContext& context) {
+            seen = context.getArgument(0);
+            context.setResult(0x55);
+        }) == true);
+        REQUIRE(handler.registerSyscall(SyscallHandler::LIMIT_SYSCALL, "max", [](SyscallContext& context) { context.requestExit(); }) == true);
+
+        registerBank.writeRegister(2, 100);
+        registerBank.writeRegister(4, 42);
+        InstructionDecodeBuffer buffer = runSyscall(handler, registerBank, memory);
+
+        word_t result;
+        registerBank.readRegister(2, result);
+        REQUIRE(seen == 42);
+        REQUIRE(result == 0x55);
+        REQUIRE(buffer.bExit == false);
+
+        registerBank.writeRegister(2, SyscallHandler::LIMIT_SYSCALL);
+        REQUIRE(runSyscall(handler, registerBank, memory).bExit == true);
+    }
+
+    SECTION("registering over an existing code replaces it") {
+
+        REQUIRE(handler.registerSyscall(static_cast<word_t>(Syscalls::SYSCALL_EXIT), "noexit", [](SyscallContext& context) { }) == true);
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_EXIT));
+        REQUIRE(runSyscall(handler, registerBank, memory).bExit == false);
+    }
+
+    SECTION("registering an out of bounds code or null implementation fails") {
+
+        REQUIRE(handler.registerSyscall(SyscallHandler::LIMIT_SYSCALL + 1, "bad", [](SyscallContext& context) { }) == false);
+        REQUIRE(handler.registerSyscall(50, "null", nullptr) == false);
+        REQUIRE(handler.hasSyscall(50) == false);
+    }
+}
+
+
+/**
+ * Built-in system calls that do not need console input.
+ */
+TEST_CASE("Built-in system calls work properly", "[syscall]") {
+
+    SyscallHandler handler;
+    RegisterBank registerBank;
+    Memory memory(0x100, 0x100);
+
+    SECTION("sbrk returns the old break and grows memory") {
+
+        Memory::addr_t end = Memory::MEM_USER_START + memory.getTotalSize();
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_SBRK));
+        registerBank.writeRegister(4, 0x40);
+        runSyscall(handler, registerBank, memory);
+
+        word_t result;
+        registerBank.readRegister(2, result);
+        REQUIRE(result == end);
+        REQUIRE(memory.writeWord(end + 0x3C, 0xDEADBEEF) == true);
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_SBRK));
+        registerBank.writeRegister(4, 0x10);
+        runSyscall(handler, registerBank, memory);
+
+        registerBank.readRegister(2, result);
+        REQUIRE(result == end + 0x40);
+    }
+
+    SECTION("time writes the 64-bit millisecond count to $a0 / $a1") {
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_TIME));
+        runSyscall(handler, registerBank, memory);
+
+        word_t low, high;
+        registerBank.readRegister(4, low);
+        registerBank.readRegister(5, high);
+        REQUIRE((low != 0 || high != 0));
+    }
+
+    SECTION("core_id returns the id of the core the handler serves") {
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_CORE_ID));
+        runSyscall(handler, registerBank, memory);
+
+        word_t result;
+        registerBank.readRegister(2, result);
+        REQUIRE(result == 0);
+
+        handler.setCoreId(3);
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_CORE_ID));
+        runSyscall(handler, registerBank, memory);
+
+        registerBank.readRegister(2, result);
+        REQUIRE(result == 3);
+        REQUIRE(handler.getCoreId() == 3);
+    }
+
+    SECTION("open / write / read / close round trip through a host file") {
+
+        std::string path = "pipesim_syscall_test.tmp";
+        Memory::addr_t pathAddr = 0x1100;
+        Memory::addr_t dataAddr = 0x1120;
+        Memory::addr_t readAddr = 0x1160;
+        std::string data = "hello from the guest";
+
+        memory.writeBlock(pathAddr, reinterpret_cast<const byte_t *>(path.c_str()), path.length() + 1);
+        memory.writeBlock(dataAddr, reinterpret_cast<const byte_t *>(data.c_str()), data.length());
+
+        // Open for writing
+        word_t fd;
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_OPEN));
+        registerBank.writeRegister(4, pathAddr);
+        registerBank.writeRegister(5, 1);
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, fd);
+        REQUIRE(fd == 3);
+
+        // Write
+        word_t count;
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_WRITE));
+        registerBank.writeRegister(4, fd);
+        registerBank.writeRegister(5, dataAddr);
+        registerBank.writeRegister(6, data.length());
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, count);
+        REQUIRE(count == data.length());
+
+        // Close (the descriptor is then reused)
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_CLOSE));
+        registerBank.writeRegister(4, fd);
+        runSyscall(handler, registerBank, memory);
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_OPEN));
+        registerBank.writeRegister(4, pathAddr);
+        registerBank.writeRegister(5, 0);
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, fd);
+        REQUIRE(fd == 3);
+
+        // Read more than is there
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ));
+        registerBank.writeRegister(4, fd);
+        registerBank.writeRegister(5, readAddr);
+        registerBank.writeRegister(6, 0x40);
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, count);
+        REQUIRE(count == data.length());
+
+        std::string readBack(data.length(), '\0');
+        memory.readBlock(readAddr, reinterpret_cast<byte_t *>(&readBack[0]), readBack.length());
+        REQUIRE(readBack == data);
+
+        std::remove(path.c_str());
+    }
+
+    SECTION("reading from or writing to a closed descriptor fails") {
+
+        word_t result;
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ));
+        registerBank.writeRegister(4, 7);
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, result);
+        REQUIRE(result == static_cast<word_t>(-1));
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_WRITE));
+        registerBank.writeRegister(4, 7);
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, result);
+        REQUIRE(result == static_cast<word_t>(-1));
+    }
+}
+
+
+/**
+ * Input feeds and record / replay.
+ */
+TEST_CASE("System calls can be fed, recorded and replayed", "[syscall]") {
+
+    RegisterBank registerBank;
+    Memory memory(0x100, 0x100);
+
+    SECTION("queued input is read before the (disabled) fallback") {
+
+        SyscallHandler handler;
+        handler.getInputFeed().setFallback(nullptr);
+        handler.getInputFeed().queueInput("  42 hello");
+        handler.getInputFeed().queueInput("world");
+
+        word_t result;
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_INT));
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, result);
+        REQUIRE(result == 42);
+
+        // Tokens carry on across queued chunks
+        std::string str;
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_STRING));
+        registerBank.writeRegister(4, 0x1100);
+        registerBank.writeRegister(5, 0x20);
+        runSyscall(handler, registerBank, memory);
+        memory.readString(0x1100, str);
+        REQUIRE(str == "helloworld");
+
+        // And then the input runs out
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_CHAR));
+        runSyscall(handler, registerBank, memory);
+        registerBank.readRegister(2, result);
+        REQUIRE(result == static_cast<word_t>(-1));
+    }
+
+    SECTION("read_string truncates to the buffer size") {
+
+        SyscallHandler handler;
+        handler.getInputFeed().setFallback(nullptr);
+        handler.getInputFeed().queueInput("abcdefgh");
+
+        std::string str;
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_STRING));
+        registerBank.writeRegister(4, 0x1100);
+        registerBank.writeRegister(5, 4);
+        runSyscall(handler, registerBank, memory);
+        memory.readString(0x1100, str);
+        REQUIRE(str == "abc");
+    }
+
+    SECTION("a recorded run replays without any input") {
+
+        std::shared_ptr<SyscallLog> log(new SyscallLog());
+
+        SyscallHandler recorder;
+        recorder.getInputFeed().setFallback(nullptr);
+        recorder.getInputFeed().queueInput("7 pal");
+        recorder.setRecordLog(log);
+
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_INT));
+        runSyscall(recorder, registerBank, memory);
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_PRINT_INT));
+        runSyscall(recorder, registerBank, memory);
+        registerBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_STRING));
+        registerBank.writeRegister(4, 0x1100);
+        registerBank.writeRegister(5, 0x10);
+        runSyscall(recorder, registerBank, memory);
+        REQUIRE(log->size() == 3);
+        REQUIRE(log->at(0).vecRegisters.size() == 1);
+        REQUIRE(log->at(2).vecMemory.size() == 1);
+
+        // Replay into a fresh machine with nothing to read
+        RegisterBank replayBank;
+        Memory replayMemory(0x100, 0x100);
+        SyscallHandler replayer;
+        replayer.getInputFeed().setFallback(nullptr);
+        replayer.setReplayLog(log);
+
+        word_t result;
+        replayBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_INT));
+        runSyscall(replayer, replayBank, replayMemory);
+        replayBank.readRegister(2, result);
+        REQUIRE(result == 7);
+
+        replayBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_PRINT_INT));
+        runSyscall(replayer, replayBank, replayMemory);
+
+        std::string str;
+        replayBank.writeRegister(2, static_cast<word_t>(Syscalls::SYSCALL_READ_STRING));
+        replayBank.writeRegister(4, 0x1100);
+        replayBank.writeRegister(5, 0x10);
+        runSyscall(replayer, replayBank, replayMemory);
+        replayMemory.readString(0x1100, str);
+        REQUIRE(str == "pal");
+    }
+
+    SECTION("a log round trips through a file") {
+
+        std::string path = "pipesim_syscall_log_test.tmp";
+        {
+            std::shared_ptr<SyscallLog> log(new SyscallLog());
+            REQUIRE(log->openForRecording(path) == true);
+
+            SyscallLog::Entry entry;
+            entry.wCode = 14;
+            entry.vecRegisters.emplace_back(2, 3);
+            entry.vecMemory.push_back({ 0x1100, { 'a', 'b', 'c' } });
+            log->append(entry);
+
+            entry = SyscallLog::Entry();
+            entry.wCode = 10;
+            entry.bExit = true;
+            log->append(entry);
+        }
+
+        SyscallLog loaded;
+        REQUIRE(loaded.load(path) == true);
+        REQUIRE(loaded.size() == 2);
+        REQUIRE(loaded.at(0).wCode == 14);
+        REQUIRE(loaded.at(0).vecRegisters[0].second == 3);
+        REQUIRE(loaded.at(0).vecMemory[0].vecData.size() == 3);
+        REQUIRE(loaded.at(1).bExit == true);
+
+        std::remove(path.c_str());
+    }
+
+    SECTION("a log cut off inside an entry is rejected") {
+
+        std::string path = "pipesim_syscall_log_cut.tmp";
+        {
+            std::shared_ptr<SyscallLog> log(new SyscallLog());
+            REQUIRE(log->openForRecording(path) == true);
+
+            SyscallLog::Entry entry;
+            entry.wCode = 5;
+            entry.vecRegisters.emplace_back(2, 40);
+            log->append(entry);
+        }
+
+        std::string contents;
+        {
+            std::ifstream file(path, std::ios_base::binary);
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        REQUIRE(contents.size() > 8 + 6);
+
+        // Part way through the code word, just after it, and part way through the exit flag
+        for (size_t cut : { 2, 4, 6 }) {
+            {
+                std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+                file.write(contents.data(), 8 + cut);
+            }
+
+            SyscallLog loaded;
+            REQUIRE(loaded.load(path) == false);
+        }
+
+        // Only the end of a whole entry ends the log cleanly
+        {
+            std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+            file.write(contents.data(), contents.size());
+        }
+        SyscallLog loaded;
+        REQUIRE(loaded.load(path) == true);
+        REQUIRE(loaded.size() == 1);
+
+        std::remove(path.c_str());
+    }
+
+    SECTION("a log whose write is longer than the rest of the file is rejected") {
+
+        // One entry writing 0xfffffff0 bytes, with none of them in the file
+        std::string path = "pipesim_syscall_log_corrupt.tmp";
+        {
+            std::ofstream file(path, std::ios_base::binary);
+            const unsigned char words[] = {
+                14, 0, 0, 0,                // code
+                0, 0, 0, 0,                 // exit
+                0, 0, 0, 0,                 // no registers
+                1, 0, 0, 0,                 // one write
+                0x00, 0x11, 0, 0,           // address
+                0xf0, 0xff, 0xff, 0xff      // length
+            };
+            file.write("PSYSLOG1", 8);
+            file.write(reinterpret_cast<const char *>(words), sizeof(words));
+        }
+
+        SyscallLog loaded;
+        REQUIRE(loaded.load(path) == false);
+
+        std::remove(path.c_str());
+    }
+}
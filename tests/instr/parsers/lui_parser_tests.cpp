@@ -0,0 +1,95 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "exception/syntax_error.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/parsers/lui_parser.hpp"
+
+/**
+ * Method: LuiParser::parse(..)
+ * Desired Confidence Level: Boundary value analysis
+ *
+ * Inputs:
+ *      line        -> A valid, non-empty line starting with "lui" and containing
+ *                      a register name and an immediate, mandatory, unvalidated
+ *
+ * Outputs:
+ *      An array of a single instruction on a success, nothing on failure
+ *
+ * Valid Tests:
+ *      line        -> nominal value (lui $1, 100)
+ *                     max value (lui $1, 65535)
+ *                     hexadecimal (lui $1, 0xffff)
+ *                     signed decimal (lui $1, -1)
+ *
+ * Invalid Tests:
+ *      positive out of bounds immediate
+ *      negative out of bounds immediate
+ */
+TEST_CASE("LUI parser properly parses line") {
+
+    // MARK: -- Valid Tests
+
+    SECTION("Parsing a nominal line returns the proper instruction") {
+
+        std::string input = "lui $1, 100";
+        LuiParser parser;
+
+        std::vector<Instruction> instructions;
+        REQUIRE_NOTHROW(instructions = parser.parse(input));
+        REQUIRE(instructions.size() == 1);
+        REQUIRE(instructions[0].getType() == InstructionType::I_FORMAT);
+        REQUIRE(instructions[0].getRt() == 1);
+        REQUIRE(instructions[0].getImmediate() == 100);
+    }
+
+    SECTION("Parsing a maximal line returns the proper instruction") {
+
+        std::string input = "lui $1, 65535";
+        LuiParser parser;
+
+        std::vector<Instruction> instructions;
+        REQUIRE_NOTHROW(instructions = parser.parse(input));
+        REQUIRE(instructions[0].getImmediate() == 0xFFFF);
+    }
+
+    SECTION("Parsing a hex line returns the proper instruction") {
+
+        std::string input = "lui $1, 0xffff";
+        LuiParser parser;
+
+        std::vector<Instruction> instructions;
+        REQUIRE_NOTHROW(instructions = parser.parse(input));
+        REQUIRE(instructions[0].getImmediate() == 0xFFFF);
+    }
+
+    SECTION("Parsing a signed decimal line returns the proper instruction") {
+
+        std::string input = "lui $1, -1";
+        LuiParser parser;
+
+        std::vector<Instruction> instructions;
+        REQUIRE_NOTHROW(instructions = parser.parse(input));
+        REQUIRE(instructions[0].getImmediate() == 0xFFFF);
+    }
+
+
+    // MARK: -- Invalid Tests
+
+    SECTION("Parsing a line with positive out of bounds immediate throws a syntax error") {
+
+        std::string input = "lui $1, 65536";
+        LuiParser parser;
+        REQUIRE_THROWS_AS(parser.parse(input), SyntaxError);
+    }
+
+    SECTION("Parsing a line with negative out of bounds immediate throws a syntax error") {
+
+        std::string input = "lui $1, -32769";
+        LuiParser parser;
+        REQUIRE_THROWS_AS(parser.parse(input), SyntaxError);
+    }
+}
@@ -0,0 +1,195 @@
+#include "catch.hpp"
+
+#include <stdexcept>
+
+#include "memory/coherence_bus.hpp"
+#include "memory/l1_cache.hpp"
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * Class: CoherenceBus
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a line read by one core is exclusive, and shared once another reads it
+ *      writing a shared line invalidates the other copies
+ *      misses on lines another core took away are split into true and false sharing
+ *      evicting a modified line writes it back
+ *      bus transactions queue behind each other
+ *      accesses to the text segment are not cached
+ *
+ * Invalid Tests:
+ *      a cache geometry that is not a power of two is rejected
+ */
+TEST_CASE("The coherence bus keeps caches coherent with MESI", "[memory][coherence]") {
+
+    const Memory::addr_t data = 0x1100;
+    Memory memory(0x100, 0x100);
+
+    CoherenceBus::Config config;
+    config.szLineSize = 16;
+    CoherenceBus bus(config);
+    REQUIRE(bus.addCache() == 0);
+    REQUIRE(bus.addCache() == 1);
+    bus.setDataStart(data);
+    memory.setObserver(&bus);
+
+    byte_t byte = 0;
+
+    SECTION("A line read by one core is exclusive, and shared once another reads it") {
+
+        bus.beginCycle(0, 0);
+        memory.readByte(data, byte);
+        REQUIRE(bus.getCache(0).getState(data) == MesiState::EXCLUSIVE);
+
+        bus.beginCycle(1, 1);
+        memory.readByte(data + 4, byte);
+        REQUIRE(bus.getCache(0).getState(data) == MesiState::SHARED);
+        REQUIRE(bus.getCache(1).getState(data) == MesiState::SHARED);
+        REQUIRE(bus.getStats().dwReads == 2);
+        REQUIRE(bus.getStats().dwCacheToCache == 1);
+
+        bus.beginCycle(0, 2);
+        memory.readByte(data + 15, byte);
+        REQUIRE(bus.getCache(0).getStats().dwHits == 1);
+        REQUIRE(bus.getCache(0).getStats().dwMisses == 1);
+    }
+
+    SECTION("Writing a shared line invalidates the other copies") {
+
+        bus.beginCycle(0, 0);
+        memory.readByte(data, byte);
+        bus.beginCycle(1, 1);
+        memory.readByte(data, byte);
+        memory.writeByte(data, 1);
+
+        REQUIRE(bus.getCache(1).getState(data) == MesiState::MODIFIED);
+        REQUIRE(bus.getCache(0).getState(data) == MesiState::INVALID);
+        REQUIRE(bus.getStats().dwUpgrades == 1);
+        REQUIRE(bus.getCache(1).getStats().dwInvalidationsSent == 1);
+        REQUIRE(bus.getCache(0).getStats().dwInvalidationsReceived == 1);
+
+        // An exclusive line is written without the bus
+        bus.beginCycle(0, 2);
+        memory.readByte(data + 0x20, byte);
+        memory.writeByte(data + 0x20, 1);
+        REQUIRE(bus.getCache(0).getState(data + 0x20) == MesiState::MODIFIED);
+        REQUIRE(bus.getStats().dwUpgrades == 1);
+    }
+
+    SECTION("Misses on lines another core took away are split into true and false sharing") {
+
+        // Core 1 writes the very byte core 0 reads back
+        bus.beginCycle(0, 0);
+        memory.readByte(data, byte);
+        bus.beginCycle(1, 1);
+        memory.writeByte(data, 1);
+        bus.beginCycle(0, 2);
+        memory.readByte(data, byte);
+
+        REQUIRE(bus.getCache(0).getStats().dwCoherenceMisses == 1);
+        REQUIRE(bus.getCache(0).getStats().dwTrueSharingMisses == 1);
+        REQUIRE(bus.getCache(1).getState(data) == MesiState::SHARED);
+
+        // Core 1 writes its own byte of the line, which core 0 never reads
+        bus.beginCycle(1, 3);
+        memory.writeByte(data + 8, 2);
+        memory.writeByte(data + 9, 2);
+        bus.beginCycle(0, 4);
+        memory.readByte(data, byte);
+
+        REQUIRE(bus.getCache(0).getStats().dwCoherenceMisses == 2);
+        REQUIRE(bus.getCache(0).getStats().dwFalseSharingMisses == 1);
+
+        // A word that straddles the written byte is true sharing again
+        bus.beginCycle(1, 5);
+        memory.writeByte(data + 9, 3);
+        bus.beginCycle(0, 6);
+        word_t word = 0;
+        memory.readWord(data + 8, word);
+        REQUIRE(bus.getCache(0).getStats().dwTrueSharingMisses == 2);
+    }
+
+    SECTION("Bus transactions queue behind each other") {
+
+        bus.beginCycle(0, 0);
+        memory.readByte(data, byte);
+        dword_t first = bus.getCache(0).getStats().dwStallCycles;
+        REQUIRE(first == config.dwArbitrationLatency + config.dwMemoryLatency);
+
+        bus.beginCycle(1, 0);
+        memory.readByte(data + 0x40, byte);
+        REQUIRE(bus.getCache(1).getStats().dwStallCycles == first + config.dwArbitrationLatency + config.dwMemoryLatency);
+        REQUIRE(bus.getStats().dwWaitCycles == first);
+    }
+
+    SECTION("Accesses to the text segment are not cached") {
+
+        bus.beginCycle(0, 0);
+        word_t word = 0;
+        memory.readWord(Memory::MEM_USER_START, word);
+        REQUIRE(bus.getCache(0).getStats().dwReads == 0);
+    }
+
+    SECTION("Resetting empties every cache") {
+
+        bus.beginCycle(0, 0);
+        memory.writeByte(data, 1);
+        bus.reset();
+        REQUIRE(bus.getCache(0).getState(data) == MesiState::INVALID);
+        REQUIRE(bus.getCache(0).getStats().dwWrites == 0);
+        REQUIRE(bus.getStats().dwReadExclusives == 0);
+    }
+
+    memory.setObserver(nullptr);
+}
+
+/**
+ * Class: L1Cache
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      evicting a modified line writes it back
+ *
+ * Invalid Tests:
+ *      a cache geometry that is not a power of two is rejected
+ */
+TEST_CASE("L1 caches replace and write back lines", "[memory][coherence]") {
+
+    SECTION("Evicting a modified line writes it back") {
+
+        Memory memory(0x100, 0x100);
+        CoherenceBus::Config config;
+        config.szLineSize = 16;
+        config.szSets = 1;
+        config.szWays = 1;
+        CoherenceBus bus(config);
+        bus.addCache();
+        bus.setDataStart(0x1100);
+        memory.setObserver(&bus);
+
+        byte_t byte = 0;
+        bus.beginCycle(0, 0);
+        memory.writeByte(0x1100, 1);
+        memory.readByte(0x1110, byte);
+
+        REQUIRE(bus.getCache(0).getStats().dwWriteBacks == 1);
+        REQUIRE(bus.getCache(0).getState(0x1100) == MesiState::INVALID);
+        REQUIRE(bus.getCache(0).getState(0x1110) == MesiState::EXCLUSIVE);
+        REQUIRE(bus.getCache(0).getStats().dwCoherenceMisses == 0);
+        memory.setObserver(nullptr);
+    }
+
+    SECTION("A cache geometry that is not a power of two is rejected") {
+
+        REQUIRE_THROWS_AS(L1Cache(24, 32, 2), std::invalid_argument);
+        REQUIRE_THROWS_AS(L1Cache(128, 32, 2), std::invalid_argument);
+        REQUIRE_THROWS_AS(L1Cache(32, 3, 2), std::invalid_argument);
+        REQUIRE_THROWS_AS(L1Cache(32, 32, 0), std::invalid_argument);
+
+        CoherenceBus::Config config;
+        config.szSets = 0;
+        REQUIRE_THROWS_AS(CoherenceBus(config), std::invalid_argument);
+    }
+}
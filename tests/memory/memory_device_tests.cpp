@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "instr/input_feed.hpp"
+#include "memory/console_device.hpp"
+#include "memory/dma_device.hpp"
+#include "memory/memory.hpp"
+#include "types.hpp"
+
+/**
+ * Class: ConsoleDevice, DmaDevice
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      storing to the console prints a character, and loading takes one
+ *      loading from the console at the end of input gives 0xFF
+ *      the DMA engine copies a block once the control register is written
+ *      a copy takes the setup cycles, then the bytes at so many a cycle
+ *
+ * Invalid Tests:
+ *      console accesses off the data register fail
+ *      a copy outside of memory sets the error status
+ *      a DMA engine copying 0 bytes per cycle is rejected
+ */
+TEST_CASE("Devices mapped into memory behave as programs expect", "[memory][devices]") {
+
+    Memory memory(0x100, 0x100);
+    const Memory::addr_t data = 0x1100;
+    const Memory::addr_t console = Memory::MMIO_START;
+    const Memory::addr_t dma = Memory::MMIO_START + Memory::PAGE_SIZE;
+
+    std::ostringstream output;
+    InputFeed input;
+    input.queueInput("hi");
+    REQUIRE(memory.mapDevice(console, ConsoleDevice::SIZE, std::shared_ptr<MemoryDevice>(new ConsoleDevice(output, &input))));
+    REQUIRE(memory.mapDevice(dma, DmaDevice::SIZE, std::shared_ptr<MemoryDevice>(new DmaDevice(memory, 8, 4))));
+
+    byte_t byte = 0;
+    word_t word = 0;
+
+    SECTION("Storing to the console prints a character, and loading takes one") {
+
+        REQUIRE(memory.writeByte(console, 'o'));
+        REQUIRE(memory.writeByte(console, 'k'));
+        REQUIRE(output.str() == "ok");
+
+        REQUIRE(memory.readByte(console, byte));
+        REQUIRE(byte == 'h');
+        REQUIRE(memory.readWord(console, word));
+        REQUIRE(word == 'i');
+        REQUIRE(memory.getDeviceCycles() == 4);
+    }
+
+    SECTION("Loading from the console at the end of input gives 0xFF") {
+
+        input.get();
+        input.get();
+        REQUIRE(memory.readByte(console, byte));
+        REQUIRE(byte == 0xFF);
+    }
+
+    SECTION("The DMA engine copies a block once the control register is written") {
+
+        for (word_t i = 0; i < 10; ++i)
+            REQUIRE(memory.writeByte(data + i, static_cast<byte_t>(i + 1)));
+
+        REQUIRE(memory.writeWord(dma + DmaDevice::REG_SOURCE, data));
+        REQUIRE(memory.writeWord(dma + DmaDevice::REG_DEST, data + 0x40));
+        REQUIRE(memory.writeWord(dma + DmaDevice::REG_LENGTH, 10));
+        REQUIRE(memory.getDeviceCycles() == 3);
+
+        REQUIRE(memory.writeByte(dma + DmaDevice::REG_CONTROL, 1));
+        for (word_t i = 0; i < 10; ++i) {
+            REQUIRE(memory.readByte(data + 0x40 + i, byte));
+            REQUIRE(byte == i + 1);
+        }
+        REQUIRE(memory.readByte(data + 0x40 + 10, byte));
+        REQUIRE(byte == 0);
+
+        // Takes 1 cycle for the store, 8 to set up, then 3 to copy 10 bytes at 4 a cycle
+        REQUIRE(memory.getDeviceCycles() == 3 + 1 + 8 + 3);
+
+        REQUIRE(memory.readWord(dma + DmaDevice::REG_CONTROL, word));
+        REQUIRE(word == 0);
+    }
+
+    SECTION("Console accesses off the data register fail") {
+
+        REQUIRE(memory.writeByte(console + 1, 'x') == false);
+        REQUIRE(memory.readByte(console + 2, byte) == false);
+        REQUIRE(output.str().empty());
+    }
+
+    SECTION("A copy outside of memory sets the error status") {
+
+        REQUIRE(memory.writeWord(dma + DmaDevice::REG_SOURCE, data));
+        REQUIRE(memory.writeWord(dma + DmaDevice::REG_DEST, data + 0xF8));
+        REQUIRE(memory.writeWord(dma + DmaDevice::REG_LENGTH, 16));
+        REQUIRE(memory.writeByte(dma + DmaDevice::REG_CONTROL, 1));
+
+        REQUIRE(memory.readByte(dma + DmaDevice::REG_CONTROL, byte));
+        REQUIRE(byte == DmaDevice::STATUS_ERROR);
+    }
+
+    SECTION("A DMA engine copying 0 bytes per cycle is rejected") {
+        REQUIRE_THROWS_AS(DmaDevice(memory, 8, 0), std::invalid_argument);
+    }
+}
@@ -1,9 +1,12 @@
 #include "catch.hpp"
 
 #include "memory/memory.hpp"
+#include "memory/timer_device.hpp"
 #include "types.hpp"
 
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 TEST_CASE("Memory can be written to and read from", "[memory]") {
 
@@ -240,4 +243,285 @@ TEST_CASE("Memory can be written to and read from", "[memory]") {
         REQUIRE(memory.readString(0x2, str) == false);
         REQUIRE(memory.readString(0x1000+textSize+dataSize+100, str) == false);
     }
-}
\ No newline at end of file
+
+    // MARK: -- Block Reads / Writes
+    /**
+     * Desired Confidence: boundary-value analysis
+     * 
+     * Valid Tests:
+     *      Write / read block at nominal address
+     *      Write / read block ending exactly on the high boundary
+     *      Write / read zero-length block anywhere
+     * 
+     * Invalid Tests:
+     *      Write / read block starting under the low boundary
+     *      Write / read block running one byte past the high boundary
+     *      Write / read block larger than memory
+     * 
+     * Invalid Outputs:
+     *      False for all function calls, memory left untouched
+     */
+    SECTION("writing and reading blocks works properly") {
+
+        byte_t in[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        byte_t out[8] = { 0 };
+        REQUIRE(memory.writeBlock(0x1500, in, sizeof(in)) == true);
+        REQUIRE(memory.readBlock(0x1500, out, sizeof(out)) == true);
+        REQUIRE(std::memcmp(in, out, sizeof(in)) == 0);
+
+        word_t word;
+        REQUIRE(memory.readWord(0x1500, word) == true);
+        REQUIRE(word == 0x04030201);
+    }
+
+    SECTION("writing and reading blocks on but within the boundaries succeeds") {
+
+        byte_t in[] = { 9, 8, 7, 6 };
+        byte_t out[4] = { 0 };
+        REQUIRE(memory.writeBlock(0x1000+textSize+dataSize-4, in, sizeof(in)) == true);
+        REQUIRE(memory.readBlock(0x1000+textSize+dataSize-4, out, sizeof(out)) == true);
+        REQUIRE(std::memcmp(in, out, sizeof(in)) == 0);
+
+        REQUIRE(memory.writeBlock(0x2, in, 0) == true);
+        REQUIRE(memory.readBlock(0x2, out, 0) == true);
+    }
+
+    SECTION("writing and reading blocks outside of the boundaries fails") {
+
+        byte_t in[] = { 9, 8, 7, 6 };
+        byte_t out[4] = { 0 };
+        REQUIRE(memory.writeBlock(0x1000-1, in, sizeof(in)) == false);
+        REQUIRE(memory.writeBlock(0x1000+textSize+dataSize-3, in, sizeof(in)) == false);
+        REQUIRE(memory.readBlock(0x1000-1, out, sizeof(out)) == false);
+        REQUIRE(memory.readBlock(0x1000+textSize+dataSize-3, out, sizeof(out)) == false);
+
+        std::vector<byte_t> huge(textSize+dataSize+1);
+        REQUIRE(memory.writeBlock(0x1000, huge.data(), huge.size()) == false);
+        REQUIRE(memory.readBlock(0x1000, huge.data(), huge.size()) == false);
+    }
+
+
+    // MARK: -- Growing
+    SECTION("growing the data segment extends memory with zeroed bytes") {
+
+        REQUIRE(memory.growData(0x100) == true);
+        REQUIRE(memory.getDataSize() == dataSize + 0x100);
+        REQUIRE(memory.getTotalSize() == textSize + dataSize + 0x100);
+
+        word_t word = 1;
+        REQUIRE(memory.readWord(0x1000+textSize+dataSize, word) == true);
+        REQUIRE(word == 0);
+        REQUIRE(memory.writeWord(0x1000+textSize+dataSize+0xFC, 0x12345678) == true);
+    }
+
+    SECTION("growing the text segment moves the data segment up") {
+
+        REQUIRE(memory.writeWord(0x1000+textSize, 0x12345678) == true);
+        REQUIRE(memory.growText(0x100) == true);
+        REQUIRE(memory.getTextSize() == textSize + 0x100);
+        REQUIRE(memory.getTotalSize() == textSize + dataSize + 0x100);
+
+        word_t word = 1;
+        REQUIRE(memory.readWord(0x1000+textSize, word) == true);
+        REQUIRE(word == 0);
+        REQUIRE(memory.readWord(0x1000+textSize+0x100, word) == true);
+        REQUIRE(word == 0x12345678);
+    }
+
+
+    // MARK: -- Journal
+    SECTION("a journal records every byte written, and replays onto another copy") {
+
+        Memory::journal_t journal;
+        Memory copy(memory);
+
+        memory.setJournal(&journal);
+        REQUIRE(memory.writeByte(0x1000, 0xAB) == true);
+        REQUIRE(memory.writeWord(0x1004, 0x12345678) == true);
+        REQUIRE(memory.writeString(0x1010, "hi") == true);
+        memory.setJournal(nullptr);
+        REQUIRE(memory.writeByte(0x1020, 0xCD) == true);
+        REQUIRE(journal.size() == 1 + 4 + 3);
+        REQUIRE(journal[1].first == 0x1004);
+        REQUIRE(journal[1].second == 0x78);
+
+        REQUIRE(copy.applyJournal(journal) == true);
+
+        word_t word = 0;
+        byte_t byte = 0;
+        REQUIRE(copy.readWord(0x1004, word) == true);
+        REQUIRE(word == 0x12345678);
+        REQUIRE(copy.readByte(0x1000, byte) == true);
+        REQUIRE(byte == 0xAB);
+        REQUIRE(copy.readByte(0x1020, byte) == true);
+        REQUIRE(byte == 0);
+    }
+
+    SECTION("replaying a journal grows the data segment to fit") {
+
+        Memory::journal_t journal;
+        Memory copy(memory);
+
+        REQUIRE(memory.growData(0x10) == true);
+        memory.setJournal(&journal);
+        REQUIRE(memory.writeByte(0x1000+textSize+dataSize+0x8, 0x5A) == true);
+
+        REQUIRE(copy.applyJournal(journal) == true);
+        REQUIRE(copy.getDataSize() >= dataSize + 0x9);
+
+        byte_t byte = 0;
+        REQUIRE(copy.readByte(0x1000+textSize+dataSize+0x8, byte) == true);
+        REQUIRE(byte == 0x5A);
+
+        Memory::journal_t bad = { { 0x10, 0x01 } };
+        REQUIRE(copy.applyJournal(bad) == false);
+    }
+
+
+    // MARK: -- Undo Log
+    SECTION("an undo log records the old value of every byte before it is written") {
+
+        Memory::journal_t undo;
+        REQUIRE(memory.writeByte(0x1000, 0x11) == true);
+        memory.setUndoLog(&undo);
+        REQUIRE(memory.writeByte(0x1000, 0x22) == true);
+        REQUIRE(memory.writeWord(0x1004, 0x12345678) == true);
+        REQUIRE(memory.writeByte(0x1000, 0x33) == true);
+        memory.setUndoLog(nullptr);
+        REQUIRE(undo.size() == 1 + 4 + 1);
+        REQUIRE(undo[0] == Memory::journal_t::value_type(0x1000, 0x11));
+        REQUIRE(undo[5] == Memory::journal_t::value_type(0x1000, 0x22));
+
+        // Applying it newest first puts everything back
+        Memory::journal_t reversed(undo.rbegin(), undo.rend());
+        REQUIRE(memory.applyJournal(reversed) == true);
+
+        byte_t byte = 0;
+        word_t word = 1;
+        REQUIRE(memory.readByte(0x1000, byte) == true);
+        REQUIRE(byte == 0x11);
+        REQUIRE(memory.readWord(0x1004, word) == true);
+        REQUIRE(word == 0);
+    }
+
+
+    // MARK: -- Snapshots
+    SECTION("snapshots only copy the pages written since the last one, and restore exactly") {
+
+        Memory::Snapshot first, second;
+        REQUIRE(memory.writeByte(0x1000, 0x11) == true);
+        memory.takeSnapshot(first);
+        REQUIRE(first.vecPages.size() == (textSize + dataSize) / Memory::PAGE_SIZE);
+
+        // Only the second page is written, so the others are shared
+        REQUIRE(memory.writeByte(0x1000 + Memory::PAGE_SIZE + 4, 0x22) == true);
+        memory.takeSnapshot(second);
+        REQUIRE(second.vecPages[0] == first.vecPages[0]);
+        REQUIRE(second.vecPages[1] != first.vecPages[1]);
+        REQUIRE(second.vecPages[2] == first.vecPages[2]);
+
+        REQUIRE(memory.writeByte(0x1000, 0x33) == true);
+        REQUIRE(memory.growData(0x10) == true);
+        REQUIRE(memory.writeByte(0x1000 + textSize + dataSize, 0x44) == true);
+        memory.restoreSnapshot(first);
+
+        byte_t byte = 0;
+        REQUIRE(memory.readByte(0x1000, byte) == true);
+        REQUIRE(byte == 0x11);
+        REQUIRE(memory.readByte(0x1000 + Memory::PAGE_SIZE + 4, byte) == true);
+        REQUIRE(byte == 0);
+
+        // Memory grown since is kept, but zeroed
+        REQUIRE(memory.getTotalSize() == textSize + dataSize + 0x10);
+        REQUIRE(memory.readByte(0x1000 + textSize + dataSize, byte) == true);
+        REQUIRE(byte == 0);
+
+        memory.restoreSnapshot(second);
+        REQUIRE(memory.readByte(0x1000 + Memory::PAGE_SIZE + 4, byte) == true);
+        REQUIRE(byte == 0x22);
+    }
+
+
+    // MARK: -- Watchpoints
+    SECTION("watchpoints report only the accesses that touch them, of the kinds asked for") {
+
+        std::vector<Memory::WatchHit> hits;
+        memory.setWatchHandler([&hits](const Memory::WatchHit& hit) { hits.push_back(hit); });
+
+        REQUIRE(memory.writeWord(0x2000, 0x11223344) == true);
+        REQUIRE(memory.addWatchpoint(0x2002, 2, Memory::WatchKind::WRITE) == true);
+        REQUIRE(memory.addWatchpoint(0x3000, 1, Memory::WatchKind::READ) == true);
+
+        // Next to (but not touching) the watched bytes, or a read of them, is not reported
+        word_t word = 0;
+        byte_t byte = 0;
+        REQUIRE(memory.writeByte(0x2001, 0x55) == true);
+        REQUIRE(memory.writeByte(0x2004, 0x66) == true);
+        REQUIRE(memory.readWord(0x2000, word) == true);
+        REQUIRE(hits.empty());
+
+        REQUIRE(memory.writeWord(0x2000, 0xAABBCCDD) == true);
+        REQUIRE(hits.size() == 1);
+        REQUIRE(hits[0].wAddress == 0x2000);
+        REQUIRE(hits[0].szSize == sizeof(word_t));
+        REQUIRE(hits[0].bWrite == true);
+        REQUIRE(hits[0].wOldValue == 0x11225544);
+        REQUIRE(hits[0].wNewValue == 0xAABBCCDD);
+
+        REQUIRE(memory.readByte(0x3000, byte) == true);
+        REQUIRE(memory.writeByte(0x3000, 0x77) == true);
+        REQUIRE(hits.size() == 2);
+        REQUIRE(hits[1].bWrite == false);
+
+        // Patches are never reported, and removed watchpoints no longer are
+        word_t old = 0;
+        REQUIRE(memory.patchWord(0x2000, 0x01020304, old) == true);
+        REQUIRE(old == 0xAABBCCDD);
+        REQUIRE(memory.removeWatchpoint(0x2002) == true);
+        REQUIRE(memory.removeWatchpoint(0x2002) == false);
+        REQUIRE(memory.writeWord(0x2000, 0) == true);
+        REQUIRE(memory.readByte(0x3000, byte) == true);
+        REQUIRE(hits.size() == 3);
+    }
+
+    SECTION("watchpoints outside of memory, or of no bytes, are rejected") {
+
+        REQUIRE(memory.addWatchpoint(0x0FFF, 1, Memory::WatchKind::ACCESS) == false);
+        REQUIRE(memory.addWatchpoint(0x1000 + textSize + dataSize - 1, 2, Memory::WatchKind::ACCESS) == false);
+        REQUIRE(memory.addWatchpoint(0x2000, 0, Memory::WatchKind::ACCESS) == false);
+    }
+
+    SECTION("accesses to a mapped device are dispatched to it, and its cycles tallied") {
+
+        dword_t clock = 0x0123456789ABCDEF;
+        std::shared_ptr<TimerDevice> timer(new TimerDevice(3));
+        timer->setClock(&clock);
+        REQUIRE(memory.mapDevice(Memory::MMIO_START + Memory::PAGE_SIZE, TimerDevice::SIZE, timer) == true);
+
+        word_t word = 0;
+        byte_t byte = 0;
+        REQUIRE(memory.readWord(Memory::MMIO_START + Memory::PAGE_SIZE, word) == true);
+        REQUIRE(word == 0x89ABCDEF);
+        REQUIRE(memory.readByte(Memory::MMIO_START + Memory::PAGE_SIZE + TimerDevice::REG_CYCLES_HI, byte) == true);
+        REQUIRE(byte == 0x67);
+        REQUIRE(memory.getDeviceCycles() == 6);
+
+        REQUIRE(memory.writeWord(Memory::MMIO_START + Memory::PAGE_SIZE, 0) == false);
+        REQUIRE(memory.readWord(Memory::MMIO_START, word) == false);
+        REQUIRE(memory.readWord(Memory::MMIO_START + Memory::PAGE_SIZE + TimerDevice::SIZE, word) == false);
+        REQUIRE(memory.getDeviceCycles() == 6);
+    }
+
+    SECTION("devices off a page boundary, outside the MMIO region, or over another device are rejected") {
+
+        std::shared_ptr<TimerDevice> timer(new TimerDevice());
+        REQUIRE(memory.mapDevice(Memory::MMIO_START + 4, TimerDevice::SIZE, timer) == false);
+        REQUIRE(memory.mapDevice(0x2000, TimerDevice::SIZE, timer) == false);
+        REQUIRE(memory.mapDevice(Memory::MMIO_START + (Memory::MMIO_PAGES - 1) * Memory::PAGE_SIZE, 2 * Memory::PAGE_SIZE, timer) == false);
+        REQUIRE(memory.mapDevice(Memory::MMIO_START, 0, timer) == false);
+        REQUIRE(memory.mapDevice(Memory::MMIO_START, TimerDevice::SIZE, nullptr) == false);
+
+        REQUIRE(memory.mapDevice(Memory::MMIO_START, 2 * Memory::PAGE_SIZE, timer) == true);
+        REQUIRE(memory.mapDevice(Memory::MMIO_START + Memory::PAGE_SIZE, TimerDevice::SIZE, timer) == false);
+    }
+}
@@ -20,7 +20,7 @@ public:
      * @param registerBank The register bank
      * @param PC The program counter
      */
-    virtual void onDecode(InstructionDecodeBuffer& decodeBuffer, const RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
+    virtual void onDecode(InstructionDecodeBuffer& decodeBuffer, RegisterBank& registerBank, Memory& memory, Memory::addr_t& PC) override;
 
     /**
      * Handles any execution necessary.
@@ -35,5 +35,5 @@ public:
      * @param memory Our memory
      * @return Any read memory, or 0
      */
-    virtual word_t onMemory(const ExecutionBuffer& executionBuffer, const Memory& memory) override;
+    virtual word_t onMemory(const ExecutionBuffer& executionBuffer, Memory& memory) override;
 };
\ No newline at end of file
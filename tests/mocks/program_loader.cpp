@@ -0,0 +1,25 @@
+#include "catch.hpp"
+
+#include "mocks/program_loader.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Assembles a program
+std::shared_ptr<Memory> ProgramLoader::load(const char * program, InstructionSet& instrSet, FileReader& reader) {
+
+    // The reader only takes files
+    std::string path = "pipesim_program_test.tmp";
+    {
+        std::ofstream file(path);
+        file << program;
+    }
+
+    std::shared_ptr<Memory> memory(new Memory(0x1000, 0x1000));
+    bool loaded = reader.readFile(path, instrSet, *memory.get());
+    std::remove(path.c_str());
+
+    REQUIRE(loaded);
+    return memory;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+
+#include "instr/instruction_set.hpp"
+#include "memory/memory.hpp"
+#include "reader/file_reader.hpp"
+
+/**
+ * Assembles test programs from their source, the way the simulator loads a
+ * file, failing the test if the source does not assemble.
+ */
+namespace ProgramLoader {
+
+    /**
+     * Assembles a program into a new memory (0x1000 bytes each of text and data).
+     * @param program The program's source
+     * @param instrSet The instruction set
+     * @param reader The reader, already set up with any passes to run, to find symbols with afterwards
+     * @return The loaded memory
+     */
+    std::shared_ptr<Memory> load(const char * program, InstructionSet& instrSet, FileReader& reader);
+}
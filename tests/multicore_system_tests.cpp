@@ -0,0 +1,428 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "reader/file_reader.hpp"
+
+#include "multicore_system.hpp"
+
+// Two cores that each store their id, with the second waiting on a flag the first sets
+static const char * TWO_CORE_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $2, 60\n"
+    "    syscall\n"
+    "    addi $8, $2, 1\n"
+    "    la $3, ids\n"
+    "    sb $8, 0($3)\n"
+    "    li $9, 42\n"
+    "    la $4, flag\n"
+    "    sb $9, 0($4)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    "worker:\n"
+    "    li $2, 60\n"
+    "    syscall\n"
+    "    addi $8, $2, 1\n"
+    "    la $3, ids\n"
+    "    sb $8, 1($3)\n"
+    "    la $4, flag\n"
+    "wait:\n"
+    "    lb $9, 0($4)\n"
+    "    beq $9, $0, wait\n"
+    "    nop\n"
+    "    la $3, result\n"
+    "    sb $9, 0($3)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "ids: .space 2\n"
+    "flag: .space 1\n"
+    "result: .space 1\n";
+
+/**
+ * Class: MulticoreSystem
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      each core starts at its own entry point and learns its own id
+ *      stores from one core are seen by the others through the shared memory
+ *      the global clock runs until the last core exits, and resetting starts it over
+ *
+ * Invalid Tests:
+ *      a null memory is rejected
+ */
+TEST_CASE("Multiple cores run against one shared memory", "[multicore]") {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    FileReader reader;
+    std::shared_ptr<Memory> memory = ProgramLoader::load(TWO_CORE_PROGRAM, *instrSet.get(), reader);
+
+    MulticoreSystem system(memory);
+    REQUIRE(system.addCore(reader.getSymbols().at("main")) == 0);
+    REQUIRE(system.addCore(reader.getSymbols().at("worker")) == 1);
+    REQUIRE(system.getNumCores() == 2);
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+    system.run();
+    spdlog::set_level(level);
+
+    SECTION("Each core starts at its own entry point and learns its id") {
+
+        byte_t first, second;
+        memory->readByte(reader.getSymbols().at("ids"), first);
+        memory->readByte(reader.getSymbols().at("ids") + 1, second);
+        REQUIRE(first == 1);
+        REQUIRE(second == 2);
+    }
+
+    SECTION("Stores from one core are seen by the others") {
+
+        byte_t result;
+        memory->readByte(reader.getSymbols().at("result"), result);
+        REQUIRE(result == 42);
+
+        word_t value;
+        system.getRegisterBank(1).readRegister(9, value);
+        REQUIRE(value == 42);
+    }
+
+    SECTION("The global clock runs until the last core exits") {
+
+        dword_t first = system.getCore(0).getStats().dwClockCycles;
+        dword_t second = system.getCore(1).getStats().dwClockCycles;
+        REQUIRE(second > first);
+        REQUIRE(system.getClockCycles() == second);
+        REQUIRE(system.getCore(0).isRunning() == false);
+
+        system.reset();
+        REQUIRE(system.getClockCycles() == 0);
+        REQUIRE(system.getCore(0).isRunning() == true);
+    }
+
+    SECTION("A null memory is rejected") {
+
+        REQUIRE_THROWS_AS(MulticoreSystem(nullptr), std::invalid_argument);
+    }
+}
+
+
+// Two cores that each grow the heap twice, keeping the old breaks in $8 and $9
+static const char * TWO_CORE_SBRK_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $4, 16\n"
+    "    li $2, 9\n"
+    "    syscall\n"
+    "    addi $8, $2, 0\n"
+    "    li $4, 16\n"
+    "    li $2, 9\n"
+    "    syscall\n"
+    "    addi $9, $2, 0\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    "worker:\n"
+    "    li $4, 16\n"
+    "    li $2, 9\n"
+    "    syscall\n"
+    "    addi $8, $2, 0\n"
+    "    li $4, 16\n"
+    "    li $2, 9\n"
+    "    syscall\n"
+    "    addi $9, $2, 0\n"
+    "    li $2, 10\n"
+    "    syscall\n";
+
+/**
+ * Class: MulticoreSystem (heap)
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      every SBRK from every core hands out its own bytes
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Multiple cores share one heap", "[multicore][syscall]") {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    FileReader reader;
+    std::shared_ptr<Memory> memory = ProgramLoader::load(TWO_CORE_SBRK_PROGRAM, *instrSet.get(), reader);
+
+    Memory::addr_t start = Memory::MEM_USER_START + memory->getTotalSize();
+    MulticoreSystem system(memory);
+    system.addCore(reader.getSymbols().at("main"));
+    system.addCore(reader.getSymbols().at("worker"));
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+    system.run();
+    spdlog::set_level(level);
+
+    SECTION("Every SBRK from every core hands out its own bytes") {
+
+        std::vector<word_t> breaks;
+        for (size_t core = 0; core < 2; ++core) {
+            for (word_t reg : { 8, 9 }) {
+                word_t value = 0;
+                system.getRegisterBank(core).readRegister(reg, value);
+                breaks.push_back(value);
+            }
+        }
+
+        std::sort(breaks.begin(), breaks.end());
+        for (size_t i = 0; i < breaks.size(); ++i)
+            REQUIRE(breaks[i] == start + 16 * i);
+        REQUIRE(memory->getTotalSize() >= 4 * 16 + (start - Memory::MEM_USER_START));
+    }
+}
+
+/**
+ * Runs the two core program with a quantum and returns the data it leaves in the shared memory.
+ * @param quantum The quantum
+ * @param parallel Whether or not to run on host threads
+ * @param cycles A placeholder for the number of global cycles run
+ * @return The ids, flag and result bytes
+ */
+static std::vector<byte_t> runWithQuantum(dword_t quantum, bool parallel, dword_t& cycles) {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    FileReader reader;
+    std::shared_ptr<Memory> memory = ProgramLoader::load(TWO_CORE_PROGRAM, *instrSet.get(), reader);
+
+    MulticoreSystem system(memory, quantum);
+    system.setParallel(parallel);
+    system.addCore(reader.getSymbols().at("main"));
+    system.addCore(reader.getSymbols().at("worker"));
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+    system.run();
+    spdlog::set_level(level);
+
+    cycles = system.getClockCycles();
+
+    std::vector<byte_t> data(4, 0);
+    memory->readBlock(reader.getSymbols().at("ids"), data.data(), data.size());
+    return data;
+}
+
+/**
+ * Class: MulticoreSystem (with a quantum)
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      stores from every core reach the shared memory by the end of the run
+ *      stores are only seen by other cores at quantum boundaries
+ *      running on host threads gives the same result as running in order
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Multiple cores synchronise their memory at quantum boundaries", "[multicore]") {
+
+    dword_t lockstepCycles = 0;
+    runWithQuantum(0, false, lockstepCycles);
+
+    SECTION("Stores from every core reach the shared memory") {
+
+        dword_t cycles = 0;
+        std::vector<byte_t> data = runWithQuantum(4, false, cycles);
+        REQUIRE(data == std::vector<byte_t>({ 1, 2, 42, 42 }));
+    }
+
+    SECTION("Stores are only seen by other cores at quantum boundaries") {
+
+        // The worker keeps spinning on the flag until the boundary after the first core sets it
+        dword_t cycles = 0;
+        runWithQuantum(64, false, cycles);
+        REQUIRE(cycles > lockstepCycles);
+        REQUIRE(cycles > 64);
+    }
+
+    SECTION("Running on host threads gives the same result as running in order") {
+
+        for (dword_t quantum : { 1, 3, 16, 64 }) {
+
+            dword_t sequentialCycles = 0;
+            dword_t parallelCycles = 0;
+            std::vector<byte_t> sequential = runWithQuantum(quantum, false, sequentialCycles);
+            std::vector<byte_t> parallel = runWithQuantum(quantum, true, parallelCycles);
+
+            REQUIRE(parallel == sequential);
+            REQUIRE(parallelCycles == sequentialCycles);
+        }
+    }
+}
+
+
+// The first core counts down in a register for a while before setting a flag the second core spins on
+static const char * WAIT_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $8, 200\n"
+    "count:\n"
+    "    subi $8, $8, 1\n"
+    "    bne $8, $0, count\n"
+    "    nop\n"
+    "    li $9, 1\n"
+    "    la $4, flag\n"
+    "    sb $9, 0($4)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    "worker:\n"
+    "    la $4, flag\n"
+    "wait:\n"
+    "    lb $9, 0($4)\n"
+    "    beq $9, $0, wait\n"
+    "    nop\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "flag: .space 1\n";
+
+/**
+ * Class: MulticoreSystem (stopping for good)
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a core waiting on another that is still working is not a livelock
+ *      cores that all wait forever stop with a livelock, in lockstep or at quantum boundaries
+ *      a cycle limit stops every core on the same cycle
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Multiple cores stop at cycle limits and livelocks", "[multicore][livelock]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    FileReader reader;
+    std::shared_ptr<Memory> memory = ProgramLoader::load(WAIT_PROGRAM, *instrSet.get(), reader);
+    Memory::addr_t worker = reader.getSymbols().at("worker");
+
+    SECTION("A core waiting on another that is still working is not a livelock") {
+
+        MulticoreSystem system(memory);
+        system.addCore(reader.getSymbols().at("main"));
+        system.addCore(worker);
+        system.setLivelockDetection(true);
+
+        system.reset();
+        while (system.step()) { }
+        REQUIRE(system.getStop().reason == StopReason::NONE);
+        REQUIRE(system.getClockCycles() > 400);
+
+        byte_t flag = 0;
+        memory->readByte(reader.getSymbols().at("flag"), flag);
+        REQUIRE(flag == 1);
+    }
+
+    SECTION("Cores that all wait forever stop with a livelock, in lockstep or at quantum boundaries") {
+
+        for (dword_t quantum : { 0, 1, 16 }) {
+            for (bool parallel : { false, true }) {
+
+                MulticoreSystem system(memory, quantum);
+                system.addCore(worker);
+                system.addCore(worker);
+                system.setParallel(parallel);
+                system.setLivelockDetection(true);
+                system.run();
+
+                const SimulatorStop& stop = system.getStop();
+                REQUIRE(stop.reason == StopReason::LIVELOCK);
+                REQUIRE(stop.dwPeriod > 0);
+                REQUIRE(stop.dwCycle < 1000);
+                REQUIRE(system.step() == false);
+            }
+        }
+    }
+
+    SECTION("A cycle limit stops every core on the same cycle") {
+
+        MulticoreSystem system(memory);
+        system.addCore(reader.getSymbols().at("main"));
+        system.addCore(worker);
+        system.setCycleLimit(50);
+        system.run();
+
+        const SimulatorStop& stop = system.getStop();
+        REQUIRE(stop.reason == StopReason::CYCLE_LIMIT);
+        REQUIRE(stop.dwCycle == 50);
+        REQUIRE(system.getClockCycles() == 50);
+        REQUIRE(system.getCore(0).getStats().dwClockCycles == 50);
+        REQUIRE(system.getCore(1).getStats().dwClockCycles == 50);
+
+        system.setCycleLimit(0);
+        system.run();
+        REQUIRE(system.getStop().reason == StopReason::NONE);
+    }
+
+    spdlog::set_level(level);
+}
+
+
+/**
+ * Class: MulticoreSystem (with caches)
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a core spinning on a flag another core writes takes a coherence miss
+ *      the result is the same with or without caches
+ *
+ * Invalid Tests:
+ *      caches cannot be enabled with a quantum
+ */
+TEST_CASE("Multiple cores can model coherent L1 caches", "[multicore][coherence]") {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    FileReader reader;
+    std::shared_ptr<Memory> memory = ProgramLoader::load(TWO_CORE_PROGRAM, *instrSet.get(), reader);
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    SECTION("A core spinning on a flag another core writes takes a coherence miss") {
+
+        MulticoreSystem system(memory);
+        system.addCore(reader.getSymbols().at("main"));
+        REQUIRE(system.enableCaches() == true);
+        system.addCore(reader.getSymbols().at("worker"));
+        system.run();
+
+        REQUIRE(system.getBus() != nullptr);
+        REQUIRE(system.getBus()->getNumCaches() == 2);
+
+        const L1Cache::Stats& worker = system.getBus()->getCache(1).getStats();
+        REQUIRE(worker.dwCoherenceMisses >= 1);
+        REQUIRE(worker.dwInvalidationsReceived >= 1);
+        REQUIRE(worker.dwStallCycles > 0);
+
+        byte_t result = 0;
+        memory->readByte(reader.getSymbols().at("result"), result);
+        REQUIRE(result == 42);
+    }
+
+    SECTION("Caches cannot be enabled with a quantum") {
+
+        MulticoreSystem system(memory, 4);
+        system.addCore(reader.getSymbols().at("main"));
+        REQUIRE(system.enableCaches() == false);
+        REQUIRE(system.getBus() == nullptr);
+    }
+
+    spdlog::set_level(level);
+}
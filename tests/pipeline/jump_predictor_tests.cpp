@@ -0,0 +1,180 @@
+#include "catch.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include "exception/syntax_error.hpp"
+#include "instr/functions.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/opcodes.hpp"
+#include "instr/parsers/jump_parser.hpp"
+#include "instr/parsers/jump_register_parser.hpp"
+#include "pipeline/jump_predictor.hpp"
+#include "pipeline/retire_record.hpp"
+#include "pipeline/timing_model.hpp"
+
+/**
+ * Builds a record for an ALU instruction.
+ * @param pc The address
+ * @return The record
+ */
+static RetireRecord makeRecord(Memory::addr_t pc) {
+
+    RetireRecord record;
+    record.wPC = pc;
+    return record;
+}
+
+/**
+ * Builds a record for a JAL.
+ * @param pc The address
+ * @param target The function called
+ * @return The record
+ */
+static RetireRecord makeCall(Memory::addr_t pc, Memory::addr_t target) {
+
+    RetireRecord record = makeRecord(pc);
+    record.bJump = true;
+    record.bCall = true;
+    record.wTarget = target;
+    record.wRegDest = 31;
+    return record;
+}
+
+/**
+ * Builds a record for a jump through a register.
+ * @param pc The address
+ * @param reg The register jumped through
+ * @return The record
+ */
+static RetireRecord makeJumpRegister(Memory::addr_t pc, word_t reg) {
+
+    RetireRecord record = makeRecord(pc);
+    record.bJump = true;
+    record.bIndirect = true;
+    record.wRegSrc1 = reg;
+    return record;
+}
+
+/**
+ * Class: JumpPredictor
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      returns are predicted from the return-address stack, newest first
+ *      a call chain deeper than the stack loses its oldest return addresses
+ *      other jumps through a register go where they last went
+ *      the timing model predicts returns to every caller of a function
+ *      the timing model charges a jump through a register that goes somewhere new
+ *      jumps parse with a label, and jumps through a register with one or two registers
+ *
+ * Invalid Tests:
+ *      an empty stack, or a table size that is not a power of two, is rejected
+ *      jr with two registers and j with a register are syntax errors
+ */
+TEST_CASE("Jumps through a register are predicted from a return-address stack", "[pipeline][jumps]") {
+
+    SECTION("Returns are predicted from the return-address stack, newest first") {
+
+        JumpPredictor predictor(4, 16);
+        predictor.pushReturn(0x1004);
+        predictor.pushReturn(0x1104);
+        REQUIRE(predictor.predict(0x1200, true) == 0x1104);
+        REQUIRE(predictor.predict(0x1200, true) == 0x1004);
+    }
+
+    SECTION("A call chain deeper than the stack loses its oldest return addresses") {
+
+        JumpPredictor predictor(2, 16);
+        predictor.pushReturn(0x1004);
+        predictor.pushReturn(0x1104);
+        predictor.pushReturn(0x1204);
+        REQUIRE(predictor.predict(0x1300, true) == 0x1204);
+        REQUIRE(predictor.predict(0x1300, true) == 0x1104);
+
+        // Empty, so the return falls back to where it last went
+        predictor.update(0x1300, 0x1008);
+        REQUIRE(predictor.predict(0x1300, true) == 0x1008);
+    }
+
+    SECTION("Other jumps through a register go where they last went") {
+
+        JumpPredictor predictor(4, 16);
+        REQUIRE(predictor.predict(0x1000, false) == 0);
+        predictor.update(0x1000, 0x1400);
+        REQUIRE(predictor.predict(0x1000, false) == 0x1400);
+
+        predictor.reset();
+        REQUIRE(predictor.predict(0x1000, false) == 0);
+    }
+
+    SECTION("The timing model predicts returns to every caller of a function") {
+
+        TimingModel model{TimingModel::Config()};
+        for (Memory::addr_t caller : { 0x1000, 0x1010, 0x1020, 0x1010 }) {
+            model.consume(makeCall(caller, 0x1100));
+            model.consume(makeRecord(0x1100));
+            model.consume(makeJumpRegister(0x1104, 31));
+            model.consume(makeRecord(caller + 4));
+        }
+        model.finish();
+
+        REQUIRE(model.getStats().dwJumps == 8);
+        REQUIRE(model.getStats().dwJumpMispredictions == 0);
+        REQUIRE(model.getStats().dwCycles == 16 + model.getDepth() - 1);
+    }
+
+    SECTION("The timing model charges a jump through a register that goes somewhere new") {
+
+        TimingModel model{TimingModel::Config()};
+        for (Memory::addr_t target : { 0x1200, 0x1200, 0x1300 }) {
+            model.consume(makeJumpRegister(0x1000, 8));
+            model.consume(makeRecord(target));
+        }
+        model.finish();
+
+        REQUIRE(model.getStats().dwJumpMispredictions == 2);
+        REQUIRE(model.getStats().dwMispredictions == 0);
+        REQUIRE(model.getStats().dwCycles == 6 + 2 * model.getMispredictPenalty() + model.getDepth() - 1);
+    }
+
+    SECTION("Jumps parse with a label, and jumps through a register with one or two registers") {
+
+        std::vector<Instruction> instructions;
+        REQUIRE_NOTHROW(instructions = JumpParser("jal", static_cast<word_t>(Opcodes::OPCODE_JAL)).parse("jal fact"));
+        REQUIRE(instructions.size() == 1);
+        REQUIRE(instructions[0].getType() == InstructionType::J_FORMAT);
+        REQUIRE(instructions[0].getOpcode() == static_cast<word_t>(Opcodes::OPCODE_JAL));
+        REQUIRE(instructions[0].getLabel() == "fact");
+
+        const word_t jalr = static_cast<word_t>(Functions::FUNCT_JALR);
+        REQUIRE_NOTHROW(instructions = JumpRegisterParser("jalr", jalr).parse("jalr $t0"));
+        REQUIRE(instructions[0].getFunct() == jalr);
+        REQUIRE(instructions[0].getRs() == 8);
+        REQUIRE(instructions[0].getRd() == 31);
+
+        REQUIRE_NOTHROW(instructions = JumpRegisterParser("jalr", jalr).parse("jalr $9, $8"));
+        REQUIRE(instructions[0].getRs() == 8);
+        REQUIRE(instructions[0].getRd() == 9);
+
+        REQUIRE_NOTHROW(instructions = JumpRegisterParser("jr", static_cast<word_t>(Functions::FUNCT_JR)).parse("jr $ra"));
+        REQUIRE(instructions[0].getRs() == 31);
+        REQUIRE(instructions[0].getRd() == 0);
+    }
+
+    SECTION("An empty stack, or a table size that is not a power of two, is rejected") {
+
+        REQUIRE_THROWS_AS(JumpPredictor(0, 16), std::invalid_argument);
+        REQUIRE_THROWS_AS(JumpPredictor(4, 12), std::invalid_argument);
+
+        TimingModel::Config config;
+        config.szIndirectEntries = 0;
+        REQUIRE_THROWS_AS(TimingModel(config), std::invalid_argument);
+    }
+
+    SECTION("jr with two registers and j with a register are syntax errors") {
+        REQUIRE_THROWS_AS(JumpRegisterParser("jr", static_cast<word_t>(Functions::FUNCT_JR)).parse("jr $9, $8"), SyntaxError);
+        REQUIRE_THROWS_AS(JumpParser("j", static_cast<word_t>(Opcodes::OPCODE_J)).parse("j $8"), SyntaxError);
+    }
+}
@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "memory/memory.hpp"
+#include "pipeline/livelock_detector.hpp"
+#include "registers/register_bank.hpp"
+
+/**
+ * Class: LivelockDetector
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a loop that changes nothing is caught, with its length
+ *      a loop that only starts late is still caught
+ *      a loop that counts in a register is not caught
+ *      a loop that writes memory or makes system calls is not caught
+ *      a reset forgets the saved state
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Livelocks are caught when a run repeats itself exactly", "[pipeline][livelock]") {
+
+    const Memory::addr_t loop = Memory::MEM_USER_START + 0x10;
+    RegisterBank registers;
+    LivelockDetector detector;
+
+    SECTION("A loop that changes nothing is caught, with its length") {
+
+        // Three instructions, around and around
+        dword_t cycle = 0;
+        bool caught = false;
+        while (!caught && cycle < 100) {
+            cycle++;
+            caught = detector.check(cycle, loop + 4 * (cycle % 3), registers, 0, 0);
+        }
+
+        REQUIRE(caught);
+        REQUIRE(detector.getPeriod() == 3);
+        REQUIRE(cycle <= 2 * 4 + 3);
+    }
+
+    SECTION("A loop that only starts late is still caught") {
+
+        dword_t cycle = 0;
+        for (; cycle < 1000; ++cycle) {
+            registers.writeRegister(8, cycle);
+            REQUIRE_FALSE(detector.check(cycle + 1, loop, registers, 0, 0));
+        }
+
+        bool caught = false;
+        while (!caught && cycle < 5000) {
+            cycle++;
+            caught = detector.check(cycle, loop + 4 * (cycle % 7), registers, 0, 0);
+        }
+
+        REQUIRE(caught);
+        REQUIRE(detector.getPeriod() == 7);
+        REQUIRE(cycle <= 2 * 1024 + 7);
+    }
+
+    SECTION("A loop that counts in a register is not caught") {
+
+        for (dword_t cycle = 1; cycle <= 5000; ++cycle) {
+            if (cycle % 2 == 0) registers.writeRegister(8, cycle / 2);
+            REQUIRE_FALSE(detector.check(cycle, loop + 4 * (cycle % 2), registers, 0, 0));
+        }
+    }
+
+    SECTION("A loop that writes memory or makes system calls is not caught") {
+
+        // Four instructions, one of which stores (or makes a system call)
+        for (dword_t cycle = 1; cycle <= 5000; ++cycle)
+            REQUIRE_FALSE(detector.check(cycle, loop + 4 * (cycle % 4), registers, cycle / 4, 0));
+
+        detector.reset();
+        for (dword_t cycle = 1; cycle <= 5000; ++cycle)
+            REQUIRE_FALSE(detector.check(cycle, loop + 4 * (cycle % 4), registers, 0, cycle / 4));
+    }
+
+    SECTION("A reset forgets the saved state") {
+
+        REQUIRE_FALSE(detector.check(1, loop, registers, 0, 0));
+        detector.reset();
+        REQUIRE(detector.getPeriod() == 0);
+        REQUIRE_FALSE(detector.check(1, loop, registers, 0, 0));
+        REQUIRE(detector.check(2, loop, registers, 0, 0));
+        REQUIRE(detector.getPeriod() == 1);
+    }
+}
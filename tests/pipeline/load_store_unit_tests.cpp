@@ -0,0 +1,205 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/handlers/load_handler.hpp"
+#include "instr/handlers/store_handler.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "instr/opcodes.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "pipeline/execution_buffer.hpp"
+#include "pipeline/load_store_unit.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+// Loads and stores every width, with the word 0x8001ff7f to sign extend
+static const char * LOAD_STORE_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, byte0\n"
+    "    lw $5, 0($4)\n"
+    "    lh $6, 0($4)\n"
+    "    lhu $7, 2($4)\n"
+    "    lb $8, 0($4)\n"
+    "    lbu $9, 3($4)\n"
+    "    lb $10, 3($4)\n"
+    "    sw $5, 4($4)\n"
+    "    lw $11, 4($4)\n"
+    "    sh $6, 8($4)\n"
+    "    lhu $12, 8($4)\n"
+    "    sb $9, 10($4)\n"
+    "    lw $13, 8($4)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "byte0: .byte 0x7f\n"
+    "byte1: .byte 0xff\n"
+    "byte2: .byte 0x01\n"
+    "byte3: .byte 0x80\n"
+    "buffer: .space 12\n";
+
+/**
+ * Builds an execution buffer for a load or store.
+ * @param opcode The opcode
+ * @param addr The address
+ * @param value The value to store
+ * @return The buffer
+ */
+static ExecutionBuffer makeAccess(Opcodes opcode, Memory::addr_t addr, word_t value = 0) {
+
+    ExecutionBuffer buffer = {};
+    buffer.wOpcode = static_cast<word_t>(opcode);
+    buffer.wOutput = addr;
+    buffer.wRegDest = -1;
+    buffer.wRegValue = value;
+    return buffer;
+}
+
+/**
+ * Class: LoadStoreUnit
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a program loads and stores bytes, halfwords and words, sign extending as asked
+ *      a load covered by a buffered store is forwarded, and still reads memory
+ *      a load only partly covered by a buffered store reads memory
+ *      stores retire from the buffer when drained, or when it is full
+ *      a store to a device drains the buffer
+ *
+ * Invalid Tests:
+ *      loads and stores of sizes other than 1, 2 or 4 bytes are rejected
+ */
+TEST_CASE("The load/store unit covers every width and forwards buffered stores", "[pipeline][lsu]") {
+
+    const Memory::addr_t data = 0x1100;
+    Memory memory(0x100, 0x100);
+
+    LoadHandler lw(4, false), lhu(2, false), lb(1, true);
+    StoreHandler sw(4), sh(2), sb(1);
+    LoadStoreUnit lsu;
+
+    SECTION("A program loads and stores bytes, halfwords and words, sign extending as asked") {
+
+        auto level = spdlog::default_logger()->level();
+        spdlog::set_level(spdlog::level::off);
+
+        std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+        FileReader reader;
+        std::shared_ptr<Memory> programMemory = ProgramLoader::load(LOAD_STORE_PROGRAM, *instrSet.get(), reader);
+
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+        const RegisterBank * registers = registerBank.get();
+        Simulator simulator(std::move(instrSet), programMemory, std::move(registerBank));
+        while (simulator.step()) { }
+        spdlog::set_level(level);
+
+        word_t value = 0;
+        registers->readRegister(5, value);
+        REQUIRE(value == 0x8001FF7F);
+        registers->readRegister(6, value);
+        REQUIRE(value == 0xFFFFFF7F);
+        registers->readRegister(7, value);
+        REQUIRE(value == 0x8001);
+        registers->readRegister(8, value);
+        REQUIRE(value == 0x7F);
+        registers->readRegister(9, value);
+        REQUIRE(value == 0x80);
+        registers->readRegister(10, value);
+        REQUIRE(value == 0xFFFFFF80);
+        registers->readRegister(11, value);
+        REQUIRE(value == 0x8001FF7F);
+        registers->readRegister(12, value);
+        REQUIRE(value == 0xFF7F);
+        registers->readRegister(13, value);
+        REQUIRE(value == 0x0080FF7F);
+
+        const LoadStoreUnit::Stats& stats = simulator.getLoadStoreUnit().getStats();
+        REQUIRE(stats.dwLoads == 9);
+        REQUIRE(stats.dwStores == 3);
+        REQUIRE(stats.dwForwards == 2);
+    }
+
+    SECTION("A load covered by a buffered store is forwarded, and still reads memory") {
+
+        lsu.access(makeAccess(Opcodes::OPCODE_SW, data, 0x11223344), sw, memory);
+        REQUIRE(lsu.getBufferedStores() == 1);
+
+        std::vector<Memory::WatchHit> hits;
+        REQUIRE(memory.addWatchpoint(data, 4, Memory::WatchKind::READ) == true);
+        memory.setWatchHandler([&hits](const Memory::WatchHit& hit) { hits.push_back(hit); });
+
+        REQUIRE(lsu.access(makeAccess(Opcodes::OPCODE_LHU, data + 2), lhu, memory) == 0x1122);
+        REQUIRE(lsu.access(makeAccess(Opcodes::OPCODE_LB, data + 1), lb, memory) == 0x33);
+        REQUIRE(lsu.getStats().dwForwards == 2);
+
+        REQUIRE(hits.size() == 2);
+        REQUIRE(hits[0].wAddress == data + 2);
+        REQUIRE(hits[0].bWrite == false);
+        REQUIRE(hits[1].wAddress == data + 1);
+    }
+
+    SECTION("A load only partly covered by a buffered store reads memory") {
+
+        memory.writeWord(data, 0xAABBCCDD);
+        lsu.access(makeAccess(Opcodes::OPCODE_SB, data, 0x11), sb, memory);
+        REQUIRE(lsu.access(makeAccess(Opcodes::OPCODE_LW, data), lw, memory) == 0xAABBCC11);
+        REQUIRE(lsu.getStats().dwForwards == 0);
+
+        // The youngest overlapping store decides, even when an older one covers the load
+        lsu.access(makeAccess(Opcodes::OPCODE_SW, data + 4, 0x55667788), sw, memory);
+        lsu.access(makeAccess(Opcodes::OPCODE_SH, data + 6, 0x9900), sh, memory);
+        REQUIRE(lsu.access(makeAccess(Opcodes::OPCODE_LW, data + 4), lw, memory) == 0x99007788);
+        REQUIRE(lsu.getStats().dwForwards == 0);
+        REQUIRE(lsu.access(makeAccess(Opcodes::OPCODE_LHU, data + 6), lhu, memory) == 0x9900);
+        REQUIRE(lsu.getStats().dwForwards == 1);
+    }
+
+    SECTION("Stores retire from the buffer when drained, or when it is full") {
+
+        for (word_t i = 0; i < LoadStoreUnit::BUFFER_SIZE + 2; ++i)
+            lsu.access(makeAccess(Opcodes::OPCODE_SB, data + i, i), sb, memory);
+        REQUIRE(lsu.getBufferedStores() == LoadStoreUnit::BUFFER_SIZE);
+        REQUIRE(lsu.getStats().dwStores == LoadStoreUnit::BUFFER_SIZE + 2);
+
+        lsu.drain();
+        REQUIRE(lsu.getBufferedStores() == LoadStoreUnit::BUFFER_SIZE - 1);
+
+        // The oldest stores are gone, so their bytes come from memory
+        lsu.access(makeAccess(Opcodes::OPCODE_LB, data + 2), lb, memory);
+        REQUIRE(lsu.getStats().dwForwards == 0);
+        lsu.access(makeAccess(Opcodes::OPCODE_LB, data + 3), lb, memory);
+        REQUIRE(lsu.getStats().dwForwards == 1);
+
+        lsu.flush();
+        REQUIRE(lsu.getBufferedStores() == 0);
+    }
+
+    SECTION("A store to a device drains the buffer") {
+
+        class NullDevice : public MemoryDevice {
+        public:
+            bool read(word_t offset, byte_t * data, size_t size, dword_t& cycles) override { return true; }
+            bool write(word_t offset, const byte_t * data, size_t size, dword_t& cycles) override { return true; }
+        };
+        REQUIRE(memory.mapDevice(Memory::MMIO_START, 4, std::shared_ptr<MemoryDevice>(new NullDevice())));
+
+        lsu.access(makeAccess(Opcodes::OPCODE_SW, data, 1), sw, memory);
+        lsu.access(makeAccess(Opcodes::OPCODE_SB, Memory::MMIO_START, 1), sb, memory);
+        REQUIRE(lsu.getBufferedStores() == 0);
+        REQUIRE(lsu.getStats().dwStores == 2);
+    }
+
+    SECTION("Loads and stores of sizes other than 1, 2 or 4 bytes are rejected") {
+        REQUIRE_THROWS_AS(LoadHandler(3, false), std::invalid_argument);
+        REQUIRE_THROWS_AS(StoreHandler(8), std::invalid_argument);
+    }
+}
@@ -0,0 +1,213 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "exception/syntax_error.hpp"
+#include "instr/functions.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "instr/opcodes.hpp"
+#include "instr/parsers/multiply_divide_parser.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "pipeline/multiply_divide_unit.hpp"
+#include "pipeline/retire_record.hpp"
+#include "pipeline/timing_model.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+// Multiplies and divides -7 by 3 every way, then divides by zero and INT_MIN by -1
+static const char * MULTIPLY_DIVIDE_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    addi $8, $0, -7\n"
+    "    addi $9, $0, 3\n"
+    "    mult $8, $9\n"
+    "    mfhi $10\n"
+    "    mflo $11\n"
+    "    multu $8, $9\n"
+    "    mfhi $12\n"
+    "    div $8, $9\n"
+    "    mflo $13\n"
+    "    mfhi $14\n"
+    "    divu $8, $9\n"
+    "    mflo $15\n"
+    "    mfhi $16\n"
+    "    div $8, $0\n"
+    "    mflo $17\n"
+    "    lui $18, 0x8000\n"
+    "    addi $19, $0, -1\n"
+    "    div $18, $19\n"
+    "    mflo $20\n"
+    "    mfhi $21\n"
+    "    mthi $9\n"
+    "    mtlo $8\n"
+    "    mfhi $22\n"
+    "    mflo $23\n"
+    "    li $2, 10\n"
+    "    syscall\n";
+
+/**
+ * Builds a record for an instruction of the multiply/divide unit.
+ * @param pc The address
+ * @param funct The funct
+ * @param dest The register written
+ * @return The record
+ */
+static RetireRecord makeRecord(Memory::addr_t pc, Functions funct, word_t dest) {
+
+    RetireRecord record;
+    record.wPC = pc;
+    record.wOpcode = static_cast<word_t>(Opcodes::OPCODE_R_TYPE);
+    record.wFunct = static_cast<word_t>(funct);
+    record.wRegDest = dest;
+    record.wRegSrc1 = 8;
+    record.wRegSrc2 = 9;
+    return record;
+}
+
+/**
+ * Class: MultiplyDivideUnit
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a program multiplies, divides and moves to and from HI and LO
+ *      a move from LO right after a multiply waits for the multiply's latency
+ *      a pipelined multiplier takes a multiply every cycle, but a divide holds the unit
+ *      an unpipelined multiplier holds the unit for the whole multiply
+ *      the timing model charges the unit's stalls
+ *      the instructions parse with one or two registers
+ *
+ * Invalid Tests:
+ *      a latency of 0 is rejected
+ *      a multiply with one register is a syntax error
+ */
+TEST_CASE("The multiply/divide unit computes into HI and LO and stalls early reads", "[pipeline][mdu]") {
+
+    const word_t mult = static_cast<word_t>(Functions::FUNCT_MULT);
+    const word_t div = static_cast<word_t>(Functions::FUNCT_DIV);
+    const word_t mflo = static_cast<word_t>(Functions::FUNCT_MFLO);
+
+    MultiplyDivideUnit::Config config;
+    config.dwMultiplyLatency = 4;
+    config.dwDivideLatency = 10;
+
+    SECTION("A program multiplies, divides and moves to and from HI and LO") {
+
+        auto level = spdlog::default_logger()->level();
+        spdlog::set_level(spdlog::level::off);
+
+        std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+        FileReader reader;
+        std::shared_ptr<Memory> programMemory = ProgramLoader::load(MULTIPLY_DIVIDE_PROGRAM, *instrSet.get(), reader);
+
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+        const RegisterBank * registers = registerBank.get();
+        Simulator simulator(std::move(instrSet), programMemory, std::move(registerBank));
+        while (simulator.step()) { }
+        spdlog::set_level(level);
+
+        const word_t expected[][2] = {
+            { 10, 0xFFFFFFFF }, { 11, 0xFFFFFFEB },     // -7 * 3
+            { 12, 2 },                                  // 0xFFFFFFF9 * 3
+            { 13, 0xFFFFFFFE }, { 14, 0xFFFFFFFF },     // -7 / 3 and -7 % 3
+            { 15, 0x55555553 }, { 16, 0 },              // 0xFFFFFFF9 / 3 and % 3
+            { 17, 0x55555553 },                         // Dividing by zero changes nothing
+            { 20, 0x80000000 }, { 21, 0 },              // INT_MIN / -1
+            { 22, 3 }, { 23, 0xFFFFFFF9 }
+        };
+
+        for (const auto& reg : expected) {
+            word_t value = 0;
+            registers->readRegister(reg[0], value);
+            INFO("register $" << reg[0]);
+            REQUIRE(value == reg[1]);
+        }
+
+        // Each multiply is read the cycle after, and each divide too
+        const MultiplyDivideUnit::Stats& stats = simulator.getMultiplyDivideUnit().getStats();
+        const MultiplyDivideUnit::Config defaults;
+        REQUIRE(stats.dwMultiplies == 2);
+        REQUIRE(stats.dwDivides == 4);
+        REQUIRE(stats.dwStalls == 2 * (defaults.dwMultiplyLatency - 1) + 4 * (defaults.dwDivideLatency - 1));
+    }
+
+    SECTION("A move from LO right after a multiply waits for the multiply's latency") {
+
+        MultiplyDivideUnit unit(config);
+        REQUIRE(unit.issue(mult, 100) == 0);
+        REQUIRE(unit.issue(mflo, 101) == 3);
+        REQUIRE(unit.issue(mflo, 104) == 0);
+        REQUIRE(unit.getStats().dwStalls == 3);
+    }
+
+    SECTION("A pipelined multiplier takes a multiply every cycle, but a divide holds the unit") {
+
+        MultiplyDivideUnit unit(config);
+        REQUIRE(unit.issue(mult, 0) == 0);
+        REQUIRE(unit.issue(mult, 1) == 0);
+        REQUIRE(unit.issue(div, 2) == 0);
+        REQUIRE(unit.issue(mult, 3) == 9);
+        REQUIRE(unit.getStats().dwMultiplies == 3);
+        REQUIRE(unit.getStats().dwDivides == 1);
+    }
+
+    SECTION("An unpipelined multiplier holds the unit for the whole multiply") {
+
+        config.bPipelinedMultiply = false;
+        MultiplyDivideUnit unit(config);
+        REQUIRE(unit.issue(mult, 0) == 0);
+        REQUIRE(unit.issue(mult, 1) == 3);
+    }
+
+    SECTION("The timing model charges the unit's stalls") {
+
+        TimingModel::Config timingConfig;
+        timingConfig.mdu = config;
+        TimingModel model(timingConfig);
+
+        model.consume(makeRecord(0x1000, Functions::FUNCT_MULT, -1));
+        model.consume(makeRecord(0x1004, Functions::FUNCT_MFLO, 10));
+        model.finish();
+
+        REQUIRE(model.getStats().dwMduStalls == 3);
+        REQUIRE(model.getStats().dwCycles == 2 + 3 + model.getDepth() - 1);
+    }
+
+    SECTION("The instructions parse with one or two registers") {
+
+        std::vector<Instruction> instructions;
+        REQUIRE_NOTHROW(instructions = MultiplyDivideParser("multu", static_cast<word_t>(Functions::FUNCT_MULTU)).parse("multu $8, $9"));
+        REQUIRE(instructions.size() == 1);
+        REQUIRE(instructions[0].getFunct() == static_cast<word_t>(Functions::FUNCT_MULTU));
+        REQUIRE(instructions[0].getRs() == 8);
+        REQUIRE(instructions[0].getRt() == 9);
+        REQUIRE(instructions[0].getRd() == 0);
+
+        REQUIRE_NOTHROW(instructions = MultiplyDivideParser("mfhi", static_cast<word_t>(Functions::FUNCT_MFHI)).parse("mfhi $t0"));
+        REQUIRE(instructions[0].getRd() == 8);
+        REQUIRE(instructions[0].getRs() == 0);
+
+        REQUIRE_NOTHROW(instructions = MultiplyDivideParser("mtlo", static_cast<word_t>(Functions::FUNCT_MTLO)).parse("mtlo $t1"));
+        REQUIRE(instructions[0].getRs() == 9);
+        REQUIRE(instructions[0].getRd() == 0);
+    }
+
+    SECTION("A latency of 0 is rejected") {
+        config.dwDivideLatency = 0;
+        REQUIRE_THROWS_AS(MultiplyDivideUnit(config), std::invalid_argument);
+    }
+
+    SECTION("A multiply with one register is a syntax error") {
+        REQUIRE_THROWS_AS(MultiplyDivideParser("mult", mult).parse("mult $8"), SyntaxError);
+        REQUIRE_THROWS_AS(MultiplyDivideParser("mfhi", static_cast<word_t>(Functions::FUNCT_MFHI)).parse("mfhi $8, $9"), SyntaxError);
+    }
+}
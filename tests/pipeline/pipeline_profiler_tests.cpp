@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "pipeline/pipeline_profiler.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+/**
+ * Class: PipelineProfiler
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      cycles are attributed to the address they were recorded at
+ *      addresses are grouped under the nearest label before them
+ *      folded stacks have one line per hot address
+ *      a profiled run attributes every cycle, and FileReader keeps its symbols for it
+ *
+ * Invalid Tests:
+ *      addresses outside the text segment are counted separately
+ *      symbols outside the text segment are ignored
+ */
+TEST_CASE("Cycles are attributed to addresses and labels", "[profile]") {
+
+    PipelineProfiler profiler(PipelineStage::EX, 0x20);
+    profiler.setSymbols({ { "main", 0x1000 }, { "loop", 0x1008 }, { "done", 0x1018 }, { "buffer", 0x1020 } });
+
+    // main runs once, the loop three times, and done once
+    profiler.record(0x1000);
+    profiler.record(0x1004);
+    for (int i = 0; i < 3; ++i) {
+        for (Memory::addr_t pc = 0x1008; pc < 0x1018; pc += 4)
+            profiler.record(pc);
+    }
+    profiler.record(0x1018);
+
+    SECTION("Cycles are attributed to their address") {
+
+        REQUIRE(profiler.getCycles(0x1000) == 1);
+        REQUIRE(profiler.getCycles(0x100c) == 3);
+        REQUIRE(profiler.getCycles(0x101c) == 0);
+        REQUIRE(profiler.getTotalCycles() == 15);
+        REQUIRE(profiler.getStage() == PipelineStage::EX);
+    }
+
+    SECTION("Addresses are grouped under the nearest label before them") {
+
+        REQUIRE(profiler.getLabel(0x1004) == "main");
+        REQUIRE(profiler.getLabel(0x1014) == "loop");
+        REQUIRE(profiler.getLabel(0x101c) == "done");
+
+        std::vector<PipelineProfiler::Entry> labels = profiler.getHotLabels();
+        REQUIRE(labels.size() == 3);
+        REQUIRE(labels[0].strName == "loop");
+        REQUIRE(labels[0].dwCycles == 12);
+        REQUIRE(labels[1].strName == "main");
+        REQUIRE(labels[1].dwCycles == 2);
+
+        std::vector<PipelineProfiler::Entry> addresses = profiler.getHotAddresses(2);
+        REQUIRE(addresses.size() == 2);
+        REQUIRE(addresses[0].strName == "0x00001008");
+        REQUIRE(addresses[0].dwCycles == 3);
+    }
+
+    SECTION("Folded stacks have one line per hot address") {
+
+        std::stringstream stream;
+        profiler.writeFolded(stream);
+
+        std::string folded = stream.str();
+        REQUIRE(folded.find("main;0x00001000 1\n") == 0);
+        REQUIRE(folded.find("loop;0x00001014 3\n") != std::string::npos);
+        REQUIRE(folded.find("done;0x00001018 1\n") != std::string::npos);
+        REQUIRE(std::count(folded.begin(), folded.end(), '\n') == 7);
+    }
+
+    SECTION("Addresses outside the text segment are counted separately") {
+
+        profiler.record(0x0ffc);
+        profiler.record(0x1020);
+
+        REQUIRE(profiler.getOutsideCycles() == 2);
+        REQUIRE(profiler.getTotalCycles() == 17);
+        REQUIRE(profiler.getCycles(0x1020) == 0);
+        REQUIRE(profiler.getHotLabels().size() == 4);
+        REQUIRE(profiler.getHotLabels()[2].strName == "[outside text]");
+    }
+
+    SECTION("Symbols outside the text segment are ignored") {
+
+        REQUIRE(profiler.getLabel(0x1020) == "done");
+    }
+}
+
+TEST_CASE("A profiled run attributes every cycle", "[profile]") {
+
+    std::string path = "pipesim_profile_test.tmp";
+    {
+        std::ofstream file(path);
+        file << ".text\n"
+             << "main:\n"
+             << "    li $8, 4\n"
+             << "loop:\n"
+             << "    subi $8, $8, 1\n"
+             << "    bne $8, $0, loop\n"
+             << "    nop\n"
+             << "    li $2, 10\n"
+             << "    syscall\n"
+             << ".data\n"
+             << "value: .space 4\n";
+    }
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    std::unique_ptr<Memory> memory(new Memory(0x1000, 0x1000));
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+
+    FileReader reader;
+    REQUIRE(reader.readFile(path, *instrSet.get(), *memory.get()) == true);
+    std::remove(path.c_str());
+
+    REQUIRE(reader.getSymbols().size() == 3);
+    REQUIRE(reader.getSymbols().at("loop") == 0x1004);
+
+    std::unique_ptr<PipelineProfiler> profiler(new PipelineProfiler(PipelineStage::WB, memory->getTextSize()));
+    profiler->setSymbols(reader.getSymbols());
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+    InstrumentedSimulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+    simulator.getInstrumentation().setProfiler(std::move(profiler));
+    simulator.run();
+    spdlog::set_level(level);
+
+    const PipelineProfiler * result = simulator.getInstrumentation().getProfiler();
+    REQUIRE(result->getTotalCycles() == simulator.getStats().dwClockCycles);
+    REQUIRE(result->getCycles(0x1004) == 4);
+    REQUIRE(result->getHotLabels(1).front().strName == "loop");
+}
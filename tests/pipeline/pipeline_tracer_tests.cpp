@@ -0,0 +1,153 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "pipeline/chrome_tracer.hpp"
+#include "pipeline/konata_tracer.hpp"
+
+/**
+ * Reads a whole file into a string.
+ * @param path The file
+ * @return The contents
+ */
+static std::string readAll(const std::string& path) {
+
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/**
+ * Counts how many times a string appears in another.
+ * @param str The string to search
+ * @param needle The string to search for
+ * @return The count
+ */
+static size_t count(const std::string& str, const std::string& needle) {
+
+    size_t total = 0;
+    for (size_t pos = str.find(needle); pos != std::string::npos; pos = str.find(needle, pos + 1))
+        total++;
+
+    return total;
+}
+
+/**
+ * Runs a small, made-up pipeline through a tracer: one instruction is fetched
+ * every cycle and moves one stage further each cycle after that.
+ * @param tracer The tracer
+ * @param cycles The number of cycles
+ */
+static void runPipeline(PipelineTracer& tracer, dword_t cycles) {
+
+    for (dword_t cycle = 0; cycle < cycles; ++cycle) {
+
+        tracer.beginCycle(cycle);
+        tracer.recordFetch(cycle, 0x1000 + 4 * cycle, "add", cycle % 3 == 2);
+        for (size_t stage = 0; stage < NUM_PIPELINE_STAGES && stage <= cycle; ++stage)
+            tracer.recordStage(static_cast<PipelineStage>(stage), cycle - stage);
+
+        if (cycle >= 2)
+            tracer.recordForward(cycle - 2, 8, PipelineStage::MEM, cycle - 3);
+
+        if (cycle >= NUM_PIPELINE_STAGES - 1)
+            tracer.recordRetire(cycle - (NUM_PIPELINE_STAGES - 1));
+    }
+
+    tracer.finish();
+}
+
+/**
+ * Class: PipelineTracer (via ChromeTracer and KonataTracer)
+ * Desired Confidence Level: Basic validation
+ * 
+ * Valid Tests:
+ *      a Konata trace has one slice per stage per instruction, retires what completed,
+ *          and flushes what was still in flight
+ *      a Konata trace limited to a window only holds those cycles
+ *      a Chrome trace is a complete JSON array with one slice per stage per instruction
+ *      a trace with a window past the end of the run is empty but well-formed
+ * 
+ * Invalid Tests:
+ *      opening a trace in a directory that does not exist fails
+ */
+TEST_CASE("Pipeline traces are streamed properly", "[trace]") {
+
+    std::string path = "pipesim_trace_test.tmp";
+
+    SECTION("A Konata trace records every stage, retirement and flush") {
+        {
+            KonataTracer tracer;
+            REQUIRE(tracer.open(path) == true);
+            runPipeline(tracer, 10);
+        }
+
+        std::string trace = readAll(path);
+        REQUIRE(trace.find("Kanata\t0004\nC=\t0\n") == 0);
+        REQUIRE(count(trace, "\nI\t") == 10);
+        REQUIRE(count(trace, "\tIF\n") == 10);
+        REQUIRE(count(trace, "\tWB\n") == 6);
+        REQUIRE(count(trace, "\t0\n") >= 6);
+        REQUIRE(count(trace, "\nC\t1\n") == 9);
+        REQUIRE(count(trace, "forward $8 from MEM") == 8);
+        REQUIRE(trace.find("L\t2\t0\t00001008 nop\n") != std::string::npos);
+
+        // Six made it out, and the last four were still in flight
+        REQUIRE(count(trace, "\nR\t") == 10);
+        REQUIRE(trace.find("R\t9\t9\t1\n") != std::string::npos);
+    }
+
+    SECTION("A Konata trace limited to a window only holds those cycles") {
+        {
+            KonataTracer tracer(4, 3);
+            REQUIRE(tracer.open(path) == true);
+            runPipeline(tracer, 20);
+        }
+
+        std::string trace = readAll(path);
+        REQUIRE(trace.find("C=\t4\n") != std::string::npos);
+        REQUIRE(count(trace, "\nC\t1\n") == 2);
+        REQUIRE(count(trace, "\tIF\n") == 3);
+        REQUIRE(count(trace, "\tWB\n") == 3);
+    }
+
+    SECTION("A Chrome trace is a complete array with one slice per stage") {
+        {
+            ChromeTracer tracer;
+            REQUIRE(tracer.open(path) == true);
+            runPipeline(tracer, 10);
+        }
+
+        std::string trace = readAll(path);
+        REQUIRE(trace.front() == '[');
+        REQUIRE(trace.substr(trace.length() - 3) == "\n]\n");
+        REQUIRE(count(trace, "\"ph\":\"X\"") == 10 + 9 + 8 + 7 + 6);
+        REQUIRE(count(trace, "\"cat\":\"bubble\"") == 5 + 5 + 2);
+        REQUIRE(count(trace, "\"thread_name\"") == NUM_PIPELINE_STAGES);
+        REQUIRE(count(trace, "},\n{") + 1 == count(trace, "\n{"));
+    }
+
+    SECTION("A trace with a window past the end of the run is empty but well-formed") {
+        {
+            ChromeTracer tracer(100, 10);
+            REQUIRE(tracer.open(path) == true);
+            runPipeline(tracer, 10);
+        }
+
+        std::string trace = readAll(path);
+        REQUIRE(count(trace, "\"ph\":\"X\"") == 0);
+        REQUIRE(trace.substr(trace.length() - 3) == "\n]\n");
+    }
+
+    SECTION("Opening a trace in a directory that does not exist fails") {
+
+        KonataTracer tracer;
+        REQUIRE_FALSE(tracer.open("no/such/directory/trace.log"));
+    }
+
+    std::remove(path.c_str());
+}
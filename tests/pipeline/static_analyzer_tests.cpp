@@ -0,0 +1,185 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "instr/instruction_type.hpp"
+#include "instr/opcodes.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "pipeline/predecoded_instruction.hpp"
+#include "pipeline/static_analyzer.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+// Loads and uses values straight away, with two branches and a jump through a register
+static const char * HAZARD_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    addi $4, $0, 8\n"
+    "    lw $5, 0($4)\n"
+    "    add $6, $5, $4\n"
+    "    beq $6, $5, main\n"
+    "    addi $7, $0, 2\n"
+    "    addi $8, $0, 3\n"
+    "    bne $7, $0, done\n"
+    "    nop\n"
+    "done:\n"
+    "    jr $9\n";
+
+/**
+ * Loads a program.
+ * @param program The program's source
+ * @param instrSet The instruction set
+ * @return The loaded memory
+ */
+static std::shared_ptr<Memory> loadProgram(const char * program, InstructionSet& instrSet) {
+    FileReader reader;
+    return ProgramLoader::load(program, instrSet, reader);
+}
+
+/**
+ * Class: StaticAnalyzer
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      every instruction is decoded as the decode stage would
+ *      hazards are classified against the two instructions falling through
+ *      writes to the text segment are counted, and the simulator runs the same once it changes
+ *
+ * Invalid Tests:
+ *      illegal instructions are reported by address
+ */
+TEST_CASE("The static analyzer predecodes the text and classifies its hazards", "[pipeline][analyzer]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    std::shared_ptr<Memory> memory = loadProgram(HAZARD_PROGRAM, *instrSet.get());
+
+    StaticAnalyzer analyzer(*instrSet.get());
+    std::vector<PredecodedInstruction> stream;
+    StaticAnalyzer::Report report;
+
+    SECTION("Every instruction is decoded as the decode stage would") {
+
+        REQUIRE(analyzer.analyze(*memory.get(), stream, report));
+        REQUIRE(stream.size() == memory->getTextSize() / 4);
+        REQUIRE(report.dwInstructions == stream.size());
+        REQUIRE(report.vecIllegal.empty());
+
+        REQUIRE(stream[0].wOpcode == static_cast<word_t>(Opcodes::OPCODE_ADDI));
+        REQUIRE(stream[0].wRegDest == 4);
+        REQUIRE(stream[0].wRegSrc1 == 0);
+        REQUIRE(stream[0].wRegSrc2 == -1);
+        REQUIRE(stream[0].wImmediate == 8);
+        REQUIRE(stream[0].ptrHandler != nullptr);
+
+        // Branches read RT as their second source
+        REQUIRE(stream[3].bReadsInDecode);
+        REQUIRE(stream[3].wRegSrc1 + stream[3].wRegSrc2 == 6 + 5);
+        REQUIRE(stream[3].wRegSrc2 != -1);
+
+        REQUIRE(stream[8].bReadsInDecode);
+        REQUIRE(stream[8].wRegSrc1 == 9);
+        REQUIRE_FALSE(stream[2].bReadsInDecode);
+
+        // What is past the program is all NOPs
+        REQUIRE(stream[9].wInstruction == 0);
+        REQUIRE(stream[9].ptrHandler != nullptr);
+    }
+
+    SECTION("Hazards are classified against the two instructions falling through") {
+
+        REQUIRE(analyzer.analyze(*memory.get(), stream, report));
+
+        // The load reads the addi right before it, and the add uses the load straight away
+        REQUIRE(stream[1].dwRawDistance == 1);
+        REQUIRE_FALSE(stream[1].bLoadUse);
+        REQUIRE(stream[2].dwRawDistance == 1);
+        REQUIRE(stream[2].bLoadUse);
+
+        // beq waits a cycle for the add, and the load two ahead is no sooner
+        REQUIRE(stream[3].bDecodeHazard);
+        REQUIRE(stream[3].dwRawDistance == 1);
+        REQUIRE(stream[3].dwDecodeStall == 1);
+
+        // bne forwards from two ahead, which has its result by then
+        REQUIRE(stream[6].bDecodeHazard);
+        REQUIRE(stream[6].dwRawDistance == 2);
+        REQUIRE(stream[6].dwDecodeStall == 0);
+
+        // Nothing falling through into the jump writes $9
+        REQUIRE_FALSE(stream[8].bDecodeHazard);
+        REQUIRE(stream[8].dwRawDistance == 0);
+
+        REQUIRE(report.dwRawHazards == 4);
+        REQUIRE(report.dwLoadUses == 1);
+        REQUIRE(report.dwDecodeHazards == 2);
+        REQUIRE(report.dwDecodeStalls == 1);
+    }
+
+    SECTION("Writes to the text segment are counted, and the simulator runs the same once it changes") {
+
+        const char * program =
+            ".text\n"
+            "main:\n"
+            "    la $4, patch\n"
+            "    lw $5, 0($4)\n"
+            "    la $6, target\n"
+            "    sw $5, 0($6)\n"
+            "    li $7, 3\n"
+            "target:\n"
+            "    nop\n"
+            "    li $2, 10\n"
+            "    syscall\n"
+            "patch:\n"
+            "    addi $7, $7, 1\n";
+
+        std::shared_ptr<Memory> patched = loadProgram(program, *instrSet.get());
+        dword_t writes = patched->getTextWrites();
+        REQUIRE(writes > 0);
+
+        std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+        RegisterBank * registers = registerBank.get();
+        Simulator simulator(InstructionSetFactory::createDefault(), patched, std::move(registerBank));
+        simulator.run();
+
+        // The stored instruction replaced the NOP, and was run rather than its stale decode
+        word_t value = 0;
+        registers->readRegister(7, value);
+        REQUIRE(value == 4);
+        REQUIRE(patched->getTextWrites() == writes + 1);
+
+        // Writes to the data segment are not counted
+        patched->writeWord(Memory::MEM_USER_START + patched->getTextSize(), 1);
+        REQUIRE(patched->getTextWrites() == writes + 1);
+    }
+
+    SECTION("Illegal instructions are reported by address") {
+
+        word_t illegal = Instruction::LIMIT_OPCODE - 1;
+        REQUIRE(instrSet->getType(illegal) == InstructionType::UNKNOWN);
+
+        Memory::addr_t addr = Memory::MEM_USER_START + 4 * 7;
+        memory->writeWord(addr, illegal);
+        REQUIRE_FALSE(analyzer.analyze(*memory.get(), stream, report));
+        REQUIRE(report.vecIllegal.size() == 1);
+        REQUIRE(report.vecIllegal[0] == addr);
+        REQUIRE(stream[7].ptrHandler == nullptr);
+
+        // It may be anything by the time it runs, so the jump after it may depend on it
+        REQUIRE(stream[8].bDecodeHazard);
+    }
+
+    spdlog::set_level(level);
+}
@@ -0,0 +1,214 @@
+#include "catch.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include "pipeline/retire_record.hpp"
+#include "pipeline/timing_model.hpp"
+
+/**
+ * Builds a record for an ALU instruction.
+ * @param pc The address
+ * @param dest The register written
+ * @param src1 The first register read
+ * @param src2 The second register read
+ * @return The record
+ */
+static RetireRecord makeRecord(Memory::addr_t pc, word_t dest, word_t src1, word_t src2) {
+
+    RetireRecord record;
+    record.wPC = pc;
+    record.wRegDest = dest;
+    record.wRegSrc1 = src1;
+    record.wRegSrc2 = src2;
+    return record;
+}
+
+/**
+ * Class: TimingModel
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      straight-line code takes one cycle per instruction plus the pipeline fill
+ *      an instruction using the load just before it stalls
+ *      a branch waits in decode on the ALU instruction just before it
+ *      a mispredicted branch costs the penalty and asks for wrong-path instructions
+ *      the predictor learns a branch that is always taken
+ *
+ * Invalid Tests:
+ *      a predictor size that is not a power of two is rejected
+ *      stages that are missing or out of order are rejected
+ *      a split decode stage is rejected
+ */
+TEST_CASE("The timing model charges hazards and mispredictions", "[timing]") {
+
+    TimingModel::Config config;
+    TimingModel model(config);
+
+    SECTION("Straight-line code takes one cycle per instruction plus the pipeline fill") {
+
+        model.consume(makeRecord(0x1000, 8, 9, 10));
+        model.consume(makeRecord(0x1004, 11, 8, 8));
+        model.finish();
+
+        REQUIRE(model.getStats().dwInstructions == 2);
+        REQUIRE(model.getStats().dwCycles == 2 + model.getDepth() - 1);
+        REQUIRE(model.getStats().dwLoadUseStalls == 0);
+    }
+
+    SECTION("An instruction using the load just before it stalls") {
+
+        RetireRecord load = makeRecord(0x1000, 8, 9, -1);
+        load.bLoad = true;
+        model.consume(load);
+        model.consume(makeRecord(0x1004, 10, 11, 12));
+        model.consume(load);
+        model.consume(makeRecord(0x1008, 10, 11, 8));
+        model.finish();
+
+        REQUIRE(model.getStats().dwLoadUseStalls == 1);
+        REQUIRE(model.getStats().dwCycles == 4 + 1 + model.getDepth() - 1);
+    }
+
+    SECTION("A branch waits in decode on the ALU instruction just before it") {
+
+        RetireRecord branch = makeRecord(0x1004, -1, 8, 0);
+        branch.bBranch = true;
+        branch.wTarget = 0x1010;
+        model.consume(makeRecord(0x1000, 8, 9, 10));
+        model.consume(branch);
+        model.consume(makeRecord(0x1008, 11, 8, 8));
+        model.finish();
+
+        REQUIRE(model.getStats().dwAluStalls == 1);
+        REQUIRE(model.getStats().dwLoadUseStalls == 0);
+        REQUIRE(model.getStats().dwCycles == 3 + 1 + model.getDepth() - 1);
+    }
+
+    SECTION("A mispredicted branch costs the penalty and asks for wrong-path instructions") {
+
+        std::vector<Memory::addr_t> requested;
+        model.setWrongPathSource([&requested](Memory::addr_t pc, size_t count, std::vector<RetireRecord>& records) {
+            requested.push_back(pc);
+            for (size_t i = 0; i < count; ++i)
+                records.push_back(RetireRecord());
+        });
+
+        // Predicted not taken (the counters start weakly not taken), but taken
+        RetireRecord branch = makeRecord(0x1000, -1, 8, 9);
+        branch.bBranch = true;
+        branch.wTarget = 0x1010;
+        model.consume(branch);
+        model.consume(makeRecord(0x1010, 8, 8, 8));
+        model.finish();
+
+        REQUIRE(model.getStats().dwBranches == 1);
+        REQUIRE(model.getStats().dwMispredictions == 1);
+        REQUIRE(model.getStats().dwWrongPathRecords == model.getMispredictPenalty());
+        REQUIRE(requested == std::vector<Memory::addr_t>({ 0x1004 }));
+    }
+
+    SECTION("The predictor learns a branch that is always taken") {
+
+        RetireRecord branch = makeRecord(0x1004, -1, 8, 9);
+        branch.bBranch = true;
+        branch.wTarget = 0x1000;
+        for (int i = 0; i < 10; ++i) {
+            model.consume(makeRecord(0x1000, 8, 8, 8));
+            model.consume(branch);
+        }
+        model.consume(makeRecord(0x1000, 8, 8, 8));
+        model.finish();
+
+        REQUIRE(model.getStats().dwBranches == 10);
+        REQUIRE(model.getStats().dwMispredictions == 1);
+
+        model.reset();
+        REQUIRE(model.getStats().dwCycles == 0);
+    }
+
+    SECTION("A predictor size that is not a power of two is rejected") {
+
+        TimingModel::Config bad;
+        bad.szPredictorEntries = 100;
+        REQUIRE_THROWS_AS(TimingModel(bad), std::invalid_argument);
+    }
+
+    SECTION("Stages that are missing or out of order are rejected") {
+
+        TimingModel::Config bad;
+        bad.vecStages = { PipelineStage::IF, PipelineStage::ID, PipelineStage::MEM, PipelineStage::WB };
+        REQUIRE_THROWS_AS(TimingModel(bad), std::invalid_argument);
+
+        bad.vecStages = { PipelineStage::IF, PipelineStage::EX, PipelineStage::ID, PipelineStage::MEM, PipelineStage::WB };
+        REQUIRE_THROWS_AS(TimingModel(bad), std::invalid_argument);
+
+        bad.vecStages.clear();
+        REQUIRE_THROWS_AS(TimingModel(bad), std::invalid_argument);
+    }
+
+    SECTION("A split decode stage is rejected") {
+
+        TimingModel::Config bad;
+        bad.vecStages = { PipelineStage::IF, PipelineStage::ID, PipelineStage::ID, PipelineStage::EX, PipelineStage::MEM, PipelineStage::WB };
+        REQUIRE_THROWS_AS(TimingModel(bad), std::invalid_argument);
+    }
+}
+
+/**
+ * Class: TimingModel
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      the presets have 5 and 8 stages, and resolve branches one and two cycles in
+ *      a split execute stage stalls dependent ALU instructions
+ *      a split memory stage lengthens load-use stalls
+ *      a deeper pipeline has a higher CPI on the same instructions
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("The timing model's hazards follow its stage latencies", "[timing]") {
+
+    TimingModel classic(TimingModel::Config::fiveStage());
+    TimingModel deep(TimingModel::Config::eightStage());
+
+    // A load, an ALU instruction using it, then a branch on the ALU result
+    RetireRecord load = makeRecord(0x1000, 8, 9, -1);
+    load.bLoad = true;
+    RetireRecord branch = makeRecord(0x1008, -1, 10, 0);
+    branch.bBranch = true;
+    branch.wTarget = 0x1100;
+    std::vector<RetireRecord> records = { load, makeRecord(0x1004, 10, 8, 8), branch, makeRecord(0x100c, 11, 0, 0) };
+
+    for (const RetireRecord& record : records) {
+        classic.consume(record);
+        deep.consume(record);
+    }
+    classic.finish();
+    deep.finish();
+
+    SECTION("The presets have 5 and 8 stages, and resolve branches one and two cycles in") {
+        REQUIRE(classic.getDepth() == 5);
+        REQUIRE(classic.getMispredictPenalty() == 1);
+        REQUIRE(deep.getDepth() == 8);
+        REQUIRE(deep.getMispredictPenalty() == 2);
+    }
+
+    SECTION("A split execute stage stalls dependent ALU instructions") {
+
+        // The branch reads in decode: one cycle behind EX on 5 stages, two behind the second EX on 8
+        REQUIRE(classic.getStats().dwAluStalls == 1);
+        REQUIRE(deep.getStats().dwAluStalls == 2);
+    }
+
+    SECTION("A split memory stage lengthens load-use stalls") {
+        REQUIRE(classic.getStats().dwLoadUseStalls == 1);
+        REQUIRE(deep.getStats().dwLoadUseStalls == 3);
+    }
+
+    SECTION("A deeper pipeline has a higher CPI on the same instructions") {
+        REQUIRE(classic.getStats().dwCycles == 4 + 1 + 1 + 4);
+        REQUIRE(deep.getStats().dwCycles == 4 + 3 + 2 + 7);
+    }
+}
@@ -0,0 +1,261 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/handlers/syscall_handler.hpp"
+#include "instr/instruction.hpp"
+#include "instr/instruction_encoder.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "instr/opcodes.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "pipeline/pipeline_stage.hpp"
+#include "pipeline/timing_model.hpp"
+#include "reader/file_reader.hpp"
+#include "reader/instruction_scheduler.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+// Sums a string of bytes, padded with NOPs by hand, with each load used straight away
+static const char * NOP_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, values\n"
+    "    li $5, 0\n"
+    "    li $6, 6\n"
+    "    nop\n"
+    "loop:\n"
+    "    lb $7, 0($4)\n"
+    "    add $5, $5, $7\n"
+    "    addi $4, $4, 1\n"
+    "    subi $6, $6, 1\n"
+    "    nop\n"
+    "    nop\n"
+    "    bne $6, $0, loop\n"
+    "    nop\n"
+    "    la $4, total\n"
+    "    sb $5, 0($4)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "values: .asciiz \"abcdef\"\n"
+    "total: .space 1\n";
+
+// Reads a number and branches on it straight after the system call, storing which way it went
+static const char * SYSCALL_BRANCH_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $2, 5\n"
+    "    syscall\n"
+    "    nop\n"
+    "    beq $2, $0, zero\n"
+    "    li $4, 1\n"
+    "    j done\n"
+    "zero:\n"
+    "    li $4, 0\n"
+    "done:\n"
+    "    la $5, result\n"
+    "    sw $4, 0($5)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "result: .word 7\n";
+
+/**
+ * Loads a program.
+ * @param program The program's source
+ * @param scheduler The scheduler, or nullptr for none
+ * @param reader The reader, to find symbols with
+ * @return The loaded memory
+ */
+static std::shared_ptr<Memory> loadProgram(const char * program, std::unique_ptr<InstructionScheduler> scheduler, FileReader& reader) {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    reader.setScheduler(std::move(scheduler));
+    return ProgramLoader::load(program, *instrSet.get(), reader);
+}
+
+/**
+ * Runs a program, with its console input a single number.
+ * @param memory The loaded memory
+ * @param input The number to read
+ */
+static void runWithInput(std::shared_ptr<Memory> memory, const std::string& input) {
+
+    std::unique_ptr<SyscallHandler> syscallHandler(new SyscallHandler());
+    syscallHandler->getInputFeed().setFallback(nullptr);
+    syscallHandler->getInputFeed().queueInput(input);
+
+    Simulator simulator(InstructionSetFactory::createDefault(std::move(syscallHandler)), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+    simulator.run();
+}
+
+/**
+ * Reads the opcodes of the first few instructions.
+ * @param memory The memory
+ * @param count The number of instructions
+ * @return The opcodes
+ */
+static std::vector<word_t> readOpcodes(const Memory& memory, size_t count) {
+
+    std::vector<word_t> opcodes;
+    for (size_t i = 0; i < count; ++i) {
+        word_t word = 0;
+        memory.readWord(Memory::MEM_USER_START + 4 * i, word);
+        opcodes.push_back(word & Instruction::LIMIT_OPCODE);
+    }
+    return opcodes;
+}
+
+/**
+ * Class: InstructionScheduler
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      NOPs are removed, labels follow their blocks, and the program gives the same result in fewer cycles
+ *      an independent instruction fills the slot after a load
+ *      dependent instructions, loads and stores keep their order, and branches stay last
+ *      a reader without a scheduler keeps the text as written
+ *      a branch on a system call's result goes the same way with or without its NOP
+ *
+ * Invalid Tests:
+ *      pipelines whose stages are out of order or missing one, or that split decode, are rejected
+ */
+TEST_CASE("The scheduler removes NOPs and fills load-use slots", "[reader][scheduler]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    SECTION("NOPs are removed, labels follow their blocks, and the program gives the same result in fewer cycles") {
+
+        FileReader plainReader, reader;
+        std::shared_ptr<Memory> plainMemory = loadProgram(NOP_PROGRAM, nullptr, plainReader);
+        std::shared_ptr<Memory> memory = loadProgram(NOP_PROGRAM, std::unique_ptr<InstructionScheduler>(new InstructionScheduler()), reader);
+
+        const InstructionScheduler::Stats& stats = reader.getScheduleStats();
+        REQUIRE(stats.dwNopsRemoved == 4);
+        REQUIRE(stats.dwBlocks == 3);
+        REQUIRE(stats.dwCyclesAfter < stats.dwCyclesBefore);
+
+        // Only the NOP ahead of it moved the loop
+        REQUIRE(plainReader.getSymbols().at("loop") == Memory::MEM_USER_START + 4 * 5);
+        REQUIRE(reader.getSymbols().at("loop") == Memory::MEM_USER_START + 4 * 4);
+        REQUIRE(reader.getSymbols().at("total") == plainReader.getSymbols().at("total"));
+
+        Simulator plain(InstructionSetFactory::createDefault(), plainMemory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+        plain.run();
+        Simulator simulator(InstructionSetFactory::createDefault(), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+        simulator.run();
+
+        byte_t total = 0;
+        memory->readByte(reader.getSymbols().at("total"), total);
+        REQUIRE(total == static_cast<byte_t>('a' + 'b' + 'c' + 'd' + 'e' + 'f'));
+        REQUIRE(simulator.getStats().dwNops == 0);
+        REQUIRE(simulator.getStats().dwClockCycles + 6 * 2 + 2 == plain.getStats().dwClockCycles);
+    }
+
+    SECTION("An independent instruction fills the slot after a load") {
+
+        const char * program =
+            ".text\n"
+            "main:\n"
+            "    lw $5, 0($4)\n"
+            "    add $6, $5, $5\n"
+            "    addi $7, $0, 1\n";
+
+        FileReader reader;
+        std::shared_ptr<Memory> memory = loadProgram(program, std::unique_ptr<InstructionScheduler>(new InstructionScheduler()), reader);
+
+        std::vector<word_t> opcodes = readOpcodes(*memory, 3);
+        REQUIRE(opcodes[0] == static_cast<word_t>(Opcodes::OPCODE_LW));
+        REQUIRE(opcodes[1] == static_cast<word_t>(Opcodes::OPCODE_ADDI));
+        REQUIRE(opcodes[2] == static_cast<word_t>(Opcodes::OPCODE_R_TYPE));
+
+        const InstructionScheduler::Stats& stats = reader.getScheduleStats();
+        REQUIRE(stats.dwBlocksReordered == 1);
+        REQUIRE(stats.dwCyclesBefore == 4);
+        REQUIRE(stats.dwCyclesAfter == 3);
+
+        // Splitting execute in two makes the load wait longer, so it is worth the same
+        FileReader deepReader;
+        loadProgram(program, std::unique_ptr<InstructionScheduler>(new InstructionScheduler(TimingModel::Config::eightStage().vecStages)), deepReader);
+        REQUIRE(deepReader.getScheduleStats().dwCyclesBefore == 6);
+        REQUIRE(deepReader.getScheduleStats().dwCyclesAfter == 5);
+    }
+
+    SECTION("Dependent instructions, loads and stores keep their order, and branches stay last") {
+
+        const char * program =
+            ".text\n"
+            "main:\n"
+            "    sw $5, 0($4)\n"
+            "    lw $6, 4($4)\n"
+            "    addi $7, $6, 1\n"
+            "    addi $8, $0, 2\n"
+            "    beq $7, $8, main\n";
+
+        FileReader reader;
+        std::shared_ptr<Memory> memory = loadProgram(program, std::unique_ptr<InstructionScheduler>(new InstructionScheduler()), reader);
+
+        std::vector<word_t> opcodes = readOpcodes(*memory, 5);
+        REQUIRE(opcodes[0] == static_cast<word_t>(Opcodes::OPCODE_SW));
+        REQUIRE(opcodes[1] == static_cast<word_t>(Opcodes::OPCODE_LW));
+        REQUIRE(opcodes[2] == static_cast<word_t>(Opcodes::OPCODE_ADDI));
+        REQUIRE(opcodes[3] == static_cast<word_t>(Opcodes::OPCODE_ADDI));
+        REQUIRE(opcodes[4] == static_cast<word_t>(Opcodes::OPCODE_BEQ));
+
+        // The independent addi went between the load and its use
+        word_t word = 0;
+        memory->readWord(Memory::MEM_USER_START + 8, word);
+        REQUIRE(InstructionEncoder::decode(word, InstructionType::I_FORMAT).getRt() == 8);
+
+        // The branch still reaches the start of the block
+        memory->readWord(Memory::MEM_USER_START + 16, word);
+        REQUIRE(static_cast<shword_t>(InstructionEncoder::decode(word, InstructionType::I_FORMAT).getImmediate()) == -20);
+    }
+
+    SECTION("A reader without a scheduler keeps the text as written") {
+
+        FileReader reader;
+        std::shared_ptr<Memory> memory = loadProgram(NOP_PROGRAM, nullptr, reader);
+        REQUIRE(reader.getScheduleStats().dwBlocks == 0);
+        REQUIRE(reader.getScheduleStats().dwNopsRemoved == 0);
+
+        word_t word = 1;
+        memory->readWord(Memory::MEM_USER_START + 4 * 4, word);
+        REQUIRE(word == 0);
+    }
+
+    SECTION("A branch on a system call's result goes the same way with or without its NOP") {
+
+        FileReader plainReader, reader;
+        std::shared_ptr<Memory> plainMemory = loadProgram(SYSCALL_BRANCH_PROGRAM, nullptr, plainReader);
+        std::shared_ptr<Memory> memory = loadProgram(SYSCALL_BRANCH_PROGRAM, std::unique_ptr<InstructionScheduler>(new InstructionScheduler()), reader);
+        REQUIRE(reader.getScheduleStats().dwNopsRemoved == 1);
+
+        runWithInput(plainMemory, "0\n");
+        runWithInput(memory, "0\n");
+
+        word_t plainResult = 7, result = 7;
+        plainMemory->readWord(plainReader.getSymbols().at("result"), plainResult);
+        memory->readWord(reader.getSymbols().at("result"), result);
+        REQUIRE(plainResult == 0);
+        REQUIRE(result == plainResult);
+    }
+
+    SECTION("Pipelines whose stages are out of order or missing one, or that split decode, are rejected") {
+        REQUIRE_THROWS_AS(InstructionScheduler(std::vector<PipelineStage>()), std::invalid_argument);
+        REQUIRE_THROWS_AS(InstructionScheduler({ PipelineStage::IF, PipelineStage::EX, PipelineStage::MEM, PipelineStage::WB }), std::invalid_argument);
+        REQUIRE_THROWS_AS(InstructionScheduler({ PipelineStage::IF, PipelineStage::ID, PipelineStage::MEM, PipelineStage::EX, PipelineStage::WB }), std::invalid_argument);
+        REQUIRE_THROWS_AS(InstructionScheduler({ PipelineStage::IF, PipelineStage::ID, PipelineStage::ID, PipelineStage::EX, PipelineStage::MEM, PipelineStage::WB }), std::invalid_argument);
+    }
+
+    spdlog::set_level(level);
+}
@@ -0,0 +1,203 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "instr/opcodes.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "reader/file_reader.hpp"
+#include "reader/peephole_optimizer.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+// Loads constants of every size, an address and a few no-ops, then stores through the address
+static const char * PEEPHOLE_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $4, 100\n"
+    "    li $5, -2\n"
+    "    li $6, 0x10000\n"
+    "    li $7, 0x12345678\n"
+    "    la $8, value\n"
+    "    subi $9, $9, 0\n"
+    "    subi $10, $4, 0\n"
+    "    nop\n"
+    "    nop\n"
+    "    nop\n"
+    "    sw $5, 0($8)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "value: .word 0\n";
+
+/**
+ * Loads and runs a program.
+ * @param program The program's source
+ * @param peephole Whether or not to run the peephole optimizer
+ * @param reader The reader, to find symbols and statistics with
+ * @param registers A placeholder for the registers once the program has run
+ * @return The memory once the program has run
+ */
+static std::shared_ptr<Memory> runProgram(const char * program, bool peephole, FileReader& reader, RegisterBank& registers) {
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    reader.setPeephole(peephole);
+    std::shared_ptr<Memory> memory = ProgramLoader::load(program, *instrSet.get(), reader);
+
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+    RegisterBank * bank = registerBank.get();
+    Simulator simulator(std::move(instrSet), memory, std::move(registerBank));
+    simulator.run();
+    registers = *bank;
+    return memory;
+}
+
+/**
+ * Reads the opcode of an instruction.
+ * @param memory The memory
+ * @param index The index of the instruction
+ * @return The opcode
+ */
+static word_t readOpcode(const Memory& memory, size_t index) {
+
+    word_t word = 0;
+    memory.readWord(Memory::MEM_USER_START + 4 * index, word);
+    return word & Instruction::LIMIT_OPCODE;
+}
+
+/**
+ * Class: PeepholeOptimizer
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      li loads any 32-bit value, with or without the optimizer
+ *      the optimizer folds li and la into single instructions, and removes subi of 0 and extra NOPs
+ *      labels move with the instructions they name
+ *      a reader without the optimizer keeps every expansion
+ *
+ * Invalid Tests:
+ *      nothing is folded across a label
+ */
+TEST_CASE("The peephole optimizer shrinks pseudo-instruction expansions", "[reader][peephole]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    SECTION("li loads any 32-bit value, with or without the optimizer") {
+
+        for (bool peephole : { false, true }) {
+
+            FileReader reader;
+            RegisterBank registers;
+            std::shared_ptr<Memory> memory = runProgram(PEEPHOLE_PROGRAM, peephole, reader, registers);
+
+            word_t value = 0;
+            registers.readRegister(4, value);
+            REQUIRE(value == 100);
+            registers.readRegister(5, value);
+            REQUIRE(value == 0xFFFFFFFE);
+            registers.readRegister(6, value);
+            REQUIRE(value == 0x10000);
+            registers.readRegister(7, value);
+            REQUIRE(value == 0x12345678);
+            registers.readRegister(10, value);
+            REQUIRE(value == 100);
+
+            memory->readWord(reader.getSymbols().at("value"), value);
+            REQUIRE(value == 0xFFFFFFFE);
+        }
+    }
+
+    SECTION("The optimizer folds li and la into single instructions, and removes subi of 0 and extra NOPs") {
+
+        FileReader reader;
+        RegisterBank registers;
+        std::shared_ptr<Memory> memory = runProgram(PEEPHOLE_PROGRAM, true, reader, registers);
+
+        const PeepholeOptimizer::Stats& stats = reader.getPeepholeStats();
+        REQUIRE(stats.dwInstructionsBefore == 17);
+        REQUIRE(stats.dwInstructionsAfter == 11);
+        REQUIRE(stats.dwConstantsFolded == 2);
+        REQUIRE(stats.dwAddressesFolded == 1);
+        REQUIRE(stats.dwMovesRemoved == 1);
+        REQUIRE(stats.dwNopsRemoved == 2);
+
+        REQUIRE(readOpcode(*memory, 0) == static_cast<word_t>(Opcodes::OPCODE_ORI));
+        REQUIRE(readOpcode(*memory, 1) == static_cast<word_t>(Opcodes::OPCODE_ADDI));
+        REQUIRE(readOpcode(*memory, 2) == static_cast<word_t>(Opcodes::OPCODE_LUI));
+        REQUIRE(readOpcode(*memory, 3) == static_cast<word_t>(Opcodes::OPCODE_LUI));
+        REQUIRE(readOpcode(*memory, 4) == static_cast<word_t>(Opcodes::OPCODE_ORI));
+        REQUIRE(readOpcode(*memory, 5) == static_cast<word_t>(Opcodes::OPCODE_ORI));
+        REQUIRE(readOpcode(*memory, 6) == static_cast<word_t>(Opcodes::OPCODE_ADDI));
+        REQUIRE(readOpcode(*memory, 7) == static_cast<word_t>(Opcodes::OPCODE_R_TYPE));
+        REQUIRE(readOpcode(*memory, 8) == static_cast<word_t>(Opcodes::OPCODE_SW));
+    }
+
+    SECTION("Labels move with the instructions they name") {
+
+        const char * program =
+            ".text\n"
+            "main:\n"
+            "    la $4, target\n"
+            "    nop\n"
+            "    nop\n"
+            "target:\n"
+            "    li $5, 7\n"
+            "end:\n"
+            "    li $2, 10\n"
+            "    syscall\n";
+
+        FileReader reader;
+        RegisterBank registers;
+        runProgram(program, true, reader, registers);
+
+        REQUIRE(reader.getSymbols().at("target") == Memory::MEM_USER_START + 4 * 2);
+        REQUIRE(reader.getSymbols().at("end") == Memory::MEM_USER_START + 4 * 3);
+
+        word_t value = 0;
+        registers.readRegister(4, value);
+        REQUIRE(value == reader.getSymbols().at("target"));
+    }
+
+    SECTION("A reader without the optimizer keeps every expansion") {
+
+        FileReader reader;
+        RegisterBank registers;
+        std::shared_ptr<Memory> memory = runProgram(PEEPHOLE_PROGRAM, false, reader, registers);
+
+        REQUIRE(reader.getPeepholeStats().dwInstructionsBefore == 0);
+        REQUIRE(readOpcode(*memory, 1) == static_cast<word_t>(Opcodes::OPCODE_LUI));
+        REQUIRE(readOpcode(*memory, 2) == static_cast<word_t>(Opcodes::OPCODE_ORI));
+    }
+
+    SECTION("Nothing is folded across a label") {
+
+        const char * program =
+            ".text\n"
+            "main:\n"
+            "    lui $4, 1\n"
+            "middle:\n"
+            "    ori $4, $4, 0\n"
+            "    nop\n"
+            "again:\n"
+            "    nop\n"
+            "    li $2, 10\n"
+            "    syscall\n";
+
+        FileReader reader;
+        RegisterBank registers;
+        runProgram(program, true, reader, registers);
+
+        REQUIRE(reader.getPeepholeStats().dwConstantsFolded == 0);
+        REQUIRE(reader.getPeepholeStats().dwNopsRemoved == 0);
+        REQUIRE(reader.getSymbols().at("middle") == Memory::MEM_USER_START + 4);
+    }
+
+    spdlog::set_level(level);
+}
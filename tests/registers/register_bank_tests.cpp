@@ -195,3 +195,63 @@ TEST_CASE("Register bank can be written to / read from properly") {
         REQUIRE(value == 100);
     }
 }
+
+/**
+ * Method: RegisterBank::setUndoLog(..)
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      every write records the register and its old value, in order
+ *      nothing is recorded once the log is removed
+ *      writes to HI and LO are recorded, and put back by restoreRegister
+ *
+ * Invalid Tests:
+ *      HI and LO are not general registers, so readRegister and writeRegister refuse them
+ */
+TEST_CASE("Register bank records old values into an undo log") {
+
+    SECTION("Every write records the register and its old value, in order") {
+
+        RegisterBank rb;
+        RegisterBank::undo_log_t undo;
+        rb.writeRegister(8, 1);
+        rb.setUndoLog(&undo);
+        rb.writeRegister(8, 2);
+        rb.writeRegister(9, 3);
+        rb.writeRegister(8, 4);
+        rb.setUndoLog(nullptr);
+        rb.writeRegister(8, 5);
+
+        REQUIRE(undo == RegisterBank::undo_log_t({ { 8, 1 }, { 9, 0 }, { 8, 2 } }));
+    }
+
+    SECTION("Writes to HI and LO are recorded, and put back by restoreRegister") {
+
+        RegisterBank rb;
+        RegisterBank::undo_log_t undo;
+        rb.writeHi(1);
+        rb.setUndoLog(&undo);
+        rb.writeHi(2);
+        rb.writeLo(3);
+        rb.setUndoLog(nullptr);
+
+        REQUIRE(rb.readHi() == 2);
+        REQUIRE(rb.readLo() == 3);
+        REQUIRE(undo == RegisterBank::undo_log_t({ { RegisterBank::REG_HI, 1 }, { RegisterBank::REG_LO, 0 } }));
+
+        for (size_t i = undo.size(); i > 0; --i)
+            REQUIRE(rb.restoreRegister(undo[i-1].first, undo[i-1].second));
+        REQUIRE(rb.readHi() == 1);
+        REQUIRE(rb.readLo() == 0);
+        REQUIRE(rb.restoreRegister(RegisterBank::REG_LO + 1, 0) == false);
+    }
+
+    SECTION("HI and LO are not general registers, so readRegister and writeRegister refuse them") {
+
+        RegisterBank rb;
+        word_t value = 0;
+        REQUIRE(rb.writeRegister(RegisterBank::REG_HI, 1) == false);
+        REQUIRE(rb.readRegister(RegisterBank::REG_LO, value) == false);
+        REQUIRE(rb.readHi() == 0);
+    }
+}
@@ -0,0 +1,526 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+
+// Stores a run of bytes counting up from 0
+static const char * STORE_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, buffer\n"
+    "    li $5, 0\n"
+    "    li $6, 12\n"
+    "loop:\n"
+    "    sb $5, 0($4)\n"
+    "    addi $4, $4, 1\n"
+    "    addi $5, $5, 1\n"
+    "    bne $5, $6, loop\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "buffer: .space 16\n";
+
+// Branches on registers written just before them, by an ALU instruction and by a load
+static const char * BRANCH_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $4, 3\n"
+    "loop:\n"
+    "    addi $4, $4, -1\n"
+    "    bne $4, $0, loop\n"
+    "    la $5, value\n"
+    "    lw $6, 0($5)\n"
+    "    beq $6, $0, skip\n"
+    "    li $7, 1\n"
+    "skip:\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "value: .word 5\n";
+
+// Branches on $v0 just after a system call writes it, with an older instruction writing it too
+static const char * SYSCALL_BRANCH_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $8, 9\n"
+    "    li $4, 0\n"
+    "    li $2, 9\n"
+    "    syscall\n"
+    "    beq $2, $8, stale\n"
+    "    li $7, 1\n"
+    "stale:\n"
+    "    li $2, 10\n"
+    "    syscall\n";
+
+// Calls a function from three places, through jal and jalr, then jumps over an instruction
+static const char * CALL_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $16, 0\n"
+    "    li $4, 3\n"
+    "    jal addtwo\n"
+    "    add $16, $16, $2\n"
+    "    li $4, 10\n"
+    "    jal addtwo\n"
+    "    add $16, $16, $2\n"
+    "    la $8, addtwo\n"
+    "    li $4, 1\n"
+    "    jalr $8\n"
+    "after:\n"
+    "    add $16, $16, $2\n"
+    "    j done\n"
+    "    li $16, 0\n"
+    "done:\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    "addtwo:\n"
+    "    addi $2, $4, 2\n"
+    "    jr $ra\n";
+
+// Spins on a flag nothing sets, so it never gets anywhere
+static const char * SPIN_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, flag\n"
+    "wait:\n"
+    "    lb $5, 0($4)\n"
+    "    beq $5, $0, wait\n"
+    "    nop\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "flag: .space 1\n";
+
+// Stores a word, then loads it back while the store is still buffered
+static const char * FORWARD_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, value\n"
+    "    li $5, 7\n"
+    "    sw $5, 0($4)\n"
+    "    lw $6, 0($4)\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "value: .word 0\n";
+
+/**
+ * Loads the test program.
+ * @param instrSet A placeholder for the instruction set
+ * @param reader The reader, to find symbols with
+ * @param program The program's source
+ * @return The loaded memory
+ */
+static std::shared_ptr<Memory> loadProgram(std::unique_ptr<InstructionSet>& instrSet, FileReader& reader, const char * program = STORE_PROGRAM) {
+    instrSet = InstructionSetFactory::createDefault();
+    return ProgramLoader::load(program, *instrSet.get(), reader);
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a breakpoint stops a run before its instruction each time it is reached
+ *      a run with breakpoints and watchpoints ends as a run without them does
+ *      a watchpoint stops a run after the access to it, with the old and new values
+ *      removing the breakpoint we stopped at runs its instruction as usual
+ *      the instructions replaced by breakpoints are put back when the simulator goes
+ *
+ * Invalid Tests:
+ *      breakpoints outside of the text segment, or off a word boundary, are rejected
+ *      watchpoints outside of the data segment are rejected
+ */
+TEST_CASE("Breakpoints and watchpoints stop a run without changing it", "[simulator]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    // Does the reference run without any stops
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> reference = loadProgram(instrSet, reader);
+    Memory::addr_t buffer = reader.getSymbols().at("buffer");
+    Memory::addr_t loop = reader.getSymbols().at("loop");
+
+    Simulator plain(std::move(instrSet), reference, std::unique_ptr<RegisterBank>(new RegisterBank()));
+    while (plain.step()) { }
+    const dword_t end = plain.getStats().dwClockCycles;
+
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader);
+    word_t original = 0;
+    REQUIRE(memory->readWord(loop, original) == true);
+
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+    const RegisterBank * registers = registerBank.get();
+    std::unique_ptr<Simulator> simulator(new Simulator(std::move(instrSet), memory, std::move(registerBank)));
+
+    SECTION("A breakpoint stops a run before its instruction each time it is reached") {
+
+        REQUIRE(simulator->addBreakpoint(loop) == true);
+        for (word_t visit = 0; visit < 12; ++visit) {
+
+            const Simulator::Stop& stop = simulator->resume();
+            REQUIRE(stop.reason == StopReason::BREAKPOINT);
+            REQUIRE(stop.wPC == loop);
+            REQUIRE(simulator->getPC() == loop);
+
+            word_t count = 0;
+            registers->readRegister(5, count);
+            REQUIRE(count == visit);
+        }
+
+        REQUIRE(simulator->resume().reason == StopReason::EXITED);
+        REQUIRE(simulator->getStats().dwClockCycles == end);
+        REQUIRE(simulator->resume().reason == StopReason::EXITED);
+
+        for (Memory::addr_t addr = buffer; addr < buffer + 12; ++addr) {
+            byte_t expected = 0, actual = 0;
+            reference->readByte(addr, expected);
+            memory->readByte(addr, actual);
+            REQUIRE(actual == expected);
+        }
+    }
+
+    SECTION("A watchpoint stops a run after the access to it, with the old and new values") {
+
+        REQUIRE(simulator->addWatchpoint(buffer + 5, 1, Memory::WatchKind::WRITE) == true);
+        REQUIRE(simulator->addWatchpoint(buffer, 16, Memory::WatchKind::READ) == true);
+
+        const Simulator::Stop& stop = simulator->resume();
+        REQUIRE(stop.reason == StopReason::WATCHPOINT);
+        REQUIRE(stop.wPC == loop);
+        REQUIRE(stop.watch.wAddress == buffer + 5);
+        REQUIRE(stop.watch.bWrite == true);
+        REQUIRE(stop.watch.wOldValue == 0);
+        REQUIRE(stop.watch.wNewValue == 5);
+
+        REQUIRE(simulator->resume().reason == StopReason::EXITED);
+        REQUIRE(simulator->getStats().dwClockCycles == end);
+    }
+
+    SECTION("Removing the breakpoint we stopped at runs its instruction as usual") {
+
+        REQUIRE(simulator->addBreakpoint(loop) == true);
+        REQUIRE(simulator->resume().reason == StopReason::BREAKPOINT);
+        REQUIRE(simulator->removeBreakpoint(loop) == true);
+        REQUIRE(simulator->removeBreakpoint(loop) == false);
+
+        REQUIRE(simulator->resume().reason == StopReason::EXITED);
+        REQUIRE(simulator->getStats().dwClockCycles == end);
+    }
+
+    SECTION("A plain run passes over breakpoints, and they are put back when the simulator goes") {
+
+        REQUIRE(simulator->addBreakpoint(loop) == true);
+        word_t trap = 0;
+        REQUIRE(memory->readWord(loop, trap) == true);
+        REQUIRE(trap != original);
+
+        while (simulator->step()) { }
+        REQUIRE(simulator->getStats().dwClockCycles == end);
+
+        simulator.reset();
+        word_t word = 0;
+        REQUIRE(memory->readWord(loop, word) == true);
+        REQUIRE(word == original);
+    }
+
+    SECTION("Breakpoints and watchpoints outside of their segments are rejected") {
+
+        REQUIRE(simulator->addBreakpoint(buffer) == false);
+        REQUIRE(simulator->addBreakpoint(loop + 2) == false);
+        REQUIRE(simulator->addBreakpoint(Memory::MEM_USER_START - 4) == false);
+        REQUIRE(simulator->addWatchpoint(loop, 4, Memory::WatchKind::ACCESS) == false);
+        REQUIRE(simulator->addWatchpoint(buffer, 0x2000, Memory::WatchKind::ACCESS) == false);
+    }
+
+    spdlog::set_level(level);
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a run stops for good at its cycle limit, and says so
+ *      a run within its cycle limit finishes as usual
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Runs stop at their cycle limit", "[simulator]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader);
+    Simulator simulator(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+
+    simulator.run();
+    const dword_t end = simulator.getStats().dwClockCycles;
+    REQUIRE(simulator.getStop().reason == StopReason::NONE);
+
+    SECTION("A run stops for good at its cycle limit, and says so") {
+
+        simulator.setCycleLimit(10);
+        simulator.reset();
+
+        const Simulator::Stop& stop = simulator.resume();
+        REQUIRE(stop.reason == StopReason::CYCLE_LIMIT);
+        REQUIRE(stop.dwCycle == 10);
+        REQUIRE(stop.wPC == simulator.getPC());
+        REQUIRE(simulator.getStats().dwClockCycles == 10);
+        REQUIRE(simulator.isRunning() == false);
+
+        REQUIRE(simulator.step() == false);
+        REQUIRE(simulator.resume().reason == StopReason::CYCLE_LIMIT);
+        REQUIRE(simulator.getStats().dwClockCycles == 10);
+
+        simulator.run();
+        REQUIRE(simulator.getStop().reason == StopReason::CYCLE_LIMIT);
+        REQUIRE(simulator.getStats().dwClockCycles == 10);
+    }
+
+    SECTION("A run within its cycle limit finishes as usual") {
+
+        simulator.setCycleLimit(end);
+        simulator.run();
+        REQUIRE(simulator.getStop().reason == StopReason::NONE);
+        REQUIRE(simulator.getStats().dwClockCycles == end);
+
+        simulator.reset();
+        REQUIRE(simulator.resume().reason == StopReason::EXITED);
+    }
+
+    spdlog::set_level(level);
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a looping program stops for good on a livelock, with the loop's length
+ *      a program making progress runs to the end with detection on
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Runs stop on a livelock", "[simulator][livelock]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    SECTION("A looping program stops for good on a livelock, with the loop's length") {
+
+        std::unique_ptr<InstructionSet> instrSet;
+        FileReader reader;
+        std::shared_ptr<Memory> memory = loadProgram(instrSet, reader, SPIN_PROGRAM);
+        Memory::addr_t wait = reader.getSymbols().at("wait");
+
+        Simulator simulator(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+        simulator.setLivelockDetection(true);
+        simulator.run();
+
+        const Simulator::Stop& stop = simulator.getStop();
+        REQUIRE(stop.reason == StopReason::LIVELOCK);
+        REQUIRE(stop.dwPeriod > 0);
+        REQUIRE(stop.wPC >= wait);
+        REQUIRE(stop.wPC <= wait + 12);
+        REQUIRE(simulator.getStats().dwClockCycles < 100);
+        REQUIRE(simulator.isRunning() == false);
+        REQUIRE(simulator.resume().reason == StopReason::LIVELOCK);
+
+        // Resetting runs again, and finds the same loop
+        simulator.reset();
+        REQUIRE(simulator.resume().reason == StopReason::LIVELOCK);
+        REQUIRE(simulator.getStop().dwCycle == stop.dwCycle);
+    }
+
+    SECTION("A program making progress runs to the end with detection on") {
+
+        std::unique_ptr<InstructionSet> instrSet;
+        FileReader reader;
+        std::shared_ptr<Memory> memory = loadProgram(instrSet, reader);
+
+        Simulator simulator(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+        simulator.setLivelockDetection(true);
+        REQUIRE(simulator.resume().reason == StopReason::EXITED);
+    }
+
+    spdlog::set_level(level);
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a load forwarded from the store buffer stops on a read watchpoint
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Loads forwarded from the store buffer are watched", "[simulator][lsu]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader, FORWARD_PROGRAM);
+    Memory::addr_t value = reader.getSymbols().at("value");
+
+    Simulator simulator(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()));
+    REQUIRE(simulator.addWatchpoint(value, 4, Memory::WatchKind::READ) == true);
+
+    SECTION("A load forwarded from the store buffer stops on a read watchpoint") {
+
+        const Simulator::Stop& stop = simulator.resume();
+        REQUIRE(stop.reason == StopReason::WATCHPOINT);
+        REQUIRE(stop.watch.wAddress == value);
+        REQUIRE(stop.watch.bWrite == false);
+        REQUIRE(stop.watch.wNewValue == 7);
+        REQUIRE(simulator.getLoadStoreUnit().getStats().dwForwards == 1);
+
+        REQUIRE(simulator.resume().reason == StopReason::EXITED);
+    }
+
+    spdlog::set_level(level);
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      branches on registers written just before them take the new values
+ *      a branch waits a cycle on the ALU instruction before it, and two on a load
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Branch operands are forwarded into decode", "[simulator]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader, BRANCH_PROGRAM);
+
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+    const RegisterBank * registers = registerBank.get();
+    Simulator simulator(std::move(instrSet), memory, std::move(registerBank));
+    while (simulator.step()) { }
+    spdlog::set_level(level);
+
+    SECTION("Branches on registers written just before them take the new values") {
+
+        word_t value = 1;
+        registers->readRegister(4, value);
+        REQUIRE(value == 0);
+        registers->readRegister(7, value);
+        REQUIRE(value == 1);
+    }
+
+    SECTION("A branch waits a cycle on the ALU instruction before it, and two on a load") {
+
+        // Three passes of the loop forward $4 from the addi, then the beq forwards $6 from the lw
+        const SimulatorStats& stats = simulator.getStats();
+        REQUIRE(stats.dwDecodeForwards == 4);
+        REQUIRE(stats.dwDecodeStalls == 3 * 1 + 2);
+    }
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a branch just after a system call takes the value the call wrote, not an older one
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Branch operands written by a system call are not forwarded", "[simulator]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader, SYSCALL_BRANCH_PROGRAM);
+
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+    const RegisterBank * registers = registerBank.get();
+    Simulator simulator(std::move(instrSet), memory, std::move(registerBank));
+    while (simulator.step()) { }
+    spdlog::set_level(level);
+
+    SECTION("A branch just after a system call takes the value the call wrote, not an older one") {
+
+        // sbrk leaves the old break in $v0, so the beq falls through rather than matching the li's 9
+        word_t value = 0;
+        registers->readRegister(7, value);
+        REQUIRE(value == 1);
+        REQUIRE(simulator.getStats().dwDecodeForwards == 0);
+    }
+}
+
+/**
+ * Class: Simulator
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      jal and jalr call a function, jr returns to each caller, and j jumps over an instruction
+ *      jal and jalr link the address after them into $ra
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Jumps call and return from functions", "[simulator]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader, CALL_PROGRAM);
+
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+    const RegisterBank * registers = registerBank.get();
+    Simulator simulator(std::move(instrSet), memory, std::move(registerBank));
+    while (simulator.step()) { }
+    spdlog::set_level(level);
+
+    SECTION("jal and jalr call a function, jr returns to each caller, and j jumps over an instruction") {
+
+        // 3 + 2, then 10 + 2, then 1 + 2, and the jumped-over li never clears the sum
+        word_t value = 0;
+        registers->readRegister(16, value);
+        REQUIRE(value == 5 + 12 + 3);
+    }
+
+    SECTION("jal and jalr link the address after them into $ra") {
+
+        // The last call was the jalr
+        word_t value = 0;
+        registers->readRegister(31, value);
+        REQUIRE(value == reader.getSymbols().at("after"));
+    }
+}
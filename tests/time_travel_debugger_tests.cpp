@@ -0,0 +1,328 @@
+#include "catch.hpp"
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/handlers/syscall_handler.hpp"
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "mocks/program_loader.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+
+#include "simulator.hpp"
+#include "time_travel_debugger.hpp"
+
+// Reads a number, then stores a run of bytes counting up from it
+static const char * COUNT_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    li $2, 5\n"
+    "    syscall\n"
+    "    add $8, $2, $0\n"
+    "    la $4, buffer\n"
+    "    li $5, 0\n"
+    "    li $6, 12\n"
+    "loop:\n"
+    "    sb $8, 0($4)\n"
+    "    addi $4, $4, 1\n"
+    "    addi $5, $5, 1\n"
+    "    addi $8, $8, 1\n"
+    "    bne $5, $6, loop\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "buffer: .space 16\n";
+
+// Spins on a flag nothing sets, so it never gets anywhere
+static const char * SPIN_PROGRAM =
+    ".text\n"
+    "main:\n"
+    "    la $4, flag\n"
+    "wait:\n"
+    "    lb $5, 0($4)\n"
+    "    beq $5, $0, wait\n"
+    "    nop\n"
+    "    li $2, 10\n"
+    "    syscall\n"
+    ".data\n"
+    "flag: .space 1\n";
+
+/** The registers and buffer after a cycle. */
+struct CycleState {
+    Memory::addr_t wPC;
+    std::array<word_t, RegisterBank::NUM_REGISTERS> arrRegisters;
+    std::array<byte_t, 16> arrBuffer;
+};
+
+/**
+ * Loads the test program, with an instruction set whose console input is a single number.
+ * @param instrSet A placeholder for the instruction set
+ * @param reader The reader, to find symbols with
+ * @return The loaded memory
+ */
+static std::shared_ptr<Memory> loadProgram(std::unique_ptr<InstructionSet>& instrSet, FileReader& reader) {
+
+    // The number can only be read once, so reading it again would fail the run
+    std::unique_ptr<SyscallHandler> syscallHandler(new SyscallHandler());
+    syscallHandler->getInputFeed().setFallback(nullptr);
+    syscallHandler->getInputFeed().queueInput("40\n");
+
+    instrSet = InstructionSetFactory::createDefault(std::move(syscallHandler));
+    return ProgramLoader::load(COUNT_PROGRAM, *instrSet.get(), reader);
+}
+
+/**
+ * Captures the registers and buffer.
+ * @param pc The program counter
+ * @param registers The registers
+ * @param memory The memory
+ * @param buffer The address of the buffer
+ * @return The state
+ */
+static CycleState capture(Memory::addr_t pc, const RegisterBank& registers, const Memory& memory, Memory::addr_t buffer) {
+
+    CycleState state;
+    state.wPC = pc;
+    for (word_t reg = 0; reg < RegisterBank::NUM_REGISTERS; ++reg)
+        registers.readRegister(reg, state.arrRegisters[reg]);
+    memory.readBlock(buffer, state.arrBuffer.data(), state.arrBuffer.size());
+    return state;
+}
+
+/**
+ * Returns whether two states match.
+ * @param a The first state
+ * @param b The second state
+ * @return Whether or not they match
+ */
+static bool matches(const CycleState& a, const CycleState& b) {
+    return a.wPC == b.wPC && a.arrRegisters == b.arrRegisters && a.arrBuffer == b.arrBuffer;
+}
+
+/**
+ * Class: TimeTravelDebugger
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      running forwards gives the same results as the simulator
+ *      seeking to every cycle, in any order, gives the state the simulator had then
+ *      stepping back from the end passes through every cycle's state
+ *      reverse continuing stops at the last visit to an address before now
+ *      going back never runs more than an interval of cycles again
+ *      going forward over cycles already run never runs more than an interval of them again
+ *      system calls are not run again after going back
+ *
+ * Invalid Tests:
+ *      a checkpoint interval of 0 is rejected
+ *      seeking past the end of the program stops at the end
+ */
+TEST_CASE("The time travel debugger reaches any cycle, forwards or backwards", "[debugger]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    // Does the reference run on the plain simulator, a cycle at a time
+    std::unique_ptr<InstructionSet> instrSet;
+    FileReader reader;
+    std::shared_ptr<Memory> reference = loadProgram(instrSet, reader);
+    Memory::addr_t buffer = reader.getSymbols().at("buffer");
+    Memory::addr_t loop = reader.getSymbols().at("loop");
+
+    std::unique_ptr<RegisterBank> referenceRegisters(new RegisterBank());
+    const RegisterBank * registers = referenceRegisters.get();
+    Simulator simulator(std::move(instrSet), reference, std::move(referenceRegisters));
+
+    std::vector<CycleState> expected;
+    expected.push_back(capture(simulator.getPC(), *registers, *reference, buffer));
+    while (simulator.step())
+        expected.push_back(capture(simulator.getPC(), *registers, *reference, buffer));
+    expected.push_back(capture(simulator.getPC(), *registers, *reference, buffer));
+    const dword_t end = simulator.getStats().dwClockCycles;
+
+    const dword_t interval = 8;
+    std::shared_ptr<Memory> memory = loadProgram(instrSet, reader);
+    TimeTravelDebugger debugger(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()), interval);
+
+    auto current = [&debugger, buffer]() {
+        return capture(debugger.getPC(), debugger.getRegisters(), debugger.getMemory(), buffer);
+    };
+
+    SECTION("Running forwards gives the same results as the simulator") {
+
+        REQUIRE(matches(current(), expected[0]));
+        while (debugger.step()) { }
+
+        REQUIRE(debugger.getCycle() == end);
+        REQUIRE(debugger.getFrontier() == end);
+        REQUIRE(debugger.isRunning() == false);
+        REQUIRE(matches(current(), expected.back()));
+        REQUIRE(current().arrBuffer[11] == 40 + 11);
+        REQUIRE(debugger.getStats().dwCheckpoints == end / interval + 1);
+    }
+
+    SECTION("Seeking to every cycle, in any order, gives the state the simulator had then") {
+
+        REQUIRE(debugger.seek(end) == true);
+        for (dword_t cycle : { end / 2, dword_t(3), end - 1, dword_t(0), interval, interval - 1, end / 3 }) {
+            REQUIRE(debugger.seek(cycle) == true);
+            REQUIRE(debugger.getCycle() == cycle);
+            REQUIRE(matches(current(), expected[cycle]));
+        }
+    }
+
+    SECTION("Stepping back from the end passes through every cycle's state") {
+
+        REQUIRE(debugger.seek(end) == true);
+        for (dword_t cycle = end; cycle > 0; --cycle) {
+            REQUIRE(debugger.reverseStep() == true);
+            REQUIRE(matches(current(), expected[cycle - 1]));
+        }
+
+        REQUIRE(debugger.reverseStep() == false);
+        REQUIRE(debugger.getCycle() == 0);
+
+        // Going forward again runs the same way
+        while (debugger.step()) { }
+        REQUIRE(matches(current(), expected.back()));
+    }
+
+    SECTION("Reverse continuing stops at the last visit to an address before now") {
+
+        std::vector<dword_t> visits;
+        for (dword_t cycle = 0; cycle < end; ++cycle) {
+            if (expected[cycle].wPC == loop) visits.push_back(cycle);
+        }
+        REQUIRE(visits.size() == 12);
+
+        REQUIRE(debugger.seek(end) == true);
+        auto atLoop = [loop](Memory::addr_t pc) { return pc == loop; };
+        for (size_t visit = visits.size(); visit > 0; --visit) {
+            REQUIRE(debugger.reverseContinue(atLoop) == true);
+            REQUIRE(debugger.getCycle() == visits[visit - 1]);
+            REQUIRE(matches(current(), expected[visits[visit - 1]]));
+        }
+
+        REQUIRE(debugger.reverseContinue(atLoop) == false);
+        REQUIRE(debugger.getCycle() == 0);
+
+        REQUIRE(debugger.forwardContinue(atLoop) == true);
+        REQUIRE(debugger.getCycle() == visits[0]);
+    }
+
+    SECTION("Going back never runs more than an interval of cycles again") {
+
+        REQUIRE(debugger.seek(end) == true);
+        for (dword_t cycle : { end - 3, end / 2, dword_t(1) }) {
+            dword_t before = debugger.getStats().dwCyclesReplayed;
+            REQUIRE(debugger.seek(cycle) == true);
+            REQUIRE(debugger.getStats().dwCyclesReplayed - before < interval);
+        }
+    }
+
+    SECTION("Going forward over cycles already run never runs more than an interval of them again") {
+
+        REQUIRE(debugger.seek(end) == true);
+        for (dword_t cycle : { end - 1, end, end / 2 + 1 }) {
+            REQUIRE(debugger.seek(0) == true);
+            dword_t before = debugger.getStats().dwCyclesReplayed;
+            REQUIRE(debugger.seek(cycle) == true);
+            REQUIRE(debugger.getStats().dwCyclesReplayed - before < interval);
+            REQUIRE(matches(current(), expected[cycle]));
+        }
+    }
+
+    SECTION("System calls are not run again after going back") {
+
+        // The read at cycle 1 would fail a second time, and exit the run
+        REQUIRE(debugger.seek(end) == true);
+        REQUIRE(debugger.seek(0) == true);
+        REQUIRE(debugger.seek(end) == true);
+        REQUIRE(matches(current(), expected.back()));
+        REQUIRE(debugger.getMemory().getTotalSize() == reference->getTotalSize());
+    }
+
+    SECTION("Seeking past the end of the program stops at the end") {
+
+        REQUIRE(debugger.seek(end + 10) == false);
+        REQUIRE(debugger.getCycle() == end);
+        REQUIRE(debugger.step() == false);
+        REQUIRE(debugger.getCycle() == end);
+    }
+
+    SECTION("A checkpoint interval of 0 is rejected") {
+
+        std::shared_ptr<Memory> other = loadProgram(instrSet, reader);
+        REQUIRE_THROWS_AS(TimeTravelDebugger(std::move(instrSet), other, std::unique_ptr<RegisterBank>(new RegisterBank()), 0), std::invalid_argument);
+    }
+
+    spdlog::set_level(level);
+}
+
+/**
+ * Class: TimeTravelDebugger (stopping for good)
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      a run stops for good at its cycle limit, and runs again after going back
+ *      a run stops for good on a livelock, and finds it again after going back
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("The time travel debugger stops at cycle limits and livelocks", "[debugger][livelock]") {
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    FileReader reader;
+    std::shared_ptr<Memory> memory = ProgramLoader::load(SPIN_PROGRAM, *instrSet.get(), reader);
+    TimeTravelDebugger debugger(std::move(instrSet), memory, std::unique_ptr<RegisterBank>(new RegisterBank()), 8);
+
+    SECTION("A run stops for good at its cycle limit, and runs again after going back") {
+
+        debugger.setCycleLimit(20);
+        while (debugger.step()) { }
+        REQUIRE(debugger.getCycle() == 20);
+        REQUIRE(debugger.getStop().reason == StopReason::CYCLE_LIMIT);
+        REQUIRE(debugger.step() == false);
+        REQUIRE(debugger.seek(30) == false);
+
+        REQUIRE(debugger.reverseStep() == true);
+        REQUIRE(debugger.getCycle() == 19);
+        REQUIRE(debugger.isRunning() == true);
+        REQUIRE(debugger.getStop().reason == StopReason::NONE);
+
+        // Going to the cycle of the stop from a checkpoint stops there again
+        REQUIRE(debugger.seek(0) == true);
+        REQUIRE(debugger.seek(20) == true);
+        REQUIRE(debugger.getStop().reason == StopReason::CYCLE_LIMIT);
+        REQUIRE(debugger.isRunning() == false);
+    }
+
+    SECTION("A run stops for good on a livelock, and finds it again after going back") {
+
+        debugger.setLivelockDetection(true);
+        while (debugger.step()) { }
+        dword_t end = debugger.getCycle();
+        REQUIRE(debugger.getStop().reason == StopReason::LIVELOCK);
+        REQUIRE(debugger.getStop().dwPeriod > 0);
+        REQUIRE(end < 100);
+
+        REQUIRE(debugger.reverseStep() == true);
+        REQUIRE(debugger.getStop().reason == StopReason::NONE);
+
+        REQUIRE(debugger.seek(0) == true);
+        while (debugger.step()) { }
+        REQUIRE(debugger.getStop().reason == StopReason::LIVELOCK);
+    }
+
+    spdlog::set_level(level);
+}
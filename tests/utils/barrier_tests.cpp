@@ -0,0 +1,59 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "utils/barrier.hpp"
+
+/**
+ * Class: Barrier
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      no thread leaves a round before every thread has arrived
+ *      exactly one thread is told it arrived last each round
+ *      a barrier of a single thread never blocks
+ *
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Barriers hold every thread until the last arrives", "[barrier]") {
+
+    SECTION("No thread leaves a round early, and one thread arrives last each round") {
+
+        const size_t numThreads = 4;
+        const size_t numRounds = 50;
+        Barrier barrier(numThreads);
+        std::atomic<size_t> arrived(0);
+        std::atomic<size_t> last(0);
+        std::atomic<bool> early(false);
+
+        std::vector<std::thread> threads;
+        for (size_t thread = 0; thread < numThreads; ++thread) {
+            threads.emplace_back([&]() {
+                for (size_t round = 0; round < numRounds; ++round) {
+
+                    arrived++;
+                    if (barrier.wait()) last++;
+                    if (arrived.load() < (round + 1) * numThreads) early = true;
+                    barrier.wait();
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(early == false);
+        REQUIRE(arrived == numThreads * numRounds);
+        REQUIRE(last == numRounds);
+    }
+
+    SECTION("A barrier of a single thread never blocks") {
+
+        Barrier barrier(1);
+        REQUIRE(barrier.wait() == true);
+        REQUIRE(barrier.wait() == true);
+    }
+}
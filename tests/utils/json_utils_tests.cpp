@@ -0,0 +1,61 @@
+#include "catch.hpp"
+
+#include <string>
+#include <unordered_map>
+
+#include "utils/json_utils.hpp"
+
+/**
+ * Class: JsonUtils
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      strings (with escapes), numbers, booleans, null and arrays of strings are parsed
+ *      an empty object is parsed
+ *      quoting escapes quotes, backslashes and control characters
+ *
+ * Invalid Tests:
+ *      anything but a flat object is rejected
+ *      unterminated strings and missing separators are rejected
+ *      text after the object is rejected
+ */
+TEST_CASE("Flat JSON objects are parsed and strings are quoted", "[json]") {
+
+    std::unordered_map<std::string, JsonUtils::Value> object;
+    std::string error;
+
+    SECTION("Every kind of value is parsed") {
+
+        REQUIRE(JsonUtils::parseObject(" { \"a\": \"x\\\"y\\n\", \"b\": 42, \"c\": true, \"d\": null, \"e\": [\"--peephole\", \"--schedule\"] } ", object, error));
+        REQUIRE(object.size() == 5);
+        REQUIRE(object["a"].kind == JsonUtils::Value::Kind::STRING);
+        REQUIRE(object["a"].str == "x\"y\n");
+        REQUIRE(object["b"].kind == JsonUtils::Value::Kind::NUMBER);
+        REQUIRE(object["b"].str == "42");
+        REQUIRE(object["c"].kind == JsonUtils::Value::Kind::BOOLEAN);
+        REQUIRE(object["c"].b);
+        REQUIRE(object["d"].kind == JsonUtils::Value::Kind::NONE);
+        REQUIRE(object["e"].kind == JsonUtils::Value::Kind::ARRAY);
+        REQUIRE(object["e"].vecItems.size() == 2);
+        REQUIRE(object["e"].vecItems[1] == "--schedule");
+    }
+
+    SECTION("An empty object is parsed") {
+        REQUIRE(JsonUtils::parseObject("{}", object, error));
+        REQUIRE(object.empty());
+    }
+
+    SECTION("Quoting escapes what it must") {
+        REQUIRE(JsonUtils::quote("a\"b\\c\n\x01") == "\"a\\\"b\\\\c\\n\\u0001\"");
+    }
+
+    SECTION("Malformed objects are rejected") {
+        REQUIRE_FALSE(JsonUtils::parseObject("[1, 2]", object, error));
+        REQUIRE_FALSE(JsonUtils::parseObject("{\"a\": \"x}", object, error));
+        REQUIRE_FALSE(JsonUtils::parseObject("{\"a\" 1}", object, error));
+        REQUIRE_FALSE(JsonUtils::parseObject("{\"a\": 1 \"b\": 2}", object, error));
+        REQUIRE_FALSE(JsonUtils::parseObject("{\"a\": [1]}", object, error));
+        REQUIRE_FALSE(JsonUtils::parseObject("{\"a\": 1} x", object, error));
+        REQUIRE_FALSE(error.empty());
+    }
+}
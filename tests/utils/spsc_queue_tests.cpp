@@ -0,0 +1,84 @@
+#include "catch.hpp"
+
+#include <stdexcept>
+#include <thread>
+
+#include "utils/spsc_queue.hpp"
+#include "types.hpp"
+
+/**
+ * Class: SpscQueue
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      elements come out in the order they went in
+ *      pushing to a full queue and popping from an empty one fail
+ *      a producer and consumer thread pass every element across in order
+ *
+ * Invalid Tests:
+ *      a capacity that is not a power of two is rejected
+ */
+TEST_CASE("Single producer single consumer queues pass elements in order", "[queue]") {
+
+    SECTION("Elements come out in the order they went in, and the bounds hold") {
+
+        SpscQueue<int> queue(4);
+        REQUIRE(queue.getCapacity() == 4);
+        REQUIRE(queue.isEmpty() == true);
+
+        int value = 0;
+        REQUIRE(queue.tryPop(value) == false);
+
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(queue.tryPush(i) == true);
+        REQUIRE(queue.tryPush(4) == false);
+
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.tryPop(value) == true);
+            REQUIRE(value == i);
+        }
+        REQUIRE(queue.tryPop(value) == false);
+
+        // Wrapping around the ring keeps the order
+        for (int round = 0; round < 10; ++round) {
+            REQUIRE(queue.tryPush(round) == true);
+            REQUIRE(queue.tryPop(value) == true);
+            REQUIRE(value == round);
+        }
+    }
+
+    SECTION("A producer and consumer thread pass every element across in order") {
+
+        const dword_t count = 200000;
+        SpscQueue<dword_t> queue(64);
+
+        std::thread producer([&queue, count]() {
+            for (dword_t i = 0; i < count; ++i) {
+                while (!queue.tryPush(i))
+                    std::this_thread::yield();
+            }
+        });
+
+        bool ordered = true;
+        dword_t expected = 0;
+        dword_t value = 0;
+        while (expected < count) {
+            if (!queue.tryPop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            ordered &= (value == expected++);
+        }
+
+        producer.join();
+        REQUIRE(ordered == true);
+        REQUIRE(queue.isEmpty() == true);
+    }
+
+    SECTION("A capacity that is not a power of two is rejected") {
+
+        REQUIRE_THROWS_AS(SpscQueue<int>(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(SpscQueue<int>(1), std::invalid_argument);
+        REQUIRE_THROWS_AS(SpscQueue<int>(12), std::invalid_argument);
+    }
+}
@@ -285,4 +285,43 @@ TEST_CASE("Trimming a string works properly") {
         std::string expected = "";
         REQUIRE(result == expected);
     }
-}
\ No newline at end of file
+}
+
+
+/**
+ * Method: StringUtils::split(..)
+ * Desired Confidence Level: Basic validation
+ * 
+ * Valid Tests:
+ *      str     -> a list of pieces separated by the separator
+ *                 a list with whitespace around and empty pieces between the separators
+ *                 a string with no separator
+ *                 an empty string
+ * 
+ * Invalid Tests:
+ *      None
+ */
+TEST_CASE("Splitting a string works properly") {
+
+    SECTION("Splitting a list returns each piece") {
+        std::vector<std::string> result = StringUtils::split("main,worker,idle", ',');
+        std::vector<std::string> expected = { "main", "worker", "idle" };
+        REQUIRE(result == expected);
+    }
+
+    SECTION("Splitting a list trims each piece and drops empty ones") {
+        std::vector<std::string> result = StringUtils::split(" main ,, worker ,", ',');
+        std::vector<std::string> expected = { "main", "worker" };
+        REQUIRE(result == expected);
+    }
+
+    SECTION("Splitting a string with no separator returns the string") {
+        std::vector<std::string> result = StringUtils::split("main", ',');
+        std::vector<std::string> expected = { "main" };
+        REQUIRE(result == expected);
+    }
+
+    SECTION("Splitting an empty string returns nothing") {
+        REQUIRE(StringUtils::split("", ',').empty());
+    }
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/work_stealing_pool.hpp"
+
+/**
+ * Class: WorkStealingPool
+ * Desired Confidence Level: Basic validation
+ *
+ * Valid Tests:
+ *      every task runs exactly once, on any number of threads
+ *      a thread whose queue runs dry steals from another
+ *      no task starts more than the window past the oldest unfinished one
+ *      a pool of a single thread runs the tasks in order
+ *
+ * Invalid Tests:
+ *      a pool of no threads or no window is clamped to one
+ */
+TEST_CASE("Work-stealing pools run every task once, within their window", "[pool]") {
+
+    SECTION("Every task runs exactly once") {
+
+        for (size_t threads : { 1, 3, 8 }) {
+            WorkStealingPool pool(threads, 4, false);
+            std::vector<std::atomic<int>> runs(100);
+            for (auto& count : runs) count = 0;
+
+            pool.run(runs.size(), [&](size_t index) { runs[index]++; });
+            for (const auto& count : runs)
+                REQUIRE(count.load() == 1);
+        }
+    }
+
+    SECTION("Slow tasks leave their thread's queue to be stolen") {
+
+        // Thread 0 is dealt every even task, and the first of them is slow
+        WorkStealingPool pool(2, 16, false);
+        pool.run(16, [](size_t index) {
+            if (index == 0) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        });
+
+        REQUIRE(pool.getSteals() > 0);
+    }
+
+    SECTION("No task starts more than the window past the oldest unfinished one") {
+
+        const size_t window = 3;
+        WorkStealingPool pool(4, window, false);
+        std::mutex mutex;
+        std::vector<bool> finished(40, false);
+        bool outside = false;
+
+        pool.run(finished.size(), [&](size_t index) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                size_t oldest = std::find(finished.begin(), finished.end(), false) - finished.begin();
+                if (index >= oldest + window) outside = true;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds((index % 5) * 200));
+            std::lock_guard<std::mutex> lock(mutex);
+            finished[index] = true;
+        });
+
+        REQUIRE_FALSE(outside);
+    }
+
+    SECTION("A single thread runs the tasks in order") {
+
+        WorkStealingPool pool(1, 1, false);
+        std::vector<size_t> order;
+        pool.run(10, [&](size_t index) { order.push_back(index); });
+
+        REQUIRE(order.size() == 10);
+        REQUIRE(std::is_sorted(order.begin(), order.end()));
+        REQUIRE(pool.getSteals() == 0);
+    }
+
+    SECTION("No threads and no window are clamped to one") {
+        WorkStealingPool pool(0, 0, false);
+        REQUIRE(pool.getThreads() == 1);
+
+        size_t runs = 0;
+        pool.run(5, [&](size_t) { runs++; });
+        REQUIRE(runs == 5);
+    }
+}
@@ -0,0 +1,153 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+#include "instr/instruction_set.hpp"
+#include "instr/instruction_set_factory.hpp"
+#include "memory/memory.hpp"
+#include "reader/file_reader.hpp"
+#include "registers/register_bank.hpp"
+#include "utils/workload_generator.hpp"
+
+#include "simulator.hpp"
+
+/**
+ * Loads and runs a generated program.
+ * @param options The workload options
+ * @param stats A placeholder for the run's statistics
+ * @param textSize A placeholder for the loaded text segment size
+ * @return Whether or not the program loaded
+ */
+static bool runWorkload(const WorkloadGenerator::Options& options, Simulator::Stats& stats, size_t& textSize) {
+
+    std::string path = "pipesim_workload_test.tmp";
+    {
+        std::ofstream file(path);
+        WorkloadGenerator generator(options);
+        generator.generate(file);
+    }
+
+    std::unique_ptr<InstructionSet> instrSet = InstructionSetFactory::createDefault();
+    std::unique_ptr<Memory> memory(new Memory(0x1000, 0x1000));
+    std::unique_ptr<RegisterBank> registerBank(new RegisterBank());
+
+    FileReader reader;
+    bool loaded = reader.readFile(path, *instrSet.get(), *memory.get());
+    std::remove(path.c_str());
+    if (!loaded) return false;
+
+    textSize = memory->getTextSize();
+
+    auto level = spdlog::default_logger()->level();
+    spdlog::set_level(spdlog::level::off);
+    Simulator simulator(std::move(instrSet), std::move(memory), std::move(registerBank));
+    simulator.run();
+    spdlog::set_level(level);
+
+    stats = simulator.getStats();
+    return true;
+}
+
+/**
+ * Method: WorkloadGenerator::generate(..)
+ * Desired Confidence Level: Basic validation
+ * 
+ * Inputs:
+ *      options     -> The program shape, clamped
+ * 
+ * Outputs:
+ *      A valid program of roughly the requested size, and a summary of it
+ * 
+ * Valid Tests:
+ *      the same options generate the same program
+ *      a small program loads and runs to completion
+ *      straight-line code runs every statement once
+ *      a program larger than the default text segment grows memory and runs
+ *      a byte target produces roughly that many bytes
+ * 
+ * Invalid Tests:
+ *      None (options are clamped)
+ */
+TEST_CASE("Generated workloads are valid programs", "[workload]") {
+
+    SECTION("The same options generate the same program") {
+
+        WorkloadGenerator::Options options;
+        options.wSeed = 42;
+
+        std::ostringstream first;
+        std::ostringstream second;
+        WorkloadGenerator generator(options);
+        WorkloadGenerator::Summary summary = generator.generate(first);
+        WorkloadGenerator(options).generate(second);
+
+        REQUIRE(first.str() == second.str());
+        REQUIRE(summary.szBytes == first.str().length());
+        REQUIRE(summary.szInstructions >= options.szInstructions);
+    }
+
+    SECTION("A small nested program loads and runs to completion") {
+
+        WorkloadGenerator::Options options;
+        options.szInstructions = 100;
+        options.szNesting = 2;
+        options.szIterations = 3;
+        options.szBlockSize = 20;
+
+        Simulator::Stats stats;
+        size_t textSize = 0;
+        REQUIRE(runWorkload(options, stats, textSize) == true);
+
+        // Nested loops run the body many more times than it appears
+        REQUIRE(stats.dwInstructions > 9 * 20);
+    }
+
+    SECTION("Straight-line code runs every statement once") {
+
+        WorkloadGenerator::Options options;
+        options.szInstructions = 50;
+        options.szNesting = 0;
+        options.dBranchDensity = 0.0;
+        options.dLoadDensity = 0.0;
+        options.szDataSize = 0;
+
+        Simulator::Stats stats;
+        size_t textSize = 0;
+        REQUIRE(runWorkload(options, stats, textSize) == true);
+
+        // Every statement is a single instruction here, and the exit ends the run
+        REQUIRE(stats.dwInstructions == 50);
+    }
+
+    SECTION("A program larger than the text segment grows memory and runs") {
+
+        WorkloadGenerator::Options options;
+        options.szInstructions = 3000;
+        options.szDataSize = 100000;
+        options.dBranchDensity = 0.3;
+        options.szDependencyDistance = 4;
+
+        Simulator::Stats stats;
+        size_t textSize = 0;
+        REQUIRE(runWorkload(options, stats, textSize) == true);
+        REQUIRE(textSize > 0x1000);
+        REQUIRE(stats.dwInstructions > 3000);
+    }
+
+    SECTION("A byte target produces roughly that many bytes") {
+
+        WorkloadGenerator::Options options;
+        options.szTargetBytes = 64 * 1024;
+
+        std::ostringstream out;
+        WorkloadGenerator::Summary summary = WorkloadGenerator(options).generate(out);
+        REQUIRE(summary.szBytes >= options.szTargetBytes);
+        REQUIRE(summary.szBytes < options.szTargetBytes + options.szTargetBytes / 4);
+    }
+}